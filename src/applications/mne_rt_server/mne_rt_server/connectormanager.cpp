@@ -200,8 +200,9 @@ void ConnectorManager::connectActiveConnector()
         // connect command server and connector manager
 
         // connect connector manager and fiff stream server
+        // direct connection: the buffer is encoded in the acquisition thread and the block policy holds back the producer
         QObject::connect(   t_activeConnector, &IConnector::remitRawBuffer,
-                            this->m_pFiffStreamServer, &FiffStreamServer::forwardRawBuffer);
+                            this->m_pFiffStreamServer, &FiffStreamServer::forwardRawBuffer, Qt::DirectConnection);
     }
     else
     {
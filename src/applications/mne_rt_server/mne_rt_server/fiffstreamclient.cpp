@@ -0,0 +1,515 @@
+//=============================================================================================================
+/**
+ * @file     fiffstreamclient.cpp
+ * @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+ *           Felix Arndt <Felix.Arndt@tu-ilmenau.de>;
+ *           Limin Sun <limin.sun@childrens.harvard.edu>;
+ *           Lorenz Esch <lesch@mgh.harvard.edu>;
+ *           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+ * @since    0.1.0
+ * @date     July, 2012
+ *
+ * @section  LICENSE
+ *
+ *
+ *                      Copyright (C) 2012, Christoph Dinh, Felix Arndt, Limin Sun, Lorenz Esch, Matti Hamalainen. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief     Definition of the FiffStreamClient Class.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffstreamclient.h"
+#include "fiffstreamserver.h"
+#include "mne_rt_commands.h"
+
+//=============================================================================================================
+// Fiff INCLUDES
+//=============================================================================================================
+
+#include <utils/ioutils.h>
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_tag.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtNetwork>
+#include <QtEndian>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace RTSERVER;
+using namespace FIFFLIB;
+
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define SOCKET_WRITE_CHUNK 262144   /**< Maximum number of bytes handed to the socket buffer at once. */
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffStreamClient::FiffStreamClient(qint32 id,
+                                   qintptr socketDescriptor,
+                                   FiffStreamServer* pServer)
+: QObject()
+, m_iDataClientId(id)
+, m_sDataClientAlias(QString(""))
+, m_iSocketDescriptor(socketDescriptor)
+, m_pServer(pServer)
+, m_pTcpSocket(Q_NULLPTR)
+, m_iSendOffset(0)
+, m_iQueuedBytes(0)
+, m_iDroppedFrames(0)
+, m_bIsSendingRawBuffer(false)
+, m_bIsCongested(false)
+, m_bUseSharedMemory(false)
+, m_bUseCompression(false)
+, m_bCalibrationsSent(false)
+, m_iCalibrationId(0)
+, m_pStreamingCounter(Q_NULLPTR)
+{
+}
+
+//=============================================================================================================
+
+FiffStreamClient::~FiffStreamClient()
+{
+    // The socket is a child of this client and is deleted together with it
+}
+
+//=============================================================================================================
+
+QString FiffStreamClient::getAlias()
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_sDataClientAlias;
+}
+
+//=============================================================================================================
+
+QHostAddress FiffStreamClient::getPeerAddress()
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_peerAddress;
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::open()
+{
+    m_pTcpSocket = new QTcpSocket(this);
+
+    if (!m_pTcpSocket->setSocketDescriptor(m_iSocketDescriptor)) {
+        emit error(m_pTcpSocket->error());
+        emit closed(m_iDataClientId);
+        return;
+    }
+
+    m_qMutex.lock();
+    m_peerAddress = m_pTcpSocket->peerAddress();
+    m_qMutex.unlock();
+
+    printf("FiffStreamClient (assigned ID %d) accepted from\n\tIP:\t%s\n\tPort:\t%d\n\n",
+           m_iDataClientId,
+           QHostAddress(m_pTcpSocket->peerAddress()).toString().toUtf8().constData(),
+           m_pTcpSocket->peerPort());
+
+    connect(m_pTcpSocket, &QTcpSocket::readyRead,
+            this, &FiffStreamClient::readCommands);
+    connect(m_pTcpSocket, &QTcpSocket::bytesWritten,
+            this, &FiffStreamClient::flush);
+    connect(m_pTcpSocket, &QTcpSocket::disconnected, this, [this]() {
+        close();
+        emit closed(m_iDataClientId);
+    });
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::close()
+{
+    m_bIsSendingRawBuffer = false;
+    updateStreaming();
+
+    setCongested(false);
+
+    m_qSendQueue.clear();
+    m_iSendOffset = 0;
+    m_iQueuedBytes = 0;
+
+    if(m_pTcpSocket) {
+        QTcpSocket* pTcpSocket = m_pTcpSocket;
+        m_pTcpSocket = Q_NULLPTR;
+
+        pTcpSocket->disconnect(this);
+        pTcpSocket->abort();
+        pTcpSocket->deleteLater();
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::startMeas(qint32 ID)
+{
+    if(ID == m_iDataClientId && !m_bIsSendingRawBuffer)
+    {
+        qDebug() << "Activate raw buffer sending.";
+
+        // ToDo send start meas
+        QByteArray t_blockStart;
+        FiffStream t_FiffStreamOut(&t_blockStart, QIODevice::WriteOnly);
+        t_FiffStreamOut.start_block(FIFFB_RAW_DATA);
+        enqueue(t_blockStart, false);
+
+        m_bIsSendingRawBuffer = true;
+        m_bCalibrationsSent = false;
+        updateStreaming();
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::stopMeas(qint32 ID)
+{
+    qDebug() << "void FiffStreamClient::stopMeas(qint32 ID)";
+    if((ID == m_iDataClientId || ID == -1) && m_bIsSendingRawBuffer)
+    {
+        qDebug() << "stop raw buffer sending.";
+
+        QByteArray t_blockEnd;
+        FiffStream t_FiffStreamOut(&t_blockEnd, QIODevice::WriteOnly);
+        t_FiffStreamOut.end_block(FIFFB_RAW_DATA);
+        enqueue(t_blockEnd, false);
+
+        m_bIsSendingRawBuffer = false;
+        updateStreaming();
+
+        if(m_iDroppedFrames > 0) {
+            qWarning() << "FiffStreamClient (ID" << m_iDataClientId << "): dropped" << m_iDroppedFrames << "raw buffers due to a slow connection.";
+            m_iDroppedFrames = 0;
+        }
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::parseCommand(FiffTag::SPtr p_pTag)
+{
+    if(p_pTag->size() >= 4)
+    {
+        qint32* t_pInt = (qint32*)p_pTag->data();
+        IOUtils::swap_intp(t_pInt);
+        qint32 t_iCmd = t_pInt[0];
+
+        if(t_iCmd == MNE_RT_SET_CLIENT_ALIAS)
+        {
+            //
+            // Set Client Alias
+            //
+            m_qMutex.lock();
+            m_sDataClientAlias = QString(p_pTag->mid(4, p_pTag->size()-4));
+            m_qMutex.unlock();
+            printf("FiffStreamClient (ID %d): new alias = '%s'\r\n\n", m_iDataClientId, getAlias().toUtf8().constData());
+        }
+        else if(t_iCmd == MNE_RT_GET_CLIENT_ID)
+        {
+            //
+            // Send Client ID
+            //
+            printf("FiffStreamClient (ID %d): send client ID %d\r\n\n", m_iDataClientId, m_iDataClientId);
+            writeClientId();
+        }
+        else if(t_iCmd == MNE_RT_SET_COMPRESSION)
+        {
+            //
+            // Enable/disable lossless compression of raw buffers
+            //
+            m_bUseCompression = QString(p_pTag->mid(4, p_pTag->size()-4)).trimmed() == "1";
+            printf("FiffStreamClient (ID %d): compression %s\r\n\n", m_iDataClientId, m_bUseCompression ? "enabled" : "disabled");
+            updateStreaming();
+        }
+        else
+        {
+            printf("FiffStreamClient (ID %d): unknown command\r\n\n", m_iDataClientId);
+        }
+    }
+    else
+    {
+        printf("FiffStreamClient (ID %d): unknown command\r\n\n", m_iDataClientId);
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::sendRawFrame(const QByteArray& frame)
+{
+    if(m_pStreamingCounter == &m_pServer->m_iStreamingClients)
+    {
+        enqueue(frame, true);
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::sendCompressedFrame(const QByteArray& frame)
+{
+    if(m_pStreamingCounter != &m_pServer->m_iCompressedStreamingClients)
+    {
+        return;
+    }
+
+    // The calibration id is the first field behind the tag header
+    const quint32 t_iCalibrationId = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(frame.constData()) + 4*sizeof(qint32));
+
+    if(!m_bCalibrationsSent || t_iCalibrationId != m_iCalibrationId)
+    {
+        COMMUNICATIONLIB::RtBufferCodec::ConstSPtr t_pBufferCodec = m_pServer->getBufferCodec();
+
+        if(t_pBufferCodec->getCalibrationId() != t_iCalibrationId)
+        {
+            // The calibrations changed while the frame was encoded, the next frame uses the new ones
+            return;
+        }
+
+        QByteArray t_blockCals;
+        FiffStream t_FiffStreamOut(&t_blockCals, QIODevice::WriteOnly);
+        t_FiffStreamOut.write_double(FIFF_MNE_RT_CALIBRATIONS,
+                                     t_pBufferCodec->getCalibrations().data(),
+                                     t_pBufferCodec->getCalibrations().size());
+        enqueue(t_blockCals, false);
+
+        m_iCalibrationId = t_iCalibrationId;
+        m_bCalibrationsSent = true;
+    }
+
+    enqueue(frame, true);
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::setUseSharedMemory(qint32 ID, bool bUse)
+{
+    if(ID == m_iDataClientId && bUse != m_bUseSharedMemory)
+    {
+        m_bUseSharedMemory = bUse;
+        updateStreaming();
+
+        qint32 t_iUse = bUse ? 1 : 0;
+        QByteArray t_blockSwitch;
+        FiffStream t_FiffStreamOut(&t_blockSwitch, QIODevice::WriteOnly);
+        t_FiffStreamOut.write_int(FIFF_MNE_RT_SHARED_MEMORY, &t_iUse);
+
+        enqueue(t_blockSwitch, false);
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo)
+{
+    if(ID == m_iDataClientId)
+    {
+        QByteArray t_blockInfo;
+        FiffStream t_FiffStreamOut(&t_blockInfo, QIODevice::WriteOnly);
+        p_fiffInfo.writeToStream(&t_FiffStreamOut);
+
+        enqueue(t_blockInfo, false);
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::writeClientId()
+{
+    QByteArray t_blockId;
+    FiffStream t_FiffStreamOut(&t_blockId, QIODevice::WriteOnly);
+    t_FiffStreamOut.write_int(FIFF_MNE_RT_CLIENT_ID, &m_iDataClientId);
+
+    enqueue(t_blockId, false);
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::updateStreaming()
+{
+    QAtomicInt* pStreamingCounter = Q_NULLPTR;
+
+    if(m_bIsSendingRawBuffer && !m_bUseSharedMemory) {
+        pStreamingCounter = m_bUseCompression ? &m_pServer->m_iCompressedStreamingClients
+                                              : &m_pServer->m_iStreamingClients;
+    }
+
+    if(pStreamingCounter != m_pStreamingCounter) {
+        if(m_pStreamingCounter) {
+            m_pStreamingCounter->deref();
+        }
+        if(pStreamingCounter) {
+            pStreamingCounter->ref();
+        }
+        m_pStreamingCounter = pStreamingCounter;
+    }
+
+    // Also reported before the switch, the server needs to know whether to write the ring once the reader attached
+    m_pServer->setSharedMemoryStreaming(m_iDataClientId, m_bIsSendingRawBuffer);
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::enqueue(const QByteArray& frame,
+                               bool bDroppable)
+{
+    if(!m_pTcpSocket) {
+        return;
+    }
+
+    qint64 iMaxQueueSize = m_pServer->getMaxClientQueueSize();
+
+    if(bDroppable && m_iQueuedBytes + frame.size() > iMaxQueueSize) {
+        switch(m_pServer->getSlowClientPolicy()) {
+            case FiffStreamServer::DropOldest: {
+                // The head frame might be partially written already, hence it has to be kept to not corrupt the stream
+                QQueue<Frame>::iterator it = m_qSendQueue.begin();
+                if(m_iSendOffset > 0 && it != m_qSendQueue.end()) {
+                    ++it;
+                }
+
+                while(it != m_qSendQueue.end() && m_iQueuedBytes + frame.size() > iMaxQueueSize) {
+                    if(it->bDroppable) {
+                        m_iQueuedBytes -= it->data.size();
+                        ++m_iDroppedFrames;
+                        it = m_qSendQueue.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                break;
+            }
+
+            case FiffStreamServer::Disconnect:
+                qWarning() << "FiffStreamClient (ID" << m_iDataClientId << "): send queue exceeded" << iMaxQueueSize << "bytes. Disconnecting slow client.";
+                m_pTcpSocket->abort();
+                return;
+
+            case FiffStreamServer::Block:
+                // The frame is queued anyway. The server holds back the producer until the queue drained.
+                break;
+        }
+    }
+
+    Frame t_frame;
+    t_frame.data = frame;
+    t_frame.bDroppable = bDroppable;
+    m_qSendQueue.enqueue(t_frame);
+    m_iQueuedBytes += frame.size();
+
+    flush();
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::flush()
+{
+    if(!m_pTcpSocket || m_pTcpSocket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+
+    // Only hand a bounded amount of data to the socket, the rest stays in the queue as shared frames and can
+    // still be dropped if the client does not keep up
+    while(!m_qSendQueue.isEmpty() && m_pTcpSocket->bytesToWrite() < SOCKET_WRITE_CHUNK) {
+        const QByteArray& t_frame = m_qSendQueue.head().data;
+
+        qint64 t_iBytesWritten = m_pTcpSocket->write(t_frame.constData() + m_iSendOffset,
+                                                     t_frame.size() - m_iSendOffset);
+
+        if(t_iBytesWritten < 0) {
+            qWarning() << "FiffStreamClient (ID" << m_iDataClientId << "): write failed:" << m_pTcpSocket->errorString();
+            m_pTcpSocket->abort();
+            return;
+        }
+
+        m_iSendOffset += t_iBytesWritten;
+        m_iQueuedBytes -= t_iBytesWritten;
+
+        if(m_iSendOffset >= t_frame.size()) {
+            m_qSendQueue.dequeue();
+            m_iSendOffset = 0;
+        }
+    }
+
+    setCongested(m_pServer->getSlowClientPolicy() == FiffStreamServer::Block
+                 && m_iQueuedBytes > m_pServer->getMaxClientQueueSize());
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::readCommands()
+{
+    const qint64 t_iHeaderSize = sizeof(qint32)*4;
+
+    while(m_pTcpSocket && m_pTcpSocket->bytesAvailable() >= t_iHeaderSize)
+    {
+        //
+        // Peek the tag header and wait for the next readyRead until the whole tag is available
+        //
+        QByteArray t_header = m_pTcpSocket->peek(t_iHeaderSize);
+        qint32 t_iTagSize = qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(t_header.constData()) + 2*sizeof(qint32));
+
+        if (m_pTcpSocket->bytesAvailable() < t_iHeaderSize + t_iTagSize)
+        {
+            return;
+        }
+
+        FiffStream t_FiffStreamIn(m_pTcpSocket);
+        FiffTag::SPtr t_pTag;
+        t_FiffStreamIn.read_tag_info(t_pTag, false);
+        t_FiffStreamIn.read_tag_data(t_pTag);
+
+        //
+        // Parse the tag
+        //
+        if(t_pTag->kind == FIFF_MNE_RT_COMMAND)
+        {
+            parseCommand(t_pTag);
+        }
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamClient::setCongested(bool bCongested)
+{
+    if(bCongested != m_bIsCongested) {
+        m_bIsCongested = bCongested;
+        m_pServer->setClientCongested(bCongested);
+    }
+}
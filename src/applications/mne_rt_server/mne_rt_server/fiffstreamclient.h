@@ -0,0 +1,251 @@
+//=============================================================================================================
+/**
+ * @file     fiffstreamclient.h
+ * @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+ *           Limin Sun <limin.sun@childrens.harvard.edu>;
+ *           Lorenz Esch <lesch@mgh.harvard.edu>;
+ *           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+ * @since    0.1.0
+ * @date     July, 2012
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2012, Christoph Dinh, Limin Sun, Lorenz Esch, Matti Hamalainen. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief     Declaration of the FiffStreamClient Class.
+ *
+ */
+
+#ifndef FIFFSTREAMCLIENT_H
+#define FIFFSTREAMCLIENT_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_info.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QAtomicInt>
+
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVER
+//=============================================================================================================
+
+namespace RTSERVER
+{
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class FiffStreamServer;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS FiffStreamClient
+ *
+ * @brief The FiffStreamClient class serves one connected fiff data client. All clients live in the single I/O
+ * thread of the FiffStreamServer and write without blocking from a queue of shared, already encoded frames.
+ */
+class FiffStreamClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    //=========================================================================================================
+    /**
+     * Constructs a FiffStreamClient. The socket is opened with open() once the client was moved to the I/O thread.
+     *
+     * @param[in] id                 The client id.
+     * @param[in] socketDescriptor   The descriptor of the accepted connection.
+     * @param[in] pServer            The server which accepted the connection.
+     */
+    FiffStreamClient(qint32 id,
+                     qintptr socketDescriptor,
+                     FiffStreamServer* pServer);
+
+    ~FiffStreamClient();
+
+    inline qint32 getID();
+
+    QString getAlias();
+
+    //=========================================================================================================
+    /**
+     * Returns the address of the connected peer. May be called from the command thread.
+     *
+     * @return the peer address, a null address if the socket is not open.
+     */
+    QHostAddress getPeerAddress();
+
+    //=========================================================================================================
+    /**
+     * Opens the socket. Has to be called from the thread the client lives in.
+     */
+    void open();
+
+    //=========================================================================================================
+    /**
+     * Aborts the connection and releases the socket. Has to be called from the thread the client lives in.
+     */
+    void close();
+
+    void parseCommand(QSharedPointer<FIFFLIB::FiffTag> p_pTag);
+
+    void writeClientId();
+
+    void startMeas(qint32 ID);
+
+    void stopMeas(qint32 ID);
+
+    void sendMeasurementInfo(qint32 ID, const FIFFLIB::FiffInfo& p_fiffInfo);
+
+    //=========================================================================================================
+    /**
+     * Queues a raw buffer frame which was encoded once for all clients.
+     *
+     * @param[in] frame  The encoded FIFF_DATA_BUFFER tag.
+     */
+    void sendRawFrame(const QByteArray& frame);
+
+    //=========================================================================================================
+    /**
+     * Queues a compressed raw buffer frame which was encoded once for all clients. The calibrations are sent
+     * before the first compressed frame of a measurement.
+     *
+     * @param[in] frame  The encoded FIFF_MNE_RT_COMPRESSED_BUFFER tag.
+     */
+    void sendCompressedFrame(const QByteArray& frame);
+
+    //=========================================================================================================
+    /**
+     * Switches the raw buffer transport of this client between the shared memory ring and TCP. The switch is
+     * announced to the data client with a FIFF_MNE_RT_SHARED_MEMORY tag behind the raw buffers which were already
+     * queued, so the data client knows from which point on it has to read the ring.
+     *
+     * @param[in] ID     The client id the switch is meant for.
+     * @param[in] bUse   Whether raw buffers are written to the shared memory ring of the server.
+     */
+    void setUseSharedMemory(qint32 ID, bool bUse);
+
+signals:
+    void error(QTcpSocket::SocketError socketError);
+
+    //=========================================================================================================
+    /**
+     * Emitted when the connection was closed and the client can be deleted.
+     *
+     * @param[in] id     The client id.
+     */
+    void closed(qint32 id);
+
+private:
+    //=========================================================================================================
+    /**
+     * Encoded frame in the send queue. Frames are implicitly shared between all clients.
+     */
+    struct Frame {
+        QByteArray  data;           /**< The encoded tag(s). */
+        bool        bDroppable;     /**< Whether the frame is a raw buffer which may be dropped for slow clients. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Appends a frame to the send queue and applies the slow client policy of the server.
+     *
+     * @param[in] frame          The encoded frame.
+     * @param[in] bDroppable     Whether the frame is a raw buffer which may be dropped.
+     */
+    void enqueue(const QByteArray& frame,
+                 bool bDroppable);
+
+    //=========================================================================================================
+    /**
+     * Hands queued frames to the socket without blocking. Called whenever the socket wrote data.
+     */
+    void flush();
+
+    //=========================================================================================================
+    /**
+     * Reads and parses all complete command tags which are available on the socket.
+     */
+    void readCommands();
+
+    //=========================================================================================================
+    /**
+     * Reports to the server whether this client holds back the producer.
+     *
+     * @param[in] bCongested     Whether the send queue exceeds the limit while the block policy is active.
+     */
+    void setCongested(bool bCongested);
+
+    //=========================================================================================================
+    /**
+     * Reports to the server whether this client receives raw, compressed or shared memory raw buffers.
+     */
+    void updateStreaming();
+
+    qint32              m_iDataClientId;        /**< The client id. */
+    QString             m_sDataClientAlias;     /**< The client alias. */
+    QHostAddress        m_peerAddress;          /**< The address of the connected peer. */
+    QMutex              m_qMutex;               /**< Guards the alias and the peer address, which are read from the command thread. */
+
+    qintptr             m_iSocketDescriptor;    /**< The descriptor of the accepted connection. */
+    FiffStreamServer*   m_pServer;              /**< The server which holds the slow client policy. */
+    QTcpSocket*         m_pTcpSocket;           /**< The socket, owned by the client and living in the I/O thread. */
+
+    QQueue<Frame>       m_qSendQueue;           /**< Frames which were not yet handed to the socket. */
+    qint64              m_iSendOffset;          /**< Bytes of the head frame which were already handed to the socket. */
+    qint64              m_iQueuedBytes;         /**< Bytes in the send queue which still have to be written. */
+    qint64              m_iDroppedFrames;       /**< Number of raw buffers dropped due to a slow connection. */
+
+    bool                m_bIsSendingRawBuffer;  /**< Whether raw buffers are sent to this client. */
+    bool                m_bIsCongested;         /**< Whether this client currently holds back the producer. */
+    bool                m_bUseSharedMemory;     /**< Whether raw buffers are sent via the shared memory ring. */
+    bool                m_bUseCompression;      /**< Whether raw buffers are sent losslessly compressed. */
+    bool                m_bCalibrationsSent;    /**< Whether the calibrations of the compressed frames were sent. */
+    quint32             m_iCalibrationId;       /**< Id of the calibrations which were sent. */
+    QAtomicInt*         m_pStreamingCounter;    /**< Server counter this client is counted in, if streaming via TCP. */
+};
+
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline qint32 FiffStreamClient::getID()
+{
+    return m_iDataClientId;
+}
+} // NAMESPACE
+
+#endif //FIFFSTREAMCLIENT_H
@@ -40,12 +40,27 @@
 //=============================================================================================================
 
 #include "fiffstreamserver.h"
-#include "fiffstreamthread.h"
+#include "fiffstreamclient.h"
 
 #include "mne_rt_server.h"
 
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_file.h>
+
 #include <stdlib.h>
 
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QNetworkInterface>
+
 //=============================================================================================================
 // USED NAMESPACES
 //=============================================================================================================
@@ -54,6 +69,28 @@ using namespace RTSERVER;
 using namespace FIFFLIB;
 using namespace COMMUNICATIONLIB;
 
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+const qint64 SHARED_MEMORY_ATTACH_TIMEOUT = 5000;  /**< Milliseconds a reader has to attach to a new ring. */
+
+//=============================================================================================================
+
+bool isSameHost(const QHostAddress& address)
+{
+    // IPv4 clients of a dual stack server are reported as IPv4-mapped IPv6 addresses
+    bool bIsIPv4 = false;
+    const quint32 iIPv4Address = address.toIPv4Address(&bIsIPv4);
+    const QHostAddress t_address = bIsIPv4 ? QHostAddress(iIPv4Address) : address;
+
+    return t_address.isLoopback() || QNetworkInterface::allAddresses().contains(t_address);
+}
+
+}
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -61,7 +98,18 @@ using namespace COMMUNICATIONLIB;
 FiffStreamServer::FiffStreamServer(QObject *parent)
 : QTcpServer(parent)
 , m_iNextClientId(0)
+, m_iStreamingClients(0)
+, m_iCompressedStreamingClients(0)
+, m_iSlowClientPolicy(DropOldest)
+, m_iMaxClientQueueSize(64*1024*1024)
+, m_iCongestedClients(0)
+, m_iSharedMemorySize(32*1024*1024)
+, m_pBufferCodec(new RtBufferCodec)
+, m_compressionStatistics()
 {
+
+    m_ioThread.setObjectName("FiffStreamServerIO");
+    m_ioThread.start();
 }
 
 //=============================================================================================================
@@ -69,6 +117,78 @@ FiffStreamServer::FiffStreamServer(QObject *parent)
 FiffStreamServer::~FiffStreamServer()
 {
     emit closeFiffStreamServer();
+
+    m_sharedMemoryMutex.lock();
+    m_qSharedMemoryClients.clear();
+    m_sharedMemoryMutex.unlock();
+
+    //Close all sockets from within the I/O thread they live in
+    QMap<qint32, FiffStreamClient*>::const_iterator i;
+    for (i = m_qClientList.constBegin(); i != m_qClientList.constEnd(); ++i) {
+        FiffStreamClient* t_pClient = i.value();
+        QMetaObject::invokeMethod(t_pClient, [t_pClient]() { t_pClient->close(); }, Qt::BlockingQueuedConnection);
+    }
+
+    m_ioThread.quit();
+    m_ioThread.wait();
+
+    //Release a producer which might still wait for a congested client
+    m_congestionMutex.lock();
+    m_iCongestedClients = 0;
+    m_congestionCondition.wakeAll();
+    m_congestionMutex.unlock();
+
+    qDeleteAll(m_qClientList);
+    m_qClientList.clear();
+}
+
+//=============================================================================================================
+
+void FiffStreamServer::setSlowClientPolicy(SlowClientPolicy policy)
+{
+    m_iSlowClientPolicy.storeRelease(policy);
+
+    //Release the producer if the block policy was switched off
+    if(policy != Block) {
+        QMutexLocker locker(&m_congestionMutex);
+        m_congestionCondition.wakeAll();
+    }
+}
+
+//=============================================================================================================
+
+FiffStreamServer::SlowClientPolicy FiffStreamServer::getSlowClientPolicy() const
+{
+    return static_cast<SlowClientPolicy>(m_iSlowClientPolicy.loadAcquire());
+}
+
+//=============================================================================================================
+
+void FiffStreamServer::setMaxClientQueueSize(qint64 iBytes)
+{
+    m_iMaxClientQueueSize.storeRelease(iBytes);
+}
+
+//=============================================================================================================
+
+qint64 FiffStreamServer::getMaxClientQueueSize() const
+{
+    return m_iMaxClientQueueSize.loadAcquire();
+}
+
+//=============================================================================================================
+
+void FiffStreamServer::setSharedMemorySize(qint64 iBytes)
+{
+    m_iSharedMemorySize.storeRelease(iBytes);
+}
+
+//=============================================================================================================
+
+FiffStreamServer::CompressionStatistics FiffStreamServer::getCompressionStatistics() const
+{
+    QMutexLocker locker(&m_codecMutex);
+    return m_compressionStatistics;
 }
 
 //=============================================================================================================
@@ -78,7 +198,7 @@ void FiffStreamServer::comClist(Command p_command)
     //ToDo JSON
     QString t_sOutput("");
     t_sOutput.append("\tID\tAlias\r\n");
-    QMap<qint32, FiffStreamThread*>::iterator i;
+    QMap<qint32, FiffStreamClient*>::iterator i;
     for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
     {
         QString str = QString("\t%1\t%2\r\n").arg(i.key()).arg(i.value()->getAlias());
@@ -159,6 +279,37 @@ void FiffStreamServer::comStopAll(Command p_command)
 
 //=============================================================================================================
 
+void FiffStreamServer::comShmem(Command p_command)
+{
+    qint32 t_id = -1;
+    QString t_sOutput("");
+    QString t_sAlias(p_command.pValues()[0].toString());
+    t_sOutput.append(parseToId(t_sAlias,t_id));
+
+    QString t_sKey;
+    if(t_id != -1)
+    {
+        t_sKey = createSharedMemory(t_id);
+    }
+
+    if(p_command.isJson())
+    {
+        QJsonObject t_jsonObject;
+        t_jsonObject.insert("shmem", t_sKey);
+        qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["shmem"].reply(QJsonDocument(t_jsonObject).toJson(QJsonDocument::Compact));
+    }
+    else
+    {
+        if(t_sKey.isEmpty())
+            t_sOutput.append("\tshared memory not available, raw buffers are sent via TCP\r\n\n");
+        else
+            t_sOutput.append(QString("\tFiffStreamClient (ID: %1) receives raw buffers via shared memory '%2' once it attached\r\n\n").arg(t_id).arg(t_sKey));
+        qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["shmem"].reply(t_sOutput);
+    }
+}
+
+//=============================================================================================================
+
 void FiffStreamServer::connectCommands()
 {
     //Connect slots
@@ -169,6 +320,7 @@ void FiffStreamServer::connectCommands()
     QObject::connect(&t_pMNERTServer->getCommandManager()["start"], &Command::executed, this, &FiffStreamServer::comStart);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop"], &Command::executed, this, &FiffStreamServer::comStop);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop-all"], &Command::executed, this, &FiffStreamServer::comStopAll);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["shmem"], &Command::executed, this, &FiffStreamServer::comShmem);
 
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("clist"), this, &FiffStreamServer::comClist);
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("measinfo"), this, &FiffStreamServer::comMeasinfo);
@@ -191,7 +343,7 @@ void FiffStreamServer::connectCommands()
 //        printf("clist\n");
 
 //        p_blockOutputInfo.append("\tID\tAlias\r\n");
-//        QMap<qint32, FiffStreamThread*>::iterator i;
+//        QMap<qint32, FiffStreamClient*>::iterator i;
 //        for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
 //        {
 //            QString str = QString("\t%1\t%2\r\n").arg(i.key()).arg(i.value()->getAlias());
@@ -304,7 +456,7 @@ QByteArray FiffStreamServer::parseToId(QString& p_sRawId, qint32& p_iParsedId)
         }
         else
         {
-            QMap<qint32, FiffStreamThread*>::iterator i;
+            QMap<qint32, FiffStreamClient*>::iterator i;
             for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
             {
                 if(i.value()->getAlias().compare(p_sRawId) == 0)
@@ -335,7 +487,7 @@ QByteArray FiffStreamServer::parseToId(QString& p_sRawId, qint32& p_iParsedId)
 
 //void FiffStreamServer::clearClients()
 //{
-//    QMap<qint32, FiffStreamThread*>::const_iterator i = m_qClientList.constBegin();
+//    QMap<qint32, FiffStreamClient*>::const_iterator i = m_qClientList.constBegin();
 //    while (i != m_qClientList.constEnd()) {
 //        if(i.value())
 //            delete i.value();
@@ -348,28 +500,260 @@ QByteArray FiffStreamServer::parseToId(QString& p_sRawId, qint32& p_iParsedId)
 
 void FiffStreamServer::forwardMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo)
 {
+    //Compressed buffers are coded against the calibrations of the current measurement
+    RtBufferCodec::ConstSPtr t_pBufferCodec(new RtBufferCodec(RtBufferCodec::calibrationsFromInfo(p_fiffInfo)));
+
+    m_codecMutex.lock();
+    if(t_pBufferCodec->getCalibrationId() != m_pBufferCodec->getCalibrationId()) {
+        m_pBufferCodec = t_pBufferCodec;
+    }
+    m_codecMutex.unlock();
+
     emit remitMeasInfo(ID, p_fiffInfo);
 }
 
 //=============================================================================================================
-//ToDo increase preformance --> try inline
+
 void FiffStreamServer::forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData)
 {
-    emit remitRawBuffer(m_pMatRawData);
+    //Same-host clients get a single copy into their ring
+    writeSharedMemory(*m_pMatRawData);
+
+    //Remaining clients are served via TCP
+    const bool t_bRawClients = m_iStreamingClients.loadAcquire() > 0;
+    const bool t_bCompressedClients = m_iCompressedStreamingClients.loadAcquire() > 0;
+
+    if(!t_bRawClients && !t_bCompressedClients) {
+        return;
+    }
+
+    //Block policy: hold back the producer until no client is congested anymore
+    if(getSlowClientPolicy() == Block) {
+        QMutexLocker locker(&m_congestionMutex);
+        while(m_iCongestedClients > 0 && getSlowClientPolicy() == Block && m_ioThread.isRunning()) {
+            m_congestionCondition.wait(&m_congestionMutex, 100);
+        }
+    }
+
+    //Encode the buffer once per encoding, all clients share the same immutable frame
+    if(t_bRawClients) {
+        QByteArray t_frame;
+        {
+            FiffStream t_FiffStreamOut(&t_frame, QIODevice::WriteOnly);
+            t_FiffStreamOut.write_float(FIFF_DATA_BUFFER,m_pMatRawData->data(),m_pMatRawData->rows()*m_pMatRawData->cols());
+        }
+
+        emit remitRawFrame(t_frame);
+    }
+
+    if(t_bCompressedClients) {
+        emit remitCompressedFrame(encodeCompressedFrame(*m_pMatRawData));
+    }
+}
+
+//=============================================================================================================
+
+RtBufferCodec::ConstSPtr FiffStreamServer::getBufferCodec() const
+{
+    QMutexLocker locker(&m_codecMutex);
+    return m_pBufferCodec;
+}
+
+//=============================================================================================================
+
+QByteArray FiffStreamServer::encodeCompressedFrame(const Eigen::MatrixXf& matRawData)
+{
+    RtBufferCodec::ConstSPtr t_pBufferCodec = getBufferCodec();
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    QByteArray t_compressed = t_pBufferCodec->encode(matRawData);
+
+    QByteArray t_frame;
+    {
+        FiffStream t_FiffStreamOut(&t_frame, QIODevice::WriteOnly);
+        t_FiffStreamOut << (qint32)FIFF_MNE_RT_COMPRESSED_BUFFER;
+        t_FiffStreamOut << (qint32)FIFFT_BYTE;
+        t_FiffStreamOut << (qint32)t_compressed.size();
+        t_FiffStreamOut << (qint32)FIFFV_NEXT_SEQ;
+        t_FiffStreamOut.writeRawData(t_compressed.constData(), t_compressed.size());
+    }
+
+    const double t_dEncodeTimeMs = t_timer.nsecsElapsed() / 1.0e6;
+    const qint64 t_iRawBytes = matRawData.size() * sizeof(float);
+
+    QMutexLocker locker(&m_codecMutex);
+
+    m_compressionStatistics.iBuffers++;
+    m_compressionStatistics.iRawBytes += t_iRawBytes;
+    m_compressionStatistics.iCompressedBytes += t_compressed.size();
+    m_compressionStatistics.dEncodeTimeMs += t_dEncodeTimeMs;
+    m_compressionStatistics.dLastRatio = t_compressed.isEmpty() ? 0.0 : double(t_iRawBytes) / t_compressed.size();
+    m_compressionStatistics.dLastEncodeTimeMs = t_dEncodeTimeMs;
+
+    if(m_compressionStatistics.iBuffers % 100 == 0) {
+        qInfo("FiffStreamServer: compressed buffer ratio %.2f (mean %.2f), encode time %.3f ms (mean %.3f ms)",
+              m_compressionStatistics.dLastRatio,
+              double(m_compressionStatistics.iRawBytes) / m_compressionStatistics.iCompressedBytes,
+              m_compressionStatistics.dLastEncodeTimeMs,
+              m_compressionStatistics.dEncodeTimeMs / m_compressionStatistics.iBuffers);
+    }
+
+    return t_frame;
+}
+
+//=============================================================================================================
+
+void FiffStreamServer::writeSharedMemory(const Eigen::MatrixXf& matRawData)
+{
+    QMutexLocker locker(&m_sharedMemoryMutex);
+
+    QMutableMapIterator<qint32, SharedMemoryClient> it(m_qSharedMemoryClients);
+    while(it.hasNext()) {
+        it.next();
+        SharedMemoryClient& t_client = it.value();
+
+        if(!t_client.bReaderAttached) {
+            if(t_client.pRing->isReaderAttached()) {
+                //The client skips its TCP raw buffers from now on, this buffer is the first one in the ring
+                t_client.bReaderAttached = true;
+                emit useSharedMemoryFiffStreamClient(it.key(), true);
+            } else if(t_client.pRing->isReaderDetached() || t_client.attachTimer.elapsed() > SHARED_MEMORY_ATTACH_TIMEOUT) {
+                qInfo() << "FiffStreamClient (ID" << it.key() << "): no shared memory reader attached. Raw buffers are sent via TCP.";
+                it.remove();
+                continue;
+            } else {
+                continue;
+            }
+        }
+
+        if(t_client.pRing->isReaderDetached()) {
+            //The reader left the ring, continue via TCP
+            qInfo() << "FiffStreamClient (ID" << it.key() << "): shared memory reader detached. Falling back to TCP.";
+            emit useSharedMemoryFiffStreamClient(it.key(), false);
+            it.remove();
+            continue;
+        }
+
+        if(!t_client.bStreaming
+           || t_client.pRing->write(FIFF_DATA_BUFFER, matRawData.data(), matRawData.rows()*matRawData.cols())) {
+            continue;
+        }
+
+        //Ring is full, the reader does not keep up
+        if(t_client.iDroppedBuffers++ == 0) {
+            qWarning() << "FiffStreamClient (ID" << it.key() << "): shared memory ring is full. Dropping raw buffers.";
+        }
+    }
+}
+
+//=============================================================================================================
+
+QString FiffStreamServer::createSharedMemory(qint32 id)
+{
+    FiffStreamClient* t_pClient = m_qClientList.value(id, Q_NULLPTR);
+    if(!t_pClient || !isSameHost(t_pClient->getPeerAddress())) {
+        qInfo() << "FiffStreamClient (ID" << id << "): not on this host. Raw buffers are sent via TCP.";
+        return QString();
+    }
+
+    const QString t_sKey = QString("mne_rt_server_%1_%2").arg(QCoreApplication::applicationPid()).arg(id);
+
+    SharedMemoryClient t_client;
+    t_client.pRing = RtSharedMemoryRing::SPtr(new RtSharedMemoryRing);
+    t_client.bStreaming = false;
+    t_client.bReaderAttached = false;
+    t_client.iDroppedBuffers = 0;
+
+    if(!t_client.pRing->create(t_sKey, m_iSharedMemorySize.loadAcquire())) {
+        return QString();
+    }
+
+    t_client.attachTimer.start();
+
+    //The client is switched to the ring by writeSharedMemory once the reader attached
+    m_sharedMemoryMutex.lock();
+    m_qSharedMemoryClients.insert(id, t_client);
+    m_sharedMemoryMutex.unlock();
+
+    return t_sKey;
+}
+
+//=============================================================================================================
+
+void FiffStreamServer::setSharedMemoryStreaming(qint32 id, bool bStreaming)
+{
+    QMutexLocker locker(&m_sharedMemoryMutex);
+
+    QMap<qint32, SharedMemoryClient>::iterator it = m_qSharedMemoryClients.find(id);
+    if(it == m_qSharedMemoryClients.end()) {
+        return;
+    }
+
+    if(!bStreaming && it->iDroppedBuffers > 0) {
+        qWarning() << "FiffStreamClient (ID" << id << "): dropped" << it->iDroppedBuffers << "raw buffers due to a full shared memory ring.";
+        it->iDroppedBuffers = 0;
+    }
+
+    it->bStreaming = bStreaming;
+}
+
+//=============================================================================================================
+
+void FiffStreamServer::removeClient(qint32 id)
+{
+    m_sharedMemoryMutex.lock();
+    m_qSharedMemoryClients.remove(id);
+    m_sharedMemoryMutex.unlock();
+
+    FiffStreamClient* t_pClient = m_qClientList.take(id);
+
+    if(t_pClient) {
+        t_pClient->deleteLater();
+    }
+}
+
+//=============================================================================================================
+
+void FiffStreamServer::setClientCongested(bool bCongested)
+{
+    QMutexLocker locker(&m_congestionMutex);
+
+    m_iCongestedClients += bCongested ? 1 : -1;
+
+    if(m_iCongestedClients == 0) {
+        m_congestionCondition.wakeAll();
+    }
 }
 
 //=============================================================================================================
 
 void FiffStreamServer::incomingConnection(qintptr socketDescriptor)
 {
-    FiffStreamThread* t_pStreamThread = new FiffStreamThread(m_iNextClientId, socketDescriptor, this);
+    FiffStreamClient* t_pClient = new FiffStreamClient(m_iNextClientId, socketDescriptor, this);
+    t_pClient->moveToThread(&m_ioThread);
 
-    m_qClientList.insert(m_iNextClientId, t_pStreamThread);
+    m_qClientList.insert(m_iNextClientId, t_pClient);
     ++m_iNextClientId;
 
-    //when thread has finished it gets deleted
-    connect(t_pStreamThread, SIGNAL(finished()), t_pStreamThread, SLOT(deleteLater()));
-    connect(this, SIGNAL(closeFiffStreamServer()), t_pStreamThread, SLOT(deleteLater()));
-
-    t_pStreamThread->start();
+    //All clients live in the I/O thread, hence these connections are queued
+    connect(this, &FiffStreamServer::remitMeasInfo,
+            t_pClient, &FiffStreamClient::sendMeasurementInfo);
+    connect(this, &FiffStreamServer::remitRawFrame,
+            t_pClient, &FiffStreamClient::sendRawFrame);
+    connect(this, &FiffStreamServer::remitCompressedFrame,
+            t_pClient, &FiffStreamClient::sendCompressedFrame);
+    connect(this, &FiffStreamServer::startMeasFiffStreamClient,
+            t_pClient, &FiffStreamClient::startMeas);
+    connect(this, &FiffStreamServer::stopMeasFiffStreamClient,
+            t_pClient, &FiffStreamClient::stopMeas);
+    connect(this, &FiffStreamServer::useSharedMemoryFiffStreamClient,
+            t_pClient, &FiffStreamClient::setUseSharedMemory);
+
+    //when the connection was closed the client gets deleted
+    connect(t_pClient, &FiffStreamClient::closed,
+            this, &FiffStreamServer::removeClient);
+
+    QMetaObject::invokeMethod(t_pClient, [t_pClient]() { t_pClient->open(); }, Qt::QueuedConnection);
 }
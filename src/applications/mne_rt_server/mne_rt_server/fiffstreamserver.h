@@ -43,6 +43,8 @@
 
 #include <fiff/fiff_info.h>
 #include <communication/rtCommand/commandmanager.h>
+#include <communication/rtClient/rtsharedmemoryring.h>
+#include <communication/rtClient/rtbuffercodec.h>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -50,6 +52,12 @@
 
 #include <QStringList>
 #include <QTcpServer>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QMap>
+#include <QElapsedTimer>
 
 //=============================================================================================================
 // DEFINE NAMESPACE RTSERVER
@@ -62,22 +70,36 @@ namespace RTSERVER
 // FORWARD DECLARATIONS
 //=============================================================================================================
 
-class FiffStreamThread;
+class FiffStreamClient;
 
 //=============================================================================================================
 /**
  * DECLARE CLASS FiffStreamServer
  *
- * @brief The FiffStreamServer class provides
+ * @brief The FiffStreamServer class provides the fiff data port. Raw buffers are encoded once into a shared frame
+ * and all clients are served from a single I/O thread.
  */
 class FiffStreamServer : public QTcpServer//, public ICommandParser //OLD remove this
 {
     Q_OBJECT
 
-    friend class FiffStreamThread;
+    friend class FiffStreamClient;
 
 public:
 
+    //=========================================================================================================
+    /**
+     * Statistics of the lossless raw buffer compression.
+     */
+    struct CompressionStatistics {
+        qint64  iBuffers;               /**< Number of compressed buffers. */
+        qint64  iRawBytes;              /**< Size of these buffers uncompressed. */
+        qint64  iCompressedBytes;       /**< Size of these buffers compressed. */
+        double  dEncodeTimeMs;          /**< Total encode time in milliseconds. */
+        double  dLastRatio;             /**< Compression ratio of the last buffer. */
+        double  dLastEncodeTimeMs;      /**< Encode time of the last buffer in milliseconds. */
+    };
+
     FiffStreamServer(QObject *parent = 0);
 
     //=========================================================================================================
@@ -90,7 +112,55 @@ public:
     /**
      * ToDo...
      */
-    inline FiffStreamThread* getClient(qint32 id);
+    inline FiffStreamClient* getClient(qint32 id);
+
+    //=========================================================================================================
+    /**
+     * Sets the policy which is applied to clients which do not keep up with the data rate.
+     *
+     * @param[in] policy     The slow client policy.
+     */
+    void setSlowClientPolicy(SlowClientPolicy policy);
+
+    //=========================================================================================================
+    /**
+     * Returns the policy which is applied to clients which do not keep up with the data rate.
+     *
+     * @return the slow client policy.
+     */
+    SlowClientPolicy getSlowClientPolicy() const;
+
+    //=========================================================================================================
+    /**
+     * Sets the number of bytes which may be queued for a client before the slow client policy is applied.
+     *
+     * @param[in] iBytes     The maximum send queue size in bytes.
+     */
+    void setMaxClientQueueSize(qint64 iBytes);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of bytes which may be queued for a client before the slow client policy is applied.
+     *
+     * @return the maximum send queue size in bytes.
+     */
+    qint64 getMaxClientQueueSize() const;
+
+    //=========================================================================================================
+    /**
+     * Sets the capacity of the shared memory rings which are created for clients on the same host.
+     *
+     * @param[in] iBytes     The ring capacity in bytes.
+     */
+    void setSharedMemorySize(qint64 iBytes);
+
+    //=========================================================================================================
+    /**
+     * Returns the statistics of the lossless raw buffer compression.
+     *
+     * @return the compression statistics.
+     */
+    CompressionStatistics getCompressionStatistics() const;
 
     //=========================================================================================================
     /**
@@ -115,9 +185,11 @@ signals:
 
     void startMeasFiffStreamClient(qint32 ID);
     void stopMeasFiffStreamClient(qint32 ID);
+    void useSharedMemoryFiffStreamClient(qint32 ID, bool bUse);
 
     void remitMeasInfo(qint32 ID, const FIFFLIB::FiffInfo& p_fiffInfo);
-    void remitRawBuffer(QSharedPointer<Eigen::MatrixXf>);
+    void remitRawFrame(const QByteArray& frame);
+    void remitCompressedFrame(const QByteArray& frame);
 
     void closeFiffStreamServer();
 
@@ -166,17 +238,119 @@ private:
      */
     void comStopAll(COMMUNICATIONLIB::Command p_command);
 
+    //=========================================================================================================
+    /**
+     * Creates a shared memory ring for the raw buffers of a specified client and replies its key
+     *
+     * @param[in] p_command  The shmem command.
+     */
+    void comShmem(COMMUNICATIONLIB::Command p_command);
+
     QByteArray parseToId(QString& p_sRawId, qint32& p_iParsedId);
 
-    QMap<qint32, FiffStreamThread*> m_qClientList;
+    //=========================================================================================================
+    /**
+     * Removes a client whose connection was closed.
+     *
+     * @param[in] id     The client id.
+     */
+    void removeClient(qint32 id);
+
+    //=========================================================================================================
+    /**
+     * Is called from the I/O thread when a client starts or stops holding back the producer.
+     *
+     * @param[in] bCongested     Whether the client became congested.
+     */
+    void setClientCongested(bool bCongested);
+
+    //=========================================================================================================
+    /**
+     * Creates the shared memory ring of a client on the same host. Raw buffers are still sent via TCP until the
+     * reader attached to the ring. If the reader does not attach in time, the ring is removed again.
+     *
+     * @param[in] id     The client id.
+     *
+     * @return the key of the ring, an empty string if the client is not on this host or the ring could not be
+     *         created.
+     */
+    QString createSharedMemory(qint32 id);
+
+    //=========================================================================================================
+    /**
+     * Is called from the I/O thread when a client starts or stops receiving raw buffers.
+     *
+     * @param[in] id             The client id.
+     * @param[in] bStreaming     Whether raw buffers are written to the ring of the client.
+     */
+    void setSharedMemoryStreaming(qint32 id, bool bStreaming);
+
+    //=========================================================================================================
+    /**
+     * Writes a raw buffer to the rings of all streaming shared memory clients. Clients are switched to the ring once
+     * their reader attached. Clients whose reader detached or did not attach in time fall back to TCP.
+     *
+     * @param[in] matRawData     The raw buffer.
+     */
+    void writeSharedMemory(const Eigen::MatrixXf& matRawData);
+
+    //=========================================================================================================
+    /**
+     * Returns the codec the compressed frames are currently encoded with.
+     *
+     * @return the buffer codec.
+     */
+    COMMUNICATIONLIB::RtBufferCodec::ConstSPtr getBufferCodec() const;
+
+    //=========================================================================================================
+    /**
+     * Encodes a raw buffer into a FIFF_MNE_RT_COMPRESSED_BUFFER tag and updates the compression statistics.
+     *
+     * @param[in] matRawData     The raw buffer.
+     *
+     * @return the encoded frame.
+     */
+    QByteArray encodeCompressedFrame(const Eigen::MatrixXf& matRawData);
+
+    //=========================================================================================================
+    /**
+     * Same-host client which receives its raw buffers via a shared memory ring.
+     */
+    struct SharedMemoryClient {
+        COMMUNICATIONLIB::RtSharedMemoryRing::SPtr  pRing;              /**< The ring the raw buffers are written to. */
+        bool                                        bStreaming;         /**< Whether the client receives raw buffers. */
+        bool                                        bReaderAttached;    /**< Whether the client was switched to the ring. */
+        QElapsedTimer                               attachTimer;        /**< Time since the ring was created. */
+        qint64                                      iDroppedBuffers;    /**< Raw buffers dropped due to a full ring. */
+    };
+
+    QMap<qint32, FiffStreamClient*> m_qClientList;
     qint32                          m_iNextClientId;
+
+    QThread                         m_ioThread;             /**< The thread which serves all client sockets. */
+    QAtomicInt                      m_iStreamingClients;    /**< Number of clients which receive raw buffers. */
+    QAtomicInt                      m_iCompressedStreamingClients;  /**< Number of clients which receive compressed raw buffers. */
+    QAtomicInt                      m_iSlowClientPolicy;    /**< The SlowClientPolicy. */
+    QAtomicInteger<qint64>          m_iMaxClientQueueSize;  /**< Bytes which may be queued per client. */
+
+    QMutex                          m_congestionMutex;      /**< Guards the number of congested clients. */
+    QWaitCondition                  m_congestionCondition;  /**< Wakes the producer once no client is congested. */
+    qint32                          m_iCongestedClients;    /**< Number of clients which hold back the producer. */
+
+    QMutex                              m_sharedMemoryMutex;        /**< Guards the shared memory clients. */
+    QMap<qint32, SharedMemoryClient>    m_qSharedMemoryClients;     /**< Shared memory clients by client id. */
+    QAtomicInteger<qint64>              m_iSharedMemorySize;        /**< Capacity of new shared memory rings in bytes. */
+
+    mutable QMutex                              m_codecMutex;               /**< Guards the codec and the compression statistics. */
+    COMMUNICATIONLIB::RtBufferCodec::ConstSPtr  m_pBufferCodec;             /**< Codec with the calibrations of the current measurement. */
+    CompressionStatistics                       m_compressionStatistics;    /**< Statistics of the compressed buffers. */
 };
 
 //=============================================================================================================
 // INLINE DEFINITIONS
 //=============================================================================================================
 
-FiffStreamThread* FiffStreamServer::getClient(qint32 id)
+FiffStreamClient* FiffStreamServer::getClient(qint32 id)
 {
     return m_qClientList[id];
 }
@@ -93,7 +93,18 @@ int main(int argc, char *argv[])
                                  QCoreApplication::translate("main","File to stream."),
                                  QCoreApplication::translate("main","filePath"));
 
+    QCommandLineOption slowClientOpt("slowClientPolicy",
+                                     QCoreApplication::translate("main","Policy for fiff data clients which do not keep up: drop (drop oldest buffers), block (hold back the acquisition) or disconnect."),
+                                     QCoreApplication::translate("main","policy"),
+                                     "drop");
+    QCommandLineOption clientQueueOpt("maxClientQueue",
+                                      QCoreApplication::translate("main","Maximum number of MB queued per fiff data client before the slow client policy is applied."),
+                                      QCoreApplication::translate("main","size"),
+                                      "64");
+
     parser.addOption(inFileOpt);
+    parser.addOption(slowClientOpt);
+    parser.addOption(clientQueueOpt);
 
     parser.process(app);
 
@@ -125,6 +136,26 @@ int main(int argc, char *argv[])
     }
 
     MNERTServer t_MneRtServer;
+
+    QString sSlowClientPolicy = parser.value(slowClientOpt);
+    if(sSlowClientPolicy == "block") {
+        t_MneRtServer.getFiffStreamServer().setSlowClientPolicy(FiffStreamServer::Block);
+    } else if(sSlowClientPolicy == "disconnect") {
+        t_MneRtServer.getFiffStreamServer().setSlowClientPolicy(FiffStreamServer::Disconnect);
+    } else {
+        if(sSlowClientPolicy != "drop") {
+            qWarning() << QString("[MneRtServer::main] Unknown slow client policy %1. Falling back to drop.").arg(sSlowClientPolicy);
+        }
+        t_MneRtServer.getFiffStreamServer().setSlowClientPolicy(FiffStreamServer::DropOldest);
+    }
+
+    bool bOk = false;
+    qint64 iMaxClientQueue = parser.value(clientQueueOpt).toLongLong(&bOk);
+    if(bOk && iMaxClientQueue > 0) {
+        t_MneRtServer.getFiffStreamServer().setMaxClientQueueSize(iMaxClientQueue*1024*1024);
+    } else {
+        qWarning() << QString("[MneRtServer::main] Invalid maximum client queue size %1. Using the default.").arg(parser.value(clientQueueOpt));
+    }
     QObject::connect(&t_MneRtServer, SIGNAL(closeServer()), &app, SLOT(quit()));
 
     return app.exec();
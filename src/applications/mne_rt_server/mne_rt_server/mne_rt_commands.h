@@ -49,6 +49,7 @@ namespace RTSERVER
 
 #define MNE_RT_GET_CLIENT_ID        1       /**< Request client id at mne_rt_server. */
 #define MNE_RT_SET_CLIENT_ALIAS     2       /**< Set client alias at mne_rt_server. */
+#define MNE_RT_SET_COMPRESSION      3       /**< Enable/disable lossless compression of raw buffers. */
 } // NAMESPACE
 
 #endif // MNE_RT_COMMANDS_H
@@ -333,6 +333,15 @@ void MNERTServer::init()
             "               }"
             "           }"
             "        },"
+            "       \"shmem\": {"
+            "           \"description\": \"Creates a shared memory ring for the raw buffers of the specified FiffStreamClient. Only available if the client runs on the same host.\","
+            "           \"parameters\": {"
+            "               \"id\": {"
+            "                   \"description\": \"ID/Alias\","
+            "                   \"type\": \"QString\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"start\": {"
             "           \"description\": \"Adds specified FiffStreamClient to raw data buffer receivers. If acquisition is not already started, it is triggered.\","
             "           \"parameters\": {"
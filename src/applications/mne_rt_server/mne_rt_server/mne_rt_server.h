@@ -94,6 +94,12 @@ public:
      */
     inline COMMUNICATIONLIB::CommandManager& getCommandManager();
 
+    //=========================================================================================================
+    /**
+     * Returns the fiff stream server
+     */
+    inline FiffStreamServer& getFiffStreamServer();
+
     //=========================================================================================================
     /**
      * Inits the mne_rt_server.
@@ -134,6 +140,13 @@ inline COMMUNICATIONLIB::CommandManager& MNERTServer::getCommandManager()
 {
     return m_commandManager;
 }
+
+//=============================================================================================================
+
+inline FiffStreamServer& MNERTServer::getFiffStreamServer()
+{
+    return m_fiffStreamServer;
+}
 } // NAMESPACE
 
 #ifndef metatype_matrixxf
@@ -116,15 +116,15 @@ void RealTimeMultiSampleArrayWidget::update(SCMEASLIB::Measurement::SPtr pMeasur
     if(m_pRTMSA) {
         if(m_pRTMSA->isChInit() && !m_pFiffInfo) {
             m_pFiffInfo = m_pRTMSA->info();
-            m_iMaxFilterTapSize = m_pRTMSA->getMultiSampleArray().first().cols();
+            m_iMaxFilterTapSize = m_pRTMSA->getSampleBlocks().first()->cols();
 
             if(!m_bDisplayWidgetsInitialized) {
                 initDisplayControllWidgets();
             }
         }
-        if (!m_pRTMSA->getMultiSampleArray().isEmpty()) {
+        if (!m_pRTMSA->getSampleBlocks().isEmpty()) {
             //Add data to table view
-            m_pChannelDataView->addData(m_pRTMSA->getMultiSampleArray());
+            m_pChannelDataView->addData(m_pRTMSA->getSampleBlocks());
         }
     }
 }
@@ -68,6 +68,7 @@ RealTimeMultiSampleArray::RealTimeMultiSampleArray(QObject *parent)
 , m_pFiffDigitizerData_orig(nullptr)
 , m_fSamplingRate(0)
 , m_iMultiArraySize(10)
+, m_pSampleBlockPool(SampleBlockPool::create())
 , m_bChInfoIsInit(false)
 {
 }
@@ -140,33 +141,70 @@ void RealTimeMultiSampleArray::initFromFiffInfo(QSharedPointer<FIFFLIB::FiffInfo
 
 //=============================================================================================================
 
+QList<MatrixXd> RealTimeMultiSampleArray::getMultiSampleArray() const
+{
+    QList<MatrixXd> lMatSamples;
+
+    for(const SampleBlockPool::Block& block : m_lSampleBlocks) {
+        lMatSamples.append(*block);
+    }
+
+    return lMatSamples;
+}
+
+//=============================================================================================================
+
 void RealTimeMultiSampleArray::setValue(const MatrixXd& mat)
 {
     if(!m_bChInfoIsInit)
         return;
 
+    appendBlock(m_pSampleBlockPool->acquire(mat));
+}
+
+//=============================================================================================================
+
+void RealTimeMultiSampleArray::setValue(MatrixXd&& mat)
+{
+    if(!m_bChInfoIsInit)
+        return;
+
+    appendBlock(m_pSampleBlockPool->acquire(std::move(mat)));
+}
+
+//=============================================================================================================
+
+void RealTimeMultiSampleArray::setValue(const SampleBlockPool::Block& block)
+{
+    if(!m_bChInfoIsInit || !block)
+        return;
+
+    appendBlock(block);
+}
+
+//=============================================================================================================
+
+void RealTimeMultiSampleArray::appendBlock(const SampleBlockPool::Block& block)
+{
     m_qMutex.lock();
     //check vector size
-    if(mat.rows() != m_qListChInfo.size())
+    if(block->rows() != m_qListChInfo.size())
         qCritical() << "Error Occured in RealTimeMultiSampleArray::setVector: Vector size does not match the number of channels! ";
 
-    //ToDo
-//    //Check if maximum exceeded //ToDo speed this up
-//    for(qint32 i = 0; i < v.size(); ++i)
-//    {
-//        if(v[i] < m_qListChInfo[i].getMinValue()) v[i] = m_qListChInfo[i].getMinValue();
-//        else if(v[i] > m_qListChInfo[i].getMaxValue()) v[i] = m_qListChInfo[i].getMaxValue();
-//    }
-
     //Store
-    m_matSamples.push_back(mat);
+    m_lSampleBlocks.push_back(block);
 
     m_qMutex.unlock();
-    if(m_matSamples.size() >= m_iMultiArraySize)
+    if(m_lSampleBlocks.size() >= m_iMultiArraySize)
     {
+        // Report the pool statistics under the name of the producing plugin as soon as it is known
+        if(!getName().isEmpty() && m_pSampleBlockPool->getName() != getName()) {
+            m_pSampleBlockPool->setName(getName());
+        }
+
         emit notify();
         m_qMutex.lock();
-        m_matSamples.clear();
+        m_lSampleBlocks.clear();
         m_qMutex.unlock();
     }
 }
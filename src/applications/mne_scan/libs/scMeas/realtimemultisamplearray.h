@@ -43,6 +43,7 @@
 #include "scmeas_global.h"
 #include "measurement.h"
 #include "realtimesamplearraychinfo.h"
+#include "sampleblockpool.h"
 
 //=============================================================================================================
 // QT INCLUDES
@@ -208,20 +209,54 @@ public:
 
     //=========================================================================================================
     /**
-     * Returns the gathered multi sample array.
+     * Returns the gathered sample blocks. The blocks are immutable and shared by all attached plugins. Keep a
+     * reference instead of copying the data, the storage is recycled once the last reference is dropped.
+     *
+     * @return the current sample blocks.
+     */
+    inline const QList<SampleBlockPool::Block>& getSampleBlocks() const;
+
+    //=========================================================================================================
+    /**
+     * Returns a copy of the gathered multi sample array. Prefer getSampleBlocks() which does not copy.
      *
      * @return the current multi sample array.
      */
-    inline const QList<Eigen::MatrixXd>& getMultiSampleArray();
+    QList<Eigen::MatrixXd> getMultiSampleArray() const;
 
     //=========================================================================================================
     /**
-     * Attaches a value to the sample array list.
+     * Attaches a value to the sample array list. The samples are copied into a pooled block.
      *
      * @param[in] mat   the value which is attached to the sample array list.
      */
     virtual void setValue(const Eigen::MatrixXd& mat);
 
+    //=========================================================================================================
+    /**
+     * Attaches a value to the sample array list without copying it. mat receives recycled storage of a released
+     * block which can be refilled by the producer without allocating.
+     *
+     * @param[in, out] mat   the value which is attached to the sample array list.
+     */
+    void setValue(Eigen::MatrixXd&& mat);
+
+    //=========================================================================================================
+    /**
+     * Attaches an already shared block to the sample array list, e.g. to forward a block without modifying it.
+     *
+     * @param[in] block     the block which is attached to the sample array list.
+     */
+    void setValue(const SampleBlockPool::Block& block);
+
+    //=========================================================================================================
+    /**
+     * Returns the pool which holds the sample blocks of this measurement.
+     *
+     * @return the sample block pool.
+     */
+    inline SampleBlockPool::SPtr getSampleBlockPool() const;
+
     //=========================================================================================================
     /**
      * Sets digitizer data for measurement
@@ -231,6 +266,15 @@ public:
     void setDigitizerData(QSharedPointer<FIFFLIB::FiffDigitizerData> digData);
 
 private:
+    //=========================================================================================================
+    /**
+     * Checks the block dimensions, stores the block and notifies the attached observers once enough blocks are
+     * gathered.
+     *
+     * @param[in] block     the block which is attached to the sample array list.
+     */
+    void appendBlock(const SampleBlockPool::Block& block);
+
     mutable QMutex              m_qMutex;           /**< Mutex to ensure thread safety. */
 
     QSharedPointer<FIFFLIB::FiffInfo>               m_pFiffInfo_orig;           /**< Original Fiff Info if initialized by fiff info. */
@@ -239,7 +283,8 @@ private:
     QString                     m_sXMLLayoutFile;   /**< Layout file name. */
     float                       m_fSamplingRate;    /**< Sampling rate of the RealTimeSampleArray.*/
     qint32                      m_iMultiArraySize;  /**< Sample size of the multi sample array.*/
-    QList<Eigen::MatrixXd>      m_matSamples;       /**< The multi sample array.*/
+    QList<SampleBlockPool::Block>   m_lSampleBlocks;        /**< The shared sample blocks.*/
+    SampleBlockPool::SPtr           m_pSampleBlockPool;     /**< The pool which recycles the sample block storage.*/
     bool                        m_bChInfoIsInit;    /**< If channel info is initialized.*/
 
     QList<RealTimeSampleArrayChInfo> m_qListChInfo; /**< Channel info list.*/
@@ -252,7 +297,7 @@ private:
 inline void RealTimeMultiSampleArray::clear()
 {
     QMutexLocker locker(&m_qMutex);
-    m_matSamples.clear();
+    m_lSampleBlocks.clear();
 }
 
 //=============================================================================================================
@@ -347,9 +392,16 @@ qint32 RealTimeMultiSampleArray::getMultiArraySize() const
 
 //=============================================================================================================
 
-inline const QList<Eigen::MatrixXd>& RealTimeMultiSampleArray::getMultiSampleArray()
+inline const QList<SampleBlockPool::Block>& RealTimeMultiSampleArray::getSampleBlocks() const
+{
+    return m_lSampleBlocks;
+}
+
+//=============================================================================================================
+
+inline SampleBlockPool::SPtr RealTimeMultiSampleArray::getSampleBlockPool() const
 {
-    return m_matSamples;
+    return m_pSampleBlockPool;
 }
 } // NAMESPACE
 
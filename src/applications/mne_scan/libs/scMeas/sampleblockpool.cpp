@@ -0,0 +1,256 @@
+//=============================================================================================================
+/**
+ * @file     sampleblockpool.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the SampleBlockPool class.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "sampleblockpool.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCMEASLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+QMutex                      s_registryMutex;    /**< Guards the registry of alive pools. */
+QList<SampleBlockPool*>     s_lPools;           /**< All pools which are currently alive. */
+
+}
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SampleBlockPool::SampleBlockPool(const QString& sName,
+                                 int iMaxPooledBlocks)
+: m_sName(sName)
+, m_iMaxPooledBlocks(iMaxPooledBlocks)
+{
+    m_timer.start();
+
+    QMutexLocker locker(&s_registryMutex);
+    s_lPools.append(this);
+}
+
+//=============================================================================================================
+
+SampleBlockPool::SPtr SampleBlockPool::create(const QString& sName,
+                                              int iMaxPooledBlocks)
+{
+    return SPtr(new SampleBlockPool(sName, iMaxPooledBlocks));
+}
+
+//=============================================================================================================
+
+SampleBlockPool::~SampleBlockPool()
+{
+    QMutexLocker registryLocker(&s_registryMutex);
+    s_lPools.removeAll(this);
+    registryLocker.unlock();
+
+    clear();
+}
+
+//=============================================================================================================
+
+SampleBlockPool::Block SampleBlockPool::acquire(const MatrixXd& mat)
+{
+    MatrixXd* pMat = takeStorage(mat.size(), true);
+
+    // Same number of coefficients, hence the assignment only reshapes and does not reallocate
+    *pMat = mat;
+
+    return wrap(pMat);
+}
+
+//=============================================================================================================
+
+SampleBlockPool::Block SampleBlockPool::acquire(MatrixXd&& mat)
+{
+    MatrixXd* pMat = takeStorage(mat.size(), false);
+
+    // Hand the samples over to the block and give the released storage back to the producer
+    pMat->swap(mat);
+
+    return wrap(pMat);
+}
+
+//=============================================================================================================
+
+void SampleBlockPool::clear()
+{
+    QMutexLocker locker(&m_qMutex);
+
+    qDeleteAll(m_lFreeBlocks);
+    m_lFreeBlocks.clear();
+    m_statistics.iBlocksPooled = 0;
+}
+
+//=============================================================================================================
+
+QString SampleBlockPool::getName() const
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_sName;
+}
+
+//=============================================================================================================
+
+void SampleBlockPool::setName(const QString& sName)
+{
+    QMutexLocker locker(&m_qMutex);
+    m_sName = sName;
+}
+
+//=============================================================================================================
+
+SampleBlockPool::Statistics SampleBlockPool::getStatistics() const
+{
+    QMutexLocker locker(&m_qMutex);
+
+    Statistics statistics = m_statistics;
+    double dSeconds = m_timer.elapsed() / 1000.0;
+
+    if(dSeconds > 0.0) {
+        statistics.dAllocationsPerSecond = statistics.iAllocations / dSeconds;
+        statistics.dBlocksPerSecond = (statistics.iAllocations + statistics.iRecycled) / dSeconds;
+    }
+
+    return statistics;
+}
+
+//=============================================================================================================
+
+void SampleBlockPool::resetStatistics()
+{
+    QMutexLocker locker(&m_qMutex);
+
+    m_statistics.iAllocations = 0;
+    m_statistics.iRecycled = 0;
+    m_statistics.iBytesAllocated = 0;
+    m_timer.restart();
+}
+
+//=============================================================================================================
+
+QList<QPair<QString, SampleBlockPool::Statistics> > SampleBlockPool::getStatisticsOfAllPools()
+{
+    QList<QPair<QString, Statistics> > lStatistics;
+
+    QMutexLocker locker(&s_registryMutex);
+    for(const SampleBlockPool* pPool : s_lPools) {
+        lStatistics.append(qMakePair(pPool->getName(), pPool->getStatistics()));
+    }
+
+    return lStatistics;
+}
+
+//=============================================================================================================
+
+MatrixXd* SampleBlockPool::takeStorage(Index iSize,
+                                       bool bAllocate)
+{
+    QMutexLocker locker(&m_qMutex);
+
+    // Search from the back since the most recently released storage is most likely still cached
+    for(int i = m_lFreeBlocks.size() - 1; i >= 0; --i) {
+        if(m_lFreeBlocks.at(i)->size() == iSize) {
+            ++m_statistics.iRecycled;
+            ++m_statistics.iBlocksInUse;
+            --m_statistics.iBlocksPooled;
+            return m_lFreeBlocks.takeAt(i);
+        }
+    }
+
+    ++m_statistics.iAllocations;
+    ++m_statistics.iBlocksInUse;
+    m_statistics.iBytesAllocated += iSize * static_cast<qint64>(sizeof(double));
+
+    locker.unlock();
+
+    return bAllocate ? new MatrixXd(iSize, 1) : new MatrixXd();
+}
+
+//=============================================================================================================
+
+SampleBlockPool::Block SampleBlockPool::wrap(MatrixXd* pMat)
+{
+    QWeakPointer<SampleBlockPool> wpPool = sharedFromThis().toWeakRef();
+
+    return Block(pMat, [wpPool](MatrixXd* pReleased) {
+        SampleBlockPool::SPtr pPool = wpPool.toStrongRef();
+
+        if(pPool) {
+            pPool->release(pReleased);
+        } else {
+            delete pReleased;
+        }
+    });
+}
+
+//=============================================================================================================
+
+void SampleBlockPool::release(MatrixXd* pMat)
+{
+    QMutexLocker locker(&m_qMutex);
+
+    --m_statistics.iBlocksInUse;
+
+    if(pMat->size() == 0 || m_iMaxPooledBlocks <= 0) {
+        delete pMat;
+        return;
+    }
+
+    if(m_lFreeBlocks.size() >= m_iMaxPooledBlocks) {
+        delete m_lFreeBlocks.takeFirst();
+        --m_statistics.iBlocksPooled;
+    }
+
+    m_lFreeBlocks.append(pMat);
+    ++m_statistics.iBlocksPooled;
+}
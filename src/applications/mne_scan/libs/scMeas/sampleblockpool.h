@@ -0,0 +1,234 @@
+//=============================================================================================================
+/**
+ * @file     sampleblockpool.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Contains the declaration of the SampleBlockPool class.
+ *
+ */
+
+#ifndef SAMPLEBLOCKPOOL_H
+#define SAMPLEBLOCKPOOL_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "scmeas_global.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QEnableSharedFromThis>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE SCMEASLIB
+//=============================================================================================================
+
+namespace SCMEASLIB
+{
+
+//=========================================================================================================
+/**
+ * Hands out immutable, reference counted sample blocks. The storage of a block is returned to the pool once the
+ * last consumer drops its reference and is reused for the next block of the same size. This way one block can be
+ * shared by all plugins which are attached to a measurement without copying it and without allocating new memory
+ * for every incoming block.
+ *
+ * @brief Pool of immutable shared sample blocks.
+ */
+class SCMEASSHARED_EXPORT SampleBlockPool : public QEnableSharedFromThis<SampleBlockPool>
+{
+public:
+    typedef QSharedPointer<SampleBlockPool> SPtr;               /**< Shared pointer type for SampleBlockPool. */
+    typedef QSharedPointer<const SampleBlockPool> ConstSPtr;    /**< Const shared pointer type for SampleBlockPool. */
+    typedef QSharedPointer<const Eigen::MatrixXd> Block;        /**< Immutable shared sample block. */
+
+    //=========================================================================================================
+    /**
+     * Allocation counters of a pool.
+     */
+    struct Statistics {
+        qint64  iAllocations = 0;               /**< Number of blocks for which new memory had to be allocated. */
+        qint64  iRecycled = 0;                  /**< Number of blocks which reused the memory of a released block. */
+        qint64  iBytesAllocated = 0;            /**< Number of bytes allocated for new blocks. */
+        qint64  iBlocksInUse = 0;               /**< Number of blocks which are currently referenced by a consumer. */
+        qint64  iBlocksPooled = 0;              /**< Number of released blocks which wait to be reused. */
+        double  dAllocationsPerSecond = 0.0;    /**< Allocation rate since the counters were reset. */
+        double  dBlocksPerSecond = 0.0;         /**< Block rate (allocated and recycled) since the counters were reset. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Creates a SampleBlockPool. Pools are always owned by a shared pointer since the blocks keep a weak
+     * reference to the pool they have to be returned to.
+     *
+     * @param[in] sName              The name under which the pool statistics are reported, e.g. the plugin name.
+     * @param[in] iMaxPooledBlocks   The maximum number of released blocks which are kept for reuse.
+     *
+     * @return the created pool.
+     */
+    static SPtr create(const QString& sName = QString(),
+                       int iMaxPooledBlocks = 64);
+
+    //=========================================================================================================
+    /**
+     * Destroys the SampleBlockPool. Blocks which are still referenced stay valid and are freed on release.
+     */
+    ~SampleBlockPool();
+
+    //=========================================================================================================
+    /**
+     * Copies mat into a pooled block.
+     *
+     * @param[in] mat    The samples to store.
+     *
+     * @return the immutable block.
+     */
+    Block acquire(const Eigen::MatrixXd& mat);
+
+    //=========================================================================================================
+    /**
+     * Moves mat into a pooled block without copying the samples. In exchange, mat receives the storage of a
+     * released block (if one is available) which the producer can refill without allocating.
+     *
+     * @param[in, out] mat   The samples to store. Holds recycled storage of unspecified content afterwards.
+     *
+     * @return the immutable block.
+     */
+    Block acquire(Eigen::MatrixXd&& mat);
+
+    //=========================================================================================================
+    /**
+     * Frees all released blocks which are kept for reuse.
+     */
+    void clear();
+
+    //=========================================================================================================
+    /**
+     * Returns the name of the pool.
+     *
+     * @return the name of the pool.
+     */
+    QString getName() const;
+
+    //=========================================================================================================
+    /**
+     * Sets the name under which the pool statistics are reported.
+     *
+     * @param[in] sName  The name of the pool.
+     */
+    void setName(const QString& sName);
+
+    //=========================================================================================================
+    /**
+     * Returns the allocation counters of this pool.
+     *
+     * @return the current statistics.
+     */
+    Statistics getStatistics() const;
+
+    //=========================================================================================================
+    /**
+     * Resets the allocation counters and restarts the rate measurement.
+     */
+    void resetStatistics();
+
+    //=========================================================================================================
+    /**
+     * Returns the statistics of all pools which are currently alive, together with their names. Since every
+     * plugin owns the pools of its output measurements, this reports the allocation rates per plugin.
+     *
+     * @return the list of pool names and statistics.
+     */
+    static QList<QPair<QString, Statistics> > getStatisticsOfAllPools();
+
+private:
+    //=========================================================================================================
+    /**
+     * Constructs a SampleBlockPool. Use create() instead.
+     *
+     * @param[in] sName              The name of the pool.
+     * @param[in] iMaxPooledBlocks   The maximum number of released blocks which are kept for reuse.
+     */
+    SampleBlockPool(const QString& sName,
+                    int iMaxPooledBlocks);
+
+    //=========================================================================================================
+    /**
+     * Takes storage of iSize coefficients from the free list or allocates new storage and updates the counters.
+     *
+     * @param[in] iSize      The number of coefficients the block has to hold. -1 accepts any released block.
+     * @param[in] bAllocate  Whether to allocate iSize coefficients if no released block fits.
+     *
+     * @return the storage. Never a nullptr.
+     */
+    Eigen::MatrixXd* takeStorage(Eigen::Index iSize,
+                                 bool bAllocate);
+
+    //=========================================================================================================
+    /**
+     * Wraps storage into a block which returns it to this pool on release.
+     *
+     * @param[in] pMat   The storage to wrap.
+     *
+     * @return the immutable block.
+     */
+    Block wrap(Eigen::MatrixXd* pMat);
+
+    //=========================================================================================================
+    /**
+     * Returns the storage of a released block to the free list.
+     *
+     * @param[in] pMat   The storage of the released block.
+     */
+    void release(Eigen::MatrixXd* pMat);
+
+    mutable QMutex              m_qMutex;               /**< Guards the free list and the counters. */
+    QString                     m_sName;                /**< The name of the pool. */
+    int                         m_iMaxPooledBlocks;     /**< Maximum number of released blocks kept for reuse. */
+    QList<Eigen::MatrixXd*>     m_lFreeBlocks;          /**< Storage of released blocks. */
+    Statistics                  m_statistics;           /**< Allocation counters. */
+    QElapsedTimer               m_timer;                /**< Time since the counters were reset. */
+};
+} // NAMESPACE
+
+#endif // SAMPLEBLOCKPOOL_H
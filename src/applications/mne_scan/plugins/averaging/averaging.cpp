@@ -166,17 +166,12 @@ void Averaging::update(SCMEASLIB::Measurement::SPtr pMeasurement)
             initPluginControlWidgets();
         }
 
-        // Append new data
-        MatrixXd matData;
-
+        // Append new data. The worker thread of RtAveraging receives the reference to the shared block, which
+        // keeps the block alive until it was averaged.
         if(m_pFiffInfo) {
-            for(qint32 i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
+            for(qint32 i = 0; i < pRTMSA->getSampleBlocks().size(); ++i) {
                 if(m_pRtAve) {
-                    // This extra copy is necessary since the referenced data is getting deleted as soon as
-                    // m_pRtAve->append() returns. m_pRtAve->append() returns without a copy since it communicates
-                    // via signals with the worker thread of RtCov.
-                    matData = pRTMSA->getMultiSampleArray()[i];
-                    m_pRtAve->append(matData);
+                    m_pRtAve->append(pRTMSA->getSampleBlocks()[i]);
                 }
             }
         }
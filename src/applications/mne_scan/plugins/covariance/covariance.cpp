@@ -81,7 +81,7 @@ using namespace Eigen;
 
 Covariance::Covariance()
 : m_iEstimationSamples(2000)
-, m_pCircularBuffer(CircularBuffer_Matrix_double::SPtr::create(40))
+, m_pCircularBuffer(SpscCircularBuffer<SampleBlockPool::Block>::SPtr::create(40))
 {
 }
 
@@ -220,10 +220,8 @@ void Covariance::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         }
 
         for(qint32 i = 0; i < pRTMSA->getMultiArraySize(); ++i) {
-            // Please note that we do not need a copy here since this function will block until
-            // the buffer accepts new data again. Hence, the data is not deleted in the actual
-            // Measurement function after it emitted the notify signal.
-            while(!m_pCircularBuffer->push(pRTMSA->getMultiSampleArray()[i])) {
+            // Only the reference to the shared block is queued, the samples are not copied
+            while(!m_pCircularBuffer->push(pRTMSA->getSampleBlocks()[i])) {
                 //Do nothing until the circular buffer is ready to accept new data again
             }
         }
@@ -252,22 +250,24 @@ void Covariance::run()
         msleep(100);
     }
 
-    MatrixXd matData;
+    SampleBlockPool::Block block;
     FiffCov fiffCov;
     m_mutex.lock();
     int iEstimationSamples = m_iEstimationSamples;
     m_mutex.unlock();
     RTPROCESSINGLIB::RtCov rtCov(m_pFiffInfo);
+    // Accumulate incrementally to avoid storing the whole estimation window
+    rtCov.setIncrementalMode(true);
 
     // Start processing data
     while(!isInterruptionRequested()) {
         // Get the current data
-        if(m_pCircularBuffer->pop(matData)) {
+        if(m_pCircularBuffer->pop(block)) {
             m_mutex.lock();
             iEstimationSamples = m_iEstimationSamples;
             m_mutex.unlock();
 
-            fiffCov = rtCov.estimateCovariance(matData, iEstimationSamples);
+            fiffCov = rtCov.estimateCovariance(*block, iEstimationSamples);
             if(!fiffCov.names.isEmpty()) {
                 m_pCovarianceOutput->measurementData()->setValue(fiffCov);
             }
@@ -44,6 +44,7 @@
 
 #include <scShared/Plugins/abstractalgorithm.h>
 #include <utils/generics/circularbuffer.h>
+#include <scMeas/sampleblockpool.h>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -157,7 +158,7 @@ private:
     QMutex      m_mutex;
     qint32      m_iEstimationSamples;
 
-    UTILSLIB::CircularBuffer_Matrix_double::SPtr        m_pCircularBuffer;              /**< Matrix data circular buffer. */
+    QSharedPointer<UTILSLIB::SpscCircularBuffer<SCMEASLIB::SampleBlockPool::Block> > m_pCircularBuffer;   /**< Holds the shared blocks of the incoming data. */
 
     QSharedPointer<FIFFLIB::FiffInfo>                   m_pFiffInfo;                    /**< Fiff measurement info.*/
 
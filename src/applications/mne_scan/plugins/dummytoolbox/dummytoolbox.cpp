@@ -65,7 +65,7 @@ using namespace Eigen;
 //=============================================================================================================
 
 DummyToolbox::DummyToolbox()
-: m_pCircularBuffer(QSharedPointer<CircularBuffer_Matrix_double>(new CircularBuffer_Matrix_double(40)))
+: m_pCircularBuffer(QSharedPointer<SpscCircularBuffer<SampleBlockPool::Block> >(new SpscCircularBuffer<SampleBlockPool::Block>(40)))
 {
 }
 
@@ -182,10 +182,8 @@ void DummyToolbox::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         }
 
         for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i) {
-            // Please note that we do not need a copy here since this function will block until
-            // the buffer accepts new data again. Hence, the data is not deleted in the actual
-            // Mesaurement function after it emitted the notify signal.
-            while(!m_pCircularBuffer->push(pRTMSA->getMultiSampleArray()[i])) {
+            // Only the reference to the shared block is queued, the samples are not copied
+            while(!m_pCircularBuffer->push(pRTMSA->getSampleBlocks()[i])) {
                 //Do nothing until the circular buffer is ready to accept new data again
             }
         }
@@ -215,7 +213,7 @@ void DummyToolbox::initPluginControlWidgets()
 
 void DummyToolbox::run()
 {
-    MatrixXd matData;
+    SampleBlockPool::Block block;
 
     // Wait for Fiff Info
     while(!m_pFiffInfo) {
@@ -224,13 +222,13 @@ void DummyToolbox::run()
 
     while(!isInterruptionRequested()) {
         // Get the current data
-        if(m_pCircularBuffer->pop(matData)) {
+        if(m_pCircularBuffer->pop(block)) {
             //ToDo: Implement your algorithm here
 
             //Send the data to the connected plugins and the online display
             //Unocmment this if you also uncommented the m_pOutput in the constructor above
             if(!isInterruptionRequested()) {
-                m_pOutput->measurementData()->setValue(matData);
+                m_pOutput->measurementData()->setValue(block);
             }
         }
     }
@@ -56,6 +56,7 @@
 #include <QtCore/QFile>
 #include <QMutexLocker>
 #include <QList>
+#include <QSettings>
 
 #include <QDebug>
 
@@ -150,6 +151,12 @@ bool FiffSimulator::start()
         // Wait one sec so the producer can update the m_iDataClientId accordingly
         msleep(1000);
 
+        // Receive the raw buffers via shared memory if mne_rt_server runs on the same host
+        QSettings settings("MNECPP");
+        if(settings.value("MNESCAN/FiffSimulator/useSharedMemory", false).toBool()) {
+            m_pFiffSimulatorProducer->setSharedMemoryKey(m_pRtCmdClient->requestSharedMemory(m_pFiffSimulatorProducer->m_iDataClientId));
+        }
+
         // Start Measurement at mne_rt_server
         (*m_pRtCmdClient)["start"].pValues()[0].setValue(m_pFiffSimulatorProducer->m_iDataClientId);
         (*m_pRtCmdClient)["start"].send();
@@ -213,13 +220,17 @@ QWidget* FiffSimulator::setupWidget()
 void FiffSimulator::run()
 {
     MatrixXf matValue;
+    MatrixXd matData;
 
     while(!isInterruptionRequested()) {
         //pop matrix
         if(m_pCircularBuffer->pop(matValue)) {
             //emit values
             if(!isInterruptionRequested()) {
-                m_pRTMSA_FiffSimulator->measurementData()->setValue(matValue.cast<double>());
+                // Move the block into the measurement. matData gets the storage of a released block back,
+                // so the cast does not allocate once the pool is warmed up.
+                matData = matValue.cast<double>();
+                m_pRTMSA_FiffSimulator->measurementData()->setValue(std::move(matData));
             }
         }
     }
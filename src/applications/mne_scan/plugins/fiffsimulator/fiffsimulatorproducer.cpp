@@ -47,6 +47,8 @@
 //=============================================================================================================
 
 #include <QMutexLocker>
+#include <QDebug>
+#include <QSettings>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -107,6 +109,12 @@ void FiffSimulatorProducer::connectDataClient(QString p_sRtSeverIP)
             // set data client alias -> for convinience (optional)
             m_pRtDataClient->setClientAlias(m_pFiffSimulator->m_sFiffSimulatorClientAlias); // used in option 2 later on
 
+            // request lossless compression of the raw buffers, e.g. for congested networks (optional)
+            QSettings settings("MNECPP");
+            if(settings.value("MNESCAN/FiffSimulator/useCompression", false).toBool()) {
+                m_pRtDataClient->requestCompression(true);
+            }
+
             // set new state
             m_bDataClientIsConnected = true;
             emit dataConnectionChanged(m_bDataClientIsConnected);
@@ -135,6 +143,14 @@ void FiffSimulatorProducer::disconnectDataClient()
 
 //=============================================================================================================
 
+void FiffSimulatorProducer::setSharedMemoryKey(const QString& sKey)
+{
+    QMutexLocker locker(&m_producerMutex);
+    m_sSharedMemoryKey = sKey;
+}
+
+//=============================================================================================================
+
 void FiffSimulatorProducer::stop()
 {
     requestInterruption();
@@ -175,6 +191,12 @@ void FiffSimulatorProducer::run()
             emit m_pFiffSimulator->fiffInfoAvailable();
             m_bFlagInfoRequest = false;
         }
+        if(!m_sSharedMemoryKey.isEmpty()) {
+            if(!m_pRtDataClient->attachSharedMemory(m_sSharedMemoryKey)) {
+                qInfo() << "[FiffSimulatorProducer::run] Shared memory not available. Receiving raw buffers via TCP.";
+            }
+            m_sSharedMemoryKey.clear();
+        }
         m_producerMutex.unlock();
 
         // Only perform data reading if the measurement was started
@@ -107,6 +107,15 @@ public:
      */
     void disconnectDataClient();
 
+    //=========================================================================================================
+    /**
+     * Sets the key of the shared memory ring the data client attaches to. The data client keeps using TCP if the
+     * key is empty or the ring is not available on this host.
+     *
+     * @param[in] sKey   The key of the shared memory ring.
+     */
+    void setSharedMemoryKey(const QString& sKey);
+
     //=========================================================================================================
     /**
      * Stops the MneRtClientProducer by stopping the producer's thread.
@@ -142,6 +151,7 @@ private:
     bool                    m_bFlagInfoRequest;                     /**< Read Fiff Info flag. */
 
     qint32                  m_iDataClientId;                        /**< The client id. */
+    QString                 m_sSharedMemoryKey;                     /**< The shared memory ring to attach to from within the producer thread. */
     quint16                 m_iDefaultPortDataClient;               /**< The default port for the rt data client. */
 };
 } // NAMESPACE
@@ -96,7 +96,7 @@ Hpi::Hpi()
 , m_bDoContinousHpi(false)
 , m_bUseSSP(false)
 , m_bUseComp(false)
-, m_pCircularBuffer(CircularBuffer_Matrix_double::SPtr::create(40))
+, m_pCircularBuffer(SpscCircularBuffer<SampleBlockPool::Block>::SPtr::create(40))
 {
     connect(this, &Hpi::devHeadTransAvailable,
             this, &Hpi::onDevHeadTransAvailable, Qt::BlockingQueuedConnection);
@@ -202,7 +202,7 @@ void Hpi::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         manageInitialization(pRTMSA);
 
         // Check if data is present
-        if(pRTMSA->getMultiSampleArray().size() > 0) {
+        if(pRTMSA->getSampleBlocks().size() > 0) {
             //If bad channels changed, recalcluate projectors
             updateProjections();
 
@@ -212,17 +212,15 @@ void Hpi::update(SCMEASLIB::Measurement::SPtr pMeasurement)
             m_mutex.unlock();
 
             if(bDoFreqOrder || bDoSingleHpi) {
-                while(!m_pCircularBuffer->push(pRTMSA->getMultiSampleArray()[0])) {
+                while(!m_pCircularBuffer->push(pRTMSA->getSampleBlocks()[0])) {
                     //Do nothing until the circular buffer is ready to accept new data again
                 }
             }
 
             if(m_bDoContinousHpi && (m_vCoilFreqs.size() >= 3)) {
-                for(unsigned char i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
-                    // Please note that we do not need a copy here since this function will block until
-                    // the buffer accepts new data again. Hence, the data is not deleted in the actual
-                    // Measurement function after it emitted the notify signal.
-                    while(!m_pCircularBuffer->push(pRTMSA->getMultiSampleArray()[i])) {
+                for(unsigned char i = 0; i < pRTMSA->getSampleBlocks().size(); ++i) {
+                    // Only the reference to the shared block is queued, the samples are not copied
+                    while(!m_pCircularBuffer->push(pRTMSA->getSampleBlocks()[i])) {
                         //Do nothing until the circular buffer is ready to accept new data again
                     }
                 }
@@ -564,6 +562,8 @@ void Hpi::run()
 
     HpiDataUpdater hpiDataUpdater = HpiDataUpdater(m_pFiffInfo);
     HPIFit HPI = HPIFit(hpiDataUpdater.getSensors());
+    // continuous fits start from the previous window's result
+    HPI.setFitMethod(HpiFitMethod::levenbergMarquardt);
 
     double dErrorMax = 0.0;
     double dMeanErrorDist = 0.0;
@@ -574,7 +574,7 @@ void Hpi::run()
     double dRotation = 0.0;
 
     int iDataIndexCounter = 0;
-    MatrixXd matData;
+    SampleBlockPool::Block block;
 
     m_mutex.lock();
     int fittingWindowSize = m_iFittingWindowSize;
@@ -594,7 +594,9 @@ void Hpi::run()
         m_mutex.unlock();
 
         //pop matrix
-        if(m_pCircularBuffer->pop(matData)) {
+        if(m_pCircularBuffer->pop(block)) {
+            const MatrixXd& matData = *block;
+
             if(iDataIndexCounter + matData.cols() < matDataMerged.cols()) {
                 matDataMerged.block(0, iDataIndexCounter, matData.rows(), matData.cols()) = matData;
                 iDataIndexCounter += matData.cols();
@@ -43,6 +43,7 @@
 #include "hpi_global.h"
 
 #include <utils/generics/circularbuffer.h>
+#include <scMeas/sampleblockpool.h>
 #include <scShared/Plugins/abstractalgorithm.h>
 
 #include <fiff/fiff_dig_point.h>
@@ -315,7 +316,7 @@ private:
 
     QSharedPointer<FIFFLIB::FiffInfo>                                           m_pFiffInfo;            /**< Fiff measurement info.*/
     QSharedPointer<FIFFLIB::FiffDigitizerData>                                  m_pFiffDigitizerData;
-    QSharedPointer<UTILSLIB::CircularBuffer_Matrix_double>                      m_pCircularBuffer;      /**< Holds incoming raw data. */
+    QSharedPointer<UTILSLIB::SpscCircularBuffer<SCMEASLIB::SampleBlockPool::Block> > m_pCircularBuffer;     /**< Holds the shared blocks of the incoming raw data. */
 
     SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr     m_pHpiInput;            /**< The RealTimeMultiSampleArray of the Hpi input.*/
     SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeHpiResult>::SPtr           m_pHpiOutput;           /**< The RealTimeHpiResult of the Hpi output.*/
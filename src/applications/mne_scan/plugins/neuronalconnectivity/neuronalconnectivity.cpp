@@ -338,9 +338,9 @@ void NeuronalConnectivity::updateRTMSA(SCMEASLIB::Measurement::SPtr pMeasurement
 
             MatrixXd data;
 
-            for(qint32 i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
-                const MatrixXd& t_mat = pRTMSA->getMultiSampleArray()[i];
-                m_iBlockSize = pRTMSA->getMultiSampleArray()[i].cols();
+            for(qint32 i = 0; i < pRTMSA->getSampleBlocks().size(); ++i) {
+                const MatrixXd& t_mat = *pRTMSA->getSampleBlocks()[i];
+                m_iBlockSize = t_mat.cols();
 
                 // Check row and colum integrity and restart if necessary
                 if(m_connectivitySettings.size() != 0) {
@@ -48,6 +48,7 @@
 #include <disp/viewers/spharasettingsview.h>
 
 #include <rtprocessing/filter.h>
+#include <rtprocessing/causalfilter.h>
 #include <rtprocessing/sphara.h>
 
 #include <utils/ioutils.h>
@@ -87,10 +88,12 @@ NoiseReduction::NoiseReduction()
 , m_bSpharaActive(false)
 , m_bProjActivated(false)
 , m_bFilterActivated(false)
+, m_bCausalFilterChanged(true)
 , m_iMaxFilterLength(1)
 , m_iMaxFilterTapSize(-1)
+, m_iFilterMode(0)
 , m_sCurrentSystem("VectorView")
-, m_pCircularBuffer(QSharedPointer<UTILSLIB::CircularBuffer_Matrix_double>::create(40))
+, m_pCircularBuffer(QSharedPointer<UTILSLIB::SpscCircularBuffer<SampleBlockPool::Block> >::create(40))
 , m_pNoiseReductionInput(Q_NULLPTR)
 , m_pNoiseReductionOutput(Q_NULLPTR)
 {
@@ -219,19 +222,17 @@ void NoiseReduction::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         }
 
         // Check if data is present
-        if(pRTMSA->getMultiSampleArray().size() > 0) {
+        if(pRTMSA->getSampleBlocks().size() > 0) {
             //Init widgets
             if(m_iMaxFilterTapSize == -1) {
-                m_iMaxFilterTapSize = pRTMSA->getMultiSampleArray().first().cols();
+                m_iMaxFilterTapSize = pRTMSA->getSampleBlocks().first()->cols();
                 initPluginControlWidgets();
                 QThread::start();
             }
 
-            for(unsigned char i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
-                // Please note that we do not need a copy here since this function will block until
-                // the buffer accepts new data again. Hence, the data is not deleted in the actual
-                // Measurement function after it emitted the notify signal.
-                while(!m_pCircularBuffer->push(pRTMSA->getMultiSampleArray()[i])) {
+            for(unsigned char i = 0; i < pRTMSA->getSampleBlocks().size(); ++i) {
+                // Only the reference to the shared block is queued, the samples are not copied
+                while(!m_pCircularBuffer->push(pRTMSA->getSampleBlocks()[i])) {
                     //Do nothing until the circular buffer is ready to accept new data again
                 }
             }
@@ -286,10 +287,14 @@ void NoiseReduction::initPluginControlWidgets()
         connect(pFilterSettingsView, &FilterSettingsView::filterActivationChanged,
                 this, &NoiseReduction::setFilterActive);
 
+        connect(pFilterSettingsView, &FilterSettingsView::filterModeChanged,
+                this, &NoiseReduction::setFilterMode);
+
         pFilterSettingsView->setSamplingRate(m_pFiffInfo->sfreq);
         pFilterSettingsView->getFilterView()->setMaxAllowedFilterTaps(m_iMaxFilterTapSize);
 
         this->setFilterActive(pFilterSettingsView->getFilterActive());
+        this->setFilterMode(pFilterSettingsView->getFilterMode());
         this->setFilterChannelType(pFilterSettingsView->getFilterView()->getChannelType());
 
         // SPHARA settings
@@ -342,36 +347,55 @@ void NoiseReduction::run()
     createSpharaOperator();
 
     // Init
+    SampleBlockPool::Block block;
     MatrixXd matData;
     QScopedPointer<RTPROCESSINGLIB::FilterOverlapAdd> pRtFilter(new RTPROCESSINGLIB::FilterOverlapAdd());
+    QScopedPointer<RTPROCESSINGLIB::CausalFilter> pCausalFilter(new RTPROCESSINGLIB::CausalFilter());
 
     while(!isInterruptionRequested()) {
         // Get the current data
-        if(m_pCircularBuffer->pop(matData)) {
+        if(m_pCircularBuffer->pop(block)) {
             m_mutex.lock();
-            //Do SSP's and compensators here
+            //Do SSP's and compensators here. The shared block is only copied if it is modified.
+            bool bModified = true;
+
             if(m_bCompActivated) {
                 if(m_bProjActivated) {
                     //Comp + Proj
-                    matData = m_matSparseProjCompMult * matData;
+                    matData = m_matSparseProjCompMult * *block;
                 } else {
                     //Comp
-                    matData = m_matSparseCompMult * matData;
+                    matData = m_matSparseCompMult * *block;
                 }
             } else {
                 if(m_bProjActivated) {
                     //Proj
-                    matData = m_matSparseProjMult * matData;
+                    matData = m_matSparseProjMult * *block;
                 } else {
                     //None - Raw
+                    bModified = m_bFilterActivated || m_bSpharaActive;
+
+                    if(bModified) {
+                        matData = *block;
+                    }
                 }
             }
 
             //Do temporal filtering here
             if(m_bFilterActivated) {
-                matData = pRtFilter->calculate(matData,
-                                               m_filterKernel,
-                                               m_lFilterChannelList);
+                if(m_iFilterMode == 0) {
+                    matData = pRtFilter->calculate(matData,
+                                                   m_filterKernel,
+                                                   m_lFilterChannelList);
+                } else {
+                    if(m_bCausalFilterChanged) {
+                        setupCausalFilter(*pCausalFilter);
+                        m_bCausalFilterChanged = false;
+                    }
+
+                    matData = pCausalFilter->calculate(matData,
+                                                       m_lFilterChannelList);
+                }
             }
 
             //Do SPHARA here
@@ -410,7 +434,11 @@ void NoiseReduction::run()
 
             //Send the data to the connected plugins and the display
             if(!isInterruptionRequested()) {
-                m_pNoiseReductionOutput->measurementData()->setValue(matData);
+                if(bModified) {
+                    m_pNoiseReductionOutput->measurementData()->setValue(matData);
+                } else {
+                    m_pNoiseReductionOutput->measurementData()->setValue(block);
+                }
             }
         }
     }
@@ -561,6 +589,7 @@ void NoiseReduction::setFilter(const FilterKernel& filterData)
 {
     m_mutex.lock();
     m_filterKernel = filterData;
+    m_bCausalFilterChanged = true;
 
     m_iMaxFilterLength = 1;
     if(m_iMaxFilterLength < m_filterKernel.getFilterOrder()) {
@@ -578,6 +607,39 @@ void NoiseReduction::setFilterActive(bool state)
 
 //=============================================================================================================
 
+void NoiseReduction::setFilterMode(int iMode)
+{
+    m_mutex.lock();
+    m_iFilterMode = iMode;
+    m_bCausalFilterChanged = true;
+    m_mutex.unlock();
+}
+
+//=============================================================================================================
+
+void NoiseReduction::setupCausalFilter(RTPROCESSINGLIB::CausalFilter& causalFilter)
+{
+    double dNyquist = m_pFiffInfo->sfreq / 2.0;
+    int iType = FilterKernel::m_filterTypes.indexOf(m_filterKernel.getFilterType());
+
+    if(m_iFilterMode == 1) {
+        causalFilter.designButterworth(iType,
+                                       4,
+                                       m_filterKernel.getCenterFrequency() * dNyquist,
+                                       m_filterKernel.getBandwidth() * dNyquist,
+                                       m_pFiffInfo->sfreq);
+    } else {
+        // Partitions of the incoming block size do not add any buffering latency
+        causalFilter.setFirKernel(m_filterKernel,
+                                  m_iMaxFilterTapSize);
+    }
+
+    qInfo() << "[NoiseReduction::setupCausalFilter] Filter latency at the center frequency:"
+            << causalFilter.getLatency(m_filterKernel.getCenterFrequency() * dNyquist) * 1000.0 << "ms";
+}
+
+//=============================================================================================================
+
 void NoiseReduction::initSphara()
 {
     //Load SPHARA matrix
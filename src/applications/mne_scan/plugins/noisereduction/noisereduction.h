@@ -43,6 +43,7 @@
 #include "noisereduction_global.h"
 
 #include <utils/generics/circularbuffer.h>
+#include <scMeas/sampleblockpool.h>
 
 #include <fiff/fiff_proj.h>
 
@@ -70,6 +71,7 @@ namespace FIFFLIB{
 
 namespace RTPROCESSINGLIB{
     class Filter;
+    class CausalFilter;
 }
 
 namespace SCMEASLIB{
@@ -206,6 +208,14 @@ protected:
      */
     void setFilterActive(bool state);
 
+    //=========================================================================================================
+    /**
+     * Filter mode changed
+     *
+     * @param[in] iMode    the filter mode (0 = linear phase, 1 = causal IIR, 2 = causal FIR).
+     */
+    void setFilterMode(int iMode);
+
     //=========================================================================================================
     /**
      * Init the SPHARA method.
@@ -218,6 +228,14 @@ protected:
      */
     void createSpharaOperator();
 
+    //=========================================================================================================
+    /**
+     * Sets up the causal filter based on the current filter kernel and filter mode.
+     *
+     * @param[in, out] causalFilter    The causal filter to set up.
+     */
+    void setupCausalFilter(RTPROCESSINGLIB::CausalFilter& causalFilter);
+
 private:
     QMutex                          m_mutex;                                    /**< The threads mutex.*/
 
@@ -225,11 +243,13 @@ private:
     bool                            m_bSpharaActive;                            /**< Flag whether thread is running.*/
     bool                            m_bProjActivated;                           /**< Projections activated. */
     bool                            m_bFilterActivated;                         /**< Projections activated. */
+    bool                            m_bCausalFilterChanged;                     /**< Whether the causal filter needs to be set up anew. */
 
     int                             m_iNBaseFctsFirst;                          /**< The number of grad/inner base functions to use for calculating the sphara opreator.*/
     int                             m_iNBaseFctsSecond;                         /**< The number of grad/outer base functions to use for calculating the sphara opreator.*/
     int                             m_iMaxFilterLength;                         /**< Max order of the current filters. */
     int                             m_iMaxFilterTapSize;                        /**< maximum number of allowed filter taps. This number depends on the size of the receiving blocks. */
+    int                             m_iFilterMode;                              /**< The filter mode (0 = linear phase, 1 = causal IIR, 2 = causal FIR). */
 
     QString                         m_sCurrentSystem;                           /**< The current acquisition system (EEG, babyMEG, VectorView).*/
     QString                         m_sFilterChannelType;                       /**< Kind of channel which is to be filtered. */
@@ -258,7 +278,7 @@ private:
 
     QSharedPointer<FIFFLIB::FiffInfo>                               m_pFiffInfo;            /**< Fiff measurement info.*/
 
-    QSharedPointer<UTILSLIB::CircularBuffer_Matrix_double>          m_pCircularBuffer;      /**< Holds incoming raw data. */
+    QSharedPointer<UTILSLIB::SpscCircularBuffer<SCMEASLIB::SampleBlockPool::Block> > m_pCircularBuffer;  /**< Holds the shared blocks of the incoming raw data. */
 
     SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr      m_pNoiseReductionInput;      /**< The RealTimeMultiSampleArray of the NoiseReduction input.*/
     SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr     m_pNoiseReductionOutput;     /**< The RealTimeMultiSampleArray of the NoiseReduction output.*/
@@ -93,7 +93,7 @@ using namespace Eigen;
 //=============================================================================================================
 
 RtcMne::RtcMne()
-: m_pCircularMatrixBuffer(CircularBuffer_Matrix_double::SPtr(new CircularBuffer_Matrix_double(40)))
+: m_pCircularMatrixBuffer(SpscCircularBuffer<SampleBlockPool::Block>::SPtr(new SpscCircularBuffer<SampleBlockPool::Block>(40)))
 , m_pCircularEvokedBuffer(CircularBuffer<FIFFLIB::FiffEvoked>::SPtr::create(40))
 , m_bEvokedInput(false)
 , m_bRawInput(false)
@@ -405,16 +405,14 @@ void RtcMne::updateRTMSA(SCMEASLIB::Measurement::SPtr pMeasurement)
                 QMap<QString,double> mapReject;
                 mapReject.insert("eog", 150e-06);
 
-                for(qint32 i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
-                    bool bArtifactDetected = MNEEpochDataList::checkForArtifact(pRTMSA->getMultiSampleArray()[i],
+                for(qint32 i = 0; i < pRTMSA->getSampleBlocks().size(); ++i) {
+                    bool bArtifactDetected = MNEEpochDataList::checkForArtifact(*pRTMSA->getSampleBlocks()[i],
                                                                                 *m_pFiffInfoInput,
                                                                                 mapReject);
 
                     if(!bArtifactDetected) {
-                        // Please note that we do not need a copy here since this function will block until
-                        // the buffer accepts new data again. Hence, the data is not deleted in the actual
-                        // Measurement function after it emitted the notify signal.
-                        while(!m_pCircularMatrixBuffer->push(pRTMSA->getMultiSampleArray()[i])) {
+                        // Only the reference to the shared block is queued, the samples are not copied
+                        while(!m_pCircularMatrixBuffer->push(pRTMSA->getSampleBlocks()[i])) {
                             //Do nothing until the circular buffer is ready to accept new data again
                         }
                     } else {
@@ -571,7 +569,7 @@ void RtcMne::run()
     // Init parameters
     qint32 skip_count = 0;
     FiffEvoked evoked;
-    MatrixXd matData;
+    SampleBlockPool::Block block;
     MatrixXd matDataResized;
     qint32 j;
     int iTimePointSps = 0;
@@ -616,7 +614,9 @@ void RtcMne::run()
         if(bRawInput && pMinimumNorm) {
             if(((skip_count % iDownSample) == 0)) {
                 // Get the current raw data
-                if(m_pCircularMatrixBuffer->pop(matData)) {
+                if(m_pCircularMatrixBuffer->pop(block)) {
+                    const MatrixXd& matData = *block;
+
                     //Pick the same channels as in the inverse operator
                     matDataResized.resize(iNumberChannels, matData.cols());
 
@@ -640,7 +640,7 @@ void RtcMne::run()
                     }
                 }
             } else {
-                m_pCircularMatrixBuffer->pop(matData);
+                m_pCircularMatrixBuffer->pop(block);
             }
         }
 
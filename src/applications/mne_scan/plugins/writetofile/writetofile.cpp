@@ -77,7 +77,7 @@ WriteToFile::WriteToFile()
 , m_iBlinkStatus(0)
 , m_iSplitCount(0)
 , m_iRecordingMSeconds(5*60*1000)
-, m_pCircularBuffer(CircularBuffer_Matrix_double::SPtr(new CircularBuffer_Matrix_double(40)))
+, m_pCircularBuffer(SpscCircularBuffer<SampleBlockPool::Block>::SPtr(new SpscCircularBuffer<SampleBlockPool::Block>(40)))
 {
     m_pActionRecordFile = new QAction(QIcon(":/images/record.png"), tr("Start Recording"),this);
     m_pActionRecordFile->setStatusTip(tr("Start Recording"));
@@ -204,12 +204,10 @@ void WriteToFile::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         }
 
         // Check if data is present
-        if(pRTMSA->getMultiSampleArray().size() > 0) {
-            for(unsigned char i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
-                // Please note that we do not need a copy here since this function will block until
-                // the buffer accepts new data again. Hence, the data is not deleted in the actual
-                // Measurement function after it emitted the notify signal.
-                while(!m_pCircularBuffer->push(pRTMSA->getMultiSampleArray()[i])) {
+        if(pRTMSA->getSampleBlocks().size() > 0) {
+            for(unsigned char i = 0; i < pRTMSA->getSampleBlocks().size(); ++i) {
+                // The blocks are immutable and shared, hence only the reference is queued and the samples are not copied.
+                while(!m_pCircularBuffer->push(pRTMSA->getSampleBlocks()[i])) {
                     //Do nothing until the circular buffer is ready to accept new data again
                 }
             }
@@ -290,14 +288,16 @@ void WriteToFile::initPluginControlWidgets()
 
 void WriteToFile::run()
 {
-    MatrixXd matData;
+    SampleBlockPool::Block block;
     qint32 size = 0;
 
     while(!isInterruptionRequested()) {
         if(m_pCircularBuffer) {
             //pop matrix
 
-            if(m_pCircularBuffer->pop(matData)) {
+            if(m_pCircularBuffer->pop(block)) {
+                const MatrixXd& matData = *block;
+
                 //Write raw data to fif file
                 m_mutex.lock();
                 if(m_bWriteToFile) {
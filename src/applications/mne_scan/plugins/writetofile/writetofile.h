@@ -43,6 +43,7 @@
 #include "writetofile_global.h"
 
 #include <utils/generics/circularbuffer.h>
+#include <scMeas/sampleblockpool.h>
 #include <scShared/Plugins/abstractalgorithm.h>
 #include <fiff/fifffilesharer.h>
 
@@ -301,7 +302,7 @@ private:
     QPointer<QAction>                       m_pActionRecordFile;            /**< start recording action. */
     QPointer<QAction>                       m_pActionClipRecording;
 
-    QSharedPointer<UTILSLIB::CircularBuffer_Matrix_double>                      m_pCircularBuffer;      /**< Holds incoming raw data. */
+    QSharedPointer<UTILSLIB::SpscCircularBuffer<SCMEASLIB::SampleBlockPool::Block> > m_pCircularBuffer;  /**< Holds the shared blocks of the incoming raw data. */
 
     SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr      m_pWriteToFileInput;   /**< The RealTimeMultiSampleArray of the WriteToFile input.*/
 
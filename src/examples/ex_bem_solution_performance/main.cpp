@@ -0,0 +1,164 @@
+//=============================================================================================================
+/**
+ * @file     main.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Compares the BEM linear collocation solution computation of the serial and the parallel implementation
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fwd/fwd_bem_model.h>
+
+#include <mne/c/mne_surface_old.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QThreadPool>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FWDLIB;
+using namespace MNELIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+ * The function main marks the entry point of the program.
+ * By default, main has the storage class extern.
+ *
+ * @param[in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+ * @param[in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+ * @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("BEM Solution Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption bemOption("bem", "The BEM surface <file>.", "file", QCoreApplication::applicationDirPath() + "/../resources/data/MNE-sample-data/subjects/sample/bem/sample-5120-5120-5120-bem.fif");
+    QCommandLineOption homogOption("homog", "Use the inner skull surface only (single compartment model).");
+    QCommandLineOption threadsOption("threads", "The maximum number of <threads> used by the parallel implementation.", "threads", QString::number(QThread::idealThreadCount()));
+
+    parser.addOption(bemOption);
+    parser.addOption(homogOption);
+    parser.addOption(threadsOption);
+
+    parser.process(a);
+
+    FwdBemModel* pModel = parser.isSet(homogOption) ? FwdBemModel::fwd_bem_load_homog_surface(parser.value(bemOption))
+                                                    : FwdBemModel::fwd_bem_load_three_layer_surfaces(parser.value(bemOption));
+    if(!pModel) {
+        printf("Could not load the BEM surfaces from %s\n", parser.value(bemOption).toUtf8().constData());
+        return 1;
+    }
+
+    int iThreads = parser.value(threadsOption).toInt();
+    if(iThreads > 0) {
+        QThreadPool::globalInstance()->setMaxThreadCount(iThreads);
+    }
+
+    int iNTot = 0;
+    for(int k = 0; k < pModel->nsurf; ++k) {
+        iNTot += pModel->surfs[k]->np;
+    }
+    printf("BEM solution benchmark: %d surfaces, %d nodes, %d threads\n", pModel->nsurf, iNTot, QThreadPool::globalInstance()->maxThreadCount());
+
+    QElapsedTimer timer;
+
+    // Existing single threaded implementation
+    timer.start();
+    float** pCoeffOrig = FwdBemModel::fwd_bem_lin_pot_coeff(pModel->surfs);
+    qint64 iAssembleOrig = timer.restart();
+
+    // Parallel assembly into a column-major matrix
+    MatrixXf matCoeff;
+    FwdBemModel::fwd_bem_lin_pot_coeff_parallel(pModel->surfs, matCoeff);
+    qint64 iAssembleParallel = timer.restart();
+
+    double dCoeffDiff = (matCoeff - Map<Matrix<float,Dynamic,Dynamic,RowMajor> >(pCoeffOrig[0], iNTot, iNTot)).cwiseAbs().maxCoeff();
+
+    timer.restart();
+    float** pSolOrig = FwdBemModel::fwd_bem_multi_solution(pCoeffOrig, pModel->gamma, pModel->nsurf, pModel->np);
+    qint64 iSolveOrig = timer.restart();
+
+    float** pSolParallel = FwdBemModel::fwd_bem_multi_solution_lu(matCoeff, pModel->gamma, pModel->nsurf, pModel->np);
+    qint64 iSolveParallel = timer.restart();
+
+    if(!pSolOrig || !pSolParallel) {
+        printf("Could not compute the BEM solution.\n");
+        return 1;
+    }
+
+    Map<Matrix<float,Dynamic,Dynamic,RowMajor> > matSolOrig(pSolOrig[0], iNTot, iNTot);
+    Map<Matrix<float,Dynamic,Dynamic,RowMajor> > matSolParallel(pSolParallel[0], iNTot, iNTot);
+    double dSolDiff = (matSolParallel - matSolOrig).cwiseAbs().maxCoeff();
+    double dSolMax = matSolOrig.cwiseAbs().maxCoeff();
+
+    printf("%-12s %14s %14s %8s\n", "step", "serial [ms]", "parallel [ms]", "speedup");
+    printf("%-12s %14lld %14lld %8.2f\n", "assembly", iAssembleOrig, iAssembleParallel, iAssembleParallel > 0 ? double(iAssembleOrig) / iAssembleParallel : 0.0);
+    printf("%-12s %14lld %14lld %8.2f\n", "solution", iSolveOrig, iSolveParallel, iSolveParallel > 0 ? double(iSolveOrig) / iSolveParallel : 0.0);
+    printf("Max. coefficient difference : %g\n", dCoeffDiff);
+    printf("Max. solution difference    : %g (relative %g)\n", dSolDiff, dSolMax > 0.0 ? dSolDiff / dSolMax : 0.0);
+
+    free(pSolOrig[0]);
+    free(pSolOrig);
+    free(pSolParallel[0]);
+    free(pSolParallel);
+    delete pModel;
+
+    return 0;
+}
@@ -63,6 +63,8 @@
 #include <QHostInfo>
 #include <QElapsedTimer>
 #include <QThreadPool>
+#include <QCommandLineParser>
+#include <QThread>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -121,6 +123,94 @@ void customMessageHandler(QtMsgType type, const QMessageLogContext &context, con
     }
 }
 
+//=============================================================================================================
+/**
+ * Measures how the spectral connectivity metrics scale with the number of threads. The thread pool size is doubled
+ * until the ideal thread count is reached. The results are printed to stdout.
+ *
+ * @param[in] matDataOrig      The raw data to create the trials from. Rows are repeated if more nodes are requested.
+ * @param[in] fSFreq           The sampling frequency.
+ * @param[in] iNumberNodes     The number of network nodes.
+ * @param[in] iNumberTrials    The number of trials.
+ * @param[in] iNumberSamples   The number of samples per trial.
+ *
+ * @return 0 on success.
+ */
+int runScalingBenchmark(const MatrixXd& matDataOrig,
+                        float fSFreq,
+                        int iNumberNodes,
+                        int iNumberTrials,
+                        int iNumberSamples)
+{
+    if(matDataOrig.rows() == 0 || matDataOrig.cols() < iNumberTrials * iNumberSamples) {
+        printf("Not enough data for the scaling benchmark.\n");
+        return 1;
+    }
+
+    QStringList sConnectivityMethodList = QStringList() << "COH" << "IMAGCOH" << "PLI" << "WPLI" << "USPLI" << "DSWPLI" << "PLV";
+    int iNumberRepeats = 3;
+    int iOrigMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+
+    ConnectivitySettings connectivitySettings;
+    connectivitySettings.setSamplingFrequency(fSFreq);
+    connectivitySettings.setWindowType("hanning");
+    connectivitySettings.setFFTSize(qMin(int(fSFreq), iNumberSamples));
+    connectivitySettings.setNodePositions(MatrixX3f::Random(iNumberNodes, 3));
+
+    // Use distinct data segments for each trial
+    MatrixXd matTrial(iNumberNodes, iNumberSamples);
+    for(int t = 0; t < iNumberTrials; ++t) {
+        for(int r = 0; r < iNumberNodes; ++r) {
+            matTrial.row(r) = matDataOrig.block(r % matDataOrig.rows(), t * iNumberSamples, 1, iNumberSamples);
+        }
+        connectivitySettings.append(matTrial);
+    }
+
+    printf("Thread scaling benchmark: %d nodes, %d trials, %d samples, %d bins\n", iNumberNodes, iNumberTrials, iNumberSamples, AbstractMetric::m_iNumberBinAmount);
+    printf("%-10s %8s %12s %8s\n", "method", "threads", "time [ms]", "speedup");
+
+    QList<int> lNumberThreads;
+    for(int iThreads = 1; iThreads < QThread::idealThreadCount(); iThreads *= 2) {
+        lNumberThreads << iThreads;
+    }
+    lNumberThreads << QThread::idealThreadCount();
+
+    QElapsedTimer timer;
+
+    for(int i = 0; i < sConnectivityMethodList.size(); ++i) {
+        connectivitySettings.setConnectivityMethods(QStringList() << sConnectivityMethodList.at(i));
+        double dSingleThreadTime = 0.0;
+
+        for(int k = 0; k < lNumberThreads.size(); ++k) {
+            int iThreads = lNumberThreads.at(k);
+            QThreadPool::globalInstance()->setMaxThreadCount(iThreads);
+
+            qint64 iBestTime = -1;
+            for(int u = 0; u < iNumberRepeats; ++u) {
+                connectivitySettings.clearIntermediateData();
+
+                timer.restart();
+                Connectivity::calculate(connectivitySettings);
+                qint64 iTime = timer.elapsed();
+
+                if(iBestTime < 0 || iTime < iBestTime) {
+                    iBestTime = iTime;
+                }
+            }
+
+            if(k == 0) {
+                dSingleThreadTime = iBestTime;
+            }
+
+            printf("%-10s %8d %12lld %8.2f\n", sConnectivityMethodList.at(i).toLatin1().data(), iThreads, iBestTime, iBestTime > 0 ? dSingleThreadTime / iBestTime : 0.0);
+        }
+    }
+
+    QThreadPool::globalInstance()->setMaxThreadCount(iOrigMaxThreadCount);
+
+    return 0;
+}
+
 //=============================================================================================================
 // MAIN
 //=============================================================================================================
@@ -145,6 +235,23 @@ int main(int argc, char *argv[])
 
     m_sCurrentDir = QCoreApplication::applicationDirPath();
 
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Connectivity Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption scalingOption("scaling", "Only run the thread scaling benchmark for the spectral metrics.");
+    QCommandLineOption scalingNodesOption("scalingNodes", "The number of <nodes> used for the thread scaling benchmark.", "nodes", "300");
+    QCommandLineOption scalingTrialsOption("scalingTrials", "The number of <trials> used for the thread scaling benchmark.", "trials", "50");
+    QCommandLineOption scalingSamplesOption("scalingSamples", "The number of <samples> per trial used for the thread scaling benchmark.", "samples", "1000");
+
+    parser.addOption(scalingOption);
+    parser.addOption(scalingNodesOption);
+    parser.addOption(scalingTrialsOption);
+    parser.addOption(scalingSamplesOption);
+
+    parser.process(a);
+
 //    printf("globalInstance()->maxThreadCount(): %d\n",QThreadPool::globalInstance()->maxThreadCount());
 //    QThreadPool::globalInstance()->setMaxThreadCount(24);
 
@@ -180,6 +287,14 @@ int main(int argc, char *argv[])
         qDebug() << "Could not read raw segment.";
     }
 
+    if(parser.isSet(scalingOption)) {
+        return runScalingBenchmark(matDataOrig,
+                                   raw.info.sfreq,
+                                   parser.value(scalingNodesOption).toInt(),
+                                   parser.value(scalingTrialsOption).toInt(),
+                                   parser.value(scalingSamplesOption).toInt());
+    }
+
     //Perform connectivity performance tests
     Connectivity connectivityObj;
 
@@ -0,0 +1,215 @@
+//=============================================================================================================
+/**
+ * @file     main.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Compares the batched FFT filter engine with the per-channel FilterKernel path
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtprocessing/filter.h>
+#include <rtprocessing/helpers/filterkernel.h>
+#include <rtprocessing/helpers/filterfftengine.h>
+
+#include <stdio.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+/**
+ * The per-channel path used before the filter engine: every channel gets its own copy of the prepared
+ * kernel and of its data row, and FilterKernel::applyFftFilter sets up a new FFT per call.
+ */
+MatrixXd filterDataBlockPerChannel(const MatrixXd& matData,
+                                   const FilterKernel& filterKernel,
+                                   bool bUseThreads)
+{
+    int iOrder = filterKernel.getFilterOrder();
+
+    FilterKernel filterKernelSetup = filterKernel;
+    filterKernelSetup.prepareFilter(matData.cols());
+
+    QList<FilterObject> timeData;
+    FilterObject data;
+    for(int i = 0; i < matData.rows(); ++i) {
+        data.filterKernel = filterKernelSetup;
+        data.iRow = i;
+        data.vecData = matData.row(i);
+        timeData.append(data);
+    }
+
+    MatrixXd matDataOut = MatrixXd::Zero(matData.rows(), matData.cols() + iOrder);
+
+    if(bUseThreads) {
+        QFuture<void> future = QtConcurrent::map(timeData,
+                                                 filterChannel);
+        future.waitForFinished();
+    } else {
+        for(int i = 0; i < timeData.size(); ++i) {
+            filterChannel(timeData[i]);
+        }
+    }
+
+    for(int r = 0; r < timeData.size(); ++r) {
+        matDataOut.row(timeData.at(r).iRow) = timeData.at(r).vecData;
+    }
+
+    return matDataOut;
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+ * The function main marks the entry point of the program.
+ * By default, main has the storage class extern.
+ *
+ * @param[in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+ * @param[in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+ * @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Filtering Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption channelsOption("channels", "The number of <channels> to filter.", "channels", "434");
+    QCommandLineOption samplesOption("samples", "The number of <samples> per data block.", "samples", "500");
+    QCommandLineOption blocksOption("blocks", "The number of data <blocks> to filter.", "blocks", "200");
+    QCommandLineOption sFreqOption("sfreq", "The sampling <frequency> in Hz.", "frequency", "5000");
+    QCommandLineOption orderOption("order", "The filter <order>.", "order", "1024");
+    QCommandLineOption noThreadsOption("nothreads", "Filter all channels in the calling thread.");
+
+    parser.addOption(channelsOption);
+    parser.addOption(samplesOption);
+    parser.addOption(blocksOption);
+    parser.addOption(sFreqOption);
+    parser.addOption(orderOption);
+    parser.addOption(noThreadsOption);
+
+    parser.process(a);
+
+    int iChannels = parser.value(channelsOption).toInt();
+    int iSamples = parser.value(samplesOption).toInt();
+    int iBlocks = parser.value(blocksOption).toInt();
+    double dSFreq = parser.value(sFreqOption).toDouble();
+    int iOrder = parser.value(orderOption).toInt();
+    bool bUseThreads = !parser.isSet(noThreadsOption);
+
+    if(iChannels <= 0 || iSamples < iOrder || iBlocks <= 0 || dSFreq <= 0.0) {
+        printf("Invalid arguments: the block length has to be at least the filter order.\n");
+        return 1;
+    }
+
+    // Band pass 1-40 Hz, the kernel is parametrized by the center frequency and the bandwidth
+    double dLowPass = 40.0;
+    double dHighPass = 1.0;
+    FilterKernel filterKernel("benchmark_kernel",
+                              FilterKernel::m_filterTypes.indexOf(FilterParameter("BPF")),
+                              iOrder,
+                              ((dLowPass + dHighPass) / 2.0) / (dSFreq / 2.0),
+                              (dLowPass - dHighPass) / (dSFreq / 2.0),
+                              1.0 / (dSFreq / 2.0),
+                              dSFreq,
+                              FilterKernel::m_designMethods.indexOf(FilterParameter("Cosine")));
+
+    MatrixXd matData = MatrixXd::Random(iChannels, iSamples);
+
+    printf("Filter benchmark: %d channels, %d samples per block, %d blocks, order %d, %s\n",
+           iChannels, iSamples, iBlocks, iOrder, bUseThreads ? "threaded" : "single threaded");
+
+    QElapsedTimer timer;
+    MatrixXd matPerChannel, matEngine;
+
+    // Existing per-channel path
+    timer.start();
+    for(int i = 0; i < iBlocks; ++i) {
+        matPerChannel = filterDataBlockPerChannel(matData, filterKernel, bUseThreads);
+    }
+    qint64 iPerChannel = timer.restart();
+
+    // Batched engine which keeps the kernel spectrum and the FFT plans between blocks
+    FilterFftEngine filterEngine(filterKernel);
+    for(int i = 0; i < iBlocks; ++i) {
+        matEngine = filterEngine.filterBlock(matData, RowVectorXi(), bUseThreads);
+    }
+    qint64 iEngine = timer.restart();
+
+    // filterDataBlock, which sets up a new engine per call
+    MatrixXd matDataBlock;
+    for(int i = 0; i < iBlocks; ++i) {
+        matDataBlock = filterDataBlock(matData, RowVectorXi(), filterKernel, bUseThreads);
+    }
+    qint64 iDataBlock = timer.restart();
+
+    double dSeconds = iBlocks * iSamples / dSFreq;
+
+    printf("%-22s %12s %12s %10s\n", "path", "time [ms]", "per block", "speedup");
+    printf("%-22s %12lld %12.3f %10.2f\n", "per-channel kernel", iPerChannel, double(iPerChannel) / iBlocks, 1.0);
+    printf("%-22s %12lld %12.3f %10.2f\n", "filterDataBlock", iDataBlock, double(iDataBlock) / iBlocks, iDataBlock > 0 ? double(iPerChannel) / iDataBlock : 0.0);
+    printf("%-22s %12lld %12.3f %10.2f\n", "FilterFftEngine", iEngine, double(iEngine) / iBlocks, iEngine > 0 ? double(iPerChannel) / iEngine : 0.0);
+    printf("Filtered %.1f s of data, real-time factor of the engine: %.1f\n", dSeconds, iEngine > 0 ? 1000.0 * dSeconds / iEngine : 0.0);
+
+    printf("Max. difference engine vs. per-channel         : %g\n", (matEngine - matPerChannel).cwiseAbs().maxCoeff());
+    printf("Max. difference filterDataBlock vs. per-channel: %g\n", (matDataBlock - matPerChannel).cwiseAbs().maxCoeff());
+
+    return 0;
+}
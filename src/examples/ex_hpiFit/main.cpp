@@ -45,6 +45,7 @@
 
 #include <inverse/hpiFit/hpifit.h>
 #include <inverse/hpiFit/hpidataupdater.h>
+#include <inverse/hpiFit/hpipositiontracker.h>
 
 #include <utils/ioutils.h>
 #include <utils/generics/applicationlogger.h>
@@ -85,6 +86,10 @@ using namespace Eigen;
  *
  * ex_hpiFit --fileIn C:/Git/mne-cpp/bin/MNE-sample-data/chpi/raw/phantom/2khz_3.fif --freqs 293,307,314,321 --verbose 1 --fileOut 2k_3 --buffer 600 --save 1
  *
+ * Run once with --lm 0 and once with --lm 1 to compare the average duration of the simplex and the Levenberg-Marquardt fitter.
+ *
+ * Run with --batch 1 to estimate the head positions of the whole recording in parallel and write them to a MaxFilter-like .pos file.
+ *
  * By default, the example uses the resources/data/mne-cpp-test-data set.
  *
  */
@@ -108,6 +113,9 @@ int main(int argc, char *argv[])
     QCommandLineOption inSave("save", "Store the fitting results [0,1].", "in","0");
     QCommandLineOption inVerbose("verbose", "Print to command line [0,1].", "in","1");
     QCommandLineOption inFast("fast", "Do fast fits [0,1].", "in","0");
+    QCommandLineOption inLM("lm", "Use the Levenberg-Marquardt fitter with warm start instead of the simplex fitter [0,1].", "in","0");
+    QCommandLineOption inBatch("batch", "Estimate the head positions of the whole recording in parallel and write them to fileOut [0,1].", "in","0");
+    QCommandLineOption inThreads("threads", "The number of threads used in batch mode, 0 uses all cores.", "in","0");
     QCommandLineOption outName("fileOut", "The output file name for movement data.", "out","position.txt");
 
     parser.addOption(inFile);
@@ -117,6 +125,9 @@ int main(int argc, char *argv[])
     parser.addOption(inSave);
     parser.addOption(inVerbose);
     parser.addOption(inFast);
+    parser.addOption(inLM);
+    parser.addOption(inBatch);
+    parser.addOption(inThreads);
     parser.addOption(outName);
 
     parser.process(a);
@@ -138,6 +149,9 @@ int main(int argc, char *argv[])
     bool bSave = parser.value(inSave).toInt();
     bool bVerbose = parser.value(inVerbose).toInt();
     bool bFast = parser.value(inFast).toInt();
+    bool bLM = parser.value(inLM).toInt();
+    bool bBatch = parser.value(inBatch).toInt();
+    int iThreads = parser.value(inThreads).toInt();
     QString sNameOut(parser.value(outName));
 
     // Init data loading and writing
@@ -197,11 +211,38 @@ int main(int argc, char *argv[])
         matProjectors.col(infoTemp.ch_names.indexOf(infoTemp.bads.at(j))).setZero();
     }
 
+    if(bBatch) {
+        HpiPositionTracker tracker(vecFreqs, fWindow, fStep, bFast);
+        tracker.setNumThreads(iThreads);
+
+        timer.start();
+        if(!tracker.computeHeadPositions(raw, matProjectors, matPosition)) {
+            qCritical("error during computeHeadPositions");
+            return -1;
+        }
+        float fDuration = timer.elapsed() / 1000.0f;
+        float fRecording = (last - first + 1) / pFiffInfo->sfreq;
+
+        qInfo() << "Windows:" << matPosition.rows()
+                << "Average GoF:" << matPosition.col(7).mean() * 100 << "%"
+                << "Average Error:" << matPosition.col(8).mean() * 1000 << "mm"
+                << "Duration:" << fDuration << "s"
+                << "Real-time factor:" << fRecording / fDuration;
+
+        if(!HpiPositionTracker::writeHeadPositions(sNameOut, matPosition)) {
+            return -1;
+        }
+        return 0;
+    }
+
     // if debugging files are necessary set bDoDebug = true;
     QString sHPIResourceDir = QCoreApplication::applicationDirPath() + "/HPIFittingDebug";
 
     HpiDataUpdater hpiDataUpdater = HpiDataUpdater(pFiffInfo);
     HPIFit HPI = HPIFit(hpiDataUpdater.getSensors());
+    if(bLM) {
+        HPI.setFitMethod(HpiFitMethod::levenbergMarquardt);
+    }
 
     MatrixXd matAmplitudes;
     MatrixXd matCoilLoc(4,3);
@@ -0,0 +1,442 @@
+//=============================================================================================================
+/**
+ * @file     rtbuffercodec.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the RtBufferCodec Class.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtbuffercodec.h"
+
+#include <fiff/fiff_info.h>
+
+#include <cmath>
+#include <string.h>
+#include <vector>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace COMMUNICATIONLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+const int       HEADER_SIZE = 3 * sizeof(qint32);   /**< Calibration id, number of channels, number of samples. */
+const quint32   RICE_ESCAPE = 24;                   /**< Quotients from here on are escaped with the verbatim value. */
+const int       MODE_DAU = 0;                       /**< Channel is coded as calibrated integers. */
+const int       MODE_FLOAT = 1;                     /**< Channel is coded as float bit patterns. */
+
+//=============================================================================================================
+
+/**
+ * Writes bit fields LSB first.
+ */
+class BitWriter
+{
+public:
+    explicit BitWriter(QByteArray& baOut)
+    : m_baOut(baOut)
+    , m_iAcc(0)
+    , m_iBits(0)
+    {
+    }
+
+    inline void put(quint32 iValue, int iBits)
+    {
+        m_iAcc |= static_cast<quint64>(iValue) << m_iBits;
+        m_iBits += iBits;
+        while(m_iBits >= 8) {
+            m_baOut.append(static_cast<char>(m_iAcc & 0xFF));
+            m_iAcc >>= 8;
+            m_iBits -= 8;
+        }
+    }
+
+    inline void putRice(quint32 iValue, int k)
+    {
+        quint32 q = iValue >> k;
+        if(q < RICE_ESCAPE) {
+            put((1u << q) - 1, q + 1);
+            if(k > 0) {
+                put(iValue & ((1u << k) - 1), k);
+            }
+        } else {
+            put((1u << RICE_ESCAPE) - 1, RICE_ESCAPE);
+            put(iValue, 32);
+        }
+    }
+
+    inline void flush()
+    {
+        if(m_iBits > 0) {
+            m_baOut.append(static_cast<char>(m_iAcc & 0xFF));
+        }
+        m_iAcc = 0;
+        m_iBits = 0;
+    }
+
+private:
+    QByteArray& m_baOut;
+    quint64     m_iAcc;
+    int         m_iBits;
+};
+
+//=============================================================================================================
+
+/**
+ * Reads bit fields LSB first. Reading beyond the end sets the overrun flag.
+ */
+class BitReader
+{
+public:
+    BitReader(const uchar* pData, int iSize)
+    : m_pData(pData)
+    , m_pEnd(pData + iSize)
+    , m_iAcc(0)
+    , m_iBits(0)
+    , m_bOverrun(false)
+    {
+    }
+
+    inline quint32 get(int iBits)
+    {
+        while(m_iBits < iBits) {
+            if(m_pData < m_pEnd) {
+                m_iAcc |= static_cast<quint64>(*m_pData++) << m_iBits;
+            } else {
+                m_bOverrun = true;
+            }
+            m_iBits += 8;
+        }
+        quint32 iValue = static_cast<quint32>(m_iAcc & ((static_cast<quint64>(1) << iBits) - 1));
+        m_iAcc >>= iBits;
+        m_iBits -= iBits;
+        return iValue;
+    }
+
+    inline quint32 getRice(int k)
+    {
+        quint32 q = 0;
+        while(q < RICE_ESCAPE && get(1) && !m_bOverrun) {
+            ++q;
+        }
+        if(q == RICE_ESCAPE) {
+            return get(32);
+        }
+        return k > 0 ? (q << k) | get(k) : q;
+    }
+
+    inline bool overrun() const
+    {
+        return m_bOverrun;
+    }
+
+private:
+    const uchar*    m_pData;
+    const uchar*    m_pEnd;
+    quint64         m_iAcc;
+    int             m_iBits;
+    bool            m_bOverrun;
+};
+
+//=============================================================================================================
+
+inline quint32 floatBits(float fValue)
+{
+    quint32 iBits;
+    memcpy(&iBits, &fValue, sizeof(iBits));
+    return iBits;
+}
+
+//=============================================================================================================
+
+inline float bitsToFloat(quint32 iBits)
+{
+    float fValue;
+    memcpy(&fValue, &iBits, sizeof(fValue));
+    return fValue;
+}
+
+//=============================================================================================================
+
+inline quint32 predict(const quint32* pSamples, int j, int iOrder)
+{
+    // Wrapping unsigned arithmetic keeps the prediction exactly invertible
+    if(iOrder == 0 || j == 0) {
+        return 0;
+    }
+    if(iOrder == 1 || j == 1) {
+        return pSamples[j-1];
+    }
+    return 2u * pSamples[j-1] - pSamples[j-2];
+}
+
+//=============================================================================================================
+
+inline quint32 zigzag(quint32 iResidual)
+{
+    return (iResidual << 1) ^ static_cast<quint32>(static_cast<qint32>(iResidual) >> 31);
+}
+
+//=============================================================================================================
+
+inline quint32 unzigzag(quint32 iValue)
+{
+    return (iValue >> 1) ^ (0u - (iValue & 1u));
+}
+
+//=============================================================================================================
+
+/**
+ * Converts the samples of one channel to calibrated integers if this reproduces them bitwise.
+ */
+bool toDau(const float* pData, Index iStride, int iSamples, double dCal, quint32* pSamples)
+{
+    if(!(dCal != 0.0 && std::isfinite(dCal))) {
+        return false;
+    }
+
+    for(int j = 0; j < iSamples; ++j) {
+        const float fValue = pData[j * iStride];
+        const double dDau = std::nearbyint(static_cast<double>(fValue) / dCal);
+
+        if(!(std::fabs(dDau) < 2147483647.0)) {
+            return false;
+        }
+
+        const qint32 iDau = static_cast<qint32>(dDau);
+        if(floatBits(static_cast<float>(static_cast<double>(iDau) * dCal)) != floatBits(fValue)) {
+            return false;
+        }
+
+        pSamples[j] = static_cast<quint32>(iDau);
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+quint32 checksum(const VectorXd& vecCals)
+{
+    // FNV-1a over the little endian representation, identical on all hosts
+    quint32 iHash = 2166136261u;
+    for(Index i = 0; i < vecCals.size(); ++i) {
+        quint64 iBits;
+        const double dCal = vecCals[i];
+        memcpy(&iBits, &dCal, sizeof(iBits));
+        for(int b = 0; b < 8; ++b) {
+            iHash ^= static_cast<quint32>((iBits >> (8 * b)) & 0xFF);
+            iHash *= 16777619u;
+        }
+    }
+    return iHash;
+}
+
+} // namespace
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RtBufferCodec::RtBufferCodec()
+: m_iCalibrationId(checksum(m_vecCals))
+{
+}
+
+//=============================================================================================================
+
+RtBufferCodec::RtBufferCodec(const VectorXd& vecCals)
+: m_vecCals(vecCals)
+, m_iCalibrationId(checksum(vecCals))
+{
+}
+
+//=============================================================================================================
+
+VectorXd RtBufferCodec::calibrationsFromInfo(const FiffInfo& info)
+{
+    VectorXd vecCals(info.chs.size());
+    for(int k = 0; k < info.chs.size(); ++k) {
+        vecCals[k] = info.chs[k].range*info.chs[k].cal;
+    }
+    return vecCals;
+}
+
+//=============================================================================================================
+
+const VectorXd& RtBufferCodec::getCalibrations() const
+{
+    return m_vecCals;
+}
+
+//=============================================================================================================
+
+quint32 RtBufferCodec::getCalibrationId() const
+{
+    return m_iCalibrationId;
+}
+
+//=============================================================================================================
+
+QByteArray RtBufferCodec::encode(const MatrixXf& matData) const
+{
+    const int iChannels = static_cast<int>(matData.rows());
+    const int iSamples = static_cast<int>(matData.cols());
+
+    QByteArray baOut;
+    baOut.reserve(HEADER_SIZE + iChannels * iSamples * 2);
+    baOut.resize(HEADER_SIZE);
+    qToLittleEndian<quint32>(m_iCalibrationId, reinterpret_cast<uchar*>(baOut.data()));
+    qToLittleEndian<qint32>(iChannels, reinterpret_cast<uchar*>(baOut.data()) + 4);
+    qToLittleEndian<qint32>(iSamples, reinterpret_cast<uchar*>(baOut.data()) + 8);
+
+    BitWriter writer(baOut);
+    std::vector<quint32> vecSamples(iSamples);
+    quint32* pSamples = vecSamples.data();
+
+    for(int i = 0; i < iChannels; ++i) {
+        const float* pChannel = matData.data() + i;
+
+        int iMode = MODE_DAU;
+        if(i >= m_vecCals.size() || !toDau(pChannel, iChannels, iSamples, m_vecCals[i], pSamples)) {
+            iMode = MODE_FLOAT;
+            for(int j = 0; j < iSamples; ++j) {
+                pSamples[j] = floatBits(pChannel[j * iChannels]);
+            }
+        }
+
+        // Pick the predictor with the smallest residuals
+        quint64 iSum[3] = {0, 0, 0};
+        for(int j = 0; j < iSamples; ++j) {
+            for(int iOrder = 0; iOrder < 3; ++iOrder) {
+                iSum[iOrder] += zigzag(pSamples[j] - predict(pSamples, j, iOrder));
+            }
+        }
+        int iOrder = 0;
+        for(int o = 1; o < 3; ++o) {
+            if(iSum[o] < iSum[iOrder]) {
+                iOrder = o;
+            }
+        }
+
+        // Rice parameter from the mean residual
+        int k = 0;
+        while(k < 31 && (static_cast<quint64>(iSamples) << (k + 1)) <= iSum[iOrder]) {
+            ++k;
+        }
+
+        writer.put(static_cast<quint32>(iMode | (iOrder << 1) | (k << 3)), 8);
+        for(int j = 0; j < iSamples; ++j) {
+            writer.putRice(zigzag(pSamples[j] - predict(pSamples, j, iOrder)), k);
+        }
+    }
+    writer.flush();
+
+    return baOut;
+}
+
+//=============================================================================================================
+
+bool RtBufferCodec::decode(const QByteArray& baData,
+                           MatrixXf& matData) const
+{
+    if(baData.size() < HEADER_SIZE) {
+        return false;
+    }
+
+    const uchar* pData = reinterpret_cast<const uchar*>(baData.constData());
+    const quint32 iCalibrationId = qFromLittleEndian<quint32>(pData);
+    const qint32 iChannels = qFromLittleEndian<qint32>(pData + 4);
+    const qint32 iSamples = qFromLittleEndian<qint32>(pData + 8);
+
+    if(iChannels < 0 || iSamples < 0) {
+        return false;
+    }
+
+    matData.resize(iChannels, iSamples);
+
+    BitReader reader(pData + HEADER_SIZE, baData.size() - HEADER_SIZE);
+    std::vector<quint32> vecSamples(iSamples);
+    quint32* pSamples = vecSamples.data();
+
+    for(int i = 0; i < iChannels; ++i) {
+        const quint32 iChannelHeader = reader.get(8);
+        const int iMode = iChannelHeader & 1;
+        const int iOrder = (iChannelHeader >> 1) & 3;
+        const int k = static_cast<int>(iChannelHeader >> 3);
+
+        if(iOrder > 2 || reader.overrun()) {
+            return false;
+        }
+
+        for(int j = 0; j < iSamples; ++j) {
+            pSamples[j] = unzigzag(reader.getRice(k)) + predict(pSamples, j, iOrder);
+        }
+
+        if(reader.overrun()) {
+            return false;
+        }
+
+        float* pChannel = matData.data() + i;
+        if(iMode == MODE_DAU) {
+            // Integer channels can only be restored with the calibrations they were coded with
+            if(iCalibrationId != m_iCalibrationId || i >= m_vecCals.size()) {
+                return false;
+            }
+            const double dCal = m_vecCals[i];
+            for(int j = 0; j < iSamples; ++j) {
+                pChannel[j * iChannels] = static_cast<float>(static_cast<double>(static_cast<qint32>(pSamples[j])) * dCal);
+            }
+        } else {
+            for(int j = 0; j < iSamples; ++j) {
+                pChannel[j * iChannels] = bitsToFloat(pSamples[j]);
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,157 @@
+//=============================================================================================================
+/**
+ * @file     rtbuffercodec.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the RtBufferCodec Class.
+ *
+ */
+
+#ifndef RTBUFFERCODEC_H
+#define RTBUFFERCODEC_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../communication_global.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QByteArray>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+namespace FIFFLIB {
+    class FiffInfo;
+}
+
+//=============================================================================================================
+// DEFINE NAMESPACE COMMUNICATIONLIB
+//=============================================================================================================
+
+namespace COMMUNICATIONLIB
+{
+
+//=============================================================================================================
+/**
+ * Lossless codec for raw buffers of the real-time protocol. Channels whose samples are calibrated integers
+ * (range * cal * DAU) are coded as integers, all other channels as the bit patterns of their float samples. Each
+ * channel is predicted with a fixed polynomial predictor of order 0, 1 or 2 and the residuals are Rice coded.
+ * Every buffer is self-contained, so dropping buffers for slow clients does not break the stream. The
+ * calibrations are sent once per measurement, buffers only carry the id of the calibrations they were coded with.
+ *
+ * @brief Lossless compression of raw buffers.
+ */
+class COMMUNICATIONSHARED_EXPORT RtBufferCodec
+{
+public:
+    typedef QSharedPointer<RtBufferCodec> SPtr;               /**< Shared pointer type for RtBufferCodec. */
+    typedef QSharedPointer<const RtBufferCodec> ConstSPtr;    /**< Const shared pointer type for RtBufferCodec. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a RtBufferCodec without calibrations. All channels are coded as float bit patterns.
+     */
+    RtBufferCodec();
+
+    //=========================================================================================================
+    /**
+     * Constructs a RtBufferCodec.
+     *
+     * @param[in] vecCals    The calibration (range * cal) of every channel.
+     */
+    explicit RtBufferCodec(const Eigen::VectorXd& vecCals);
+
+    //=========================================================================================================
+    /**
+     * Returns the calibrations (range * cal) of all channels in the measurement info, computed the same way
+     * the raw data reader applies them.
+     *
+     * @param[in] info   The measurement info.
+     *
+     * @return the calibrations.
+     */
+    static Eigen::VectorXd calibrationsFromInfo(const FIFFLIB::FiffInfo& info);
+
+    //=========================================================================================================
+    /**
+     * Returns the calibrations of this codec.
+     *
+     * @return the calibrations.
+     */
+    const Eigen::VectorXd& getCalibrations() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the id of the calibrations, which is stored in every encoded buffer.
+     *
+     * @return the calibration id.
+     */
+    quint32 getCalibrationId() const;
+
+    //=========================================================================================================
+    /**
+     * Encodes a raw buffer.
+     *
+     * @param[in] matData    The raw buffer (channels x samples).
+     *
+     * @return the encoded buffer.
+     */
+    QByteArray encode(const Eigen::MatrixXf& matData) const;
+
+    //=========================================================================================================
+    /**
+     * Decodes a raw buffer. The decoded samples are bitwise identical to the encoded ones.
+     *
+     * @param[in] baData     The encoded buffer.
+     * @param[out] matData   The raw buffer (channels x samples).
+     *
+     * @return true if the buffer was decoded, false if it is corrupt or was coded with other calibrations.
+     */
+    bool decode(const QByteArray& baData,
+                Eigen::MatrixXf& matData) const;
+
+private:
+    Eigen::VectorXd     m_vecCals;              /**< The calibration (range * cal) of every channel. */
+    quint32             m_iCalibrationId;       /**< Checksum of the calibrations. */
+};
+} // NAMESPACE
+
+#endif // RTBUFFERCODEC_H
@@ -209,6 +209,38 @@ qint32 RtCmdClient::requestBufsize()
 
 //=============================================================================================================
 
+QString RtCmdClient::requestSharedMemory(qint32 p_iClientId)
+{
+    //Older servers do not offer a shared memory transport
+    if(!hasCommand("shmem"))
+        return QString();
+
+    //Send
+    m_commandManager["shmem"].pValues()[0].setValue(p_iClientId);
+    m_commandManager["shmem"].send();
+
+    //Receive
+    m_qMutex.lock();
+    QByteArray t_sJsonShmem = m_sAvailableData.toUtf8();
+    m_qMutex.unlock();
+
+    //Parse
+    QJsonParseError error;
+    QJsonDocument t_jsonDocumentOrigin = QJsonDocument::fromJson(t_sJsonShmem, &error);
+
+    if (error.error == QJsonParseError::NoError
+        && t_jsonDocumentOrigin.isObject()
+        && t_jsonDocumentOrigin.object().value(QString("shmem")) != QJsonValue::Undefined)
+    {
+        return t_jsonDocumentOrigin.object().value(QString("shmem")).toString();
+    }
+
+    qWarning() << "[RtCmdClient::requestSharedMemory] Unable to parse JSON response: " << error.errorString();
+    return QString();
+}
+
+//=============================================================================================================
+
 void RtCmdClient::requestCommands()
 {
     //No commands are present -> thats why help has to be send using a self created command
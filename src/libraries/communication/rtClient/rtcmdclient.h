@@ -144,6 +144,17 @@ public:
      */
     qint32 requestConnectors(QMap<qint32, QString> &p_qMapConnectors);
 
+    //=========================================================================================================
+    /**
+     * Request a shared memory transport for a data client from mne_rt_server. This only succeeds if the server
+     * runs on the same host, see RtDataClient::attachSharedMemory.
+     *
+     * @param[in] p_iClientId    The id of the data client.
+     *
+     * @return the key of the shared memory ring, an empty string if the TCP connection has to be used.
+     */
+    QString requestSharedMemory(qint32 p_iClientId);
+
     //=========================================================================================================
     /**
      * Wait for ready read until data are available.
@@ -56,6 +56,7 @@ using namespace Eigen;
 RtDataClient::RtDataClient(QObject *parent)
 : QTcpSocket(parent)
 , m_clientID(-1)
+, m_bReadSharedMemory(false)
 {
     getClientId();
 }
@@ -64,6 +65,7 @@ RtDataClient::RtDataClient(QObject *parent)
 
 void RtDataClient::disconnectFromHost()
 {
+    detachSharedMemory();
     QTcpSocket::disconnectFromHost();
     m_clientID = -1;
 }
@@ -657,6 +659,22 @@ void RtDataClient::readRawBuffer(qint32 p_nChannels,
                                  MatrixXf& data,
                                  fiff_int_t& kind)
 {
+    if(m_pSharedMemoryRing && m_bReadSharedMemory)
+    {
+        if(m_pSharedMemoryRing->read(p_nChannels, data, kind))
+            return;
+
+        if(m_pSharedMemoryRing->isWriterAttached())
+        {
+            // No buffer arrived yet
+            kind = -1;
+            return;
+        }
+
+        qWarning() << "[RtDataClient::readRawBuffer] mne_rt_server closed the shared memory transport. Falling back to TCP.";
+        detachSharedMemory();
+    }
+
     FiffStream t_fiffStream(this);
     //
     // Find the start
@@ -665,19 +683,86 @@ void RtDataClient::readRawBuffer(qint32 p_nChannels,
 
     t_fiffStream.read_rt_tag(t_pTag);
 
+    // Calibrations are sent once before the first compressed buffer
+    while(t_pTag->kind == FIFF_MNE_RT_CALIBRATIONS)
+    {
+        qint32 nCals = t_pTag->size()/8;
+        m_bufferCodec = RtBufferCodec(VectorXd(Map<VectorXd>(t_pTag->toDouble(), nCals)));
+        t_fiffStream.read_rt_tag(t_pTag);
+    }
+
     kind = t_pTag->kind;
 
-    if(kind == FIFF_DATA_BUFFER)
+    if(kind == FIFF_MNE_RT_SHARED_MEMORY)
+    {
+        // All raw buffers which were sent via TCP before the switch are read at this point
+        m_bReadSharedMemory = m_pSharedMemoryRing && *t_pTag->toInt() != 0;
+        kind = -1;
+    }
+    else if(kind == FIFF_DATA_BUFFER)
     {
         qint32 nSamples = (t_pTag->size()/4)/p_nChannels;
         data = MatrixXf(Map< MatrixXf >(t_pTag->toFloat(), p_nChannels, nSamples));
     }
+    else if(kind == FIFF_MNE_RT_COMPRESSED_BUFFER)
+    {
+        if(m_bufferCodec.decode(*t_pTag, data) && data.rows() == p_nChannels)
+        {
+            kind = FIFF_DATA_BUFFER;
+        }
+        else
+        {
+            qWarning() << "[RtDataClient::readRawBuffer] Unable to decode compressed raw buffer. Skipping it.";
+            kind = -1;
+        }
+    }
 //        else
 //            data = tag.data;
 }
 
 //=============================================================================================================
 
+bool RtDataClient::attachSharedMemory(const QString &p_sKey)
+{
+    detachSharedMemory();
+
+    if(p_sKey.isEmpty())
+        return false;
+
+    RtSharedMemoryRing::SPtr t_pRing(new RtSharedMemoryRing);
+    if(!t_pRing->attach(p_sKey))
+        return false;
+
+    m_pSharedMemoryRing = t_pRing;
+    return true;
+}
+
+//=============================================================================================================
+
+void RtDataClient::detachSharedMemory()
+{
+    m_pSharedMemoryRing.clear();
+    m_bReadSharedMemory = false;
+}
+
+//=============================================================================================================
+
+bool RtDataClient::isUsingSharedMemory() const
+{
+    return !m_pSharedMemoryRing.isNull() && m_bReadSharedMemory;
+}
+
+//=============================================================================================================
+
+void RtDataClient::requestCompression(bool p_bEnable)
+{
+    FiffStream t_fiffStream(this);
+    t_fiffStream.write_rt_command(3, QString(p_bEnable ? "1" : "0"));//MNE_RT.MNE_RT_SET_COMPRESSION
+    this->flush();
+}
+
+//=============================================================================================================
+
 void RtDataClient::setClientAlias(const QString &p_sAlias)
 {
     FiffStream t_fiffStream(this);
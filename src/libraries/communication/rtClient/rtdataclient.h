@@ -42,6 +42,8 @@
 //=============================================================================================================
 
 #include "../communication_global.h"
+#include "rtsharedmemoryring.h"
+#include "rtbuffercodec.h"
 
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_info.h>
@@ -135,7 +137,11 @@ public:
 
     //=========================================================================================================
     /**
-     * Reads fiff measurement information of a data the connection
+     * Reads the next raw buffer. If a shared memory transport is attached, the raw buffers are read via TCP until
+     * mne_rt_server announces the switch to the ring with a FIFF_MNE_RT_SHARED_MEMORY tag, for which kind is set
+     * to -1. Afterwards the buffer is read from the shared memory ring and kind is set to -1 if no buffer arrived
+     * within 100 ms. Once mne_rt_server closes the ring, the client falls back to the TCP connection. Compressed buffers are decoded and returned with kind
+     * FIFF_DATA_BUFFER, buffers which cannot be decoded are returned with kind -1.
      *
      * @param[in] p_nChannels    Number of channels to reshape the received data.
      * @param[out] data          The read data - ToDo change this to raw buffer data object.
@@ -153,8 +159,47 @@ public:
      */
     void setClientAlias(const QString &p_sAlias);
 
+    //=========================================================================================================
+    /**
+     * Requests lossless compression of the raw buffers sent to this client. Servers which do not support
+     * compression ignore the request and keep sending uncompressed buffers, which are read as before.
+     *
+     * @param[in] p_bEnable  Whether raw buffers should be compressed.
+     */
+    void requestCompression(bool p_bEnable = true);
+
+    //=========================================================================================================
+    /**
+     * Attaches to the shared memory ring which mne_rt_server created for this client, see
+     * RtCmdClient::requestSharedMemory. mne_rt_server switches the raw buffers to the ring once it noticed the
+     * attached reader, if it does not notice it in time the raw buffers keep coming via TCP.
+     *
+     * @param[in] p_sKey     The key of the shared memory ring.
+     *
+     * @return true if the ring is available on this host, false if the TCP connection is used.
+     */
+    bool attachSharedMemory(const QString &p_sKey);
+
+    //=========================================================================================================
+    /**
+     * Detaches from the shared memory ring. mne_rt_server falls back to the TCP connection.
+     */
+    void detachSharedMemory();
+
+    //=========================================================================================================
+    /**
+     * Returns whether raw buffers are read from a shared memory ring.
+     *
+     * @return true if the shared memory transport is used.
+     */
+    bool isUsingSharedMemory() const;
+
 private:
     qint32 m_clientID;  /**< Corresponding client id of the data client at mne_rt_server. */
+
+    RtSharedMemoryRing::SPtr m_pSharedMemoryRing;   /**< The same-host transport for raw buffers, if negotiated. */
+    bool m_bReadSharedMemory;                       /**< Whether mne_rt_server switched the raw buffers to the ring. */
+    RtBufferCodec m_bufferCodec;                    /**< Decodes compressed raw buffers with the calibrations sent by the server. */
     
 };
 } // NAMESPACE
@@ -0,0 +1,346 @@
+//=============================================================================================================
+/**
+ * @file     rtsharedmemoryring.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the RtSharedMemoryRing Class.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtsharedmemoryring.h"
+
+#include <fiff/fiff_file.h>
+#include <fiff/fiff_constants.h>
+
+#include <atomic>
+#include <new>
+#include <string.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <QDebug>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace COMMUNICATIONLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+const quint32       RING_MAGIC = 0x4D4E4552;        /**< 'MNER', also identifies the byte order of the writer. */
+const quint32       RING_VERSION = 1;               /**< Version of the ring layout. */
+const qint32        RING_PADDING_KIND = -1;         /**< Kind of the record which fills the end of the ring before a wrap. */
+const qint64        RECORD_HEADER_SIZE = 4 * sizeof(qint32);   /**< FIFF tag header: kind, type, size, next. */
+const int           SPIN_COUNT = 1000;              /**< Polls before the reader starts to sleep. */
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared memory ring requires lock free 64 bit atomics.");
+
+//=============================================================================================================
+
+inline qint64 alignRecord(qint64 iSize)
+{
+    return (iSize + 7) & ~qint64(7);
+}
+
+}
+
+namespace COMMUNICATIONLIB {
+
+//=============================================================================================================
+/**
+ * Header at the beginning of the shared memory segment. The indices are monotonically increasing byte counters.
+ */
+struct RtSharedMemoryRingHeader {
+    quint32                             iMagic;             /**< RING_MAGIC. */
+    quint32                             iVersion;           /**< RING_VERSION. */
+    quint64                             iCapacity;          /**< Number of bytes available for records. */
+    alignas(64) std::atomic<quint64>    iWriteIndex;        /**< Written bytes, only modified by the writer. */
+    alignas(64) std::atomic<quint64>    iReadIndex;         /**< Read bytes, only modified by the reader. */
+    alignas(64) std::atomic<quint32>    iWriterAttached;    /**< Whether the writer is attached. */
+    std::atomic<quint32>                iReaderAttached;    /**< Whether the reader is attached. */
+    std::atomic<quint32>                iReaderDetached;    /**< Whether a reader attached and detached again. */
+};
+
+}
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RtSharedMemoryRing::RtSharedMemoryRing()
+: m_pHeader(Q_NULLPTR)
+, m_pRecords(Q_NULLPTR)
+, m_bIsWriter(false)
+{
+}
+
+//=============================================================================================================
+
+RtSharedMemoryRing::~RtSharedMemoryRing()
+{
+    detach();
+}
+
+//=============================================================================================================
+
+bool RtSharedMemoryRing::create(const QString& sKey,
+                                qint64 iCapacity)
+{
+    detach();
+
+    iCapacity = alignRecord(iCapacity);
+
+    m_sharedMemory.setKey(sKey);
+    if(!m_sharedMemory.create(sizeof(RtSharedMemoryRingHeader) + iCapacity)) {
+        qWarning() << "[RtSharedMemoryRing::create] Could not create shared memory" << sKey << ":" << m_sharedMemory.errorString();
+        return false;
+    }
+
+    m_pHeader = new (m_sharedMemory.data()) RtSharedMemoryRingHeader;
+    m_pHeader->iMagic = RING_MAGIC;
+    m_pHeader->iVersion = RING_VERSION;
+    m_pHeader->iCapacity = iCapacity;
+    m_pHeader->iWriteIndex.store(0, std::memory_order_relaxed);
+    m_pHeader->iReadIndex.store(0, std::memory_order_relaxed);
+    m_pHeader->iReaderAttached.store(0, std::memory_order_relaxed);
+    m_pHeader->iReaderDetached.store(0, std::memory_order_relaxed);
+    m_pHeader->iWriterAttached.store(1, std::memory_order_release);
+
+    m_pRecords = static_cast<char*>(m_sharedMemory.data()) + sizeof(RtSharedMemoryRingHeader);
+    m_bIsWriter = true;
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool RtSharedMemoryRing::attach(const QString& sKey)
+{
+    detach();
+
+    m_sharedMemory.setKey(sKey);
+    if(!m_sharedMemory.attach()) {
+        qWarning() << "[RtSharedMemoryRing::attach] Could not attach to shared memory" << sKey << ":" << m_sharedMemory.errorString();
+        return false;
+    }
+
+    RtSharedMemoryRingHeader* pHeader = static_cast<RtSharedMemoryRingHeader*>(m_sharedMemory.data());
+
+    if(m_sharedMemory.size() < static_cast<int>(sizeof(RtSharedMemoryRingHeader))
+       || pHeader->iMagic != RING_MAGIC
+       || pHeader->iVersion != RING_VERSION
+       || m_sharedMemory.size() < static_cast<qint64>(sizeof(RtSharedMemoryRingHeader) + pHeader->iCapacity)) {
+        qWarning() << "[RtSharedMemoryRing::attach] Shared memory" << sKey << "has an incompatible layout.";
+        m_sharedMemory.detach();
+        return false;
+    }
+
+    m_pHeader = pHeader;
+    m_pRecords = static_cast<char*>(m_sharedMemory.data()) + sizeof(RtSharedMemoryRingHeader);
+    m_bIsWriter = false;
+
+    m_pHeader->iReaderAttached.store(1, std::memory_order_release);
+
+    return true;
+}
+
+//=============================================================================================================
+
+void RtSharedMemoryRing::detach()
+{
+    if(m_pHeader) {
+        if(m_bIsWriter) {
+            m_pHeader->iWriterAttached.store(0, std::memory_order_release);
+        } else {
+            m_pHeader->iReaderAttached.store(0, std::memory_order_release);
+            m_pHeader->iReaderDetached.store(1, std::memory_order_release);
+        }
+    }
+
+    m_pHeader = Q_NULLPTR;
+    m_pRecords = Q_NULLPTR;
+
+    if(m_sharedMemory.isAttached()) {
+        m_sharedMemory.detach();
+    }
+}
+
+//=============================================================================================================
+
+bool RtSharedMemoryRing::isAttached() const
+{
+    return m_pHeader != Q_NULLPTR;
+}
+
+//=============================================================================================================
+
+QString RtSharedMemoryRing::getKey() const
+{
+    return m_sharedMemory.key();
+}
+
+//=============================================================================================================
+
+bool RtSharedMemoryRing::isWriterAttached() const
+{
+    return m_pHeader && m_pHeader->iWriterAttached.load(std::memory_order_acquire) != 0;
+}
+
+//=============================================================================================================
+
+bool RtSharedMemoryRing::isReaderAttached() const
+{
+    return m_pHeader && m_pHeader->iReaderAttached.load(std::memory_order_acquire) != 0;
+}
+
+//=============================================================================================================
+
+bool RtSharedMemoryRing::isReaderDetached() const
+{
+    return m_pHeader && m_pHeader->iReaderDetached.load(std::memory_order_acquire) != 0;
+}
+
+//=============================================================================================================
+
+bool RtSharedMemoryRing::write(fiff_int_t kind,
+                               const float* pData,
+                               qint32 iNumElements)
+{
+    if(!m_pHeader || !m_bIsWriter) {
+        return false;
+    }
+
+    const quint64 iCapacity = m_pHeader->iCapacity;
+    const qint64 iDataSize = static_cast<qint64>(iNumElements) * sizeof(float);
+    const quint64 iRecordSize = alignRecord(RECORD_HEADER_SIZE + iDataSize);
+
+    if(iRecordSize > iCapacity) {
+        return false;
+    }
+
+    quint64 iWrite = m_pHeader->iWriteIndex.load(std::memory_order_relaxed);
+    const quint64 iRead = m_pHeader->iReadIndex.load(std::memory_order_acquire);
+
+    // Records are never split, the end of the ring is skipped if the record does not fit anymore
+    quint64 iPos = iWrite % iCapacity;
+    const quint64 iTail = iCapacity - iPos;
+    const quint64 iSkip = iTail < iRecordSize ? iTail : 0;
+
+    if(iCapacity - (iWrite - iRead) < iRecordSize + iSkip) {
+        return false;
+    }
+
+    if(iSkip > 0) {
+        qint32* pPadding = reinterpret_cast<qint32*>(m_pRecords + iPos);
+        pPadding[0] = RING_PADDING_KIND;
+        iWrite += iSkip;
+        iPos = 0;
+    }
+
+    qint32* pRecord = reinterpret_cast<qint32*>(m_pRecords + iPos);
+    pRecord[0] = kind;
+    pRecord[1] = FIFFT_FLOAT;
+    pRecord[2] = static_cast<qint32>(iDataSize);
+    pRecord[3] = FIFFV_NEXT_SEQ;
+    memcpy(pRecord + 4, pData, iDataSize);
+
+    m_pHeader->iWriteIndex.store(iWrite + iRecordSize, std::memory_order_release);
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool RtSharedMemoryRing::read(qint32 iNumChannels,
+                              MatrixXf& data,
+                              fiff_int_t& kind,
+                              int iMSecsTimeout)
+{
+    if(!m_pHeader || m_bIsWriter || iNumChannels <= 0) {
+        return false;
+    }
+
+    const quint64 iCapacity = m_pHeader->iCapacity;
+    quint64 iRead = m_pHeader->iReadIndex.load(std::memory_order_relaxed);
+
+    QElapsedTimer timer;
+    timer.start();
+    int iPolls = 0;
+
+    while(true) {
+        if(m_pHeader->iWriteIndex.load(std::memory_order_acquire) == iRead) {
+            if(!isWriterAttached() || timer.elapsed() >= iMSecsTimeout) {
+                return false;
+            }
+
+            // Spin first since the next buffer is usually close, then give the CPU away
+            if(++iPolls < SPIN_COUNT) {
+                QThread::yieldCurrentThread();
+            } else {
+                QThread::usleep(200);
+            }
+            continue;
+        }
+
+        const quint64 iPos = iRead % iCapacity;
+        const qint32* pRecord = reinterpret_cast<const qint32*>(m_pRecords + iPos);
+
+        if(pRecord[0] == RING_PADDING_KIND) {
+            iRead += iCapacity - iPos;
+            m_pHeader->iReadIndex.store(iRead, std::memory_order_release);
+            continue;
+        }
+
+        kind = pRecord[0];
+        const qint32 iDataSize = pRecord[2];
+
+        if(kind == FIFF_DATA_BUFFER) {
+            const qint32 iNumSamples = (iDataSize / static_cast<qint32>(sizeof(float))) / iNumChannels;
+            data = Map<const MatrixXf>(reinterpret_cast<const float*>(pRecord + 4), iNumChannels, iNumSamples);
+        }
+
+        m_pHeader->iReadIndex.store(iRead + alignRecord(RECORD_HEADER_SIZE + iDataSize), std::memory_order_release);
+
+        return true;
+    }
+}
@@ -0,0 +1,206 @@
+//=============================================================================================================
+/**
+ * @file     rtsharedmemoryring.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the RtSharedMemoryRing Class.
+ *
+ */
+
+#ifndef RTSHAREDMEMORYRING_H
+#define RTSHAREDMEMORYRING_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../communication_global.h"
+
+#include <fiff/fiff_types.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QSharedMemory>
+#include <QString>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE COMMUNICATIONLIB
+//=============================================================================================================
+
+namespace COMMUNICATIONLIB
+{
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+struct RtSharedMemoryRingHeader;
+
+//=============================================================================================================
+/**
+ * Single producer single consumer ring of raw buffers in shared memory. It is used as same-host transport
+ * between mne_rt_server and a RtDataClient next to the TCP data connection. Every record starts with a FIFF tag
+ * header (kind, type, size, next) followed by the samples in native byte order, so a buffer is transferred with
+ * one copy into and one copy out of the ring and without any system call.
+ *
+ * @brief Shared memory ring of raw buffers.
+ */
+class COMMUNICATIONSHARED_EXPORT RtSharedMemoryRing
+{
+public:
+    typedef QSharedPointer<RtSharedMemoryRing> SPtr;               /**< Shared pointer type for RtSharedMemoryRing. */
+    typedef QSharedPointer<const RtSharedMemoryRing> ConstSPtr;    /**< Const shared pointer type for RtSharedMemoryRing. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a RtSharedMemoryRing which is neither created nor attached.
+     */
+    RtSharedMemoryRing();
+
+    //=========================================================================================================
+    /**
+     * Detaches from the shared memory and tells the other side that this side is gone.
+     */
+    ~RtSharedMemoryRing();
+
+    //=========================================================================================================
+    /**
+     * Creates the shared memory segment as writer.
+     *
+     * @param[in] sKey           The key of the segment.
+     * @param[in] iCapacity      The number of bytes available for records.
+     *
+     * @return true if the segment was created, false otherwise.
+     */
+    bool create(const QString& sKey,
+                qint64 iCapacity);
+
+    //=========================================================================================================
+    /**
+     * Attaches to an existing shared memory segment as reader.
+     *
+     * @param[in] sKey   The key of the segment.
+     *
+     * @return true if the segment exists on this host and is compatible, false otherwise.
+     */
+    bool attach(const QString& sKey);
+
+    //=========================================================================================================
+    /**
+     * Detaches from the shared memory segment.
+     */
+    void detach();
+
+    //=========================================================================================================
+    /**
+     * Returns whether the ring is created or attached.
+     *
+     * @return true if the ring can be used.
+     */
+    bool isAttached() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the key of the shared memory segment.
+     *
+     * @return the key.
+     */
+    QString getKey() const;
+
+    //=========================================================================================================
+    /**
+     * Returns whether the writer side is still attached.
+     *
+     * @return true if the writer is attached.
+     */
+    bool isWriterAttached() const;
+
+    //=========================================================================================================
+    /**
+     * Returns whether a reader is attached. The writer only switches a client to the ring once this is the case.
+     *
+     * @return true if the reader is attached.
+     */
+    bool isReaderAttached() const;
+
+    //=========================================================================================================
+    /**
+     * Returns whether a reader attached and detached again, i.e. the transport has to fall back to TCP.
+     *
+     * @return true if the reader is gone.
+     */
+    bool isReaderDetached() const;
+
+    //=========================================================================================================
+    /**
+     * Writes a record. Does not block.
+     *
+     * @param[in] kind           The FIFF tag kind, e.g. FIFF_DATA_BUFFER.
+     * @param[in] pData          The samples.
+     * @param[in] iNumElements   The number of samples.
+     *
+     * @return true if the record was written, false if the ring is full or not created.
+     */
+    bool write(FIFFLIB::fiff_int_t kind,
+               const float* pData,
+               qint32 iNumElements);
+
+    //=========================================================================================================
+    /**
+     * Reads the next record. Waits until a record is available, the timeout expired or the writer detached.
+     *
+     * @param[in] iNumChannels   Number of channels to reshape the received samples.
+     * @param[out] data          The read samples.
+     * @param[out] kind          The FIFF tag kind of the record.
+     * @param[in] iMSecsTimeout  The maximum time to wait for a record.
+     *
+     * @return true if a record was read, false otherwise.
+     */
+    bool read(qint32 iNumChannels,
+              Eigen::MatrixXf& data,
+              FIFFLIB::fiff_int_t& kind,
+              int iMSecsTimeout = 100);
+
+private:
+    QSharedMemory               m_sharedMemory;     /**< The shared memory segment. */
+    RtSharedMemoryRingHeader*   m_pHeader;          /**< The ring header at the beginning of the segment. */
+    char*                       m_pRecords;         /**< The record area behind the header. */
+    bool                        m_bIsWriter;        /**< Whether this side created the segment. */
+};
+} // NAMESPACE
+
+#endif // RTSHAREDMEMORYRING_H
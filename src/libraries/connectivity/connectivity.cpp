@@ -51,12 +51,14 @@
 #include "metrics/weightedphaselagindex.h"
 #include "metrics/unbiasedsquaredphaselagindex.h"
 #include "metrics/debiasedsquaredweightedphaselagindex.h"
+#include "metrics/abstractmetric.h"
 
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QDebug>
+#include <QFile>
 #include <QFutureSynchronizer>
 #include <QtConcurrent>
 
@@ -128,7 +130,118 @@ QList<Network> Connectivity::calculate(ConnectivitySettings& connectivitySetting
     }
 
     qWarning() << "Total" << timer.elapsed();
-    qDebug() << "Connectivity::calculateMultiMethods - Calculated"<< lMethods <<"for" << connectivitySettings.size() << "trials in"<< timer.elapsed() << "msecs.";
+    qDebug() << "Connectivity::calculateMultiMethods - Calculated"<< lMethods <<"for" << connectivitySettings.getNumberTrials() << "trials in"<< timer.elapsed() << "msecs.";
 
     return results;
 }
+
+//=============================================================================================================
+
+bool Connectivity::calculateIntermediateSumData(ConnectivitySettings& connectivitySettings,
+                                                const QString& sFileName)
+{
+    int iSums = getIntermediateSums(connectivitySettings.getConnectivityMethods());
+
+    if(iSums == 0) {
+        qWarning() << "[Connectivity::calculateIntermediateSumData] None of the methods is computed from intermediate sums. Returning.";
+        return false;
+    }
+
+    // The used frequency bins are resolved the same way as in AbstractMetric::computeIntermediateSums()
+    int iNFreqs = int(floor(connectivitySettings.getFFTSize() / 2.0)) + 1;
+    int iBinStart = AbstractMetric::m_iNumberBinStart;
+    int iBinAmount = AbstractMetric::m_iNumberBinAmount;
+
+    if(iBinStart == -1 ||
+       iBinAmount == -1 ||
+       iBinStart > iNFreqs ||
+       iBinAmount > iNFreqs ||
+       iBinAmount + iBinStart > iNFreqs) {
+        iBinStart = 0;
+        iBinAmount = iNFreqs;
+    }
+
+    if(QFile::exists(sFileName) &&
+       connectivitySettings.isValidIntermediateSumFile(sFileName, iSums, iBinStart, iBinAmount)) {
+        qDebug() << "Connectivity::calculateIntermediateSumData - Partial result" << sFileName << "is available already. Skipping.";
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(AbstractMetric::m_bStorageModeIsActive == false) {
+        connectivitySettings.clearIntermediateData();
+    }
+
+    AbstractMetric::computeIntermediateSums(connectivitySettings,
+                                            iSums);
+
+    if(!connectivitySettings.writeIntermediateSumData(sFileName,
+                                                      iSums,
+                                                      AbstractMetric::m_iNumberBinStart)) {
+        return false;
+    }
+
+    qDebug() << "Connectivity::calculateIntermediateSumData - Calculated partial result for" << connectivitySettings.getNumberTrials() << "trials in"<< timer.elapsed() << "msecs.";
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool Connectivity::mergeIntermediateSumData(ConnectivitySettings& connectivitySettings,
+                                            const QStringList& lFileNames)
+{
+    int iSums = getIntermediateSums(connectivitySettings.getConnectivityMethods());
+
+    if(iSums == 0) {
+        qWarning() << "[Connectivity::mergeIntermediateSumData] None of the methods is computed from intermediate sums. Returning.";
+        return false;
+    }
+
+    int iBinStart = AbstractMetric::m_iNumberBinStart;
+
+    for(const QString& sFileName : lFileNames) {
+        if(!connectivitySettings.mergeIntermediateSumData(sFileName,
+                                                          iSums,
+                                                          iBinStart)) {
+            return false;
+        }
+    }
+
+    // Use the frequency bins of the partial results. All methods need the CSD sum.
+    AbstractMetric::m_iNumberBinStart = iBinStart;
+    AbstractMetric::m_iNumberBinAmount = connectivitySettings.getIntermediateSumData().matCsdSum.cols();
+
+    return true;
+}
+
+//=============================================================================================================
+
+int Connectivity::getIntermediateSums(const QStringList& lMethods)
+{
+    int iSums = 0;
+
+    if(lMethods.contains("COH") || lMethods.contains("IMAGCOH")) {
+        iSums |= ConnectivitySettings::PsdSum | ConnectivitySettings::CsdSum;
+    }
+
+    if(lMethods.contains("PLI") || lMethods.contains("USPLI")) {
+        iSums |= ConnectivitySettings::CsdSum | ConnectivitySettings::CsdImagSignSum;
+    }
+
+    if(lMethods.contains("WPLI")) {
+        iSums |= ConnectivitySettings::CsdSum | ConnectivitySettings::CsdImagAbsSum;
+    }
+
+    if(lMethods.contains("DSWPLI")) {
+        iSums |= ConnectivitySettings::CsdSum | ConnectivitySettings::CsdImagAbsSum | ConnectivitySettings::CsdImagSqrdSum;
+    }
+
+    if(lMethods.contains("PLV")) {
+        iSums |= ConnectivitySettings::CsdSum | ConnectivitySettings::CsdNormalizedSum;
+    }
+
+    return iSums;
+}
@@ -46,6 +46,7 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QStringList>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -97,7 +98,46 @@ public:
      */
     static QList<Network> calculate(ConnectivitySettings& connectivitySettings);
 
+    //=========================================================================================================
+    /**
+     * Computes the intermediate sums of the stored trials for all spectral methods of the settings and writes
+     * them to a partial result file (map step). A large study can thus be split into chunks of trials, which are
+     * computed independently, e.g. by several processes, and merged afterwards via mergeIntermediateSumData()
+     * (reduce step). If the file already holds a compatible partial result, the chunk is skipped. This way an
+     * interrupted run can be resumed without computing the finished chunks again.
+     *
+     * @param[in, out] connectivitySettings   The settings holding the trials of the chunk.
+     * @param[in] sFileName                   The partial result file.
+     *
+     * @return Returns true if the partial result is available in the file.
+     */
+    static bool calculateIntermediateSumData(ConnectivitySettings& connectivitySettings,
+                                             const QString& sFileName);
+
+    //=========================================================================================================
+    /**
+     * Merges the partial result files into the intermediate sums of the settings (reduce step). Afterwards
+     * calculate() computes the networks of the spectral methods from the merged sums. No trials need to be stored
+     * for this. COR and XCOR are not computed from sums and are thus not supported.
+     *
+     * @param[in, out] connectivitySettings   The settings to merge the sums into.
+     * @param[in] lFileNames                  The partial result files.
+     *
+     * @return Returns true if all files were merged successfully.
+     */
+    static bool mergeIntermediateSumData(ConnectivitySettings& connectivitySettings,
+                                         const QStringList& lFileNames);
+
 protected:
+    //=========================================================================================================
+    /**
+     * Returns the intermediate sums needed by the given methods.
+     *
+     * @param[in] lMethods   The connectivity methods.
+     *
+     * @return The sums, a combination of ConnectivitySettings::AccumulatedSum flags.
+     */
+    static int getIntermediateSums(const QStringList& lMethods);
 };
 
 //=============================================================================================================
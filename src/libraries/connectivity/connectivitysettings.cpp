@@ -49,6 +49,10 @@
 #include <QCommandLineParser>
 #include <QElapsedTimer>
 #include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QSysInfo>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -68,6 +72,117 @@ using namespace FSLIB;
 // DEFINE GLOBAL METHODS
 //=============================================================================================================
 
+namespace {
+
+const quint32 INTERMEDIATE_SUM_FILE_ID = 0x4D4E4353;   /**< Identifies a partial result file ("MNCS"). */
+const qint32 INTERMEDIATE_SUM_FILE_VERSION = 1;
+const qint64 SUM_CHUNK_BYTES = 256 * 1024 * 1024;    /**< The maximum number of bytes written or read with one raw data call. */
+
+/**
+ * The header of a partial result file.
+ */
+struct IntermediateSumFileHeader {
+    qint32  iByteOrder = -1;
+    float   fSFreq = 0.0f;
+    qint32  iNfft = 0;
+    QString sWindowType;
+    qint32  iNumberNodes = 0;
+    qint32  iNumberTrials = 0;
+    qint32  iBinStart = 0;
+    qint32  iBinAmount = 0;
+    qint32  iSums = 0;
+};
+
+//=============================================================================================================
+
+bool readIntermediateSumFileHeader(QDataStream& stream,
+                                   IntermediateSumFileHeader& header)
+{
+    quint32 iFileId = 0;
+    qint32 iVersion = 0;
+
+    stream >> iFileId >> iVersion;
+
+    if(iFileId != INTERMEDIATE_SUM_FILE_ID || iVersion != INTERMEDIATE_SUM_FILE_VERSION) {
+        return false;
+    }
+
+    stream >> header.iByteOrder
+           >> header.fSFreq
+           >> header.iNfft
+           >> header.sWindowType
+           >> header.iNumberNodes
+           >> header.iNumberTrials
+           >> header.iBinStart
+           >> header.iBinAmount
+           >> header.iSums;
+
+    // The sums are stored in native byte order
+    return stream.status() == QDataStream::Ok && header.iByteOrder == qint32(QSysInfo::ByteOrder);
+}
+
+//=============================================================================================================
+
+template<typename Derived>
+bool writeSum(QDataStream& stream,
+              const Eigen::PlainObjectBase<Derived>& matSum)
+{
+    stream << qint32(matSum.rows()) << qint32(matSum.cols());
+
+    // Sums with many nodes and bins exceed the int range of a single raw data call, so write them in chunks
+    const char* pData = reinterpret_cast<const char*>(matSum.data());
+    qint64 iBytes = qint64(matSum.size()) * qint64(sizeof(typename Derived::Scalar));
+
+    for(qint64 iPos = 0; iPos < iBytes && stream.status() == QDataStream::Ok; ) {
+        int iChunk = int(qMin(iBytes - iPos, SUM_CHUNK_BYTES));
+
+        if(stream.writeRawData(pData + iPos, iChunk) != iChunk) {
+            stream.setStatus(QDataStream::WriteFailed);
+            return false;
+        }
+
+        iPos += iChunk;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+//=============================================================================================================
+
+template<typename Derived>
+bool readSum(QDataStream& stream,
+             Eigen::PlainObjectBase<Derived>& matSum,
+             int iRows,
+             int iCols)
+{
+    qint32 iFileRows = 0;
+    qint32 iFileCols = 0;
+    stream >> iFileRows >> iFileCols;
+
+    if(iFileRows != iRows || iFileCols != iCols) {
+        return false;
+    }
+
+    matSum.resize(iRows, iCols);
+    char* pData = reinterpret_cast<char*>(matSum.data());
+    qint64 iBytes = qint64(matSum.size()) * qint64(sizeof(typename Derived::Scalar));
+
+    for(qint64 iPos = 0; iPos < iBytes && stream.status() == QDataStream::Ok; ) {
+        int iChunk = int(qMin(iBytes - iPos, SUM_CHUNK_BYTES));
+
+        if(stream.readRawData(pData + iPos, iChunk) != iChunk) {
+            stream.setStatus(QDataStream::ReadPastEnd);
+            return false;
+        }
+
+        iPos += iChunk;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+} // namespace
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -96,20 +211,19 @@ void ConnectivitySettings::clearIntermediateData()
 {
     for (int i = 0; i < m_trialData.size(); ++i) {
         m_trialData[i].matPsd.resize(0,0);
-        m_trialData[i].vecPairCsd.clear();
         m_trialData[i].vecTapSpectra.clear();
-        m_trialData[i].vecPairCsdNormalized.clear();
-        m_trialData[i].vecPairCsdImagSign.clear();
-        m_trialData[i].vecPairCsdImagAbs.clear();
-        m_trialData[i].vecPairCsdImagSqrd.clear();
+        m_trialData[i].matCsd.resize(0,0);
+        m_trialData[i].iAccumulatedSums = 0;
     }
 
     m_intermediateSumData.matPsdSum.resize(0,0);
-    m_intermediateSumData.vecPairCsdSum.clear();
-    m_intermediateSumData.vecPairCsdNormalizedSum.clear();
-    m_intermediateSumData.vecPairCsdImagSignSum.clear();
-    m_intermediateSumData.vecPairCsdImagAbsSum.clear();
-    m_intermediateSumData.vecPairCsdImagSqrdSum.clear();
+    m_intermediateSumData.matCsdSum.resize(0,0);
+    m_intermediateSumData.matCsdNormalizedSum.resize(0,0);
+    m_intermediateSumData.matCsdImagSignSum.resize(0,0);
+    m_intermediateSumData.matCsdImagAbsSum.resize(0,0);
+    m_intermediateSumData.matCsdImagSqrdSum.resize(0,0);
+    m_intermediateSumData.iNumberMergedTrials = 0;
+    m_intermediateSumData.iNumberNodes = 0;
 }
 
 //*******************************************************************************************************
@@ -179,28 +293,7 @@ void ConnectivitySettings::removeFirst(int iAmount)
 
     // Substract influence of trials from overall summed up intermediate data and remove from data list
     for (int j = 0; j < iAmount; ++j) {
-        for (int i = 0; i < m_trialData.first().matData.rows(); ++i) {
-            if(i < m_intermediateSumData.vecPairCsdSum.size() && (m_intermediateSumData.vecPairCsdSum.size() == m_trialData.first().vecPairCsd.size())) {
-                m_intermediateSumData.vecPairCsdSum[i].second -= m_trialData.first().vecPairCsd.at(i).second;
-            }
-            if(i < m_intermediateSumData.vecPairCsdNormalizedSum.size() && (m_intermediateSumData.vecPairCsdNormalizedSum.size() == m_trialData.first().vecPairCsdNormalized.size())) {
-                m_intermediateSumData.vecPairCsdNormalizedSum[i].second -= m_trialData.first().vecPairCsdNormalized.at(i).second;
-            }
-            if(i < m_intermediateSumData.vecPairCsdImagSignSum.size() && (m_intermediateSumData.vecPairCsdImagSignSum.size() == m_trialData.first().vecPairCsdImagSign.size())) {
-                m_intermediateSumData.vecPairCsdImagSignSum[i].second -= m_trialData.first().vecPairCsdImagSign.at(i).second;
-            }
-            if(i < m_intermediateSumData.vecPairCsdImagAbsSum.size() && (m_intermediateSumData.vecPairCsdImagAbsSum.size() == m_trialData.first().vecPairCsdImagAbs.size())) {
-                m_intermediateSumData.vecPairCsdImagAbsSum[i].second -= m_trialData.first().vecPairCsdImagAbs.at(i).second;
-            }
-            if(i < m_intermediateSumData.vecPairCsdImagSqrdSum.size() && (m_intermediateSumData.vecPairCsdImagSqrdSum.size() == m_trialData.first().vecPairCsdImagSqrd.size())) {
-                m_intermediateSumData.vecPairCsdImagSqrdSum[i].second -= m_trialData.first().vecPairCsdImagSqrd.at(i).second;
-            }
-        }
-
-        if(m_intermediateSumData.matPsdSum.rows() == m_trialData.first().matPsd.rows() &&
-           m_intermediateSumData.matPsdSum.cols() == m_trialData.first().matPsd.cols() ) {
-            m_intermediateSumData.matPsdSum -= m_trialData.first().matPsd;
-        }
+        subtractFromSums(m_trialData.first());
 
         m_trialData.removeFirst();
     }
@@ -230,28 +323,7 @@ void ConnectivitySettings::removeLast(int iAmount)
 
     // Substract influence of trials from overall summed up intermediate data and remove from data list
     for (int j = 0; j < iAmount; ++j) {
-        for (int i = 0; i < m_trialData.last().matData.rows(); ++i) {
-            if(i < m_intermediateSumData.vecPairCsdSum.size() && (m_intermediateSumData.vecPairCsdSum.size() == m_trialData.last().vecPairCsd.size())) {
-                m_intermediateSumData.vecPairCsdSum[i].second -= m_trialData.last().vecPairCsd.at(i).second;
-            }
-            if(i < m_intermediateSumData.vecPairCsdNormalizedSum.size() && (m_intermediateSumData.vecPairCsdNormalizedSum.size() == m_trialData.last().vecPairCsdNormalized.size())) {
-                m_intermediateSumData.vecPairCsdNormalizedSum[i].second -= m_trialData.last().vecPairCsdNormalized.at(i).second;
-            }
-            if(i < m_intermediateSumData.vecPairCsdImagSignSum.size() && (m_intermediateSumData.vecPairCsdImagSignSum.size() == m_trialData.last().vecPairCsdImagSign.size())) {
-                m_intermediateSumData.vecPairCsdImagSignSum[i].second -= m_trialData.last().vecPairCsdImagSign.at(i).second;
-            }
-            if(i < m_intermediateSumData.vecPairCsdImagAbsSum.size() && (m_intermediateSumData.vecPairCsdImagAbsSum.size() == m_trialData.last().vecPairCsdImagAbs.size())) {
-                m_intermediateSumData.vecPairCsdImagAbsSum[i].second -= m_trialData.last().vecPairCsdImagAbs.at(i).second;
-            }
-            if(i < m_intermediateSumData.vecPairCsdImagSqrdSum.size() && (m_intermediateSumData.vecPairCsdImagSqrdSum.size() == m_trialData.last().vecPairCsdImagSqrd.size())) {
-                m_intermediateSumData.vecPairCsdImagSqrdSum[i].second -= m_trialData.last().vecPairCsdImagSqrd.at(i).second;
-            }
-        }
-
-        if(m_intermediateSumData.matPsdSum.rows() == m_trialData.last().matPsd.rows() &&
-           m_intermediateSumData.matPsdSum.cols() == m_trialData.last().matPsd.cols() ) {
-            m_intermediateSumData.matPsdSum -= m_trialData.last().matPsd;
-        }
+        subtractFromSums(m_trialData.last());
 
         m_trialData.removeLast();
     }
@@ -405,6 +477,37 @@ const MatrixX3f& ConnectivitySettings::getNodePositions() const
 
 //*******************************************************************************************************
 
+void ConnectivitySettings::subtractFromSums(const IntermediateTrialData& trialData)
+{
+    // The derived quantities are not stored per trial, recompute them from the packed CSD
+    if(trialData.matCsd.size() > 0) {
+        const Eigen::MatrixXcd& matCsd = trialData.matCsd;
+
+        if((trialData.iAccumulatedSums & CsdSum) && m_intermediateSumData.matCsdSum.rows() == matCsd.rows() && m_intermediateSumData.matCsdSum.cols() == matCsd.cols()) {
+            m_intermediateSumData.matCsdSum -= matCsd;
+        }
+        if((trialData.iAccumulatedSums & CsdNormalizedSum) && m_intermediateSumData.matCsdNormalizedSum.rows() == matCsd.rows() && m_intermediateSumData.matCsdNormalizedSum.cols() == matCsd.cols()) {
+            m_intermediateSumData.matCsdNormalizedSum -= matCsd.cwiseQuotient(matCsd.cwiseAbs());
+        }
+        if((trialData.iAccumulatedSums & CsdImagSignSum) && m_intermediateSumData.matCsdImagSignSum.rows() == matCsd.rows() && m_intermediateSumData.matCsdImagSignSum.cols() == matCsd.cols()) {
+            m_intermediateSumData.matCsdImagSignSum -= matCsd.imag().cwiseSign();
+        }
+        if((trialData.iAccumulatedSums & CsdImagAbsSum) && m_intermediateSumData.matCsdImagAbsSum.rows() == matCsd.rows() && m_intermediateSumData.matCsdImagAbsSum.cols() == matCsd.cols()) {
+            m_intermediateSumData.matCsdImagAbsSum -= matCsd.imag().cwiseAbs();
+        }
+        if((trialData.iAccumulatedSums & CsdImagSqrdSum) && m_intermediateSumData.matCsdImagSqrdSum.rows() == matCsd.rows() && m_intermediateSumData.matCsdImagSqrdSum.cols() == matCsd.cols()) {
+            m_intermediateSumData.matCsdImagSqrdSum -= matCsd.imag().cwiseAbs2();
+        }
+    }
+
+    if(m_intermediateSumData.matPsdSum.rows() == trialData.matPsd.rows() &&
+       m_intermediateSumData.matPsdSum.cols() == trialData.matPsd.cols() ) {
+        m_intermediateSumData.matPsdSum -= trialData.matPsd;
+    }
+}
+
+//*******************************************************************************************************
+
 QList<ConnectivitySettings::IntermediateTrialData>& ConnectivitySettings::getTrialData()
 {
     return m_trialData;
@@ -416,3 +519,334 @@ ConnectivitySettings::IntermediateSumData& ConnectivitySettings::getIntermediate
 {
     return m_intermediateSumData;
 }
+
+//*******************************************************************************************************
+
+int ConnectivitySettings::getNumberTrials() const
+{
+    return m_trialData.size() + m_intermediateSumData.iNumberMergedTrials;
+}
+
+//*******************************************************************************************************
+
+int ConnectivitySettings::getNumberNodes() const
+{
+    if(!m_trialData.isEmpty()) {
+        return m_trialData.first().matData.rows();
+    }
+
+    return m_intermediateSumData.iNumberNodes;
+}
+
+//*******************************************************************************************************
+
+bool ConnectivitySettings::writeIntermediateSumData(const QString& sFileName,
+                                                    int iSums,
+                                                    int iBinStart) const
+{
+    int iNRows = getNumberNodes();
+    int iNPairs = getNumberPairs(iNRows);
+    int iBinAmount = -1;
+
+    // Check that all requested sums are available and share the same frequency bins
+    QList<QPair<int, int> > lDims;
+    lDims << qMakePair(int(PsdSum), int(m_intermediateSumData.matPsdSum.rows()))
+          << qMakePair(int(CsdSum), int(m_intermediateSumData.matCsdSum.rows()))
+          << qMakePair(int(CsdNormalizedSum), int(m_intermediateSumData.matCsdNormalizedSum.rows()))
+          << qMakePair(int(CsdImagSignSum), int(m_intermediateSumData.matCsdImagSignSum.rows()))
+          << qMakePair(int(CsdImagAbsSum), int(m_intermediateSumData.matCsdImagAbsSum.rows()))
+          << qMakePair(int(CsdImagSqrdSum), int(m_intermediateSumData.matCsdImagSqrdSum.rows()));
+
+    for(const QPair<int, int>& pairDim : lDims) {
+        if(!(iSums & pairDim.first)) {
+            continue;
+        }
+
+        if(pairDim.second != (pairDim.first == PsdSum ? iNRows : iNPairs)) {
+            qWarning() << "[ConnectivitySettings::writeIntermediateSumData] Sum" << pairDim.first << "was not computed. Returning.";
+            return false;
+        }
+    }
+
+    if(iSums & PsdSum) {
+        iBinAmount = m_intermediateSumData.matPsdSum.cols();
+    } else if(iSums & CsdSum) {
+        iBinAmount = m_intermediateSumData.matCsdSum.cols();
+    } else if(iSums & CsdNormalizedSum) {
+        iBinAmount = m_intermediateSumData.matCsdNormalizedSum.cols();
+    } else if(iSums & CsdImagSignSum) {
+        iBinAmount = m_intermediateSumData.matCsdImagSignSum.cols();
+    } else if(iSums & CsdImagAbsSum) {
+        iBinAmount = m_intermediateSumData.matCsdImagAbsSum.cols();
+    } else if(iSums & CsdImagSqrdSum) {
+        iBinAmount = m_intermediateSumData.matCsdImagSqrdSum.cols();
+    } else {
+        qWarning() << "[ConnectivitySettings::writeIntermediateSumData] No sums selected. Returning.";
+        return false;
+    }
+
+    QSaveFile file(sFileName);
+
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[ConnectivitySettings::writeIntermediateSumData] Could not open" << sFileName << "for writing. Returning.";
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << INTERMEDIATE_SUM_FILE_ID
+           << INTERMEDIATE_SUM_FILE_VERSION
+           << qint32(QSysInfo::ByteOrder)
+           << m_fSFreq
+           << qint32(m_iNfft)
+           << m_sWindowType
+           << qint32(iNRows)
+           << qint32(getNumberTrials())
+           << qint32(iBinStart)
+           << qint32(iBinAmount)
+           << qint32(iSums);
+
+    bool bOk = stream.status() == QDataStream::Ok;
+
+    if(iSums & PsdSum) {
+        bOk = bOk && writeSum(stream, m_intermediateSumData.matPsdSum);
+    }
+    if(iSums & CsdSum) {
+        bOk = bOk && writeSum(stream, m_intermediateSumData.matCsdSum);
+    }
+    if(iSums & CsdNormalizedSum) {
+        bOk = bOk && writeSum(stream, m_intermediateSumData.matCsdNormalizedSum);
+    }
+    if(iSums & CsdImagSignSum) {
+        bOk = bOk && writeSum(stream, m_intermediateSumData.matCsdImagSignSum);
+    }
+    if(iSums & CsdImagAbsSum) {
+        bOk = bOk && writeSum(stream, m_intermediateSumData.matCsdImagAbsSum);
+    }
+    if(iSums & CsdImagSqrdSum) {
+        bOk = bOk && writeSum(stream, m_intermediateSumData.matCsdImagSqrdSum);
+    }
+
+    if(!bOk || stream.status() != QDataStream::Ok) {
+        qWarning() << "[ConnectivitySettings::writeIntermediateSumData] Error while writing" << sFileName << ". Returning.";
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
+
+//*******************************************************************************************************
+
+bool ConnectivitySettings::mergeIntermediateSumData(const QString& sFileName,
+                                                    int iSums,
+                                                    int& iBinStart)
+{
+    QFile file(sFileName);
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "[ConnectivitySettings::mergeIntermediateSumData] Could not open" << sFileName << ". Returning.";
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    IntermediateSumFileHeader header;
+
+    if(!readIntermediateSumFileHeader(stream, header)) {
+        qWarning() << "[ConnectivitySettings::mergeIntermediateSumData]" << sFileName << "is not a valid partial result file. Returning.";
+        return false;
+    }
+
+    if(header.fSFreq != m_fSFreq || header.iNfft != m_iNfft || header.sWindowType != m_sWindowType) {
+        qWarning() << "[ConnectivitySettings::mergeIntermediateSumData]" << sFileName << "was computed with different spectral settings. Returning.";
+        return false;
+    }
+
+    if((header.iSums & iSums) != iSums) {
+        qWarning() << "[ConnectivitySettings::mergeIntermediateSumData]" << sFileName << "does not hold all requested sums. Returning.";
+        return false;
+    }
+
+    int iNPairs = getNumberPairs(header.iNumberNodes);
+
+    // Read all sums before touching the current ones, so a broken file leaves the settings unchanged
+    IntermediateSumData fileData;
+    bool bOk = true;
+
+    if(header.iSums & PsdSum) {
+        bOk = bOk && readSum(stream, fileData.matPsdSum, header.iNumberNodes, header.iBinAmount);
+    }
+    if(header.iSums & CsdSum) {
+        bOk = bOk && readSum(stream, fileData.matCsdSum, iNPairs, header.iBinAmount);
+    }
+    if(header.iSums & CsdNormalizedSum) {
+        bOk = bOk && readSum(stream, fileData.matCsdNormalizedSum, iNPairs, header.iBinAmount);
+    }
+    if(header.iSums & CsdImagSignSum) {
+        bOk = bOk && readSum(stream, fileData.matCsdImagSignSum, iNPairs, header.iBinAmount);
+    }
+    if(header.iSums & CsdImagAbsSum) {
+        bOk = bOk && readSum(stream, fileData.matCsdImagAbsSum, iNPairs, header.iBinAmount);
+    }
+    if(header.iSums & CsdImagSqrdSum) {
+        bOk = bOk && readSum(stream, fileData.matCsdImagSqrdSum, iNPairs, header.iBinAmount);
+    }
+
+    if(!bOk) {
+        qWarning() << "[ConnectivitySettings::mergeIntermediateSumData] Could not read the sums from" << sFileName << ". Returning.";
+        return false;
+    }
+
+    // Collect the current sums and the file sums in the same order
+    QList<QPair<int, bool> > lSums;
+    lSums << qMakePair(int(PsdSum), m_intermediateSumData.matPsdSum.size() > 0)
+          << qMakePair(int(CsdSum), m_intermediateSumData.matCsdSum.size() > 0)
+          << qMakePair(int(CsdNormalizedSum), m_intermediateSumData.matCsdNormalizedSum.size() > 0)
+          << qMakePair(int(CsdImagSignSum), m_intermediateSumData.matCsdImagSignSum.size() > 0)
+          << qMakePair(int(CsdImagAbsSum), m_intermediateSumData.matCsdImagAbsSum.size() > 0)
+          << qMakePair(int(CsdImagSqrdSum), m_intermediateSumData.matCsdImagSqrdSum.size() > 0);
+
+    int iPresentSums = 0;
+    for(const QPair<int, bool>& pairSum : lSums) {
+        if(pairSum.second) {
+            iPresentSums |= pairSum.first;
+        }
+    }
+
+    // Only keep the requested sums
+    if(!(iSums & PsdSum)) {
+        fileData.matPsdSum.resize(0,0);
+    }
+    if(!(iSums & CsdSum)) {
+        fileData.matCsdSum.resize(0,0);
+    }
+    if(!(iSums & CsdNormalizedSum)) {
+        fileData.matCsdNormalizedSum.resize(0,0);
+    }
+    if(!(iSums & CsdImagSignSum)) {
+        fileData.matCsdImagSignSum.resize(0,0);
+    }
+    if(!(iSums & CsdImagAbsSum)) {
+        fileData.matCsdImagAbsSum.resize(0,0);
+    }
+    if(!(iSums & CsdImagSqrdSum)) {
+        fileData.matCsdImagSqrdSum.resize(0,0);
+    }
+
+    if(iPresentSums == 0) {
+        // Nothing accumulated yet. Take over the file's sums.
+        fileData.iNumberMergedTrials = m_intermediateSumData.iNumberMergedTrials + header.iNumberTrials;
+        fileData.iNumberNodes = header.iNumberNodes;
+        m_intermediateSumData = fileData;
+        iBinStart = header.iBinStart;
+
+        return true;
+    }
+
+    // All sums need to be present in both and the dimensions need to match
+    if(iPresentSums != iSums ||
+       header.iBinStart != iBinStart ||
+       header.iNumberNodes != getNumberNodes() ||
+       ((iSums & PsdSum) && m_intermediateSumData.matPsdSum.cols() != header.iBinAmount) ||
+       ((iSums & CsdSum) && m_intermediateSumData.matCsdSum.cols() != header.iBinAmount) ||
+       ((iSums & CsdNormalizedSum) && m_intermediateSumData.matCsdNormalizedSum.cols() != header.iBinAmount) ||
+       ((iSums & CsdImagSignSum) && m_intermediateSumData.matCsdImagSignSum.cols() != header.iBinAmount) ||
+       ((iSums & CsdImagAbsSum) && m_intermediateSumData.matCsdImagAbsSum.cols() != header.iBinAmount) ||
+       ((iSums & CsdImagSqrdSum) && m_intermediateSumData.matCsdImagSqrdSum.cols() != header.iBinAmount)) {
+        qWarning() << "[ConnectivitySettings::mergeIntermediateSumData] The sums in" << sFileName << "do not match the current sums. Returning.";
+        return false;
+    }
+
+    if(iSums & PsdSum) {
+        m_intermediateSumData.matPsdSum += fileData.matPsdSum;
+    }
+    if(iSums & CsdSum) {
+        m_intermediateSumData.matCsdSum += fileData.matCsdSum;
+    }
+    if(iSums & CsdNormalizedSum) {
+        m_intermediateSumData.matCsdNormalizedSum += fileData.matCsdNormalizedSum;
+    }
+    if(iSums & CsdImagSignSum) {
+        m_intermediateSumData.matCsdImagSignSum += fileData.matCsdImagSignSum;
+    }
+    if(iSums & CsdImagAbsSum) {
+        m_intermediateSumData.matCsdImagAbsSum += fileData.matCsdImagAbsSum;
+    }
+    if(iSums & CsdImagSqrdSum) {
+        m_intermediateSumData.matCsdImagSqrdSum += fileData.matCsdImagSqrdSum;
+    }
+
+    m_intermediateSumData.iNumberMergedTrials += header.iNumberTrials;
+    m_intermediateSumData.iNumberNodes = header.iNumberNodes;
+
+    return true;
+}
+
+//*******************************************************************************************************
+
+bool ConnectivitySettings::isValidIntermediateSumFile(const QString& sFileName,
+                                                      int iSums,
+                                                      int iBinStart,
+                                                      int iBinAmount) const
+{
+    QFile file(sFileName);
+
+    if(!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    IntermediateSumFileHeader header;
+
+    if(!readIntermediateSumFileHeader(stream, header)) {
+        qWarning() << "[ConnectivitySettings::isValidIntermediateSumFile]" << sFileName << "is not a valid partial result file.";
+        return false;
+    }
+
+    if(header.fSFreq != m_fSFreq || header.iNfft != m_iNfft || header.sWindowType != m_sWindowType) {
+        qWarning() << "[ConnectivitySettings::isValidIntermediateSumFile]" << sFileName << "was computed with different spectral settings.";
+        return false;
+    }
+
+    // A chunk of a different montage, frequency band or trial set must not be reused
+    if(header.iNumberNodes != getNumberNodes() ||
+       header.iNumberTrials != getNumberTrials() ||
+       header.iBinStart != iBinStart ||
+       header.iBinAmount != iBinAmount) {
+        qWarning() << "[ConnectivitySettings::isValidIntermediateSumFile]" << sFileName << "was computed for" << header.iNumberNodes << "nodes,"
+                   << header.iNumberTrials << "trials and bins" << header.iBinStart << "to" << header.iBinStart + header.iBinAmount - 1
+                   << "instead of" << getNumberNodes() << "nodes," << getNumberTrials() << "trials and bins" << iBinStart << "to" << iBinStart + iBinAmount - 1 << ".";
+        return false;
+    }
+
+    if((header.iSums & iSums) != iSums) {
+        qWarning() << "[ConnectivitySettings::isValidIntermediateSumFile]" << sFileName << "does not hold all requested sums.";
+        return false;
+    }
+
+    // The file is written atomically, a complete header thus means a complete file. Still check the size.
+    qint64 iExpectedSize = file.pos();
+    qint64 iNPairs = getNumberPairs(header.iNumberNodes);
+
+    for(int iSum = PsdSum; iSum <= CsdImagSqrdSum; iSum <<= 1) {
+        if(header.iSums & iSum) {
+            qint64 iScalarSize = (iSum == CsdSum || iSum == CsdNormalizedSum) ? qint64(2 * sizeof(double)) : qint64(sizeof(double));
+            iExpectedSize += 2 * sizeof(qint32) + (iSum == PsdSum ? header.iNumberNodes : iNPairs) * header.iBinAmount * iScalarSize;
+        }
+    }
+
+    if(file.size() != iExpectedSize) {
+        qWarning() << "[ConnectivitySettings::isValidIntermediateSumFile]" << sFileName << "has" << file.size() << "bytes instead of" << iExpectedSize << ".";
+        return false;
+    }
+
+    return true;
+}
@@ -95,24 +95,45 @@ public:
     typedef QSharedPointer<ConnectivitySettings> SPtr;            /**< Shared pointer type for ConnectivitySettings. */
     typedef QSharedPointer<const ConnectivitySettings> ConstSPtr; /**< Const shared pointer type for ConnectivitySettings. */
 
+    /**
+     * Flags marking which intermediate sums a trial was already added to.
+     */
+    enum AccumulatedSum {
+        PsdSum = 0x01,
+        CsdSum = 0x02,
+        CsdNormalizedSum = 0x04,
+        CsdImagSignSum = 0x08,
+        CsdImagAbsSum = 0x10,
+        CsdImagSqrdSum = 0x20
+    };
+
+    /**
+     * The per trial data. The cross spectra are stored packed: one row per node pair (i,j) with i <= j, see
+     * getPairIndex(), and one column per used frequency bin. The tapered spectra only hold the used frequency bins.
+     */
     struct IntermediateTrialData {
         Eigen::MatrixXd     matData;
         Eigen::MatrixXd     matPsd;
         QVector<Eigen::MatrixXcd>               vecTapSpectra;
-        QVector<QPair<int,Eigen::MatrixXcd> >   vecPairCsd;
-        QVector<QPair<int,Eigen::MatrixXcd> >   vecPairCsdNormalized;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagSign;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagAbs;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagSqrd;
+        Eigen::MatrixXcd    matCsd;
+        int                 iSpectraBinStart = -1;      /**< The first frequency bin of vecTapSpectra and matCsd. */
+        int                 iAccumulatedSums = 0;
     };
 
+    /**
+     * The sums over all trials. The pair sums use the same packed layout as IntermediateTrialData::matCsd.
+     * Sums merged from partial result files (see mergeIntermediateSumData()) also cover trials which are not part
+     * of the trial list. Their number and the number of nodes are kept in iNumberMergedTrials and iNumberNodes.
+     */
     struct IntermediateSumData {
         Eigen::MatrixXd     matPsdSum;
-        QVector<QPair<int,Eigen::MatrixXcd> >   vecPairCsdSum;
-        QVector<QPair<int,Eigen::MatrixXcd> >   vecPairCsdNormalizedSum;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagSignSum;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagAbsSum;
-        QVector<QPair<int,Eigen::MatrixXd> >    vecPairCsdImagSqrdSum;
+        Eigen::MatrixXcd    matCsdSum;
+        Eigen::MatrixXcd    matCsdNormalizedSum;
+        Eigen::MatrixXd     matCsdImagSignSum;
+        Eigen::MatrixXd     matCsdImagAbsSum;
+        Eigen::MatrixXd     matCsdImagSqrdSum;
+        int                 iNumberMergedTrials = 0;
+        int                 iNumberNodes = 0;
     };
 
     //=========================================================================================================
@@ -171,7 +192,106 @@ public:
 
     IntermediateSumData& getIntermediateSumData();
 
+    //=========================================================================================================
+    /**
+     * Returns the number of trials covered by the intermediate sums, i.e. the stored trials plus the trials which
+     * were merged from partial result files.
+     *
+     * @return The number of trials.
+     */
+    int getNumberTrials() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of nodes. Taken from the first trial or, if no trials are stored, from the merged sums.
+     *
+     * @return The number of nodes.
+     */
+    int getNumberNodes() const;
+
+    //=========================================================================================================
+    /**
+     * Writes the intermediate sums to a partial result file. Only the sums given by iSums are written. The file is
+     * written to a temporary file first and renamed afterwards, so it either holds a complete result or does not
+     * exist at all.
+     *
+     * @param[in] sFileName      The partial result file.
+     * @param[in] iSums          The sums to write, a combination of AccumulatedSum flags.
+     * @param[in] iBinStart      The first used frequency bin.
+     *
+     * @return Returns true if the file was written successfully.
+     */
+    bool writeIntermediateSumData(const QString& sFileName,
+                                  int iSums,
+                                  int iBinStart) const;
+
+    //=========================================================================================================
+    /**
+     * Adds the sums of a partial result file to the intermediate sums. The file must have been computed with the
+     * same sampling frequency, FFT length and window type. If sums are present already, they must be the requested
+     * ones and the number of nodes and the used frequency bins must match as well.
+     *
+     * @param[in] sFileName      The partial result file.
+     * @param[in] iSums          The sums to merge, a combination of AccumulatedSum flags.
+     * @param[in, out] iBinStart The first used frequency bin. Set from the file if no sums are present yet.
+     *
+     * @return Returns true if the file was merged successfully.
+     */
+    bool mergeIntermediateSumData(const QString& sFileName,
+                                  int iSums,
+                                  int& iBinStart);
+
+    //=========================================================================================================
+    /**
+     * Checks whether a file holds a complete partial result which is compatible to the current settings and
+     * trials, i.e. it was computed with the same spectral settings, number of nodes, number of trials and
+     * frequency bins. An existing but incompatible file is reported, so it is not silently replaced.
+     *
+     * @param[in] sFileName      The partial result file.
+     * @param[in] iSums          The sums which need to be present, a combination of AccumulatedSum flags.
+     * @param[in] iBinStart      The first used frequency bin.
+     * @param[in] iBinAmount     The number of used frequency bins.
+     *
+     * @return Returns true if the file holds a compatible partial result.
+     */
+    bool isValidIntermediateSumFile(const QString& sFileName,
+                                    int iSums,
+                                    int iBinStart,
+                                    int iBinAmount) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of node pairs (i,j) with i <= j, i.e. the number of rows of the packed cross spectra.
+     *
+     * @param[in] iNumberNodes   The number of nodes.
+     *
+     * @return The number of node pairs.
+     */
+    static inline int getNumberPairs(int iNumberNodes);
+
+    //=========================================================================================================
+    /**
+     * Returns the row of the node pair (i,j) with i <= j in the packed cross spectra.
+     *
+     * @param[in] i              The first node.
+     * @param[in] j              The second node. Must be larger or equal to i.
+     * @param[in] iNumberNodes   The number of nodes.
+     *
+     * @return The packed pair index.
+     */
+    static inline int getPairIndex(int i,
+                                   int j,
+                                   int iNumberNodes);
+
 protected:
+    //=========================================================================================================
+    /**
+     * Substracts the contribution of a trial from the intermediate sums.
+     *
+     * @param[in] trialData   The trial to substract.
+     */
+    void subtractFromSums(const IntermediateTrialData& trialData);
+
     QStringList                     m_sConnectivityMethods;         /**< The connectivity methods. */
     QString                         m_sWindowType;                  /**< The window type used to compute tapered spectra. */
 
@@ -188,6 +308,20 @@ protected:
 //=============================================================================================================
 // INLINE DEFINITIONS
 //=============================================================================================================
+
+inline int ConnectivitySettings::getNumberPairs(int iNumberNodes)
+{
+    return iNumberNodes * (iNumberNodes + 1) / 2;
+}
+
+//=============================================================================================================
+
+inline int ConnectivitySettings::getPairIndex(int i,
+                                              int j,
+                                              int iNumberNodes)
+{
+    return i * iNumberNodes - i * (i - 1) / 2 + (j - i);
+}
 } // namespace CONNECTIVITYLIB
 
 #ifndef metatype_connectivitysettings
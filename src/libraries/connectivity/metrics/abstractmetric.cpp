@@ -37,20 +37,34 @@
 //=============================================================================================================
 
 #include "abstractmetric.h"
+#include "../network/network.h"
+#include "../network/networknode.h"
+#include "../network/networkedge.h"
+#include "shardedsumaccumulator.h"
+
+#include <utils/spectral.h>
 
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QtMath>
+#include <QDebug>
+#include <QtConcurrent>
+
 //=============================================================================================================
 // EIGEN INCLUDES
 //=============================================================================================================
 
+#include <unsupported/Eigen/FFT>
+
 //=============================================================================================================
 // USED NAMESPACES
 //=============================================================================================================
 
 using namespace CONNECTIVITYLIB;
+using namespace Eigen;
+using namespace UTILSLIB;
 
 //=============================================================================================================
 // DEFINE GLOBAL METHODS
@@ -59,6 +73,7 @@ using namespace CONNECTIVITYLIB;
 bool AbstractMetric::m_bStorageModeIsActive = false;
 int AbstractMetric::m_iNumberBinStart = -1;
 int AbstractMetric::m_iNumberBinAmount = -1;
+bool AbstractMetric::m_bComputeBandOnly = false;
 
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -68,3 +83,330 @@ AbstractMetric::AbstractMetric()
 {
 }
 
+//=============================================================================================================
+
+void AbstractMetric::computeIntermediateSums(ConnectivitySettings& connectivitySettings,
+                                             int iSums)
+{
+    if(connectivitySettings.isEmpty()) {
+        qDebug() << "AbstractMetric::computeIntermediateSums - Input data is empty";
+        return;
+    }
+
+    #ifdef EIGEN_FFTW_DEFAULT
+        fftw_make_planner_thread_safe();
+    #endif
+
+    int iNRows = connectivitySettings.getNumberNodes();
+    int iSignalLength = connectivitySettings.at(0).matData.cols();
+    int iNfft = connectivitySettings.getFFTSize();
+    int iNFreqs = int(floor(iNfft / 2.0)) + 1;
+
+    // Generate tapers
+    QPair<MatrixXd, VectorXd> tapers = Spectral::generateTapers(iSignalLength, connectivitySettings.getWindowType());
+
+    // Check if start and bin amount need to be reset to full spectrum
+    if(m_iNumberBinStart == -1 ||
+       m_iNumberBinAmount == -1 ||
+       m_iNumberBinStart > iNFreqs ||
+       m_iNumberBinAmount > iNFreqs ||
+       m_iNumberBinAmount + m_iNumberBinStart > iNFreqs) {
+        qDebug() << "AbstractMetric::computeIntermediateSums - Resetting to full spectrum";
+        m_iNumberBinStart = 0;
+        m_iNumberBinAmount = iNFreqs;
+    }
+
+    ConnectivitySettings::IntermediateSumData& sumData = connectivitySettings.getIntermediateSumData();
+    int iNPairs = ConnectivitySettings::getNumberPairs(iNRows);
+
+    ShardedSumAccumulator accumulator(iNRows);
+
+    if(iSums & ConnectivitySettings::PsdSum) {
+        ShardedSumAccumulator::prepare(sumData.matPsdSum, iNRows, m_iNumberBinAmount);
+    }
+    if(iSums & ConnectivitySettings::CsdSum) {
+        ShardedSumAccumulator::prepare(sumData.matCsdSum, iNPairs, m_iNumberBinAmount);
+    }
+    if(iSums & ConnectivitySettings::CsdNormalizedSum) {
+        ShardedSumAccumulator::prepare(sumData.matCsdNormalizedSum, iNPairs, m_iNumberBinAmount);
+    }
+    if(iSums & ConnectivitySettings::CsdImagSignSum) {
+        ShardedSumAccumulator::prepare(sumData.matCsdImagSignSum, iNPairs, m_iNumberBinAmount);
+    }
+    if(iSums & ConnectivitySettings::CsdImagAbsSum) {
+        ShardedSumAccumulator::prepare(sumData.matCsdImagAbsSum, iNPairs, m_iNumberBinAmount);
+    }
+    if(iSums & ConnectivitySettings::CsdImagSqrdSum) {
+        ShardedSumAccumulator::prepare(sumData.matCsdImagSqrdSum, iNPairs, m_iNumberBinAmount);
+    }
+
+    std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
+        accumulateTrialSums(inputData,
+                            sumData,
+                            accumulator,
+                            iSums,
+                            iNRows,
+                            iNFreqs,
+                            iNfft,
+                            tapers);
+    };
+
+    QFuture<void> result = QtConcurrent::map(connectivitySettings.getTrialData(),
+                                             computeLambda);
+    result.waitForFinished();
+}
+
+//=============================================================================================================
+
+void AbstractMetric::accumulateTrialSums(ConnectivitySettings::IntermediateTrialData& inputData,
+                                         ConnectivitySettings::IntermediateSumData& sumData,
+                                         ShardedSumAccumulator& accumulator,
+                                         int iSums,
+                                         int iNRows,
+                                         int iNFreqs,
+                                         int iNfft,
+                                         const QPair<MatrixXd, VectorXd>& tapers)
+{
+    int iMissingSums = iSums & ~inputData.iAccumulatedSums;
+
+    if(iMissingSums == 0) {
+        return;
+    }
+
+    if(iMissingSums & ConnectivitySettings::PsdSum) {
+        computeTaperedSpectra(inputData,
+                              iNRows,
+                              iNfft,
+                              tapers);
+
+        computePsd(inputData,
+                   iNRows,
+                   iNFreqs,
+                   iNfft,
+                   tapers);
+
+        accumulator.add(sumData.matPsdSum, inputData.matPsd);
+    }
+
+    if(iMissingSums & ~ConnectivitySettings::PsdSum) {
+        computeCsd(inputData,
+                   iNRows,
+                   iNFreqs,
+                   iNfft,
+                   tapers);
+    }
+
+    if(iMissingSums & ConnectivitySettings::CsdSum) {
+        accumulator.add(sumData.matCsdSum, inputData.matCsd);
+    }
+    if(iMissingSums & ConnectivitySettings::CsdNormalizedSum) {
+        accumulator.add(sumData.matCsdNormalizedSum, inputData.matCsd.cwiseQuotient(inputData.matCsd.cwiseAbs()));
+    }
+    if(iMissingSums & ConnectivitySettings::CsdImagSignSum) {
+        accumulator.add(sumData.matCsdImagSignSum, inputData.matCsd.imag().cwiseSign());
+    }
+    if(iMissingSums & ConnectivitySettings::CsdImagAbsSum) {
+        accumulator.add(sumData.matCsdImagAbsSum, inputData.matCsd.imag().cwiseAbs());
+    }
+    if(iMissingSums & ConnectivitySettings::CsdImagSqrdSum) {
+        accumulator.add(sumData.matCsdImagSqrdSum, inputData.matCsd.imag().cwiseAbs2());
+    }
+
+    inputData.iAccumulatedSums |= iMissingSums;
+
+    releaseTrialData(inputData);
+}
+
+//=============================================================================================================
+
+void AbstractMetric::computeTaperedSpectra(ConnectivitySettings::IntermediateTrialData& inputData,
+                                           int iNRows,
+                                           int iNfft,
+                                           const QPair<MatrixXd, VectorXd>& tapers)
+{
+    // The cached spectra are only valid for the same bins. A band with the same width but another start must not reuse them.
+    if(inputData.vecTapSpectra.size() == iNRows
+       && inputData.vecTapSpectra.first().cols() == m_iNumberBinAmount
+       && inputData.iSpectraBinStart == m_iNumberBinStart) {
+        return;
+    }
+
+    // The CSD is derived from the spectra and becomes invalid as well
+    inputData.matCsd.resize(0,0);
+    inputData.vecTapSpectra.clear();
+    inputData.iSpectraBinStart = m_iNumberBinStart;
+    inputData.vecTapSpectra.reserve(iNRows);
+
+    int i,j;
+    RowVectorXd rowData;
+
+    if(m_bComputeBandOnly) {
+        // Eigen's FFT only uses the first iNfft samples and zero pads shorter signals. Do the same here.
+        int iNSamples = qMin(int(inputData.matData.cols()), iNfft);
+
+        // Real and imaginary part of the DFT basis of the used bins. Use the exact phase modulo iNfft.
+        MatrixXd matCos(iNSamples, m_iNumberBinAmount);
+        MatrixXd matSin(iNSamples, m_iNumberBinAmount);
+
+        for(i = 0; i < iNSamples; ++i) {
+            for(j = 0; j < m_iNumberBinAmount; ++j) {
+                double dPhase = -2.0 * M_PI * double((qint64(i) * (m_iNumberBinStart + j)) % iNfft) / double(iNfft);
+                matCos(i,j) = std::cos(dPhase);
+                matSin(i,j) = std::sin(dPhase);
+            }
+        }
+
+        MatrixXd matTapered;
+        MatrixXcd matTapSpectrum(tapers.first.rows(), m_iNumberBinAmount);
+
+        for (i = 0; i < iNRows; ++i) {
+            // Substract mean
+            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
+
+            matTapered = tapers.first.leftCols(iNSamples).array().rowwise() * rowData.head(iNSamples).array();
+
+            matTapSpectrum.real() = tapers.second.asDiagonal() * (matTapered * matCos);
+            matTapSpectrum.imag() = tapers.second.asDiagonal() * (matTapered * matSin);
+
+            inputData.vecTapSpectra.append(matTapSpectrum);
+        }
+    } else {
+        // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
+        RowVectorXd vecInputFFT;
+        RowVectorXcd vecTmpFreq;
+
+        MatrixXcd matTapSpectrum(tapers.first.rows(), m_iNumberBinAmount);
+
+        FFT<double> fft;
+        fft.SetFlag(fft.HalfSpectrum);
+
+        for (i = 0; i < iNRows; ++i) {
+            // Substract mean
+            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
+
+            for(j = 0; j < tapers.first.rows(); j++) {
+                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
+                if (rowData.cols() < iNfft) {
+                    vecInputFFT.setZero(iNfft);
+                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));
+                } else {
+                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
+                }
+
+                // FFT for freq domain returning the half spectrum and multiply taper weights. Only keep the used bins.
+                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
+                matTapSpectrum.row(j) = vecTmpFreq.segment(m_iNumberBinStart, m_iNumberBinAmount) * tapers.second(j);
+            }
+
+            inputData.vecTapSpectra.append(matTapSpectrum);
+        }
+    }
+}
+
+//=============================================================================================================
+
+void AbstractMetric::computePsd(ConnectivitySettings::IntermediateTrialData& inputData,
+                                int iNRows,
+                                int iNFreqs,
+                                int iNfft,
+                                const QPair<MatrixXd, VectorXd>& tapers)
+{
+    double denomPSD = tapers.second.cwiseAbs2().sum() / 2.0;
+
+    inputData.matPsd.resize(iNRows, m_iNumberBinAmount);
+
+    for (int i = 0; i < iNRows; ++i) {
+        // Compute PSD (average over tapers if necessary).
+        inputData.matPsd.row(i) = inputData.vecTapSpectra.at(i).cwiseAbs2().colwise().sum() / denomPSD;
+    }
+
+    // Divide first and last element by 2 due to half spectrum
+    if(m_iNumberBinStart == 0) {
+        inputData.matPsd.col(0) /= 2.0;
+    }
+
+    if(iNfft % 2 == 0 && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
+        inputData.matPsd.rightCols(1) /= 2.0;
+    }
+}
+
+//=============================================================================================================
+
+void AbstractMetric::computeCsd(ConnectivitySettings::IntermediateTrialData& inputData,
+                                int iNRows,
+                                int iNFreqs,
+                                int iNfft,
+                                const QPair<MatrixXd, VectorXd>& tapers)
+{
+    int iNPairs = ConnectivitySettings::getNumberPairs(iNRows);
+
+    if(inputData.matCsd.rows() == iNPairs
+       && inputData.matCsd.cols() == m_iNumberBinAmount
+       && inputData.iSpectraBinStart == m_iNumberBinStart) {
+        return;
+    }
+
+    computeTaperedSpectra(inputData,
+                          iNRows,
+                          iNfft,
+                          tapers);
+
+    double denomCSD = tapers.second.cwiseAbs2().sum() / 2.0;
+
+    inputData.matCsd.resize(iNPairs, m_iNumberBinAmount);
+
+    int i,j;
+    int iPair = 0;
+
+    for (i = 0; i < iNRows; ++i) {
+        const MatrixXcd& matTapSpectrumI = inputData.vecTapSpectra.at(i);
+
+        for (j = i; j < iNRows; ++j) {
+            // Compute CSD (average over tapers if necessary)
+            inputData.matCsd.row(iPair++) = matTapSpectrumI.cwiseProduct(inputData.vecTapSpectra.at(j).conjugate()).colwise().sum() / denomCSD;
+        }
+    }
+
+    // Divide first and last element by 2 due to half spectrum
+    if(m_iNumberBinStart == 0) {
+        inputData.matCsd.col(0) /= 2.0;
+    }
+
+    if(iNfft % 2 == 0 && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
+        inputData.matCsd.rightCols(1) /= 2.0;
+    }
+}
+
+//=============================================================================================================
+
+void AbstractMetric::releaseTrialData(ConnectivitySettings::IntermediateTrialData& inputData)
+{
+    if(!m_bStorageModeIsActive) {
+        inputData.matCsd.resize(0,0);
+        inputData.vecTapSpectra.clear();
+    }
+}
+
+//=============================================================================================================
+
+void AbstractMetric::addPackedEdges(Network& finalNetwork,
+                                    const MatrixXd& matWeights,
+                                    int iNRows)
+{
+    MatrixXd matWeight;
+    QSharedPointer<NetworkEdge> pEdge;
+    int i,j;
+    int iPair = 0;
+
+    for (i = 0; i < iNRows; ++i) {
+        for(j = i; j < iNRows; ++j) {
+            matWeight = matWeights.row(iPair++).transpose();
+
+            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
+
+            finalNetwork.getNodeAt(i)->append(pEdge);
+            finalNetwork.getNodeAt(j)->append(pEdge);
+            finalNetwork.append(pEdge);
+        }
+    }
+}
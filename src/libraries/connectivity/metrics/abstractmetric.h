@@ -40,6 +40,7 @@
 //=============================================================================================================
 
 #include "../connectivity_global.h"
+#include "../connectivitysettings.h"
 
 //=============================================================================================================
 // QT INCLUDES
@@ -47,6 +48,7 @@
 
 #include <QSharedPointer>
 #include <QVector>
+#include <QPair>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -68,6 +70,9 @@ namespace CONNECTIVITYLIB {
 // CONNECTIVITYLIB FORWARD DECLARATIONS
 //=============================================================================================================
 
+class Network;
+class ShardedSumAccumulator;
+
 //=============================================================================================================
 /**
  * This class provides basic functionalities for all implemented metrics.
@@ -90,8 +95,114 @@ public:
     static bool     m_bStorageModeIsActive;
     static int      m_iNumberBinStart;
     static int      m_iNumberBinAmount;
+    static bool     m_bComputeBandOnly;         /**< Whether to compute the tapered spectra only for the used frequency bins via a direct DFT instead of a full FFT. Pays off if only few bins are used. */
+
+    //=========================================================================================================
+    /**
+     * Adds all stored trials to the given intermediate sums without computing a network. Every trial's spectra
+     * are computed only once for all requested sums. Trials which were already added to a sum are skipped.
+     *
+     * @param[in, out] connectivitySettings   The connectivity settings holding the trials and the sums.
+     * @param[in] iSums                       The sums to compute, a combination of ConnectivitySettings::AccumulatedSum flags.
+     */
+    static void computeIntermediateSums(ConnectivitySettings& connectivitySettings,
+                                        int iSums);
 
 protected:
+    //=========================================================================================================
+    /**
+     * Adds one trial to the given intermediate sums. Only the sums which were not added for this trial yet are
+     * computed. The PSD and CSD are computed as needed and the per trial spectra are released afterwards.
+     * This function gets called in parallel.
+     *
+     * @param[in, out] inputData    The input data.
+     * @param[in, out] sumData      The intermediate sums. The requested sums must be prepared already.
+     * @param[in] accumulator       The accumulator used to safely add to the sums.
+     * @param[in] iSums             The sums to add to, a combination of ConnectivitySettings::AccumulatedSum flags.
+     * @param[in] iNRows            The number of rows.
+     * @param[in] iNFreqs           The number of frequency bins of the half spectrum.
+     * @param[in] iNfft             The FFT length.
+     * @param[in] tapers            The taper information.
+     */
+    static void accumulateTrialSums(ConnectivitySettings::IntermediateTrialData& inputData,
+                                    ConnectivitySettings::IntermediateSumData& sumData,
+                                    ShardedSumAccumulator& accumulator,
+                                    int iSums,
+                                    int iNRows,
+                                    int iNFreqs,
+                                    int iNfft,
+                                    const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+
+    //=========================================================================================================
+    /**
+     * Computes the tapered spectra of all rows for the used frequency bins (m_iNumberBinStart, m_iNumberBinAmount)
+     * if not available already. Depending on m_bComputeBandOnly the spectra are computed via FFT or a direct DFT
+     * of the used bins only. In both cases only the used bins are stored.
+     *
+     * @param[in, out] inputData    The input data.
+     * @param[in] iNRows            The number of rows.
+     * @param[in] iNfft             The FFT length.
+     * @param[in] tapers            The taper information.
+     */
+    static void computeTaperedSpectra(ConnectivitySettings::IntermediateTrialData& inputData,
+                                      int iNRows,
+                                      int iNfft,
+                                      const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+
+    //=========================================================================================================
+    /**
+     * Computes the PSD of all rows for the used frequency bins from the tapered spectra.
+     *
+     * @param[in, out] inputData    The input data.
+     * @param[in] iNRows            The number of rows.
+     * @param[in] iNFreqs           The number of frequency bins of the half spectrum.
+     * @param[in] iNfft             The FFT length.
+     * @param[in] tapers            The taper information.
+     */
+    static void computePsd(ConnectivitySettings::IntermediateTrialData& inputData,
+                           int iNRows,
+                           int iNFreqs,
+                           int iNfft,
+                           const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+
+    //=========================================================================================================
+    /**
+     * Computes the packed CSD of all row pairs (i,j) with i <= j for the used frequency bins from the tapered
+     * spectra if not available already. The tapered spectra are computed first if necessary.
+     *
+     * @param[in, out] inputData    The input data.
+     * @param[in] iNRows            The number of rows.
+     * @param[in] iNFreqs           The number of frequency bins of the half spectrum.
+     * @param[in] iNfft             The FFT length.
+     * @param[in] tapers            The taper information.
+     */
+    static void computeCsd(ConnectivitySettings::IntermediateTrialData& inputData,
+                           int iNRows,
+                           int iNFreqs,
+                           int iNfft,
+                           const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+
+    //=========================================================================================================
+    /**
+     * Releases the per trial spectra if the storage mode is not active. The flags of the already accumulated
+     * sums are kept, so the trial is not added twice. Without storage mode the metrics clear them together with the
+     * sums before each computation.
+     *
+     * @param[in, out] inputData    The input data.
+     */
+    static void releaseTrialData(ConnectivitySettings::IntermediateTrialData& inputData);
+
+    //=========================================================================================================
+    /**
+     * Creates the edges of all node pairs (i,j) with i <= j from the packed weights and adds them to the network.
+     *
+     * @param[out] finalNetwork     The resulting network.
+     * @param[in] matWeights        The packed weights, one row per node pair and one column per frequency bin.
+     * @param[in] iNRows            The number of nodes.
+     */
+    static void addPackedEdges(Network& finalNetwork,
+                               const Eigen::MatrixXd& matWeights,
+                               int iNRows);
 };
 
 //=============================================================================================================
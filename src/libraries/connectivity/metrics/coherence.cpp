@@ -84,12 +84,12 @@ Network Coherence::calculate(ConnectivitySettings& connectivitySettings)
 {
     Network finalNetwork("COH");
 
-    if(connectivitySettings.isEmpty()) {
+    if(connectivitySettings.getNumberTrials() == 0) {
         qDebug() << "Coherence::calculate - Input data is empty";
         return finalNetwork;
     }
 
-    if(AbstractMetric::m_bStorageModeIsActive == false) {
+    if(AbstractMetric::m_bStorageModeIsActive == false && connectivitySettings.getIntermediateSumData().iNumberMergedTrials == 0) {
         connectivitySettings.clearIntermediateData();
     }
 
@@ -114,7 +114,7 @@ Network Coherence::calculate(ConnectivitySettings& connectivitySettings)
     finalNetwork.setUsedFreqBins(AbstractMetric::m_iNumberBinAmount);
 
     //Create nodes
-    int rows = connectivitySettings.at(0).matData.rows();
+    int rows = connectivitySettings.getNumberNodes();
     RowVectorXf rowVert = RowVectorXf::Zero(3);
 
     for(int i = 0; i < rows; ++i) {
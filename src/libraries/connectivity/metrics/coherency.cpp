@@ -44,6 +44,7 @@
 #include "../network/networknode.h"
 #include "../network/networkedge.h"
 #include "../network/network.h"
+#include "shardedsumaccumulator.h"
 
 #include <utils/spectral.h>
 
@@ -89,7 +90,7 @@ void Coherency::calculateAbs(Network& finalNetwork,
 //    qint64 iTime = 0;
 //    timer.start();
 
-    if(connectivitySettings.isEmpty()) {
+    if(connectivitySettings.getNumberTrials() == 0) {
         qDebug() << "Coherency::calculateReal - Input data is empty";
         return;
     }
@@ -98,24 +99,26 @@ void Coherency::calculateAbs(Network& finalNetwork,
         fftw_make_planner_thread_safe();
     #endif
 
-    int iSignalLength = connectivitySettings.at(0).matData.cols();
+    int iSignalLength = connectivitySettings.isEmpty() ? 0 : connectivitySettings.at(0).matData.cols();
     int iNfft = connectivitySettings.getFFTSize();
 
     // Generate tapers
     QPair<MatrixXd, VectorXd> tapers = Spectral::generateTapers(iSignalLength, connectivitySettings.getWindowType());
 
     // Initialize vecPsdAvg and vecCsdAvg
-    int iNRows = connectivitySettings.at(0).matData.rows();
+    int iNRows = connectivitySettings.getNumberNodes();
     int iNFreqs = int(floor(iNfft / 2.0)) + 1;
 
     // Compute PSD/CSD for each trial
     QMutex mutex;
+    ShardedSumAccumulator accumulator(iNRows);
+    ShardedSumAccumulator::prepare(connectivitySettings.getIntermediateSumData().matPsdSum, iNRows, m_iNumberBinAmount);
+    ShardedSumAccumulator::prepare(connectivitySettings.getIntermediateSumData().matCsdSum, ConnectivitySettings::getNumberPairs(iNRows), m_iNumberBinAmount);
 
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
         compute(inputData,
-                connectivitySettings.getIntermediateSumData().matPsdSum,
-                connectivitySettings.getIntermediateSumData().vecPairCsdSum,
-                mutex,
+                connectivitySettings.getIntermediateSumData(),
+                accumulator,
                 iNRows,
                 iNFreqs,
                 iNfft,
@@ -135,14 +138,20 @@ void Coherency::calculateAbs(Network& finalNetwork,
 //    timer.restart();
 
     // Compute CSD/sqrt(PSD_X * PSD_Y)
-    std::function<void(QPair<int,MatrixXcd>&)> computePSDCSDLambda = [&](QPair<int,MatrixXcd>& pairInput) {
+    QVector<int> vecRows(iNRows);
+    for(int i = 0; i < iNRows; ++i) {
+        vecRows[i] = i;
+    }
+
+    std::function<void(int&)> computePSDCSDLambda = [&](int& iRow) {
         computePSDCSDAbs(mutex,
                          finalNetwork,
-                         pairInput,
+                         iRow,
+                         connectivitySettings.getIntermediateSumData().matCsdSum,
                          connectivitySettings.getIntermediateSumData().matPsdSum);
     };
 
-    QFuture<void> resultCSDPSD = QtConcurrent::map(connectivitySettings.getIntermediateSumData().vecPairCsdSum,
+    QFuture<void> resultCSDPSD = QtConcurrent::map(vecRows,
                                                    computePSDCSDLambda);
     resultCSDPSD.waitForFinished();
 
@@ -160,7 +169,7 @@ void Coherency::calculateImag(Network& finalNetwork,
 //    qint64 iTime = 0;
 //    timer.start();
 
-    if(connectivitySettings.isEmpty()) {
+    if(connectivitySettings.getNumberTrials() == 0) {
         qDebug() << "Coherency::calculateImag - Input data is empty";
         return;
     }
@@ -169,24 +178,26 @@ void Coherency::calculateImag(Network& finalNetwork,
         fftw_make_planner_thread_safe();
     #endif
 
-    int iSignalLength = connectivitySettings.at(0).matData.cols();
+    int iSignalLength = connectivitySettings.isEmpty() ? 0 : connectivitySettings.at(0).matData.cols();
     int iNfft = connectivitySettings.getFFTSize();
 
     // Generate tapers
     QPair<MatrixXd, VectorXd> tapers = Spectral::generateTapers(iSignalLength, connectivitySettings.getWindowType());
 
     // Initialize vecPsdAvg and vecCsdAvg
-    int iNRows = connectivitySettings.at(0).matData.rows();
+    int iNRows = connectivitySettings.getNumberNodes();
     int iNFreqs = int(floor(iNfft / 2.0)) + 1;
 
     // Compute PSD/CSD for each trial
     QMutex mutex;
+    ShardedSumAccumulator accumulator(iNRows);
+    ShardedSumAccumulator::prepare(connectivitySettings.getIntermediateSumData().matPsdSum, iNRows, m_iNumberBinAmount);
+    ShardedSumAccumulator::prepare(connectivitySettings.getIntermediateSumData().matCsdSum, ConnectivitySettings::getNumberPairs(iNRows), m_iNumberBinAmount);
 
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
         compute(inputData,
-                connectivitySettings.getIntermediateSumData().matPsdSum,
-                connectivitySettings.getIntermediateSumData().vecPairCsdSum,
-                mutex,
+                connectivitySettings.getIntermediateSumData(),
+                accumulator,
                 iNRows,
                 iNFreqs,
                 iNfft,
@@ -206,14 +217,20 @@ void Coherency::calculateImag(Network& finalNetwork,
 //    timer.restart();
 
     // Compute CSD/sqrt(PSD_X * PSD_Y)
-    std::function<void(QPair<int,MatrixXcd>&)> computePSDCSDLambda = [&](QPair<int,MatrixXcd>& pairInput) {
+    QVector<int> vecRows(iNRows);
+    for(int i = 0; i < iNRows; ++i) {
+        vecRows[i] = i;
+    }
+
+    std::function<void(int&)> computePSDCSDLambda = [&](int& iRow) {
         computePSDCSDImag(mutex,
                           finalNetwork,
-                          pairInput,
+                          iRow,
+                          connectivitySettings.getIntermediateSumData().matCsdSum,
                           connectivitySettings.getIntermediateSumData().matPsdSum);
     };
 
-    QFuture<void> resultCSDPSD = QtConcurrent::map(connectivitySettings.getIntermediateSumData().vecPairCsdSum,
+    QFuture<void> resultCSDPSD = QtConcurrent::map(vecRows,
                                                    computePSDCSDLambda);
     resultCSDPSD.waitForFinished();
 
@@ -225,179 +242,45 @@ void Coherency::calculateImag(Network& finalNetwork,
 //=============================================================================================================
 
 void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
-                        MatrixXd& matPsdSum,
-                        QVector<QPair<int,MatrixXcd> >& vecPairCsdSum,
-                        QMutex& mutex,
+                        ConnectivitySettings::IntermediateSumData& sumData,
+                        ShardedSumAccumulator& accumulator,
                         int iNRows,
                         int iNFreqs,
                         int iNfft,
                         const QPair<MatrixXd, VectorXd>& tapers)
 {
-//    QElapsedTimer timer;
-//    qint64 iTime = 0;
-//    timer.start();
-
-    if(inputData.vecPairCsd.size() == iNRows) {
-        //qDebug() << "Coherency::compute - vecPairCsd were already computed for this trial.";
-        return;
-    }
-
-    //qDebug() << "Coherency::compute - vecPairCsdSum and matPsdSum are computed for this trial.";
-
-    // Substract mean, compute tapered spectra and PSD
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    bool bNfftEven = false;
-    if (iNfft % 2 == 0){
-        bNfftEven = true;
-    }
-
-    FFT<double> fft;
-    fft.SetFlag(fft.HalfSpectrum);
-
-    double denomPSD = tapers.second.cwiseAbs2().sum() / 2.0;
-
-    RowVectorXd vecInputFFT, rowData;
-    RowVectorXcd vecTmpFreq;
-
-    MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-    int i,j;
-
-    inputData.matPsd = MatrixXd(iNRows, m_iNumberBinAmount);
-
-    for (i = 0; i < iNRows; ++i) {
-        // Substract mean
-        rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-        // Calculate tapered spectra if not available already
-        if(inputData.vecTapSpectra.size() != iNRows) {
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-
-        // Compute PSD (average over tapers if necessary).
-        inputData.matPsd.row(i) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseAbs2().colwise().sum() / denomPSD;
-
-        // Divide first and last element by 2 due to half spectrum
-        if(m_iNumberBinStart == 0) {
-            inputData.matPsd.row(i)(0) /= 2.0;
-        }
-
-        if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-            inputData.matPsd.row(i).tail(1) /= 2.0;
-        }
-    }
-
-    mutex.lock();
-
-    if(matPsdSum.rows() == 0 || matPsdSum.cols() == 0) {
-        matPsdSum = inputData.matPsd;
-    } else {
-        matPsdSum += inputData.matPsd;
-    }
-
-    mutex.unlock();
-
-//    iTime = timer.elapsed();
-//    qWarning() << QThread::currentThreadId() << "Coherency::compute timer - compute - Tapered spectra and PSD (summing):" << iTime;
-//    timer.restart();
-
-    // Compute CSD
-    if(inputData.vecPairCsd.size() != iNRows) {
-        inputData.vecPairCsd.clear();
-
-        //MatrixXcd matCsd = MatrixXcd(iNRows, iNFreqs);
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
-
-        for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-        }
-
-        mutex.lock();
-
-        if(vecPairCsdSum.isEmpty()) {
-            vecPairCsdSum = inputData.vecPairCsd;
-        } else {
-            for (j = 0; j < vecPairCsdSum.size(); ++j) {
-                vecPairCsdSum[j].second += inputData.vecPairCsd.at(j).second;
-            }
-        }
-
-        mutex.unlock();
-    }
-
-//    iTime = timer.elapsed();
-//    qWarning() << QThread::currentThreadId() << "Coherency::compute timer - compute - CSD summing:" << iTime;
-//    timer.restart();
-
-    //Do not store data to save memory
-    if(!m_bStorageModeIsActive) {
-        inputData.vecPairCsd.clear();
-        inputData.vecTapSpectra.clear();
-    }
-
-//    iTime = timer.elapsed();
-//    qWarning() << QThread::currentThreadId() << "Coherency::compute timer - compute - Deleting data:" << iTime;
-//    timer.restart();
+    accumulateTrialSums(inputData,
+                        sumData,
+                        accumulator,
+                        ConnectivitySettings::PsdSum | ConnectivitySettings::CsdSum,
+                        iNRows,
+                        iNFreqs,
+                        iNfft,
+                        tapers);
 }
 
 //=============================================================================================================
 
 void Coherency::computePSDCSDAbs(QMutex& mutex,
                                  Network& finalNetwork,
-                                 const QPair<int,MatrixXcd>& pairInput,
+                                 int iRow,
+                                 const MatrixXcd& matCsdSum,
                                  const MatrixXd& matPsdSum)
 {
-    MatrixXd matPSDtmp(matPsdSum.rows(), matPsdSum.cols());
-    RowVectorXd rowPsdSum = matPsdSum.row(pairInput.first);
-
-    for(int j = 0; j < matPSDtmp.rows(); ++j) {
-        matPSDtmp.row(j) = rowPsdSum.cwiseProduct(matPsdSum.row(j));
-    }
-
-    // Average. Note that the number of trials cancel each other out.
-    MatrixXcd matCohy = pairInput.second.cwiseQuotient(matPSDtmp.cwiseSqrt());
+    int iNRows = matPsdSum.rows();
+    RowVectorXd rowPsdSum = matPsdSum.row(iRow);
+    int iPair = ConnectivitySettings::getPairIndex(iRow, iRow, iNRows);
 
     QSharedPointer<NetworkEdge> pEdge;
     MatrixXd matWeight;
-    int j;
-    int i = pairInput.first;
 
-    for(j = i; j < matCohy.rows(); ++j) {
-        matWeight = matCohy.row(j).cwiseAbs().transpose();
-        pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
+    for(int j = iRow; j < iNRows; ++j, ++iPair) {
+        // Average. Note that the number of trials cancel each other out.
+        matWeight = matCsdSum.row(iPair).cwiseQuotient(rowPsdSum.cwiseProduct(matPsdSum.row(j)).cwiseSqrt()).cwiseAbs().transpose();
+        pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(iRow, j, matWeight));
 
         mutex.lock();
-        finalNetwork.getNodeAt(i)->append(pEdge);
+        finalNetwork.getNodeAt(iRow)->append(pEdge);
         finalNetwork.getNodeAt(j)->append(pEdge);
         finalNetwork.append(pEdge);
         mutex.unlock();
@@ -408,29 +291,23 @@ void Coherency::computePSDCSDAbs(QMutex& mutex,
 
 void Coherency::computePSDCSDImag(QMutex& mutex,
                                   Network& finalNetwork,
-                                  const QPair<int,MatrixXcd>& pairInput,
+                                  int iRow,
+                                  const MatrixXcd& matCsdSum,
                                   const MatrixXd& matPsdSum)
 {
-    MatrixXd matPSDtmp(matPsdSum.rows(), matPsdSum.cols());
-    RowVectorXd rowPsdSum = matPsdSum.row(pairInput.first);
-
-    for(int j = 0; j < matPSDtmp.rows(); ++j) {
-        matPSDtmp.row(j) = rowPsdSum.cwiseProduct(matPsdSum.row(j));
-    }
-
-    MatrixXcd matCohy = pairInput.second.cwiseQuotient(matPSDtmp.cwiseSqrt());
+    int iNRows = matPsdSum.rows();
+    RowVectorXd rowPsdSum = matPsdSum.row(iRow);
+    int iPair = ConnectivitySettings::getPairIndex(iRow, iRow, iNRows);
 
     QSharedPointer<NetworkEdge> pEdge;
     MatrixXd matWeight;
-    int j;
-    int i = pairInput.first;
 
-    for(j = i; j < matCohy.rows(); ++j) {
-        matWeight = matCohy.row(j).imag().transpose();
-        pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
+    for(int j = iRow; j < iNRows; ++j, ++iPair) {
+        matWeight = matCsdSum.row(iPair).cwiseQuotient(rowPsdSum.cwiseProduct(matPsdSum.row(j)).cwiseSqrt()).imag().transpose();
+        pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(iRow, j, matWeight));
 
         mutex.lock();
-        finalNetwork.getNodeAt(i)->append(pEdge);
+        finalNetwork.getNodeAt(iRow)->append(pEdge);
         finalNetwork.getNodeAt(j)->append(pEdge);
         finalNetwork.append(pEdge);
         mutex.unlock();
@@ -76,6 +76,7 @@ namespace CONNECTIVITYLIB {
 //=============================================================================================================
 
 class Network;
+class ShardedSumAccumulator;
 
 //=============================================================================================================
 /**
@@ -122,18 +123,16 @@ private:
      * Computes the coherency values. This function gets called in parallel.
      *
      * @param[in]   inputData           The input data.
-     * @param[out]   matPsdSum           The sum of all PSD matrices for each trial.
-     * @param[out]   vecPairCsdSum       The sum of all CSD matrices for each trial.
-     * @param[in]   mutex               The mutex used to safely access matPsdSum and vecPairCsdSum.
+     * @param[in, out] sumData           The intermediate sums.
+     * @param[in]   accumulator         The accumulator used to safely add to the sums.
      * @param[in]   iNRows              The number of rows.
      * @param[in]   iNFreqs             The number of frequenciy bins.
      * @param[in]   iNfft               The FFT length.
      * @param[in]   tapers              The taper information.
      */
     static void compute(ConnectivitySettings::IntermediateTrialData& inputData,
-                        Eigen::MatrixXd& matPsdSum,
-                        QVector<QPair<int,Eigen::MatrixXcd> >& vecPairCsdSum,
-                        QMutex& mutex,
+                        ConnectivitySettings::IntermediateSumData& sumData,
+                        ShardedSumAccumulator& accumulator,
                         int iNRows,
                         int iNFreqs,
                         int iNfft,
@@ -141,15 +140,24 @@ private:
 
     //=========================================================================================================
     /**
-     * Computes the PSD and CSD. This function gets called in parallel.
+     * Computes the coherency of one row with all following rows and adds the edges to the network. This function
+     * gets called in parallel.
+     *
+     * @param[in]   mutex               The mutex used to safely access the network.
+     * @param[out]   finalNetwork        The resulting network.
+     * @param[in]   iRow                The row.
+     * @param[in]   matCsdSum           The sum of all packed CSD matrices.
+     * @param[in]   matPsdSum           The sum of all PSD matrices.
      */
     static void computePSDCSDAbs(QMutex& mutex,
                                  Network& finalNetwork,
-                                 const QPair<int,Eigen::MatrixXcd>& pairInput,
+                                 int iRow,
+                                 const Eigen::MatrixXcd& matCsdSum,
                                  const Eigen::MatrixXd& matPsdSum);
     static void computePSDCSDImag(QMutex& mutex,
                                   Network& finalNetwork,
-                                  const QPair<int,Eigen::MatrixXcd>& pairInput,
+                                  int iRow,
+                                  const Eigen::MatrixXcd& matCsdSum,
                                   const Eigen::MatrixXd& matPsdSum);
 };
 
@@ -198,8 +198,13 @@ void CrossCorrelation::compute(ConnectivitySettings::IntermediateTrialData& inpu
 
     // Calculate tapered spectra if not available already
     // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.isEmpty()) {
-        int iNFreqs = int(floor(iNfft / 2.0)) + 1;
+    // The other metrics only store the used frequency bins, XCOR needs the full half spectrum.
+    int iNFreqs = int(floor(iNfft / 2.0)) + 1;
+    QVector<MatrixXcd> vecTapSpectra = inputData.vecTapSpectra;
+
+    if(vecTapSpectra.size() != iNRows || vecTapSpectra.first().cols() != iNFreqs) {
+        vecTapSpectra.clear();
+
         MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
 
         for (i = 0; i < iNRows; ++i) {
@@ -221,7 +226,12 @@ void CrossCorrelation::compute(ConnectivitySettings::IntermediateTrialData& inpu
                 matTapSpectrum.row(j) = vecResultFreq * tapers.second(j);
             }
 
-            inputData.vecTapSpectra.append(matTapSpectrum);
+            vecTapSpectra.append(matTapSpectrum);
+        }
+
+        if(inputData.vecTapSpectra.isEmpty()) {
+            inputData.vecTapSpectra = vecTapSpectra;
+            inputData.iSpectraBinStart = 0;
         }
     }
 
@@ -236,11 +246,11 @@ void CrossCorrelation::compute(ConnectivitySettings::IntermediateTrialData& inpu
     int idx = 0;
     double denom = tapers.second.sum();
 
-    for(i = 0; i < inputData.vecTapSpectra.size(); ++i) {
-        vecResultFreq = inputData.vecTapSpectra.at(i).colwise().sum() / denom;
+    for(i = 0; i < vecTapSpectra.size(); ++i) {
+        vecResultFreq = vecTapSpectra.at(i).colwise().sum() / denom;
 
-        for(j = i; j < inputData.vecTapSpectra.size(); ++j) {
-            vecResultXCor = vecResultFreq.cwiseProduct(inputData.vecTapSpectra.at(j).colwise().sum() / denom);
+        for(j = i; j < vecTapSpectra.size(); ++j) {
+            vecResultXCor = vecResultFreq.cwiseProduct(vecTapSpectra.at(j).colwise().sum() / denom);
 
             fft.inv(vecInputFFT, vecResultXCor, iNfft);
 
@@ -76,6 +76,7 @@ namespace CONNECTIVITYLIB {
 //=============================================================================================================
 
 class Network;
+class ShardedSumAccumulator;
 
 //=============================================================================================================
 /**
@@ -112,20 +113,16 @@ protected:
      * Computes the DSWPLI values. This function gets called in parallel.
      *
      * @param[in] inputData              The input data.
-     * @param[out]vecPairCsdSum          The sum of all CSD matrices for each trial.
-     * @param[out]vecPairCsdImagAbsSum   The sum of all imag abs CSD matrices for each trial.
-     * @param[out]vecPairCsdImagSqrdSum  The sum of all imag aqrd CSD matrices for each trial.
-     * @param[in] mutex                  The mutex used to safely access vecPairCsdSum.
+     * @param[in, out] sumData           The intermediate sums.
+     * @param[in] accumulator            The accumulator used to safely add to the sums.
      * @param[in] iNRows                 The number of rows.
      * @param[in] iNFreqs                The number of frequenciy bins.
      * @param[in] iNfft                  The FFT length.
      * @param[in] tapers                 The taper information.
      */
     static void compute(ConnectivitySettings::IntermediateTrialData& inputData,
-                        QVector<QPair<int,Eigen::MatrixXcd> >& vecPairCsdSum,
-                        QVector<QPair<int,Eigen::MatrixXd> >& vecPairCsdImagAbsSum,
-                        QVector<QPair<int,Eigen::MatrixXd> >& vecPairCsdImagSqrdSum,
-                        QMutex& mutex,
+                        ConnectivitySettings::IntermediateSumData& sumData,
+                        ShardedSumAccumulator& accumulator,
                         int iNRows,
                         int iNFreqs,
                         int iNfft,
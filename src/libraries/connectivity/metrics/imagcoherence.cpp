@@ -83,12 +83,12 @@ Network ImagCoherence::calculate(ConnectivitySettings& connectivitySettings)
 {
     Network finalNetwork("IMAGCOH");
 
-    if(connectivitySettings.isEmpty()) {
+    if(connectivitySettings.getNumberTrials() == 0) {
         qDebug() << "ImagCoherence::calculate - Input data is empty";
         return finalNetwork;
     }
 
-    if(AbstractMetric::m_bStorageModeIsActive == false) {
+    if(AbstractMetric::m_bStorageModeIsActive == false && connectivitySettings.getIntermediateSumData().iNumberMergedTrials == 0) {
         connectivitySettings.clearIntermediateData();
     }
 
@@ -119,7 +119,7 @@ Network ImagCoherence::calculate(ConnectivitySettings& connectivitySettings)
     finalNetwork.setUsedFreqBins(AbstractMetric::m_iNumberBinAmount);
 
     //Create nodes
-    int rows = connectivitySettings.at(0).matData.rows();
+    int rows = connectivitySettings.getNumberNodes();
     RowVectorXf rowVert = RowVectorXf::Zero(3);
 
     for(int i = 0; i < rows; ++i) {
@@ -44,6 +44,7 @@
 #include "../network/networknode.h"
 #include "../network/networkedge.h"
 #include "../network/network.h"
+#include "shardedsumaccumulator.h"
 
 #include <utils/spectral.h>
 
@@ -90,12 +91,12 @@ Network PhaseLagIndex::calculate(ConnectivitySettings& connectivitySettings)
 
     Network finalNetwork("PLI");
 
-    if(connectivitySettings.isEmpty()) {
+    if(connectivitySettings.getNumberTrials() == 0) {
         qDebug() << "PhaseLagIndex::calculate - Input data is empty";
         return finalNetwork;
     }
 
-    if(AbstractMetric::m_bStorageModeIsActive == false) {
+    if(AbstractMetric::m_bStorageModeIsActive == false && connectivitySettings.getIntermediateSumData().iNumberMergedTrials == 0) {
         connectivitySettings.clearIntermediateData();
     }
 
@@ -106,7 +107,7 @@ Network PhaseLagIndex::calculate(ConnectivitySettings& connectivitySettings)
     #endif
 
     //Create nodes
-    int iNRows = connectivitySettings.at(0).matData.rows();
+    int iNRows = connectivitySettings.getNumberNodes();
     RowVectorXf rowVert = RowVectorXf::Zero(3);
 
     for(int i = 0; i < iNRows; ++i) {
@@ -121,7 +122,7 @@ Network PhaseLagIndex::calculate(ConnectivitySettings& connectivitySettings)
     }
 
     // Check that iNfft >= signal length
-    int iSignalLength = connectivitySettings.at(0).matData.cols();
+    int iSignalLength = connectivitySettings.isEmpty() ? 0 : connectivitySettings.at(0).matData.cols();
     int iNfft = connectivitySettings.getFFTSize();
 
     // Generate tapers
@@ -145,13 +146,14 @@ Network PhaseLagIndex::calculate(ConnectivitySettings& connectivitySettings)
     finalNetwork.setFFTSize(iNFreqs);
     finalNetwork.setUsedFreqBins(AbstractMetric::m_iNumberBinAmount);
 
-    QMutex mutex;
+    ShardedSumAccumulator accumulator(iNRows);
+    ShardedSumAccumulator::prepare(connectivitySettings.getIntermediateSumData().matCsdSum, ConnectivitySettings::getNumberPairs(iNRows), m_iNumberBinAmount);
+    ShardedSumAccumulator::prepare(connectivitySettings.getIntermediateSumData().matCsdImagSignSum, ConnectivitySettings::getNumberPairs(iNRows), m_iNumberBinAmount);
 
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
         compute(inputData,
-                connectivitySettings.getIntermediateSumData().vecPairCsdSum,
-                connectivitySettings.getIntermediateSumData().vecPairCsdImagSignSum,
-                mutex,
+                connectivitySettings.getIntermediateSumData(),
+                accumulator,
                 iNRows,
                 iNFreqs,
                 iNfft,
@@ -185,123 +187,21 @@ Network PhaseLagIndex::calculate(ConnectivitySettings& connectivitySettings)
 //=============================================================================================================
 
 void PhaseLagIndex::compute(ConnectivitySettings::IntermediateTrialData& inputData,
-                            QVector<QPair<int,MatrixXcd> >& vecPairCsdSum,
-                            QVector<QPair<int,MatrixXd> >& vecPairCsdImagSignSum,
-                            QMutex& mutex,
+                            ConnectivitySettings::IntermediateSumData& sumData,
+                            ShardedSumAccumulator& accumulator,
                             int iNRows,
                             int iNFreqs,
                             int iNfft,
                             const QPair<MatrixXd, VectorXd>& tapers)
 {
-    if(inputData.vecPairCsdImagSign.size() == iNRows) {
-        //qDebug() << "PhaseLagIndex::compute - vecPairCsdImagSign was already computed for this trial.";
-        return;
-    }
-
-    int i,j;
-
-    // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.isEmpty()) {
-        RowVectorXd vecInputFFT, rowData;
-        RowVectorXcd vecTmpFreq;
-
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        FFT<double> fft;
-        fft.SetFlag(fft.HalfSpectrum);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-            // Calculate tapered spectra
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-    }
-
-    // Compute CSD
-    if(inputData.vecPairCsd.isEmpty()) {
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
-
-        bool bNfftEven = false;
-        if (iNfft % 2 == 0){
-            bNfftEven = true;
-        }
-
-        for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-            inputData.vecPairCsdImagSign.append(QPair<int,MatrixXd>(i,matCsd.imag().cwiseSign()));
-        }
-
-        mutex.lock();
-
-        if(vecPairCsdSum.isEmpty()) {
-            vecPairCsdSum = inputData.vecPairCsd;
-            vecPairCsdImagSignSum = inputData.vecPairCsdImagSign;
-        } else {
-            for (int j = 0; j < vecPairCsdSum.size(); ++j) {
-                vecPairCsdSum[j].second += inputData.vecPairCsd.at(j).second;
-                vecPairCsdImagSignSum[j].second += inputData.vecPairCsdImagSign.at(j).second;
-            }
-        }
-
-        mutex.unlock();
-    } else {
-        if(inputData.vecPairCsdImagSign.isEmpty()) {
-            for (i = 0; i < inputData.vecPairCsd.size(); ++i) {
-                inputData.vecPairCsdImagSign.append(QPair<int,MatrixXd>(i,inputData.vecPairCsd.at(i).second.imag().cwiseSign()));
-            }
-
-            mutex.lock();
-
-            if(vecPairCsdImagSignSum.isEmpty()) {
-                vecPairCsdImagSignSum = inputData.vecPairCsdImagSign;
-            } else {
-                for (int j = 0; j < vecPairCsdImagSignSum.size(); ++j) {
-                    vecPairCsdImagSignSum[j].second += inputData.vecPairCsdImagSign.at(j).second;
-                }
-            }
-
-            mutex.unlock();
-        }
-    }
-
-    if(!m_bStorageModeIsActive) {
-        inputData.vecPairCsd.clear();
-        inputData.vecTapSpectra.clear();
-        inputData.vecPairCsdImagSign.clear();
-    }
+    accumulateTrialSums(inputData,
+                        sumData,
+                        accumulator,
+                        ConnectivitySettings::CsdSum | ConnectivitySettings::CsdImagSignSum,
+                        iNRows,
+                        iNFreqs,
+                        iNfft,
+                        tapers);
 }
 
 //=============================================================================================================
@@ -310,23 +210,10 @@ void PhaseLagIndex::computePLI(ConnectivitySettings &connectivitySettings,
                                Network& finalNetwork)
 {
     // Compute final PLI and create Network
-    MatrixXd matNom;
-    MatrixXd matWeight;
-    QSharedPointer<NetworkEdge> pEdge;
-    int j;
-
-    for (int i = 0; i < connectivitySettings.getIntermediateSumData().vecPairCsdImagSignSum.size(); ++i) {
-        matNom = connectivitySettings.getIntermediateSumData().vecPairCsdImagSignSum.at(i).second.cwiseAbs() / connectivitySettings.size();
+    MatrixXd matWeights = connectivitySettings.getIntermediateSumData().matCsdImagSignSum.cwiseAbs() / connectivitySettings.getNumberTrials();
 
-        for(j = i; j < matNom.rows(); ++j) {
-            matWeight = matNom.row(j).transpose();
-
-            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-            finalNetwork.getNodeAt(i)->append(pEdge);
-            finalNetwork.getNodeAt(j)->append(pEdge);
-            finalNetwork.append(pEdge);
-        }
-    }
+    addPackedEdges(finalNetwork,
+                   matWeights,
+                   connectivitySettings.getNumberNodes());
 }
 
@@ -1,16 +1,13 @@
 //=============================================================================================================
 /**
- * @file     fiffstreamthread.h
- * @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
- *           Limin Sun <limin.sun@childrens.harvard.edu>;
- *           Lorenz Esch <lesch@mgh.harvard.edu>;
- *           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
- * @since    0.1.0
- * @date     July, 2012
+ * @file     shardedsumaccumulator.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
  *
  * @section  LICENSE
  *
- * Copyright (C) 2012, Christoph Dinh, Limin Sun, Lorenz Esch, Matti Hamalainen. All rights reserved.
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
  * the following conditions are met:
@@ -31,99 +28,47 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *
  *
- * @brief     Declaration of the FiffStreamThread Class.
+ * @brief    ShardedSumAccumulator class definition.
  *
  */
 
-#ifndef FIFFSTREAMTHREAD_H
-#define FIFFSTREAMTHREAD_H
-
 //=============================================================================================================
 // INCLUDES
 //=============================================================================================================
 
-#include <fiff/fiff_stream.h>
-#include <fiff/fiff_info.h>
+#include "shardedsumaccumulator.h"
 
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QThread>
-#include <QTcpSocket>
-#include <QMutex>
-#include <QSharedPointer>
 
 //=============================================================================================================
-// DEFINE NAMESPACE RTSERVER
+// USED NAMESPACES
 //=============================================================================================================
 
-namespace RTSERVER
-{
+using namespace CONNECTIVITYLIB;
 
 //=============================================================================================================
-// FORWARD DECLARATIONS
+// DEFINE MEMBER METHODS
 //=============================================================================================================
 
-class FiffStreamThread : public QThread
+ShardedSumAccumulator::ShardedSumAccumulator(int iNumberShards)
+: m_iCallCounter(0)
+, m_iStartStride(1)
 {
-    Q_OBJECT
-
-public:
-    FiffStreamThread(qint32 id, int socketDescriptor, QObject *parent);
-
-    ~FiffStreamThread();
-
-    void run();
-
-    inline qint32 getID();
-
-    inline QString getAlias();
-
-//    void deactivateRawBufferSending();
-
-    void parseCommand(QSharedPointer<FIFFLIB::FiffTag> p_pTag);
-
-    void writeClientId();
-
-//    void sendData(QTcpSocket& p_qTcpSocket);
-
-signals:
-    void error(QTcpSocket::SocketError socketError);
-
-private:
-    qint32 m_iDataClientId;
-    QString m_sDataClientAlias;
+    for(int i = 0; i < iNumberShards; ++i) {
+        m_vecShardLocks.append(QSharedPointer<QMutex>(new QMutex()));
+    }
 
-    int m_iSocketDescriptor;
-
-    QMutex m_qMutex;
-    QByteArray m_qSendBlock;
-
-    bool m_bIsSendingRawBuffer;
-
-    bool m_bIsRunning;
-
-    void startMeas(qint32 ID);
-
-    void stopMeas(qint32 ID);
-
-    void sendMeasurementInfo(qint32 ID, const FIFFLIB::FiffInfo& p_fiffInfo);
-
-    void sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData);
-    //void readToBuffer1();
-//    void readProc(QTcpSocket& p_qTcpSocket);
-};
-
-inline qint32 FiffStreamThread::getID()
-{
-    return m_iDataClientId;
+    // Spread the start shards of concurrent callers evenly over all shards
+    m_iStartStride = qMax(1, iNumberShards / qMax(1, QThread::idealThreadCount()));
 }
 
-inline QString FiffStreamThread::getAlias()
+//=============================================================================================================
+
+int ShardedSumAccumulator::getNumberShards() const
 {
-    return m_sDataClientAlias;
+    return m_vecShardLocks.size();
 }
-} // NAMESPACE
-
-#endif //FIFFSTREAMTHREAD_H
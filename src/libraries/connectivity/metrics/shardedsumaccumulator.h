@@ -0,0 +1,227 @@
+//=============================================================================================================
+/**
+ * @file     shardedsumaccumulator.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    ShardedSumAccumulator class declaration.
+ *
+ */
+
+#ifndef SHARDEDSUMACCUMULATOR_H
+#define SHARDEDSUMACCUMULATOR_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../connectivity_global.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInt>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE CONNECTIVITYLIB
+//=============================================================================================================
+
+namespace CONNECTIVITYLIB {
+
+//=============================================================================================================
+/**
+ * Accumulates the per trial intermediate results (PSD and packed CSD sums) of the connectivity metrics from many
+ * threads at once. The rows of the sums are split into contiguous shards. Every shard has its own lock, and
+ * each caller starts at a different shard and skips shards which are currently busy (try-lock). Threads therefore
+ * hardly ever wait for each other, while no per thread copies of the (potentially large) sums are needed.
+ *
+ * @brief Sharded accumulator for the intermediate sum data of the connectivity metrics.
+ */
+class CONNECTIVITYSHARED_EXPORT ShardedSumAccumulator
+{
+
+public:
+    typedef QSharedPointer<ShardedSumAccumulator> SPtr;            /**< Shared pointer type for ShardedSumAccumulator. */
+    typedef QSharedPointer<const ShardedSumAccumulator> ConstSPtr; /**< Const shared pointer type for ShardedSumAccumulator. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a ShardedSumAccumulator object.
+     *
+     * @param[in] iNumberShards    The number of shards, usually the number of network nodes.
+     */
+    explicit ShardedSumAccumulator(int iNumberShards);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of shards.
+     *
+     * @return The number of shards.
+     */
+    int getNumberShards() const;
+
+    //=========================================================================================================
+    /**
+     * Makes sure the sum has the given dimensions. Must be called before the sum is accumulated in parallel.
+     * An already existing sum with matching dimensions is left untouched, otherwise the sum is set to zero.
+     *
+     * @param[in, out] matSum        The sum to prepare.
+     * @param[in] iRows              The number of rows.
+     * @param[in] iCols              The number of columns.
+     */
+    template<typename Derived>
+    static void prepare(Eigen::PlainObjectBase<Derived>& matSum,
+                        int iRows,
+                        int iCols);
+
+    //=========================================================================================================
+    /**
+     * Adds the per trial data to the sum. The input can be an Eigen expression, which is then only evaluated
+     * shard by shard. Thread safe.
+     *
+     * @param[in, out] matSum        The prepared sum.
+     * @param[in] matInput           The per trial data to add.
+     */
+    template<typename Derived, typename OtherDerived>
+    void add(Eigen::PlainObjectBase<Derived>& matSum,
+             const Eigen::MatrixBase<OtherDerived>& matInput);
+
+protected:
+    //=========================================================================================================
+    /**
+     * Calls func(iShard) exactly once for every shard while holding the shard's lock. The shards are visited
+     * starting at a per call offset. Busy shards are postponed and only waited for if no other shard is left.
+     *
+     * @param[in] func     The function to call.
+     */
+    template<typename Func>
+    void forEachShard(Func func);
+
+    QVector<QSharedPointer<QMutex> >    m_vecShardLocks;        /**< One lock per shard. */
+    QAtomicInt                          m_iCallCounter;         /**< Counts the add calls, used to spread the start shards. */
+    int                                 m_iStartStride;         /**< The distance between the start shards of consecutive calls. */
+};
+
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+template<typename Derived>
+void ShardedSumAccumulator::prepare(Eigen::PlainObjectBase<Derived>& matSum,
+                                    int iRows,
+                                    int iCols)
+{
+    if(matSum.rows() == iRows && matSum.cols() == iCols) {
+        return;
+    }
+
+    matSum.setZero(iRows, iCols);
+}
+
+//=============================================================================================================
+
+template<typename Derived, typename OtherDerived>
+void ShardedSumAccumulator::add(Eigen::PlainObjectBase<Derived>& matSum,
+                                const Eigen::MatrixBase<OtherDerived>& matInput)
+{
+    if(matInput.rows() != matSum.rows() || matInput.cols() != matSum.cols()) {
+        qWarning("[ShardedSumAccumulator::add] Input dimensions do not match the sum dimensions.");
+        return;
+    }
+
+    const int iRows = matSum.rows();
+    const int iNumberShards = m_vecShardLocks.size();
+
+    forEachShard([&](int iShard) {
+        // Contiguous row range of this shard
+        int iStart = int(qint64(iRows) * iShard / iNumberShards);
+        int iEnd = int(qint64(iRows) * (iShard + 1) / iNumberShards);
+
+        if(iEnd > iStart) {
+            matSum.middleRows(iStart, iEnd - iStart) += matInput.middleRows(iStart, iEnd - iStart);
+        }
+    });
+}
+
+//=============================================================================================================
+
+template<typename Func>
+void ShardedSumAccumulator::forEachShard(Func func)
+{
+    const int iNumberShards = m_vecShardLocks.size();
+
+    if(iNumberShards == 0) {
+        return;
+    }
+
+    const int iStart = int((qint64(m_iCallCounter.fetchAndAddRelaxed(1)) * m_iStartStride) % iNumberShards);
+
+    QVector<int> vecPending;
+    vecPending.reserve(iNumberShards);
+    for(int i = 0; i < iNumberShards; ++i) {
+        vecPending.append((iStart + i) % iNumberShards);
+    }
+
+    while(!vecPending.isEmpty()) {
+        QVector<int> vecBusy;
+
+        for(int i = 0; i < vecPending.size(); ++i) {
+            QMutex* pLock = m_vecShardLocks.at(vecPending.at(i)).data();
+
+            if(pLock->tryLock()) {
+                func(vecPending.at(i));
+                pLock->unlock();
+            } else {
+                vecBusy.append(vecPending.at(i));
+            }
+        }
+
+        // Only block if every remaining shard was busy, otherwise try again with the postponed ones
+        if(!vecBusy.isEmpty() && vecBusy.size() == vecPending.size()) {
+            QMutex* pLock = m_vecShardLocks.at(vecBusy.first()).data();
+            pLock->lock();
+            func(vecBusy.first());
+            pLock->unlock();
+            vecBusy.removeFirst();
+        }
+
+        vecPending = vecBusy;
+    }
+}
+} // namespace CONNECTIVITYLIB
+
+#endif // SHARDEDSUMACCUMULATOR_H
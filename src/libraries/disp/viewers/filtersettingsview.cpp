@@ -107,6 +107,8 @@ FilterSettingsView::FilterSettingsView(const QString& sSettingsPath,
             this, &FilterSettingsView::onFilterToChanged);
     connect(m_pUi->m_pcomboBoxChannelTypes, &QComboBox::currentTextChanged,
             this, &FilterSettingsView::onFilterChannelTypeChanged);
+    connect(m_pUi->m_pComboBoxFilterMode, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, &FilterSettingsView::onFilterModeChanged);
 }
 
 //=============================================================================================================
@@ -133,6 +135,13 @@ bool FilterSettingsView::getFilterActive()
 
 //=============================================================================================================
 
+int FilterSettingsView::getFilterMode()
+{
+    return m_pUi->m_pComboBoxFilterMode->currentIndex();
+}
+
+//=============================================================================================================
+
 void FilterSettingsView::setSamplingRate(double dSFreq)
 {
     //Update min max of spin boxes to nyquist
@@ -166,6 +175,7 @@ void FilterSettingsView::saveSettings()
     settings.setValue(m_sSettingsPath + QString("/FilterSettingsView/filterFrom"), m_pUi->m_pDoubleSpinBoxFrom->value());
     settings.setValue(m_sSettingsPath + QString("/FilterSettingsView/filterTo"), m_pUi->m_pDoubleSpinBoxTo->value());
     settings.setValue(m_sSettingsPath + QString("/FilterSettingsView/filterChannelType"), m_pUi->m_pcomboBoxChannelTypes->currentText());
+    settings.setValue(m_sSettingsPath + QString("/FilterSettingsView/filterMode"), m_pUi->m_pComboBoxFilterMode->currentIndex());
 }
 
 //=============================================================================================================
@@ -182,6 +192,7 @@ void FilterSettingsView::loadSettings()
     m_pUi->m_pDoubleSpinBoxTo->setValue(settings.value(m_sSettingsPath + QString("/FilterSettingsView/filterTo"), 0).toDouble());
     m_pUi->m_pDoubleSpinBoxFrom->setValue(settings.value(m_sSettingsPath + QString("/FilterSettingsView/filterFrom"), 0).toDouble());
     m_pUi->m_pcomboBoxChannelTypes->setCurrentText(settings.value(m_sSettingsPath + QString("/FilterSettingsView/filterChannelType"), "All").toString());
+    m_pUi->m_pComboBoxFilterMode->setCurrentIndex(settings.value(m_sSettingsPath + QString("/FilterSettingsView/filterMode"), 0).toInt());
 }
 
 //=============================================================================================================
@@ -267,6 +278,15 @@ void FilterSettingsView::onFilterChannelTypeChanged(const QString& sType)
 
 //=============================================================================================================
 
+void FilterSettingsView::onFilterModeChanged(int iMode)
+{
+    emit filterModeChanged(iMode);
+
+    saveSettings();
+}
+
+//=============================================================================================================
+
 void FilterSettingsView::clearView()
 {
 
@@ -117,6 +117,12 @@ public:
      */
     bool getFilterActive();
 
+    //=========================================================================================================
+    /**
+     * Returns the selected filter mode (0 = linear phase, 1 = causal IIR, 2 = causal FIR).
+     */
+    int getFilterMode();
+
     //=========================================================================================================
     /**
      * Sets the sampling frequency and setups this view accrodingly.
@@ -150,6 +156,12 @@ signals:
      */
     void filterActivationChanged(bool activated);
 
+    //=========================================================================================================
+    /**
+     * Signal emited when the filter mode changed (0 = linear phase, 1 = causal IIR, 2 = causal FIR).
+     */
+    void filterModeChanged(int iMode);
+
 protected:
     //=========================================================================================================
     /**
@@ -199,6 +211,14 @@ protected:
      */
     void onFilterChannelTypeChanged(const QString& sType);
 
+    //=========================================================================================================
+    /**
+     * This function is called whenever the filter mode changed
+     *
+     * @param[in] iMode        the filter mode.
+     */
+    void onFilterModeChanged(int iMode);
+
     QString                                 m_sSettingsPath;                /**< The settings path to store the GUI settings to. */
 
     QSharedPointer<FilterDesignView>        m_pFilterView;                  /**< The filter view. */
@@ -416,157 +416,187 @@ MatrixXd RtFiffRawViewModel::getLastBlock()
 
 void RtFiffRawViewModel::addData(const QList<MatrixXd> &data)
 {
-    //SSP
-    bool doProj = m_bProjActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matProj.cols() ? true : false;
+    //Copy new data into the global data matrix
+    for(qint32 b = 0; b < data.size(); ++b) {
+        if(!addDataBlock(data.at(b))) {
+            return;
+        }
+    }
 
-    //Compensator
-    bool doComp = m_bCompActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matComp.cols() ? true : false;
+    //Update data content
+    QModelIndex topLeft = this->index(0,1);
+    QModelIndex bottomRight = this->index(m_pFiffInfo->ch_names.size()-1,1);
+    QVector<int> roles; roles << Qt::DisplayRole;
 
-    //SPHARA
-    bool doSphara = m_bSpharaActivated && m_matSparseSpharaMult.cols() > 0 && m_matDataRaw.rows() == m_matSparseSpharaMult.cols() ? true : false;
+    emit dataChanged(topLeft, bottomRight, roles);
+}
 
-    //Copy new data into the global data matrix
-    for(qint32 b = 0; b < data.size(); ++b) {
-        int nCol = data.at(b).cols();
-        int nRow = data.at(b).rows();
+//=============================================================================================================
 
-        if(nRow != m_matDataRaw.rows()) {
-            qDebug()<<"incoming data does not match internal data row size. Returning...";
+void RtFiffRawViewModel::addData(const QList<QSharedPointer<const MatrixXd> > &data)
+{
+    //Copy new data into the global data matrix. The shared blocks are read in place.
+    for(qint32 b = 0; b < data.size(); ++b) {
+        if(!addDataBlock(*data.at(b))) {
             return;
         }
+    }
 
-        //Reset m_iCurrentSample and start filling the data matrix from the beginning again. Also add residual amount of data to the end of the matrix.
-        if(m_iCurrentSample+nCol > m_matDataRaw.cols()) {
-            m_iResidual = nCol - ((m_iCurrentSample+nCol) % m_matDataRaw.cols());
+    //Update data content
+    QModelIndex topLeft = this->index(0,1);
+    QModelIndex bottomRight = this->index(m_pFiffInfo->ch_names.size()-1,1);
+    QVector<int> roles; roles << Qt::DisplayRole;
 
-            if(m_iResidual == nCol) {
-                m_iResidual = 0;
-            }
+    emit dataChanged(topLeft, bottomRight, roles);
+}
 
-//            std::cout<<"incoming data exceeds internal data cols by: "<<(m_iCurrentSample+nCol) % m_matDataRaw.cols()<<std::endl;
-//            std::cout<<"m_iCurrentSample+nCol: "<<m_iCurrentSample+nCol<<std::endl;
-//            std::cout<<"m_matDataRaw.cols(): "<<m_matDataRaw.cols()<<std::endl;
-//            std::cout<<"nCol-m_iResidual: "<<nCol-m_iResidual<<std::endl<<std::endl;
+//=============================================================================================================
 
-            if(doComp) {
-                if(doProj) {
-                    //Comp + Proj
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjCompMult * data.at(b).block(0,0,nRow,m_iResidual);
-                } else {
-                    //Comp
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseCompMult * data.at(b).block(0,0,nRow,m_iResidual);
-                }
-            } else {
-                if(doProj)
-                {
-                    //Proj
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjMult * data.at(b).block(0,0,nRow,m_iResidual);
-                } else {
-                    //None - Raw
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = data.at(b).block(0,0,nRow,m_iResidual);
-                }
-            }
+bool RtFiffRawViewModel::addDataBlock(const MatrixXd &matData)
+{
+    //SSP
+    bool doProj = m_bProjActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matProj.cols() ? true : false;
 
-            m_iCurrentStartingSample += m_iCurrentSample;
-            m_iCurrentStartingSample += m_iResidual;
+    //Compensator
+    bool doComp = m_bCompActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matComp.cols() ? true : false;
+
+    //SPHARA
+    bool doSphara = m_bSpharaActivated && m_matSparseSpharaMult.cols() > 0 && m_matDataRaw.rows() == m_matSparseSpharaMult.cols() ? true : false;
 
-            m_iCurrentSample = 0;
+    int nCol = matData.cols();
+    int nRow = matData.rows();
 
-            if(!m_bIsFreezed) {
-                m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
-                m_vecLastBlockFirstValuesRaw = m_matDataRaw.col(0);
-            }
+    if(nRow != m_matDataRaw.rows()) {
+        qDebug()<<"incoming data does not match internal data row size. Returning...";
+        return false;
+    }
 
-            //Store old detected triggers
-            m_qMapDetectedTriggerOld = m_qMapDetectedTrigger;
+    //Reset m_iCurrentSample and start filling the data matrix from the beginning again. Also add residual amount of data to the end of the matrix.
+    if(m_iCurrentSample+nCol > m_matDataRaw.cols()) {
+        m_iResidual = nCol - ((m_iCurrentSample+nCol) % m_matDataRaw.cols());
 
-            //Clear detected triggers
-            if(m_bTriggerDetectionActive) {
-                QMutableMapIterator<int,QList<QPair<int,double> > > i(m_qMapDetectedTrigger);
-                while (i.hasNext()) {
-                    i.next();
-                    i.value().clear();
-                }
-            }
-        } else {
+        if(m_iResidual == nCol) {
             m_iResidual = 0;
         }
 
-        //std::cout<<"incoming data is ok"<<std::endl;
+//        std::cout<<"incoming data exceeds internal data cols by: "<<(m_iCurrentSample+nCol) % m_matDataRaw.cols()<<std::endl;
+//        std::cout<<"m_iCurrentSample+nCol: "<<m_iCurrentSample+nCol<<std::endl;
+//        std::cout<<"m_matDataRaw.cols(): "<<m_matDataRaw.cols()<<std::endl;
+//        std::cout<<"nCol-m_iResidual: "<<nCol-m_iResidual<<std::endl<<std::endl;
 
         if(doComp) {
             if(doProj) {
                 //Comp + Proj
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjCompMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjCompMult * matData.block(0,0,nRow,m_iResidual);
             } else {
                 //Comp
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseCompMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseCompMult * matData.block(0,0,nRow,m_iResidual);
             }
         } else {
-            if(doProj) {
+            if(doProj)
+            {
                 //Proj
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjMult * matData.block(0,0,nRow,m_iResidual);
             } else {
                 //None - Raw
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = matData.block(0,0,nRow,m_iResidual);
             }
         }
 
-        //Filter if neccessary else set filtered data matrix to zero
-        if(!m_filterKernel.isEmpty() && m_bPerformFiltering) {
-            filterDataBlock(m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol), m_iCurrentSample);
+        m_iCurrentStartingSample += m_iCurrentSample;
+        m_iCurrentStartingSample += m_iResidual;
 
-            //Perform SPHARA on filtered data after actual filtering - SPHARA should be applied on the best possible data
-            if(doSphara) {
-                if(m_iCurrentSample-m_iMaxFilterLength/2 >= 0) {
-                    m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol);
-                }
-                else {
-                    if(m_iCurrentSample-m_iMaxFilterLength/2 < 0) {
-                        m_matDataFiltered.block(0, 0, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, 0, nRow, nCol);
-                        int iResidual = m_iResidual+m_iMaxFilterLength/2;
-                        m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual);
-                    }
-                }
-            }
-        } else {
-            m_matDataFiltered.block(0, m_iCurrentSample, nRow, nCol).setZero();// = m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+        m_iCurrentSample = 0;
 
-            //Perform SPHARA on raw data data
-            if(doSphara) {
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseSpharaMult * m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
-            }
+        if(!m_bIsFreezed) {
+            m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
+            m_vecLastBlockFirstValuesRaw = m_matDataRaw.col(0);
         }
 
-        m_iCurrentSample += nCol;
-        m_iCurrentBlockSize = nCol;
+        //Store old detected triggers
+        m_qMapDetectedTriggerOld = m_qMapDetectedTrigger;
 
-        //detect the trigger flanks in the trigger channels
+        //Clear detected triggers
         if(m_bTriggerDetectionActive) {
-            int iOldDetectedTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size();
+            QMutableMapIterator<int,QList<QPair<int,double> > > i(m_qMapDetectedTrigger);
+            while (i.hasNext()) {
+                i.next();
+                i.value().clear();
+            }
+        }
+    } else {
+        m_iResidual = 0;
+    }
 
-            QList<QPair<int,double> > qMapDetectedTrigger = RTPROCESSINGLIB::detectTriggerFlanksMax(data.at(b), m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, true, 500);
-            //QList<QPair<int,double> > qMapDetectedTrigger = RTPROCESSINGLIB::detectTriggerFlanksGrad(data.at(b), m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, false, "Rising");
+    //std::cout<<"incoming data is ok"<<std::endl;
 
-            //Append results to already found triggers
-            m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].append(qMapDetectedTrigger);
+    if(doComp) {
+        if(doProj) {
+            //Comp + Proj
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjCompMult * matData;
+        } else {
+            //Comp
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseCompMult * matData;
+        }
+    } else {
+        if(doProj) {
+            //Proj
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjMult * matData;
+        } else {
+            //None - Raw
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = matData;
+        }
+    }
 
-            //Compute newly counted triggers
-            int newTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size() - iOldDetectedTriggers;
+    //Filter if neccessary else set filtered data matrix to zero
+    if(!m_filterKernel.isEmpty() && m_bPerformFiltering) {
+        filterDataBlock(m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol), m_iCurrentSample);
 
-            if(newTriggers!=0) {
-                m_iDetectedTriggers += newTriggers;
-                emit triggerDetected(m_iDetectedTriggers, m_qMapDetectedTrigger);
+        //Perform SPHARA on filtered data after actual filtering - SPHARA should be applied on the best possible data
+        if(doSphara) {
+            if(m_iCurrentSample-m_iMaxFilterLength/2 >= 0) {
+                m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol);
+            }
+            else {
+                if(m_iCurrentSample-m_iMaxFilterLength/2 < 0) {
+                    m_matDataFiltered.block(0, 0, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, 0, nRow, nCol);
+                    int iResidual = m_iResidual+m_iMaxFilterLength/2;
+                    m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual);
+                }
             }
         }
+    } else {
+        m_matDataFiltered.block(0, m_iCurrentSample, nRow, nCol).setZero();// = m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+
+        //Perform SPHARA on raw data data
+        if(doSphara) {
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseSpharaMult * m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+        }
     }
 
-    //Update data content
-    QModelIndex topLeft = this->index(0,1);
-    QModelIndex bottomRight = this->index(m_pFiffInfo->ch_names.size()-1,1);
-    QVector<int> roles; roles << Qt::DisplayRole;
+    m_iCurrentSample += nCol;
+    m_iCurrentBlockSize = nCol;
 
-    emit dataChanged(topLeft, bottomRight, roles);
+    //detect the trigger flanks in the trigger channels
+    if(m_bTriggerDetectionActive) {
+        int iOldDetectedTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size();
+
+        QList<QPair<int,double> > qMapDetectedTrigger = RTPROCESSINGLIB::detectTriggerFlanksMax(matData, m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, true, 500);
+        //QList<QPair<int,double> > qMapDetectedTrigger = RTPROCESSINGLIB::detectTriggerFlanksGrad(matData, m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, false, "Rising");
+
+        //Append results to already found triggers
+        m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].append(qMapDetectedTrigger);
+
+        //Compute newly counted triggers
+        int newTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size() - iOldDetectedTriggers;
+
+        if(newTriggers!=0) {
+            m_iDetectedTriggers += newTriggers;
+            emit triggerDetected(m_iDetectedTriggers, m_qMapDetectedTrigger);
+        }
+    }
+
+    return true;
 }
 
 //=============================================================================================================
@@ -198,6 +198,14 @@ public:
      */
     void addData(const QList<Eigen::MatrixXd> &data);
 
+    //=========================================================================================================
+    /**
+     * Adds multiple time points for a channel set. The shared blocks are read in place and not copied.
+     *
+     * @param[in] data       shared data blocks to add (Time points of channel samples).
+     */
+    void addData(const QList<QSharedPointer<const Eigen::MatrixXd> > &data);
+
     //=========================================================================================================
     /**
      * Returns the kind of a given channel number
@@ -558,6 +566,16 @@ private:
 
     static void doFilterPerChannelRTMSA(QPair<QList<RTPROCESSINGLIB::FilterKernel>,QPair<int,Eigen::RowVectorXd> > &channelDataTime);
 
+    //=========================================================================================================
+    /**
+     * Copies one data block into the global data matrix and filters it
+     *
+     * @param[in] matData       data block to add (Time points of channel samples).
+     *
+     * @return false if the number of rows does not match the model.
+     */
+    bool addDataBlock(const Eigen::MatrixXd &matData);
+
     //=========================================================================================================
     /**
      * Calculates the filtered version of the channels in m_matDataRaw
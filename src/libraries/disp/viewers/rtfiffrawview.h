@@ -51,6 +51,7 @@
 //=============================================================================================================
 
 #include <QPointer>
+#include <QSharedPointer>
 #include <QMap>
 
 //=============================================================================================================
@@ -150,6 +151,14 @@ public:
      */
     void addData(const QList<Eigen::MatrixXd>& data);
 
+    //=========================================================================================================
+    /**
+     * Add shared data blocks to the view. The blocks are read in place and not copied.
+     *
+     * @param[in] data    The new data blocks.
+     */
+    void addData(const QList<QSharedPointer<const Eigen::MatrixXd> >& data);
+
     //=========================================================================================================
     /**
      * Get the latest data block from the underlying model.
@@ -455,6 +464,12 @@ protected:
      */
     void markChBad();
 
+    //=========================================================================================================
+    /**
+     * Hides or shows the rows of the bad channels after new data was added
+     */
+    void updateBadChannelRows();
+
     //=========================================================================================================
     /**
      * Adds event based on last clicked position.
@@ -427,6 +427,9 @@ namespace FIFFLIB
  */
 #define FIFF_MNE_RT_COMMAND         3700              /**< Fiff Real-Time Command. */
 #define FIFF_MNE_RT_CLIENT_ID       3701              /**< Fiff Real-Time mne_t_server client id. */
+#define FIFF_MNE_RT_COMPRESSED_BUFFER 3702            /**< Fiff Real-Time losslessly compressed raw buffer. */
+#define FIFF_MNE_RT_CALIBRATIONS    3703              /**< Fiff Real-Time calibrations of the compressed raw buffers. */
+#define FIFF_MNE_RT_SHARED_MEMORY   3704              /**< Fiff Real-Time switch of the raw buffers to (1) or from (0) the shared memory ring. */
 
 /*
  * 3710... Real-Time Blocks
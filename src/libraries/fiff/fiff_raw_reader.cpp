@@ -0,0 +1,445 @@
+//=============================================================================================================
+/**
+ * @file     fiff_raw_reader.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    FiffRawReader class definition.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_raw_reader.h"
+#include "fiff_tag.h"
+#include "fiff_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QSysInfo>
+#include <QtEndian>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC METHODS
+//=============================================================================================================
+
+/**
+ * Reads one sample of type T, stored as the unsigned integer type U, from the mapped file.
+ */
+template<typename T, typename U>
+static inline double readMappedSample(const char* pData, bool bSwap)
+{
+    U bits;
+    memcpy(&bits, pData, sizeof(U));
+    if(bSwap) {
+        bits = qbswap(bits);
+    }
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return static_cast<double>(value);
+}
+
+//=============================================================================================================
+
+/**
+ * Converts and multiplies in one pass: Only channels which are used by the operator are touched.
+ */
+template<typename T, typename U>
+static void applyMappedOperator(const SparseMatrix<double>& mult,
+                                const char* pData,
+                                int nchan,
+                                int first_pick,
+                                int picksamp,
+                                bool bSwap,
+                                Ref<MatrixXd> matOut)
+{
+    matOut.setZero();
+
+    for(int s = 0; s < picksamp; ++s) {
+        const char* pSample = pData + static_cast<qint64>(first_pick + s) * nchan * sizeof(T);
+        for(int k = 0; k < mult.outerSize(); ++k) {
+            SparseMatrix<double>::InnerIterator it(mult, k);
+            if(!it) {
+                continue;
+            }
+            const double dValue = readMappedSample<T,U>(pSample + k * sizeof(T), bSwap);
+            for(; it; ++it) {
+                matOut(it.row(), s) += it.value() * dValue;
+            }
+        }
+    }
+}
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawReader::FiffRawReader()
+: m_iMaxCachedOperators(4)
+, m_iCachedBuffer(-1)
+, m_bUseMemoryMapping(false)
+{
+}
+
+//=============================================================================================================
+
+FiffRawReader::FiffRawReader(const FiffRawData& raw,
+                             int iMaxCachedOperators)
+: m_iMaxCachedOperators(std::max(1, iMaxCachedOperators))
+, m_iCachedBuffer(-1)
+, m_bUseMemoryMapping(false)
+{
+    setRawData(raw);
+}
+
+//=============================================================================================================
+
+void FiffRawReader::setRawData(const FiffRawData& raw)
+{
+    m_raw = raw;
+    m_bUseMemoryMapping = false;
+
+    m_vecBufferLast.clear();
+    m_vecBufferLast.reserve(m_raw.rawdir.size());
+    for(int k = 0; k < m_raw.rawdir.size(); ++k) {
+        m_vecBufferLast.push_back(m_raw.rawdir[k].last);
+    }
+
+    clearCache();
+}
+
+//=============================================================================================================
+
+bool FiffRawReader::setUseMemoryMapping(bool bUseMemoryMapping)
+{
+    if(!bUseMemoryMapping) {
+        m_bUseMemoryMapping = false;
+        return true;
+    }
+
+    if(m_raw.file.isNull() || !m_raw.file->map_file()) {
+        qWarning() << "[FiffRawReader::setUseMemoryMapping] Memory mapping not available. Falling back to tag reads.";
+        m_bUseMemoryMapping = false;
+        return false;
+    }
+
+    m_bUseMemoryMapping = true;
+    return true;
+}
+
+//=============================================================================================================
+
+void FiffRawReader::clearCache()
+{
+    m_lOperators.clear();
+    m_iCachedBuffer = -1;
+    m_matCachedBuffer.resize(0,0);
+}
+
+//=============================================================================================================
+
+int FiffRawReader::findBuffer(fiff_int_t iSample) const
+{
+    if(m_vecBufferLast.empty() || iSample < m_raw.first_samp || iSample > m_vecBufferLast.back()) {
+        return -1;
+    }
+
+    // First buffer whose last sample is not before the requested one
+    std::vector<fiff_int_t>::const_iterator it = std::lower_bound(m_vecBufferLast.begin(),
+                                                                  m_vecBufferLast.end(),
+                                                                  iSample);
+
+    return static_cast<int>(it - m_vecBufferLast.begin());
+}
+
+//=============================================================================================================
+
+const SparseMatrix<double>& FiffRawReader::dataOperator(const RowVectorXi& sel)
+{
+    for(int i = 0; i < m_lOperators.size(); ++i) {
+        const RowVectorXi& selCached = m_lOperators[i].sel;
+        if(selCached.size() == sel.size() && (sel.size() == 0 || selCached == sel)) {
+            if(i > 0) {
+                m_lOperators.move(i, 0);
+            }
+            return m_lOperators.first().mult;
+        }
+    }
+
+    const int nchan = m_raw.info.nchan;
+    const bool bProjAvailable = m_raw.proj.size() != 0;
+    const bool bCompAvailable = m_raw.comp.kind != -1 && m_raw.comp.data.constData();
+
+    typedef Eigen::Triplet<double> T;
+    std::vector<T> tripletList;
+
+    OperatorCacheEntry entry;
+    entry.sel = sel;
+
+    if(!bProjAvailable && !bCompAvailable) {
+        // Pure selection and calibration, no need for a dense intermediate
+        const int nsel = sel.size() == 0 ? nchan : sel.size();
+        tripletList.reserve(nsel);
+        for(int i = 0; i < nsel; ++i) {
+            const int iChan = sel.size() == 0 ? i : sel[i];
+            tripletList.push_back(T(i, iChan, m_raw.cals[iChan]));
+        }
+        entry.mult = SparseMatrix<double>(nsel, nchan);
+        entry.mult.setFromTriplets(tripletList.begin(), tripletList.end());
+    } else {
+        MatrixXd matMult;
+        if(bProjAvailable) {
+            matMult = bCompAvailable ? MatrixXd(m_raw.proj * m_raw.comp.data.constData()->data) : m_raw.proj;
+        } else {
+            matMult = m_raw.comp.data.constData()->data;
+        }
+
+        if(sel.size() != 0) {
+            MatrixXd matSel(sel.size(), nchan);
+            for(int i = 0; i < sel.size(); ++i) {
+                matSel.row(i) = matMult.row(sel[i]);
+            }
+            matMult = matSel;
+        }
+
+        matMult *= m_raw.cals.transpose().asDiagonal();
+
+        tripletList.reserve(matMult.rows() * 4);
+        for(int i = 0; i < matMult.rows(); ++i) {
+            for(int k = 0; k < matMult.cols(); ++k) {
+                if(matMult(i,k) != 0) {
+                    tripletList.push_back(T(i, k, matMult(i,k)));
+                }
+            }
+        }
+        entry.mult = SparseMatrix<double>(matMult.rows(), matMult.cols());
+        entry.mult.setFromTriplets(tripletList.begin(), tripletList.end());
+    }
+
+    entry.mult.makeCompressed();
+
+    m_lOperators.prepend(entry);
+    while(m_lOperators.size() > m_iMaxCachedOperators) {
+        m_lOperators.removeLast();
+    }
+
+    return m_lOperators.first().mult;
+}
+
+//=============================================================================================================
+
+const MatrixXd& FiffRawReader::readBuffer(int iBuffer)
+{
+    if(iBuffer == m_iCachedBuffer) {
+        return m_matCachedBuffer;
+    }
+
+    m_iCachedBuffer = -1;
+    m_matCachedBuffer.resize(0,0);
+
+    const FiffRawDir& rawDir = m_raw.rawdir[iBuffer];
+
+    if(rawDir.ent.isNull() || rawDir.ent->kind == -1) {
+        // Skips are translated to zeros by the caller
+        return m_matCachedBuffer;
+    }
+
+    if(!m_raw.file->device()->isOpen()) {
+        if(!m_raw.file->device()->open(QIODevice::ReadOnly)) {
+            qWarning() << "[FiffRawReader::readBuffer] Cannot open file" << m_raw.info.filename;
+            return m_matCachedBuffer;
+        }
+    }
+
+    FiffTag::SPtr t_pTag;
+    if(!m_raw.file->read_tag(t_pTag, rawDir.ent->pos)) {
+        qWarning() << "[FiffRawReader::readBuffer] Could not read buffer" << iBuffer;
+        return m_matCachedBuffer;
+    }
+
+    const int nchan = m_raw.info.nchan;
+
+    if(t_pTag->type == FIFFT_DAU_PACK16) {
+        m_matCachedBuffer = (Map< MatrixDau16 >(t_pTag->toDauPack16(), nchan, rawDir.nsamp)).cast<double>();
+    } else if(t_pTag->type == FIFFT_INT) {
+        m_matCachedBuffer = (Map< MatrixXi >(t_pTag->toInt(), nchan, rawDir.nsamp)).cast<double>();
+    } else if(t_pTag->type == FIFFT_FLOAT) {
+        m_matCachedBuffer = (Map< MatrixXf >(t_pTag->toFloat(), nchan, rawDir.nsamp)).cast<double>();
+    } else if(t_pTag->type == FIFFT_SHORT) {
+        m_matCachedBuffer = (Map< MatrixShort >(t_pTag->toShort(), nchan, rawDir.nsamp)).cast<double>();
+    } else {
+        qWarning() << "[FiffRawReader::readBuffer] Data storage format not known yet. Type:" << t_pTag->type;
+        return m_matCachedBuffer;
+    }
+
+    m_iCachedBuffer = iBuffer;
+
+    return m_matCachedBuffer;
+}
+
+//=============================================================================================================
+
+bool FiffRawReader::applyMappedBuffer(int iBuffer,
+                                      const SparseMatrix<double>& mult,
+                                      int first_pick,
+                                      int picksamp,
+                                      Ref<MatrixXd> matOut) const
+{
+    const FiffRawDir& rawDir = m_raw.rawdir[iBuffer];
+
+    fiff_int_t kind, type, size;
+    const char* pData = m_raw.file->mapped_tag_data(rawDir.ent->pos, kind, type, size);
+    if(!pData) {
+        return false;
+    }
+
+    const int nchan = m_raw.info.nchan;
+    const bool bSwap = (m_raw.file->byteOrder() == QDataStream::BigEndian) != (QSysInfo::ByteOrder == QSysInfo::BigEndian);
+
+    switch(type) {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            if(size < static_cast<qint64>(nchan) * rawDir.nsamp * 2) {
+                return false;
+            }
+            applyMappedOperator<qint16,quint16>(mult, pData, nchan, first_pick, picksamp, bSwap, matOut);
+            return true;
+        case FIFFT_INT:
+            if(size < static_cast<qint64>(nchan) * rawDir.nsamp * 4) {
+                return false;
+            }
+            applyMappedOperator<qint32,quint32>(mult, pData, nchan, first_pick, picksamp, bSwap, matOut);
+            return true;
+        case FIFFT_FLOAT:
+            if(size < static_cast<qint64>(nchan) * rawDir.nsamp * 4) {
+                return false;
+            }
+            applyMappedOperator<float,quint32>(mult, pData, nchan, first_pick, picksamp, bSwap, matOut);
+            return true;
+        default:
+            qWarning() << "[FiffRawReader::applyMappedBuffer] Data storage format not known yet. Type:" << type;
+            return false;
+    }
+}
+
+//=============================================================================================================
+
+bool FiffRawReader::read_raw_segment(MatrixXd& data,
+                                     MatrixXd& times,
+                                     fiff_int_t from,
+                                     fiff_int_t to,
+                                     const RowVectorXi& sel)
+{
+    if(m_raw.isEmpty() || m_raw.file.isNull() || m_vecBufferLast.empty()) {
+        qWarning() << "[FiffRawReader::read_raw_segment] No raw data set.";
+        return false;
+    }
+
+    if(from == -1)
+        from = m_raw.first_samp;
+    if(to == -1)
+        to = m_raw.last_samp;
+
+    if(from < m_raw.first_samp)
+        from = m_raw.first_samp;
+    if(to > m_raw.last_samp)
+        to = m_raw.last_samp;
+
+    if(from > to) {
+        printf("No data in this range %d ... %d  =  %9.3f ... %9.3f secs...", from, to, ((float)from)/m_raw.info.sfreq, ((float)to)/m_raw.info.sfreq);
+        return false;
+    }
+
+    const SparseMatrix<double>& mult = dataOperator(sel);
+
+    const int iFirstBuffer = findBuffer(from);
+    if(iFirstBuffer < 0) {
+        return false;
+    }
+
+    data.resize(mult.rows(), to - from + 1);
+
+    fiff_int_t dest = 0;
+    fiff_int_t first_pick, picksamp;
+
+    for(int k = iFirstBuffer; k < m_raw.rawdir.size() && dest < data.cols(); ++k) {
+        const FiffRawDir& rawDir = m_raw.rawdir[k];
+
+        first_pick = std::max(from, rawDir.first) - rawDir.first;
+        picksamp = std::min(to, rawDir.last) - rawDir.first - first_pick + 1;
+
+        if(picksamp <= 0) {
+            continue;
+        }
+
+        if(rawDir.ent.isNull() || rawDir.ent->kind == -1) {
+            data.block(0, dest, data.rows(), picksamp).setZero();
+            dest += picksamp;
+            continue;
+        }
+
+        if(m_bUseMemoryMapping && m_raw.file->is_mapped()) {
+            if(applyMappedBuffer(k, mult, first_pick, picksamp, data.middleCols(dest, picksamp))) {
+                dest += picksamp;
+                continue;
+            }
+        }
+
+        const MatrixXd& matBuffer = readBuffer(k);
+
+        if(matBuffer.size() == 0) {
+            data.block(0, dest, data.rows(), picksamp).setZero();
+        } else {
+            // Only apply the operator to the samples which are actually needed
+            data.block(0, dest, data.rows(), picksamp) = mult * matBuffer.middleCols(first_pick, picksamp);
+        }
+
+        dest += picksamp;
+    }
+
+    times.resize(1, to - from + 1);
+    for(int i = 0; i < times.cols(); ++i) {
+        times(0, i) = ((float)(from + i)) / m_raw.info.sfreq;
+    }
+
+    return true;
+}
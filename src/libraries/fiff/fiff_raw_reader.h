@@ -0,0 +1,245 @@
+//=============================================================================================================
+/**
+ * @file     fiff_raw_reader.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    FiffRawReader class declaration.
+ *
+ */
+
+#ifndef FIFF_RAW_READER_H
+#define FIFF_RAW_READER_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_raw_data.h"
+
+#include <vector>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QSharedPointer>
+
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+//=============================================================================================================
+/**
+ * Persistent random-access reader for FIFF raw data. In contrast to FiffRawData::read_raw_segment, which walks
+ * the whole raw directory and rebuilds the calibration/projection operator on every call, the reader keeps a
+ * sorted sample-to-buffer index, caches the combined proj*comp*cal operator per pick set and keeps the most
+ * recently decoded buffer. Small windows are therefore served in O(log n) without repeated setup.
+ *
+ * Optionally, the file can be memory mapped (see setUseMemoryMapping). Buffers are then decoded directly from the
+ * mapped file and the byte order conversion is fused into the application of the data operator, so that a segment
+ * read costs one pass over the needed samples without intermediate tag copies.
+ *
+ * The reader is not thread safe. Use one reader per thread.
+ *
+ * @brief Indexed random-access reader for FIFF raw data.
+ */
+class FIFFSHARED_EXPORT FiffRawReader
+{
+public:
+    typedef QSharedPointer<FiffRawReader> SPtr;               /**< Shared pointer type for FiffRawReader. */
+    typedef QSharedPointer<const FiffRawReader> ConstSPtr;    /**< Const shared pointer type for FiffRawReader. */
+
+    //=========================================================================================================
+    /**
+     * Default constructor.
+     */
+    FiffRawReader();
+
+    //=========================================================================================================
+    /**
+     * Constructs a reader for the given raw data.
+     *
+     * @param[in] raw                    The raw data to read from. Projection and compensators must be set up already.
+     * @param[in] iMaxCachedOperators    Maximum number of pick sets for which the data operator is cached. Default is 4.
+     */
+    explicit FiffRawReader(const FiffRawData& raw,
+                           int iMaxCachedOperators = 4);
+
+    //=========================================================================================================
+    /**
+     * Sets the raw data to read from and rebuilds the buffer index. All caches are cleared.
+     *
+     * @param[in] raw    The raw data to read from.
+     */
+    void setRawData(const FiffRawData& raw);
+
+    //=========================================================================================================
+    /**
+     * Returns the raw data the reader operates on.
+     *
+     * @return The raw data.
+     */
+    inline const FiffRawData& rawData() const;
+
+    //=========================================================================================================
+    /**
+     * Switches memory mapped, zero-copy buffer access on or off. Requires the raw data to be read from a file.
+     *
+     * @param[in] bUseMemoryMapping  Whether to memory map the file.
+     *
+     * @return true if the requested mode is active, false if the file could not be mapped.
+     */
+    bool setUseMemoryMapping(bool bUseMemoryMapping);
+
+    //=========================================================================================================
+    /**
+     * Returns whether buffers are read from the memory mapped file.
+     *
+     * @return true if memory mapping is used, false otherwise.
+     */
+    inline bool usesMemoryMapping() const;
+
+    //=========================================================================================================
+    /**
+     * Clears the cached data operators and the cached buffer. Call this after changing the projection or
+     * compensator of the underlying raw data.
+     */
+    void clearCache();
+
+    //=========================================================================================================
+    /**
+     * Returns the index of the raw directory entry which contains the given sample.
+     *
+     * @param[in] iSample    The sample (including first_samp).
+     *
+     * @return The raw directory index, -1 if the sample is outside of the recording.
+     */
+    int findBuffer(fiff_int_t iSample) const;
+
+    //=========================================================================================================
+    /**
+     * Read a specific raw data segment. Behaves like FiffRawData::read_raw_segment.
+     *
+     * @param[out] data      returns the data matrix (channels x samples).
+     * @param[out] times     returns the time values corresponding to the samples.
+     * @param[in] from       first sample to include. If omitted, defaults to the first sample in data (optional).
+     * @param[in] to         last sample to include. If omitted, defaults to the last sample in data (optional).
+     * @param[in] sel        channel selection vector (optional).
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool read_raw_segment(Eigen::MatrixXd& data,
+                          Eigen::MatrixXd& times,
+                          fiff_int_t from = -1,
+                          fiff_int_t to = -1,
+                          const Eigen::RowVectorXi& sel = defaultRowVectorXi);
+
+    //=========================================================================================================
+    /**
+     * Returns the combined selection*proj*comp*cal operator for the given pick set. The operator is created
+     * on first use and cached afterwards.
+     *
+     * @param[in] sel        channel selection vector. An empty vector selects all channels.
+     *
+     * @return The data operator (n selected channels x nchan).
+     */
+    const Eigen::SparseMatrix<double>& dataOperator(const Eigen::RowVectorXi& sel = defaultRowVectorXi);
+
+private:
+    //=========================================================================================================
+    /**
+     * Reads the uncalibrated samples of a raw directory entry. The last read buffer is kept in memory.
+     *
+     * @param[in] iBuffer    The raw directory index.
+     *
+     * @return The uncalibrated buffer (nchan x nsamp), an empty matrix for skips or on failure.
+     */
+    const Eigen::MatrixXd& readBuffer(int iBuffer);
+
+    //=========================================================================================================
+    /**
+     * Applies the data operator to a part of a buffer which is read directly from the memory mapped file.
+     *
+     * @param[in] iBuffer    The raw directory index.
+     * @param[in] mult       The data operator.
+     * @param[in] first_pick The first sample inside the buffer.
+     * @param[in] picksamp   The number of samples.
+     * @param[out] matOut    The output block (n selected channels x picksamp).
+     *
+     * @return true if succeeded, false if the buffer could not be accessed.
+     */
+    bool applyMappedBuffer(int iBuffer,
+                           const Eigen::SparseMatrix<double>& mult,
+                           int first_pick,
+                           int picksamp,
+                           Eigen::Ref<Eigen::MatrixXd> matOut) const;
+
+    struct OperatorCacheEntry {
+        Eigen::RowVectorXi          sel;        /**< The pick set. */
+        Eigen::SparseMatrix<double> mult;       /**< The selection*proj*comp*cal operator. */
+    };
+
+    FiffRawData                     m_raw;                      /**< The raw data to read from. */
+    std::vector<fiff_int_t>         m_vecBufferLast;            /**< Last sample of each raw directory entry, sorted ascending. */
+    QList<OperatorCacheEntry>       m_lOperators;               /**< Cached operators, most recently used first. */
+    int                             m_iMaxCachedOperators;      /**< Maximum number of cached operators. */
+    int                             m_iCachedBuffer;            /**< Raw directory index of the cached buffer, -1 if none. */
+    Eigen::MatrixXd                 m_matCachedBuffer;          /**< The cached uncalibrated buffer. */
+    bool                            m_bUseMemoryMapping;        /**< Whether buffers are read from the memory mapped file. */
+};
+
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const FiffRawData& FiffRawReader::rawData() const
+{
+    return m_raw;
+}
+
+//=============================================================================================================
+
+inline bool FiffRawReader::usesMemoryMapping() const
+{
+    return m_bUseMemoryMapping;
+}
+} // NAMESPACE
+
+#endif // FIFF_RAW_READER_H
@@ -84,6 +84,8 @@
 
 #include <QFile>
 #include <QTcpSocket>
+#include <QtEndian>
+#include <QDebug>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -99,6 +101,8 @@ using namespace Eigen;
 
 FiffStream::FiffStream(QIODevice *p_pIODevice)
 : QDataStream(p_pIODevice)
+, m_pMappedData(Q_NULLPTR)
+, m_iMappedSize(0)
 {
     this->setFloatingPointPrecision(QDataStream::SinglePrecision);
     this->setByteOrder(QDataStream::BigEndian);
@@ -110,6 +114,8 @@ FiffStream::FiffStream(QIODevice *p_pIODevice)
 FiffStream::FiffStream(QByteArray * a,
                        QIODevice::OpenMode mode)
 : QDataStream(a, mode)
+, m_pMappedData(Q_NULLPTR)
+, m_iMappedSize(0)
 {
     this->setFloatingPointPrecision(QDataStream::SinglePrecision);
     this->setByteOrder(QDataStream::BigEndian);
@@ -1708,6 +1714,92 @@ bool FiffStream::read_tag(FiffTag::SPtr &p_pTag,
 
 //=============================================================================================================
 
+bool FiffStream::map_file()
+{
+    if(is_mapped()) {
+        return true;
+    }
+
+    QFile* pFile = qobject_cast<QFile*>(this->device());
+    if(!pFile) {
+        qWarning() << "[FiffStream::map_file] Memory mapping is only supported for files.";
+        return false;
+    }
+
+    if(!pFile->isOpen() && !pFile->open(QIODevice::ReadOnly)) {
+        qWarning() << "[FiffStream::map_file] Cannot open file" << pFile->fileName();
+        return false;
+    }
+
+    m_iMappedSize = pFile->size();
+    m_pMappedData = m_iMappedSize > 0 ? pFile->map(0, m_iMappedSize) : Q_NULLPTR;
+
+    if(!m_pMappedData) {
+        qWarning() << "[FiffStream::map_file] Could not map file" << pFile->fileName();
+        m_iMappedSize = 0;
+        return false;
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+void FiffStream::unmap_file()
+{
+    if(m_pMappedData) {
+        QFile* pFile = qobject_cast<QFile*>(this->device());
+        if(pFile && pFile->isOpen()) {
+            pFile->unmap(m_pMappedData);
+        }
+    }
+
+    m_pMappedData = Q_NULLPTR;
+    m_iMappedSize = 0;
+}
+
+//=============================================================================================================
+
+bool FiffStream::is_mapped() const
+{
+    // QFile::close releases all mappings
+    return m_pMappedData && this->device() && this->device()->isOpen();
+}
+
+//=============================================================================================================
+
+const char* FiffStream::mapped_tag_data(fiff_long_t pos,
+                                        fiff_int_t& kind,
+                                        fiff_int_t& type,
+                                        fiff_int_t& size) const
+{
+    const qint64 iHeaderSize = 4 * sizeof(fiff_int_t);
+
+    if(!is_mapped() || pos < 0 || pos + iHeaderSize > m_iMappedSize) {
+        return Q_NULLPTR;
+    }
+
+    const uchar* pTag = m_pMappedData + pos;
+
+    if(this->byteOrder() == QDataStream::BigEndian) {
+        kind = qFromBigEndian<qint32>(pTag);
+        type = qFromBigEndian<qint32>(pTag + 4);
+        size = qFromBigEndian<qint32>(pTag + 8);
+    } else {
+        kind = qFromLittleEndian<qint32>(pTag);
+        type = qFromLittleEndian<qint32>(pTag + 4);
+        size = qFromLittleEndian<qint32>(pTag + 8);
+    }
+
+    if(size < 0 || pos + iHeaderSize + size > m_iMappedSize) {
+        return Q_NULLPTR;
+    }
+
+    return reinterpret_cast<const char*>(pTag + iHeaderSize);
+}
+
+//=============================================================================================================
+
 bool FiffStream::setup_read_raw(QIODevice &p_IODevice,
                                 FiffRawData& data,
                                 bool allow_maxshield,
@@ -427,6 +427,48 @@ public:
     bool read_tag(QSharedPointer<FiffTag>& p_pTag,
                   fiff_long_t pos = -1);
 
+    //=========================================================================================================
+    /**
+     * Maps the underlying file into memory. Afterwards tag data can be accessed without copying via
+     * mapped_tag_data. Only available if the stream operates on a QFile. Closing the file invalidates the
+     * mapping.
+     *
+     * @return true if the file is mapped, false otherwise.
+     */
+    bool map_file();
+
+    //=========================================================================================================
+    /**
+     * Releases the memory mapping created with map_file.
+     */
+    void unmap_file();
+
+    //=========================================================================================================
+    /**
+     * Returns whether the underlying file is currently memory mapped.
+     *
+     * @return true if the file is mapped, false otherwise.
+     */
+    bool is_mapped() const;
+
+    //=========================================================================================================
+    /**
+     * Returns a view on the data of the tag located at pos inside the memory mapped file. The data is not
+     * converted and stays in the byte order of the stream, see byteOrder(). The file needs to be mapped via
+     * map_file beforehand.
+     *
+     * @param[in] pos        position of the tag inside the fif file.
+     * @param[out] kind      the tag kind.
+     * @param[out] type      the tag data type.
+     * @param[out] size      the tag data size in bytes.
+     *
+     * @return pointer to the tag data inside the mapped file, NULL if not mapped or pos is out of range.
+     */
+    const char* mapped_tag_data(fiff_long_t pos,
+                                fiff_int_t& kind,
+                                fiff_int_t& type,
+                                fiff_int_t& size) const;
+
     //=========================================================================================================
     /**
      * fiff_setup_read_raw
@@ -886,6 +928,8 @@ private:
     QList<FiffDirEntry::SPtr>   m_dir;  /**< This is the directory. If no directory exists, open automatically scans the file to create one. */
 //    int         nent;           /**< How many entries?. */ -> Use nent() instead
     FiffDirNode::SPtr           m_dirtree; /**< Directory compiled into a tree. */
+    uchar*                      m_pMappedData;  /**< Start of the memory mapped file, NULL if not mapped. */
+    qint64                      m_iMappedSize;  /**< Size of the memory mapped region in bytes. */
 //    char        *ext_file_name; /**< Name of the file holding the external data. */
 //    FILE        *ext_fd;        /**< The file descriptor of the above file if open . */
 
@@ -2186,6 +2186,7 @@ void ComputeFwd::initFwd()
             return;
         }
         printf("\nLoading the solution matrix...\n");
+        m_bemModel->sol_cache_dir = m_pSettings->bemcachedir;
         if (FwdBemModel::fwd_bem_load_recompute_solution(m_pSettings->bemname.toUtf8().data(),FWD_BEM_UNKNOWN,FALSE,m_bemModel) == FAIL) {
             return;
         }
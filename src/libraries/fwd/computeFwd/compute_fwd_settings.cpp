@@ -123,6 +123,7 @@ void ComputeFwdSettings::usage(char *name)
     printf("\t--notrans         head and MRI coordinate systems are identical.\n");
     printf("\t--meas name       take MEG sensor and EEG electrode locations from here\n");
     printf("\t--bem  name       BEM model name\n");
+    printf("\t--bemcache dir    keep computed BEM solutions in this directory and reuse them\n");
     printf("\t--origin x:y:z/mm use a sphere model with this origin (head coordinates/mm)\n");
     printf("\t--eegscalp        scale the electrode locations to the surface of the scalp when using a sphere model\n");
     printf("\t--eegmodels name  read EEG sphere model specifications from here.\n");
@@ -264,6 +265,14 @@ bool ComputeFwdSettings::check_args (int *argc,char **argv)
             }
             bemname = QString(argv[k+1]);
         }
+        else if (strcmp(argv[k],"--bemcache") == 0) {
+            found = 2;
+            if (k == *argc - 1) {
+                qCritical("--bemcache: argument required.");
+                return false;
+            }
+            bemcachedir = QString(argv[k+1]);
+        }
         else if (strcmp(argv[k],"--origin") == 0) {
             found = 2;
             if (k == *argc - 1) {
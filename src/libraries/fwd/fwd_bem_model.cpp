@@ -53,10 +53,17 @@
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_named_matrix.h>
 
+#include <QCryptographicHash>
+#include <QDir>
 #include <QFile>
 #include <QList>
+#include <QLockFile>
+#include <QSaveFile>
 #include <QThread>
+#include <QThreadPool>
 #include <QtConcurrent>
+#include <QAtomicInt>
+#include <QVector>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -117,6 +124,10 @@ static float Qz[] = {0.0,0.0,1.0};
 
 #define FREE_CMATRIX_40(m) mne_free_cmatrix_40((m))
 
+#define FWD_CHUNKS_PER_THREAD 16     /* Source point chunks per thread in the parallel forward computation */
+
+#define FWD_BEM_SOLVE_COLUMNS 256    /* Columns of the inverse solved for in one task */
+
 void mne_free_cmatrix_40 (float **m)
 {
     if (m) {
@@ -195,6 +206,11 @@ float **mne_lu_invert_40(float **mat,int dim)
     return mat;
 }
 
+void hash_add_40(QCryptographicHash& hash, const void *data, int len)
+{
+    hash.addData(QByteArray::fromRawData((const char *)data,len));
+}
+
 void mne_transpose_square_40(float **mat, int n)
 /*
       * In-place transpose of a square matrix
@@ -345,6 +361,8 @@ static struct {
 #define BEM_SUFFIX     "-bem.fif"
 #define BEM_SOL_SUFFIX "-bem-sol.fif"
 
+#define FWD_BEM_CACHE_VERSION "mne-cpp-bem-sol-1"   /* Changing this invalidates all cached solutions */
+
 //============================= misc_util.c =============================
 
 static QString strip_from(const QString& s, const QString& suffix)
@@ -974,77 +992,84 @@ void FwdBemModel::lin_pot_coeff(float *from, MneTriangle* to, double omega[])	/*
 
 //=============================================================================================================
 
-void FwdBemModel::correct_auto_elements(MneSurfaceOld *surf, float **mat)
+void FwdBemModel::correct_auto_row(MneSurfaceOld *surf, int j, float *row)
 /*
-          * Improve auto-element approximation...
+          * Improve auto-element approximation for one row
           */
 {
-    float *row;
     float sum,miss;
     int   nnode = surf->np;
     int   ntri  = surf->ntri;
     int   nmemb;
-    int   j,k;
+    int   k;
     float pi2 = 2.0*M_PI;
     MneTriangle*   tri;
 
 #ifdef SIMPLE
-    for (j = 0; j < nnode; j++) {
-        row = mat[j];
-        sum = 0.0;
-        for (k = 0; k < nnode; k++)
-            sum = sum + row[k];
-        fprintf (stderr,"row %d sum = %g missing = %g\n",j+1,sum/pi2,
-                 1.0-sum/pi2);
-        row[j] = pi2 - sum;
-    }
+    sum = 0.0;
+    for (k = 0; k < nnode; k++)
+        sum = sum + row[k];
+    fprintf (stderr,"row %d sum = %g missing = %g\n",j+1,sum/pi2,
+             1.0-sum/pi2);
+    row[j] = pi2 - sum;
 #else
-    for (j = 0; j < nnode; j++) {
-        /*
-         * How much is missing?
-         */
-        row = mat[j];
-        sum = 0.0;
-        for (k = 0; k < nnode; k++)
-            sum = sum + row[k];
-        miss  = pi2-sum;
-        nmemb = surf->nneighbor_tri[j];
-        /*
-         * The node itself receives one half
-         */
-        row[j] = miss/2.0;
-        /*
-         * The rest is divided evenly among the member nodes...
-         */
-        miss = miss/(4.0*nmemb);
-        for (k = 0,tri = surf->tris; k < ntri; k++,tri++) {
-            if (tri->vert[0] == j) {
-                row[tri->vert[1]] = row[tri->vert[1]] + miss;
-                row[tri->vert[2]] = row[tri->vert[2]] + miss;
-            }
-            else if (tri->vert[1] == j) {
-                row[tri->vert[0]] = row[tri->vert[0]] + miss;
-                row[tri->vert[2]] = row[tri->vert[2]] + miss;
-            }
-            else if (tri->vert[2] == j) {
-                row[tri->vert[0]] = row[tri->vert[0]] + miss;
-                row[tri->vert[1]] = row[tri->vert[1]] + miss;
-            }
+    /*
+     * How much is missing?
+     */
+    sum = 0.0;
+    for (k = 0; k < nnode; k++)
+        sum = sum + row[k];
+    miss  = pi2-sum;
+    nmemb = surf->nneighbor_tri[j];
+    /*
+     * The node itself receives one half
+     */
+    row[j] = miss/2.0;
+    /*
+     * The rest is divided evenly among the member nodes...
+     */
+    miss = miss/(4.0*nmemb);
+    for (k = 0,tri = surf->tris; k < ntri; k++,tri++) {
+        if (tri->vert[0] == j) {
+            row[tri->vert[1]] = row[tri->vert[1]] + miss;
+            row[tri->vert[2]] = row[tri->vert[2]] + miss;
+        }
+        else if (tri->vert[1] == j) {
+            row[tri->vert[0]] = row[tri->vert[0]] + miss;
+            row[tri->vert[2]] = row[tri->vert[2]] + miss;
+        }
+        else if (tri->vert[2] == j) {
+            row[tri->vert[0]] = row[tri->vert[0]] + miss;
+            row[tri->vert[1]] = row[tri->vert[1]] + miss;
         }
-        /*
-         * Just check it it out...
-         *
-        for (k = 0, sum = 0; k < nnode; k++)
-          sum = sum + row[k];
-        fprintf (stderr,"row %d sum = %g\n",j+1,sum/pi2);
-        */
     }
+    /*
+     * Just check it it out...
+     *
+    for (k = 0, sum = 0; k < nnode; k++)
+      sum = sum + row[k];
+    fprintf (stderr,"row %d sum = %g\n",j+1,sum/pi2);
+    */
 #endif
     return;
 }
 
 //=============================================================================================================
 
+void FwdBemModel::correct_auto_elements(MneSurfaceOld *surf, float **mat)
+/*
+          * Improve auto-element approximation...
+          */
+{
+    int j;
+
+    for (j = 0; j < surf->np; j++)
+        correct_auto_row(surf,j,mat[j]);
+    return;
+}
+
+//=============================================================================================================
+
 float **FwdBemModel::fwd_bem_lin_pot_coeff(const QList<MneSurfaceOld*>& surfs)
 /*
  * Calculate the coefficients for linear collocation approach
@@ -1122,12 +1147,79 @@ float **FwdBemModel::fwd_bem_lin_pot_coeff(const QList<MneSurfaceOld*>& surfs)
 
 //=============================================================================================================
 
+void FwdBemModel::fwd_bem_lin_pot_coeff_parallel(const QList<MneSurfaceOld*>& surfs, MatrixXf& mat)
+/*
+ * Calculate the coefficients for linear collocation approach
+ * The rows are computed in parallel and stored into a contiguous
+ * column-major matrix. The values are identical to fwd_bem_lin_pot_coeff.
+ */
+{
+    struct LinPotRow {
+        int surf;   /* Which surface the collocation point is on */
+        int vert;   /* The vertex on that surface */
+        int row;    /* Row in the coefficient matrix */
+    };
+    QVector<LinPotRow> rows;
+    int np_tot,p,j;
+
+    for (p = 0, np_tot = 0; p < surfs.size(); p++) {
+        for (j = 0; j < surfs[p]->np; j++) {
+            LinPotRow one;
+            one.surf = p;
+            one.vert = j;
+            one.row  = np_tot + j;
+            rows.append(one);
+        }
+        np_tot += surfs[p]->np;
+    }
+    mat.resize(np_tot,np_tot);
+
+    printf("\t\t%d x %d coefficients using %d threads ... ",np_tot,np_tot,QThreadPool::globalInstance()->maxThreadCount());
+
+    QtConcurrent::blockingMap(rows, [&surfs, &mat, np_tot](const LinPotRow& r) {
+        MneSurfaceOld*  surf1 = surfs[r.surf];
+        MneSurfaceOld*  surf2;
+        MneTriangle*    tri;
+        QVector<double> row;
+        QVector<float>  res(np_tot);
+        double          omega[3];
+        int             np2,ntri,q,k,c,koff;
+
+        for (q = 0, koff = 0; q < surfs.size(); q++, koff = koff + np2) {
+            surf2 = surfs[q];
+            np2   = surf2->np;
+            ntri  = surf2->ntri;
+
+            row.fill(0.0,np2);
+            for (k = 0, tri = surf2->tris; k < ntri; k++,tri++) {
+                /*
+                 * No contribution from a triangle that
+                 * this vertex belongs to
+                 */
+                if (r.surf == q && (tri->vert[0] == r.vert || tri->vert[1] == r.vert || tri->vert[2] == r.vert))
+                    continue;
+                lin_pot_coeff (surf1->rr[r.vert],tri,omega);
+                for (c = 0; c < 3; c++)
+                    row[tri->vert[c]] = row[tri->vert[c]] - omega[c];
+            }
+            for (k = 0; k < np2; k++)
+                res[k+koff] = row[k];
+            if (r.surf == q)
+                correct_auto_row(surf1,r.vert,res.data()+koff);
+        }
+        mat.row(r.row) = Map<const RowVectorXf>(res.constData(),np_tot);
+    });
+    printf("[done]\n");
+}
+
+//=============================================================================================================
+
 int FwdBemModel::fwd_bem_linear_collocation_solution(FwdBemModel *m)
 /*
      * Compute the linear collocation potential solution
      */
 {
-    float **coeff = NULL;
+    MatrixXf coeff;
     float ip_mult;
     int k;
 
@@ -1136,14 +1228,13 @@ int FwdBemModel::fwd_bem_linear_collocation_solution(FwdBemModel *m)
 
     printf("\nComputing the linear collocation solution...\n");
     fprintf (stderr,"\tMatrix coefficients...\n");
-    if ((coeff = fwd_bem_lin_pot_coeff (m->surfs)) == NULL)
-        goto bad;
+    fwd_bem_lin_pot_coeff_parallel(m->surfs,coeff);
 
     for (k = 0, m->nsol = 0; k < m->nsurf; k++)
         m->nsol += m->surfs[k]->np;
 
     fprintf (stderr,"\tInverting the coefficient matrix...\n");
-    if ((m->solution = fwd_bem_multi_solution (coeff,m->gamma,m->nsurf,m->np)) == NULL)
+    if ((m->solution = fwd_bem_multi_solution_lu(coeff,m->gamma,m->nsurf,m->np)) == NULL)
         goto bad;
 
     /*
@@ -1158,11 +1249,10 @@ int FwdBemModel::fwd_bem_linear_collocation_solution(FwdBemModel *m)
         fprintf (stderr,"\tMatrix coefficients (homog)...\n");
         QList<MneSurfaceOld*> last_surfs;
         last_surfs << m->surfs.last();
-        if ((coeff = fwd_bem_lin_pot_coeff(last_surfs))== NULL)//m->surfs+m->nsurf-1,1)) == NULL)
-            goto bad;
+        fwd_bem_lin_pot_coeff_parallel(last_surfs,coeff);
 
         fprintf (stderr,"\tInverting the coefficient matrix (homog)...\n");
-        if ((ip_solution = fwd_bem_homog_solution (coeff,m->surfs[m->nsurf-1]->np)) == NULL)
+        if ((ip_solution = fwd_bem_multi_solution_lu(coeff,NULL,1,m->np+m->nsurf-1)) == NULL)
             goto bad;
 
         fprintf (stderr,"\tModify the original solution to incorporate IP approach...\n");
@@ -1178,7 +1268,6 @@ int FwdBemModel::fwd_bem_linear_collocation_solution(FwdBemModel *m)
 bad : {
         if(m)
             m->fwd_bem_free_solution();
-        FREE_CMATRIX_40(coeff);
         return FAIL;
     }
 }
@@ -1225,6 +1314,56 @@ float **FwdBemModel::fwd_bem_multi_solution(float **solids, float **gamma, int n
 
 //=============================================================================================================
 
+float **FwdBemModel::fwd_bem_multi_solution_lu(MatrixXf& coeff, float **gamma, int nsurf, int *ntri)
+/*
+          * Same as fwd_bem_multi_solution but for a contiguous column-major matrix
+          * The matrix is factorized in place with a blocked LU decomposition
+          * and the columns of the inverse are solved for in parallel
+          * The matrix is destroyed
+          */
+{
+    int j,p,q;
+    float defl;
+    float pi2 = 1.0/(2*M_PI);
+    float mult;
+    int   joff,koff,ntot;
+
+    for (j = 0,ntot = 0; j < nsurf; j++)
+        ntot += ntri[j];
+    if (coeff.rows() != ntot || coeff.cols() != ntot) {
+        printf("Coefficient matrix dimension mismatch (%d x %d vs. %d x %d)\n",
+               (int)coeff.rows(),(int)coeff.cols(),ntot,ntot);
+        return NULL;
+    }
+    defl = 1.0/ntot;
+    /*
+       * Modify the matrix
+       */
+    for (q = 0, koff = 0; q < nsurf; koff += ntri[q], q++) {
+        for (p = 0, joff = 0; p < nsurf; joff += ntri[p], p++) {
+            mult = (gamma == NULL) ? pi2 : pi2*gamma[p][q];
+            coeff.block(joff,koff,ntri[p],ntri[q]) = (defl - (mult*coeff.block(joff,koff,ntri[p],ntri[q])).array()).matrix();
+        }
+    }
+    coeff.diagonal().array() += 1.0;
+
+    PartialPivLU<Ref<MatrixXf> > lu(coeff);
+
+    float **solution = ALLOC_CMATRIX_40(ntot,ntot);
+    Map<Matrix<float,Dynamic,Dynamic,RowMajor> > sol(solution[0],ntot,ntot);
+    QVector<int> first_cols;
+    for (j = 0; j < ntot; j += FWD_BEM_SOLVE_COLUMNS)
+        first_cols.append(j);
+
+    QtConcurrent::blockingMap(first_cols, [&lu, &sol, ntot](const int& first) {
+        int ncol = qMin(FWD_BEM_SOLVE_COLUMNS, ntot - first);
+        sol.middleCols(first,ncol) = lu.solve(MatrixXf::Identity(ntot,ntot).middleCols(first,ncol));
+    });
+    return solution;
+}
+
+//=============================================================================================================
+
 float **FwdBemModel::fwd_bem_homog_solution(float **solids, int ntri)
 /*
           * Invert I - solids/(2*M_PI)
@@ -1518,7 +1657,115 @@ int FwdBemModel::fwd_bem_load_recompute_solution(const QString& name, int bem_me
     }
     if (bem_method == FWD_BEM_UNKNOWN)
         bem_method = FWD_BEM_LINEAR_COLL;
-    return fwd_bem_compute_solution(m,bem_method);
+    if (m->sol_cache_dir.isEmpty())
+        return fwd_bem_compute_solution(m,bem_method);
+    return fwd_bem_cached_solution(m,bem_method,force_recompute);
+}
+
+//=============================================================================================================
+
+QString FwdBemModel::fwd_bem_solution_cache_key(FwdBemModel *m, int bem_method)
+/*
+ * Hash everything the potential solution depends on:
+ * the surface geometry, the conductivities, the method and the IP approach limit
+ */
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    MneSurfaceOld* surf;
+    int k,j;
+
+    hash.addData(QByteArray(FWD_BEM_CACHE_VERSION));
+    hash_add_40(hash,&bem_method,sizeof(int));
+    hash_add_40(hash,&m->nsurf,sizeof(int));
+    for (k = 0; k < m->nsurf; k++) {
+        surf = m->surfs[k];
+        hash_add_40(hash,&surf->id,sizeof(int));
+        hash_add_40(hash,&surf->np,sizeof(int));
+        hash_add_40(hash,&surf->ntri,sizeof(int));
+        for (j = 0; j < surf->np; j++)
+            hash_add_40(hash,surf->rr[j],3*sizeof(float));
+        for (j = 0; j < surf->ntri; j++)
+            hash_add_40(hash,surf->tris[j].vert,3*sizeof(int));
+    }
+    hash_add_40(hash,m->sigma,m->nsurf*sizeof(float));
+    hash_add_40(hash,&m->ip_approach_limit,sizeof(float));
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+//=============================================================================================================
+
+int FwdBemModel::fwd_bem_save_solution(const QString &name, FwdBemModel *m)
+/*
+ * Write the potential solution matrix into a file
+ * The data go to a temporary file which is renamed when complete
+ * so that other processes never see a partially written solution
+ */
+{
+    int method;
+
+    if (!m || !m->solution) {
+        printf("No BEM solution to save.\n");
+        return FAIL;
+    }
+    QSaveFile file(name);
+    FiffStream::SPtr stream = FiffStream::start_file(file);
+    if (!stream)
+        return FAIL;
+
+    method = (m->bem_method == FWD_BEM_LINEAR_COLL) ? FIFFV_BEM_APPROX_LINEAR : FIFFV_BEM_APPROX_CONST;
+    stream->start_block(FIFFB_BEM);
+    stream->write_int(FIFF_BEM_APPROX,&method);
+    stream->write_float_matrix(FIFF_BEM_POT_SOLUTION,toFloatEigenMatrix_40(m->solution,m->nsol,m->nsol));
+    stream->end_block(FIFFB_BEM);
+    stream->end_file();
+
+    if (!file.commit()) {
+        printf("Could not write the BEM solution to %s (%s)\n",name.toUtf8().constData(),file.errorString().toUtf8().constData());
+        return FAIL;
+    }
+    return OK;
+}
+
+//=============================================================================================================
+
+int FwdBemModel::fwd_bem_cached_solution(FwdBemModel *m, int bem_method, int force_recompute)
+/*
+ * Load the potential solution from the cache or compute and store it there
+ * A lock file per cache entry makes concurrent jobs wait for the one
+ * already computing the same solution instead of repeating the work
+ */
+{
+    QDir    dir(m->sol_cache_dir);
+    QString cache_name;
+
+    if (!dir.mkpath(".")) {
+        printf("Cannot create the BEM solution cache directory %s\n",m->sol_cache_dir.toUtf8().constData());
+        return fwd_bem_compute_solution(m,bem_method);
+    }
+    cache_name = dir.filePath(fwd_bem_solution_cache_key(m,bem_method) + BEM_SOL_SUFFIX);
+
+    QLockFile lock(cache_name + ".lock");
+    lock.setStaleLockTime(0);
+    if (!lock.lock()) {
+        printf("Cannot lock the BEM solution cache entry %s\n",cache_name.toUtf8().constData());
+        return fwd_bem_compute_solution(m,bem_method);
+    }
+
+    if (!force_recompute && QFile::exists(cache_name)) {
+        m->fwd_bem_free_solution();
+        if (fwd_bem_load_solution(cache_name,bem_method,m) == TRUE) {
+            printf("\nLoaded %s BEM solution from the cache (%s)\n",fwd_bem_explain_method(m->bem_method).toUtf8().constData(),cache_name.toUtf8().constData());
+            return OK;
+        }
+        printf("\nIgnoring the unusable cached BEM solution %s\n",cache_name.toUtf8().constData());
+    }
+
+    if (fwd_bem_compute_solution(m,bem_method) == FAIL)
+        return FAIL;
+    if (fwd_bem_save_solution(cache_name,m) == OK)
+        printf("BEM solution saved to the cache (%s)\n",cache_name.toUtf8().constData());
+    return OK;
 }
 
 //=============================================================================================================
@@ -2926,19 +3173,20 @@ int FwdBemModel::fwd_bem_field_grad(float *rd,
 void *FwdBemModel::meg_eeg_fwd_one_source_space(void *arg)
 /*
  * Compute the MEG or EEG forward solution for one source space
- * and possibly for only one source component
+ * or a range of its vertices and possibly for only one source component
  */
 {
     FwdThreadArg* a = (FwdThreadArg*)arg;
     MneSourceSpaceOld* s = a->s;
     int            j,p,q;
+    int            last = a->last_vertex < 0 ? s->np : a->last_vertex;
     float          *xyz[3];
 
     p = a->off;
     q = 3*a->off;
     if (a->fixed_ori) {					  /* The normal source component only */
         if (a->field_pot_grad && a->res_grad) {                   /* Gradient requested? */
-            for (j = 0; j < s->np; j++) {
+            for (j = a->first_vertex; j < last; j++) {
                 if (s->inuse[j]) {
                     if (a->field_pot_grad(s->rr[j],
                                           s->nn[j],
@@ -2955,7 +3203,7 @@ void *FwdBemModel::meg_eeg_fwd_one_source_space(void *arg)
                 }
             }
         } else {
-            for (j = 0; j < s->np; j++)
+            for (j = a->first_vertex; j < last; j++)
                 if (s->inuse[j])
                     if (a->field_pot(s->rr[j],
                                      s->nn[j],
@@ -2967,7 +3215,7 @@ void *FwdBemModel::meg_eeg_fwd_one_source_space(void *arg)
     }
     else {						  /* All source components */
         if (a->field_pot_grad && a->res_grad) {               /* Gradient requested? */
-            for (j = 0; j < s->np; j++) {
+            for (j = a->first_vertex; j < last; j++) {
                 if (s->inuse[j]) {
                     if (a->comp < 0) {				  /* Compute all components */
                         if (a->field_pot_grad(s->rr[j],
@@ -3047,7 +3295,7 @@ void *FwdBemModel::meg_eeg_fwd_one_source_space(void *arg)
             }
         }
         else {
-            for (j = 0; j < s->np; j++) {
+            for (j = a->first_vertex; j < last; j++) {
                 if (s->inuse[j]) {
                     if (a->vec_field_pot) {
                         xyz[0] = a->res[p++];
@@ -3097,6 +3345,86 @@ bad : {
 
 //=============================================================================================================
 
+int FwdBemModel::compute_forward_parallel(FwdThreadArg *one_arg,
+                                          MneSourceSpaceOld **spaces,
+                                          int nspace,
+                                          int nthread,
+                                          bool meg,
+                                          bool bem_model)
+/*
+ * Compute the forward solution with several threads. The in-use source points are split into chunks which the
+ * threads pick up one after the other until all are done, each thread with its own copy of the workspace.
+ * This way the number of tasks no longer depends on the number of source spaces.
+ */
+{
+    struct SourceChunk {
+        MneSourceSpaceOld*  s;      /* The source space */
+        int                 first;  /* First vertex */
+        int                 last;   /* One past the last vertex */
+        int                 off;    /* Offset of the first in-use vertex within the result */
+    };
+    QVector<SourceChunk>    chunks;
+    QList<FwdThreadArg*>    args;
+    QAtomicInt              next_chunk(0);
+    QAtomicInt              failed(0);
+    int                     ncomp = one_arg->fixed_ori ? 1 : 3;
+    int                     nsource,chunk_size,nuse,j,k,off;
+
+    for (k = 0, nsource = 0; k < nspace; k++)
+        nsource += spaces[k]->nuse;
+    /*
+     * Several chunks per thread balance the load, since points close to the BEM surfaces take longer
+     */
+    chunk_size = qMax(1,nsource/(FWD_CHUNKS_PER_THREAD*qMax(1,nthread)));
+    for (k = 0, off = 0; k < nspace; k++) {
+        MneSourceSpaceOld* s = spaces[k];
+        for (j = 0; j < s->np; ) {
+            SourceChunk chunk;
+            chunk.s     = s;
+            chunk.first = j;
+            chunk.off   = off;
+            for (nuse = 0; j < s->np && nuse < chunk_size; j++)
+                if (s->inuse[j])
+                    nuse++;
+            chunk.last = j;
+            if (nuse > 0)
+                chunks.append(chunk);
+            off += ncomp*nuse;
+        }
+    }
+    nthread = qMax(1,qMin(nthread,static_cast<int>(chunks.size())));
+    /*
+     * We need copies to allocate separate workspace for each thread
+     */
+    for (k = 0; k < nthread; k++)
+        args.append(meg ? FwdThreadArg::create_meg_multi_thread_duplicate(one_arg,bem_model)
+                        : FwdThreadArg::create_eeg_multi_thread_duplicate(one_arg,bem_model));
+    QtConcurrent::blockingMap(args, [&chunks, &next_chunk, &failed](FwdThreadArg* a) {
+        int c;
+        a->stat = OK;
+        while (!failed.loadAcquire() && (c = next_chunk.fetchAndAddRelaxed(1)) < chunks.size()) {
+            a->s            = chunks[c].s;
+            a->off          = chunks[c].off;
+            a->first_vertex = chunks[c].first;
+            a->last_vertex  = chunks[c].last;
+            a->comp         = -1;
+            meg_eeg_fwd_one_source_space(a);
+            if (a->stat != OK)
+                failed.storeRelease(1);
+        }
+    });
+
+    for (k = 0; k < args.size(); k++) {
+        if (meg)
+            FwdThreadArg::free_meg_multi_thread_duplicate(args[k],bem_model);
+        else
+            FwdThreadArg::free_eeg_multi_thread_duplicate(args[k],bem_model);
+    }
+    return failed.loadAcquire() ? FAIL : OK;
+}
+
+//=============================================================================================================
+
 int FwdBemModel::compute_forward_meg(MneSourceSpaceOld **spaces,
                                      int nspace,
                                      FwdCoilSet *coils,
@@ -3126,7 +3454,7 @@ int FwdBemModel::compute_forward_meg(MneSourceSpaceOld **spaces,
                                              * for one dipole orientation */
     int                 nmeg = coils->ncoil;/* Number of channels */
     int                 nsource;            /* Total number of sources */
-    int                 k,p,q,off;
+    int                 k,off;
     QStringList         names;              /* Channel names */
     void                *client;
     FwdThreadArg*       one_arg = NULL;
@@ -3242,54 +3570,9 @@ int FwdBemModel::compute_forward_meg(MneSourceSpaceOld **spaces,
         use_threads = false;
 
     if (use_threads) {
-        int            nthread  = (fixed_ori || vec_field || nproc < 6) ? nspace : 3*nspace;
-        QList <FwdThreadArg*> args; //fwdThreadArg   *args    = MALLOC_40(nthread,fwdThreadArg);
-        int            stat;
-        /*
-        * We need copies to allocate separate workspace for each thread
-        */
-        if (fixed_ori || vec_field || nproc < 6) {
-            for (k = 0, off = 0; k < nthread; k++) {
-                FwdThreadArg* t_arg = FwdThreadArg::create_meg_multi_thread_duplicate(one_arg,bem_model != NULL);
-                t_arg->s   = spaces[k];
-                t_arg->off = off;
-                off = fixed_ori ? off + spaces[k]->nuse : off + 3*spaces[k]->nuse;
-                args.append(t_arg);
-            }
-            printf("%d processors. I will use one thread for each of the %d source spaces.\n",
-                    nproc,nspace);
-        }
-        else {
-            for (k = 0, off = 0, q = 0; k < nspace; k++) {
-                for (p = 0; p < 3; p++,q++) {
-                    FwdThreadArg* t_arg = FwdThreadArg::create_meg_multi_thread_duplicate(one_arg,bem_model != NULL);
-                    t_arg->s    = spaces[k];
-                    t_arg->off  = off;
-                    t_arg->comp = p;
-                    args.append(t_arg);
-                }
-                off = fixed_ori ? off + spaces[k]->nuse : off + 3*spaces[k]->nuse;
-            }
-            printf("%d processors. I will use %d threads : %d source spaces x 3 source components.\n",
-                    nproc,nthread,nspace);
-        }
-        printf("Computing MEG at %d source locations (%s orientations)...",
-                nsource,fixed_ori ? "fixed" : "free");
-        /*
-        * Ready to start the threads & Wait for them to complete
-        */
-        QtConcurrent::blockingMap(args, meg_eeg_fwd_one_source_space);
-        /*
-        * Check the results
-        */
-        for (k = 0, stat = OK; k < nthread; k++)
-            if (args[k]->stat != OK) {
-                stat = FAIL;
-                break;
-            }
-        for (k = 0; k < args.size(); k++)//nthread == args.size()
-            FwdThreadArg::free_meg_multi_thread_duplicate(args[k],bem_model != NULL);
-        if (stat != OK)
+        printf("%d processors. Computing MEG at %d source locations (%s orientations) in chunks of source points...",
+                nproc,nsource,fixed_ori ? "fixed" : "free");
+        if (compute_forward_parallel(one_arg,spaces,nspace,nproc,true,bem_model != NULL) != OK)
             goto bad;
     }
     else {
@@ -3387,7 +3670,7 @@ int FwdBemModel::compute_forward_eeg(MneSourceSpaceOld **spaces,
                                              * for one dipole orientation */
     int             nsource;                /* Total number of sources */
     int             neeg = els->ncoil;      /* Number of channels */
-    int             k,p,q,off;
+    int             k,off;
     QStringList     names;                  /* Channel names */
     void            *client;
     FwdThreadArg*   one_arg = NULL;
@@ -3415,6 +3698,7 @@ int FwdBemModel::compute_forward_eeg(MneSourceSpaceOld **spaces,
     else {
         if (m->nfit == 0) {
             printf("Using the standard series expansion for a multilayer sphere model for EEG\n");
+            m->fwd_eeg_precompute_multi_sphere_coeffs();    /* The model is shared by the threads below */
             pot      = FwdEegSphereModel::fwd_eeg_multi_spherepot_coil1;
             vec_pot  = NULL;
             pot_grad = NULL;
@@ -3463,52 +3747,9 @@ int FwdBemModel::compute_forward_eeg(MneSourceSpaceOld **spaces,
         use_threads = false;
 
     if (use_threads) {
-        int            nthread  = (fixed_ori || vec_pot || nproc < 6) ? nspace : 3*nspace;
-        QList <FwdThreadArg*> args; //FwdThreadArg*   *args    = MALLOC_40(nthread,FwdThreadArg*);
-        int            stat;
-        /*
-        * We need copies to allocate separate workspace for each thread
-        */
-        if (fixed_ori || vec_pot || nproc < 6) {
-            for (k = 0, off = 0; k < nthread; k++) {
-                FwdThreadArg* t_arg = FwdThreadArg::create_eeg_multi_thread_duplicate(one_arg,bem_model != NULL);
-                t_arg->s   = spaces[k];
-                t_arg->off = off;
-                off = fixed_ori ? off + spaces[k]->nuse : off + 3*spaces[k]->nuse;
-                args.append(t_arg);
-            }
-            printf("%d processors. I will use one thread for each of the %d source spaces.\n",nproc,nspace);
-        }
-        else {
-            for (k = 0, off = 0, q = 0; k < nspace; k++) {
-                for (p = 0; p < 3; p++,q++) {
-                    FwdThreadArg* t_arg = FwdThreadArg::create_eeg_multi_thread_duplicate(one_arg,bem_model != NULL);
-                    t_arg->s    = spaces[k];
-                    t_arg->off  = off;
-                    t_arg->comp = p;
-                    args.append(t_arg);
-                }
-                off = fixed_ori ? off + spaces[k]->nuse : off + 3*spaces[k]->nuse;
-            }
-            printf("%d processors. I will use %d threads : %d source spaces x 3 source components.\n",nproc,nthread,nspace);
-        }
-        printf("Computing EEG at %d source locations (%s orientations)...",
-                nsource,fixed_ori ? "fixed" : "free");
-        /*
-        * Ready to start the threads & Wait for them to complete
-        */
-        QtConcurrent::blockingMap(args, meg_eeg_fwd_one_source_space);
-        /*
-        * Check the results
-        */
-        for (k = 0, stat = OK; k < nthread; k++)
-            if (args[k]->stat != OK) {
-                stat = FAIL;
-                break;
-            }
-        for (k = 0; k < args.size(); k++)//nthread == args.size()
-            FwdThreadArg::free_eeg_multi_thread_duplicate(args[k],bem_model != NULL);
-        if (stat != OK)
+        printf("%d processors. Computing EEG at %d source locations (%s orientations) in chunks of source points...",
+                nproc,nsource,fixed_ori ? "fixed" : "free");
+        if (compute_forward_parallel(one_arg,spaces,nspace,nproc,false,bem_model != NULL) != OK)
             goto bad;
     }
     else {
@@ -100,6 +100,7 @@ namespace FWDLIB
 //=============================================================================================================
 
 class FwdEegSphereModel;
+class FwdThreadArg;
 
 //=============================================================================================================
 /**
@@ -205,11 +206,18 @@ public:
                                MNELIB::MneTriangle* to,	/* The destination triangle */
                                double omega[3]);
 
+    static void correct_auto_row (MNELIB::MneSurfaceOld* surf,
+                                  int        j,
+                                  float      *row);
+
     static void correct_auto_elements (MNELIB::MneSurfaceOld* surf,
                                        float      **mat);
 
     static float **fwd_bem_lin_pot_coeff (const QList<MNELIB::MneSurfaceOld*>& surfs);
 
+    static void fwd_bem_lin_pot_coeff_parallel (const QList<MNELIB::MneSurfaceOld*>& surfs,
+                                                Eigen::MatrixXf& mat);      /* The coefficients (output) */
+
     static int fwd_bem_linear_collocation_solution(FwdBemModel* m);
 
     //============================= fwd_bem_solution.c =============================
@@ -219,6 +227,11 @@ public:
                                     int   nsurf,       /* Number of surfaces */
                                     int   *ntri);
 
+    static float **fwd_bem_multi_solution_lu (Eigen::MatrixXf& coeff,  /* The coefficient matrix, destroyed */
+                                       float **gamma,            /* The conductivity multipliers */
+                                       int   nsurf,              /* Number of surfaces */
+                                       int   *ntri);             /* Number of triangles or nodes on each surface */
+
     static float **fwd_bem_homog_solution (float **solids,int ntri);
 
     static void fwd_bem_ip_modify_solution(float **solution,    /* The original solution */
@@ -245,6 +258,16 @@ public:
                                         int         force_recompute,
                                         FwdBemModel* m);
 
+    static QString fwd_bem_solution_cache_key(FwdBemModel* m,
+                                              int         bem_method);
+
+    static int fwd_bem_save_solution(const QString& name,
+                                     FwdBemModel* m);
+
+    static int fwd_bem_cached_solution(FwdBemModel* m,
+                                       int         bem_method,
+                                       int         force_recompute);
+
     //============================= fwd_bem_pot.c =============================
 
     static float fwd_bem_inf_field(float *rd,      /* Dipole position */
@@ -434,6 +457,13 @@ public:
 
     static void *meg_eeg_fwd_one_source_space(void *arg);
 
+    static int compute_forward_parallel(FwdThreadArg*               one_arg,        /**< Template argument of the field computation. */
+                                        MNELIB::MneSourceSpaceOld*  *spaces,        /**< Source spaces. */
+                                        int                         nspace,         /**< How many?. */
+                                        int                         nthread,        /**< Number of threads. */
+                                        bool                        meg,            /**< MEG (true) or EEG (false) workspace. */
+                                        bool                        bem_model);     /**< Is the BEM model used?. */
+
     // TODO check if this is the correct class or move
     static int compute_forward_meg( MNELIB::MneSourceSpaceOld*  *spaces,        /**< Source spaces. */
                                     int                         nspace,         /**< How many?. */
@@ -509,6 +539,7 @@ public:
     float      *field_mult;     /* Multipliers for the magnetic field */
     int        bem_method;      /* Which approximation method is used */
     QString     sol_name;       /* Name of the file where the solution was loaded from */
+    QString     sol_cache_dir;  /* Directory of the solution cache (no caching if empty) */
 
     float      **solution;      /* The potential solution matrix */
     float      *v0;             /* Space for the infinite-medium potentials */
@@ -194,9 +194,6 @@ void mne_free_dcmatrix_1 (double **m)
 #define EPS      1e-10
 #define SIN_EPS  1e-3
 
-static int         terms = 0;       /* These statistics may be useful */
-static int         eval = 0;
-
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -490,11 +487,8 @@ void FwdEegSphereModel::calc_pot_components(double beta, double cgamma, double *
     betan = 1.0;
     p0 = p01 = p1 = p11 = 0.0;
     for (n = 1; n <= nterms; n++) {
-        if (betan < EPS) {
-            terms = terms + n;
-            eval  = eval + 1;
+        if (betan < EPS)
             break;
-        }
         next_legen (n,cgamma,&p0,&p01,&p1,&p11);
         multn = betan*fn[n-1];	/* The 2*n + 1 factor is included in fn */
         Vr = Vr + multn*p0;
@@ -506,6 +500,16 @@ void FwdEegSphereModel::calc_pot_components(double beta, double cgamma, double *
     return;
 }
 
+//=============================================================================================================
+
+void FwdEegSphereModel::fwd_eeg_precompute_multi_sphere_coeffs()
+{
+    fn.resize(MAXTERMS);
+    nterms = MAXTERMS;
+    for (int k = 0; k < MAXTERMS; k++)
+        fn[k] = (2*k+3)*fwd_eeg_get_multi_sphere_model_coeff(k+1);
+}
+
 //=============================================================================================================
 // fwd_multi_spherepot.c
 int FwdEegSphereModel::fwd_eeg_multi_spherepot(float *rd, float *Q, float **el, int neeg, float *Vval, void *client)	  /* The model definition */
@@ -542,12 +546,8 @@ int FwdEegSphereModel::fwd_eeg_multi_spherepot(float *rd, float *Q, float **el,
     /*
        * Precompute the coefficients
        */
-    if (m->fn.size() == 0 || m->nterms != MAXTERMS) {
-        m->fn.resize(MAXTERMS);
-        m->nterms = MAXTERMS;
-        for (k = 0; k < MAXTERMS; k++)
-            m->fn[k] = (2*k+3)*m->fwd_eeg_get_multi_sphere_model_coeff(k+1);
-    }
+    if (m->fn.size() == 0 || m->nterms != MAXTERMS)
+        m->fwd_eeg_precompute_multi_sphere_coeffs();
     /*
        * Move to the sphere coordinates
        */
@@ -153,6 +153,13 @@ public:
      */
     double fwd_eeg_get_multi_sphere_model_coeff(int n);
 
+    //=========================================================================================================
+    /**
+     * Computes the coefficients of the series expansion used by fwd_eeg_multi_spherepot. They are otherwise
+     * computed on first use, hence this has to be called before the model is shared between threads.
+     */
+    void fwd_eeg_precompute_multi_sphere_coeffs();
+
     static void next_legen (int n,
                 double x,
                 double *p0,         /* Input: P0(n-1) Output: P0(n) */
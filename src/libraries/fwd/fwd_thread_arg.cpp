@@ -98,6 +98,8 @@ FwdThreadArg::FwdThreadArg()
 ,fixed_ori     (FALSE)
 ,stat          (FAIL)
 ,comp          (-1)
+,first_vertex  (0)
+,last_vertex   (-1)
 {
 }
 
@@ -124,6 +124,8 @@ public:
     MNELIB::MneSourceSpaceOld   *s;                 /* The source space to process */
     int                 fixed_ori;         /* Compute fixed orientation solution? */
     int                 comp;              /* Which component to compute for free orientations */
+    int                 first_vertex;      /* First source space vertex to process */
+    int                 last_vertex;       /* One past the last vertex to process, -1 for all vertices */
     int                 stat;
 
 // ### OLD STRUCT ###
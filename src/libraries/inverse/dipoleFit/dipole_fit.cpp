@@ -6,10 +6,15 @@
 
 #include <string.h>
 #include <QScopedPointer>
+#include <QAtomicInt>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent/QtConcurrent>
 
 using namespace INVERSELIB;
 using namespace MNELIB;
 using namespace FWDLIB;
+using namespace Eigen;
 
 #if defined(_WIN32) || defined(_WIN64)
 #define snprintf _snprintf
@@ -550,6 +555,102 @@ int mne_get_values_from_data_ch (float time,      /* Interesting time point */
 // DEFINE MEMBER METHODS
 //=============================================================================================================
 
+typedef struct {
+    float time;             /* The time point */
+    QVector<float> B;       /* The data to fit */
+    ECD   dip;              /* The fitted dipole */
+    bool  ok;               /* Did the fit succeed? */
+} fitJobRec;
+
+static void fit_dipole_batch(DipoleFitData* fit, GuessData* guess, QVector<fitJobRec>& jobs, int nthread, int verbose)
+/*
+ * Fit the time points of one batch
+ * The initial guesses of all time points are selected together with matrix products.
+ * Each thread has its own copy of the forward computation workspaces.
+ * The jobs are independent of each other so the results do not depend on the number of threads.
+ */
+{
+    fitJobRec* job   = jobs.data();
+    int        njob  = jobs.size();
+    int        nchan = fit->nmeg+fit->neeg;
+    bool       batch = guess->basis.rows() == nchan;
+    bool       whitened = batch;
+    VectorXi   best;
+    VectorXf   good;
+    int        k;
+
+    if (njob == 0)
+        return;
+    if (batch) {
+        /*
+         * Whiten the data and pick the best guesses for all time points at once
+         */
+        MatrixXf data = MatrixXf::Zero(nchan,njob);
+        for (k = 0; k < njob; k++) {
+            job[k].ok = DipoleFitData::whiten_one(fit,job[k].B.data());
+            if (job[k].ok)
+                data.col(k) = Map<const VectorXf>(job[k].B.constData(),nchan);
+        }
+        if (guess->find_best_guesses(data,FIT_GUESS_LIMIT,best,good) == FAIL)
+            batch = false;
+    }
+    if (!batch)
+        best = VectorXi::Constant(njob,-1);
+    else {
+        for (k = 0; k < njob; k++)
+            if (job[k].ok && best[k] < 0) {
+                printf("No reasonable initial guess found.");
+                job[k].ok = false;
+            }
+    }
+    auto fit_job = [job, guess, &best, nchan, batch, whitened, verbose](DipoleFitData* d, int j) {
+        int   one_best;
+        float one_good;
+
+        if (!whitened)
+            job[j].ok = DipoleFitData::fit_one(d,guess,job[j].time,job[j].B.data(),verbose,job[j].dip);
+        else if (!job[j].ok)
+            return;
+        else if (batch)
+            job[j].ok = DipoleFitData::fit_one_guess(d,guess,job[j].time,job[j].B.data(),best[j],verbose,job[j].dip);
+        else
+            /*
+             * The data are whitened already, only the guess is selected for each time point separately
+             */
+            job[j].ok = DipoleFitData::find_best_guess(job[j].B.data(),nchan,guess,FIT_GUESS_LIMIT,&one_best,&one_good) == OK &&
+                    DipoleFitData::fit_one_guess(d,guess,job[j].time,job[j].B.data(),one_best,verbose,job[j].dip);
+    };
+
+    nthread = qMin(nthread,njob);
+    if (nthread <= 1) {
+        for (k = 0; k < njob; k++)
+            fit_job(fit,k);
+        return;
+    }
+
+    QList<DipoleFitData*> dups;
+    QAtomicInt            next_job(0);
+
+    /*
+     * The sphere model is shared by the threads, compute the coefficients it would otherwise set up on first use
+     */
+    if (fit->eeg_model)
+        fit->eeg_model->fwd_eeg_precompute_multi_sphere_coeffs();
+    for (k = 0; k < nthread; k++)
+        dups.append(DipoleFitData::create_thread_duplicate(fit));
+
+    QtConcurrent::blockingMap(dups, [njob, &fit_job, &next_job](DipoleFitData* d) {
+        int j;
+        while ((j = next_job.fetchAndAddOrdered(1)) < njob)
+            fit_job(d,j);
+    });
+
+    for (k = 0; k < dups.size(); k++)
+        DipoleFitData::free_thread_duplicate(dups[k]);
+}
+
+//=============================================================================================================
+
 DipoleFit::DipoleFit(DipoleFitSettings* p_settings)
 : settings(p_settings)
 {
@@ -566,6 +667,7 @@ ECDSet DipoleFit::calculateFit() const
     MneMeasData*        data     = NULL;
     MneRawData*         raw      = NULL;
     mneChSelection      sel      = NULL;
+    int                 nthread  = 1;
 
     printf("---- Setting up...\n\n");
     if (settings->include_eeg) {
@@ -590,7 +692,8 @@ ECDSet DipoleFit::calculateFit() const
                                                             settings->diagnoise,
                                                             settings->projnames,
                                                             settings->include_meg,
-                                                            settings->include_eeg)) == NULL)
+                                                            settings->include_eeg,
+                                                            settings->bemcachedir)) == NULL)
         goto out;
 
     fit_data->fit_mag_dipoles = settings->fit_mag_dipoles;
@@ -669,12 +772,15 @@ ECDSet DipoleFit::calculateFit() const
     fprintf (stderr,"\n---- Fitting : %7.1f ... %7.1f ms (step: %6.1f ms integ: %6.1f ms)\n\n",
              1000*settings->tmin,1000*settings->tmax,1000*settings->tstep,1000*settings->integ);
 
+    nthread = settings->nthread > 0 ? settings->nthread : QThread::idealThreadCount();
+    printf("Using %d threads.\n",nthread);
+
     if (raw) {
-        if (fit_dipoles_raw(settings->measname,raw,sel,fit_data,guess.take(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose) == FAIL)
+        if (fit_dipoles_raw(settings->measname,raw,sel,fit_data,guess.take(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,nthread) == FAIL)
             goto out;
     }
     else {
-        if (fit_dipoles(settings->measname,data,fit_data,guess.take(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set) == FAIL)
+        if (fit_dipoles(settings->measname,data,fit_data,guess.take(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set,nthread) == FAIL)
             goto out;
     }
     printf("%d dipoles fitted\n",set.size());
@@ -686,34 +792,44 @@ out : {
 
 //=============================================================================================================
 
-int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
+int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set, int nthread)
 {
     float *one = MALLOC(data->nchan,float);
     float time;
     ECDSet set;
-    ECD   dip;
-    int   s;
+    QVector<fitJobRec> jobs;
+    fitJobRec job;
+    int   s,k;
     int   report_interval = 10;
 
     set.dataname = dataname;
 
-    printf("Fitting...%c",verbose ? '\n' : '\0');
-    for (s = 0, time = tmin; time < tmax; s++, time = tmin  + s*tstep) {
-        /*
-     * Pick the data point
+    /*
+     * Pick the data points first, the fits can then proceed in parallel
      */
+    for (s = 0, time = tmin; time < tmax; s++, time = tmin  + s*tstep) {
         if (mne_get_values_from_data(time,integ,data->current->data,data->current->np,data->nchan,data->current->tmin,
                                      1.0/data->current->tstep,FALSE,one) == FAIL) {
             printf("Cannot pick time: %7.1f ms\n",1000*time);
             continue;
         }
+        job.time = time;
+        job.B    = QVector<float>(data->nchan);
+        memcpy(job.B.data(),one,data->nchan*sizeof(float));
+        job.ok   = false;
+        jobs.append(job);
+    }
+
+    printf("Fitting...%c",verbose ? '\n' : '\0');
+    fit_dipole_batch(fit,guess,jobs,verbose ? 1 : nthread,verbose);
 
-        if (!DipoleFitData::fit_one(fit,guess,time,one,verbose,dip))
-            printf("t = %7.1f ms : %s\n",1000*time,"error (tbd: catch)");
+    for (k = 0; k < jobs.size(); k++) {
+        if (!jobs[k].ok)
+            printf("t = %7.1f ms : %s\n",1000*jobs[k].time,"error (tbd: catch)");
         else {
-            set.addEcd(dip);
+            set.addEcd(jobs[k].dip);
             if (verbose)
-                dip.print(stdout);
+                jobs[k].dip.print(stdout);
             else {
                 if (set.size() % report_interval == 0)
                     printf("%d..",set.size());
@@ -729,7 +845,7 @@ int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFi
 
 //=============================================================================================================
 
-int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
+int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set, int nthread)
 {
     float *one    = MALLOC(sel->nchan,float);
     float sfreq   = raw->info->sfreq;
@@ -739,14 +855,17 @@ int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSe
     int   step    = length - overlap;
     int   stepo   = step + overlap/2;
     int   start   = raw->first_samp;
-    int   s,picks;
+    int   s,k,picks;
     float time,stime;
     float **data  = ALLOC_CMATRIX(sel->nchan,length);
-    ECD    dip;
     ECDSet set;
+    QVector<fitJobRec> jobs;
+    fitJobRec job;
     int    report_interval = 10;
 
     set.dataname = dataname;
+    if (verbose)
+        nthread = 1;
 
     /*
    * Load the initial data segment
@@ -755,9 +874,32 @@ int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSe
     if (MneRawData::mne_raw_pick_data_filt(raw,sel,start,length,data) == FAIL)
         goto bad;
     printf("Fitting...%c",verbose ? '\n' : '\0');
-    for (s = 0, time = tmin; time < tmax; s++, time = tmin  + s*tstep) {
+    for (s = 0, time = tmin; ; s++, time = tmin  + s*tstep) {
         picks = time*sfreq - start;
-        if (picks > stepo) {		/* Need a new data segment? */
+        if (time >= tmax || picks > stepo) {
+            /*
+             * Fit the time points picked from this segment
+             */
+            fit_dipole_batch(fit,guess,jobs,nthread,verbose);
+            for (k = 0; k < jobs.size(); k++) {
+                if (!jobs[k].ok)
+                    qWarning() << "Error";
+                else {
+                    set.addEcd(jobs[k].dip);
+                    if (verbose)
+                        jobs[k].dip.print(stdout);
+                    else {
+                        if (set.size() % report_interval == 0)
+                            printf("%d..",set.size());
+                    }
+                }
+            }
+            jobs.clear();
+            if (time >= tmax)
+                break;
+            /*
+             * Need a new data segment
+             */
             start = start + step;
             if (MneRawData::mne_raw_pick_data_filt(raw,sel,start,length,data) == FAIL)
                 goto bad;
@@ -771,20 +913,11 @@ int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSe
             printf("Cannot pick time: %8.3f s\n",time);
             continue;
         }
-        /*
-     * Fit
-     */
-        if (!DipoleFitData::fit_one(fit,guess,time,one,verbose,dip))
-            qWarning() << "Error";
-        else {
-            set.addEcd(dip);
-            if (verbose)
-                dip.print(stdout);
-            else {
-                if (set.size() % report_interval == 0)
-                    printf("%d..",set.size());
-            }
-        }
+        job.time = time;
+        job.B    = QVector<float>(sel->nchan);
+        memcpy(job.B.data(),one,sel->nchan*sizeof(float));
+        job.ok   = false;
+        jobs.append(job);
     }
     if (!verbose)
         printf("[done]\n");
@@ -802,8 +935,8 @@ bad : {
 
 //=============================================================================================================
 
-int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose)
+int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, int nthread)
 {
     ECDSet set;
-    return fit_dipoles_raw(dataname, raw, sel, fit, guess, tmin, tmax, tstep, integ, verbose, set);
+    return fit_dipoles_raw(dataname, raw, sel, fit, guess, tmin, tmax, tstep, integ, verbose, set, nthread);
 }
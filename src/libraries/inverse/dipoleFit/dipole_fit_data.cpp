@@ -1326,6 +1326,92 @@ static dipoleFitFuncs new_dipole_fit_funcs()
     return f;
 }
 
+static void free_bem_workspace(void *client)
+/*
+ * Free a copy made with dup_bem_workspace without touching the shared parts
+ */
+{
+    FwdBemModel* bem = (FwdBemModel*)client;
+
+    if (!bem)
+        return;
+    bem->surfs.clear();
+    bem->nsurf       = 0;
+    bem->ntri        = NULL;
+    bem->np          = NULL;
+    bem->sigma       = NULL;
+    bem->gamma       = NULL;
+    bem->source_mult = NULL;
+    bem->field_mult  = NULL;
+    bem->solution    = NULL;
+    bem->head_mri_t  = NULL;
+    delete bem;
+    return;
+}
+
+static FwdBemModel* dup_bem_workspace(FwdBemModel* orig)
+/*
+ * Share the model but give the copy its own potential workspace
+ */
+{
+    FwdBemModel* res = new FwdBemModel;
+
+    *res    = *orig;
+    res->v0 = NULL;
+    return res;
+}
+
+static void free_comp_workspace(void *client)
+/*
+ * Free a copy made in dup_dipole_fit_funcs
+ */
+{
+    FwdCompData* comp = (FwdCompData*)client;
+
+    if (!comp)
+        return;
+    comp->comp_coils = NULL;        /* Shared with the original */
+    delete comp;
+    return;
+}
+
+static dipoleFitFuncs dup_dipole_fit_funcs(dipoleFitFuncs f, FwdBemModel* bem)
+/*
+ * Duplicate the forward functions for use in another thread
+ * The MEG client is always a compensation data structure, see setup_forward_model.
+ * Its work areas, the compensation data and the BEM workspace are private to the copy.
+ */
+{
+    dipoleFitFuncs res;
+
+    if (!f)
+        return NULL;
+    res  = new_dipole_fit_funcs();
+    *res = *f;
+    if (f->meg_client) {
+        FwdCompData* orig = (FwdCompData*)f->meg_client;
+        FwdCompData* comp = new FwdCompData;
+
+        *comp          = *orig;
+        comp->work     = NULL;
+        comp->vec_work = NULL;
+        comp->set      = orig->set ? new MneCTFCompDataSet(*(orig->set)) : NULL;
+        if (bem && orig->client == bem) {
+            comp->client      = dup_bem_workspace(bem);
+            comp->client_free = free_bem_workspace;
+        }
+        res->meg_client      = comp;
+        res->meg_client_free = free_comp_workspace;
+    }
+    if (bem && f->eeg_client == bem) {
+        res->eeg_client      = dup_bem_workspace(bem);
+        res->eeg_client_free = free_bem_workspace;
+    }
+    else
+        res->eeg_client_free = NULL;    /* The sphere model is shared, its coefficients are precomputed in fit_dipole_batch */
+    return res;
+}
+
 //============================= mne_simplex_fit.c =============================
 
 /*
@@ -3405,6 +3491,62 @@ DipoleFitData::~DipoleFitData()
 
 //=============================================================================================================
 
+DipoleFitData* DipoleFitData::create_thread_duplicate(DipoleFitData* fit)
+/*
+ * Create a copy of the fitting data for use in another thread
+ * The read-only parts are shared, the forward computation workspaces and the user data are not
+ */
+{
+    DipoleFitData* res = new DipoleFitData;
+
+    *res = *fit;
+    res->sphere_funcs     = dup_dipole_fit_funcs(fit->sphere_funcs,fit->bem_model);
+    res->bem_funcs        = dup_dipole_fit_funcs(fit->bem_funcs,fit->bem_model);
+    res->mag_dipole_funcs = dup_dipole_fit_funcs(fit->mag_dipole_funcs,fit->bem_model);
+    if (fit->funcs == fit->bem_funcs)
+        res->funcs = res->bem_funcs;
+    else if (fit->funcs == fit->mag_dipole_funcs)
+        res->funcs = res->mag_dipole_funcs;
+    else
+        res->funcs = res->sphere_funcs;
+    res->user      = NULL;
+    res->user_free = NULL;
+    return res;
+}
+
+//=============================================================================================================
+
+void DipoleFitData::free_thread_duplicate(DipoleFitData* dup)
+{
+    if (!dup)
+        return;
+    free_dipole_fit_funcs(dup->sphere_funcs);
+    free_dipole_fit_funcs(dup->bem_funcs);
+    free_dipole_fit_funcs(dup->mag_dipole_funcs);
+    dup->sphere_funcs     = NULL;
+    dup->bem_funcs        = NULL;
+    dup->mag_dipole_funcs = NULL;
+    dup->funcs            = NULL;
+    /*
+     * The rest is shared with the original
+     */
+    dup->mri_head_t = NULL;
+    dup->meg_head_t = NULL;
+    dup->meg_coils  = NULL;
+    dup->eeg_els    = NULL;
+    dup->noise      = NULL;
+    dup->noise_orig = NULL;
+    dup->pick       = NULL;
+    dup->bem_model  = NULL;
+    dup->eeg_model  = NULL;
+    dup->proj       = NULL;
+    dup->user       = NULL;
+    dup->user_free  = NULL;
+    delete dup;
+}
+
+//=============================================================================================================
+
 int DipoleFitData::setup_forward_model(DipoleFitData *d, MneCTFCompDataSet* comp_data, FwdCoilSet *comp_coils)
 /*
      * Take care of some hairy details
@@ -3438,6 +3580,7 @@ int DipoleFitData::setup_forward_model(DipoleFitData *d, MneCTFCompDataSet* comp
             goto out;
         }
         printf("\nLoading the solution matrix...\n");
+        d->bem_model->sol_cache_dir = d->bemcachedir;
         if (FwdBemModel::fwd_bem_load_recompute_solution(d->bemname,FWD_BEM_UNKNOWN,FALSE,d->bem_model) == FAIL)
             goto out;
         printf("Employing the head->MRI coordinate transform with the BEM model.\n");
@@ -3882,7 +4025,8 @@ DipoleFitData *DipoleFitData::setup_dipole_fit_data(const QString &mriname,
                                                     int diagnoise,
                                                     const QList<QString> &projnames,
                                                     int include_meg,
-                                                    int include_eeg)              /**< Include EEG in the fitting?. */
+                                                    int include_eeg,              /**< Include EEG in the fitting?. */
+                                                    const QString& bemcachedir)   /**< Directory of the BEM solution cache. */
 /*
           * Background work for modelling
           */
@@ -4015,6 +4159,7 @@ DipoleFitData *DipoleFitData::setup_dipole_fit_data(const QString &mriname,
        * Forward model setup
        */
     res->bemname   = bemname;
+    res->bemcachedir = bemcachedir;
     if (r0) {
         res->r0[0]     = (*r0)[0];
         res->r0[1]     = (*r0)[1];
@@ -4373,14 +4518,15 @@ static float fit_eval(float *rd,int npar,void *user)
     return fuser->B2-Bm2;
 }
 
-static int find_best_guess(float     *B,         /* The whitened data */
-                           int       nch,
-                           GuessData* guess,	 /* Guesses */
-                           float     limit,	 /* Pseudoradial component omission limit */
-                           int       *bestp,	 /* Which is the best */
-                           float     *goodp)	 /* Best goodness of fit */
+int DipoleFitData::find_best_guess(float     *B,         /* The whitened data */
+                                   int       nch,
+                                   GuessData* guess,	 /* Guesses */
+                                   float     limit,	 /* Pseudoradial component omission limit */
+                                   int       *bestp,	 /* Which is the best */
+                                   float     *goodp)	 /* Best goodness of fit */
 /*
  * Thanks to the precomputed SVD everything is really simple
+ * Without a usable guess basis the guess fields are scanned one by one
  */
 {
     int    k,c;
@@ -4390,19 +4536,28 @@ static int find_best_guess(float     *B,         /* The whitened data */
     DipoleForward* fwd;
     int    ncomp;
 
-    B2 = mne_dot_vectors_3(B,B,nch);
-    for (k = 0; k < guess->nguess; k++) {
-        fwd = guess->guess_fwd[k];
-        if (fwd->nch == nch) {
-            ncomp = fwd->sing[2]/fwd->sing[0] > limit ? 3 : 2;
-            for (c = 0, Bm2 = 0.0; c < ncomp; c++) {
-                one = mne_dot_vectors_3(fwd->uu[c],B,nch);
-                Bm2 = Bm2 + one*one;
-            }
-            this_good = 1.0 - (B2 - Bm2)/B2;
-            if (this_good > good) {
-                best = k;
-                good = this_good;
+    Eigen::VectorXi bests;
+    Eigen::VectorXf goods;
+    if (guess->basis.rows() == nch &&
+            guess->find_best_guesses(Eigen::Map<const Eigen::MatrixXf>(B,nch,1),limit,bests,goods) == OK) {
+        best = bests[0];
+        good = goods[0];
+    }
+    else {
+        B2 = mne_dot_vectors_3(B,B,nch);
+        for (k = 0; k < guess->nguess; k++) {
+            fwd = guess->guess_fwd[k];
+            if (fwd->nch == nch) {
+                ncomp = fwd->sing[2]/fwd->sing[0] > limit ? 3 : 2;
+                for (c = 0, Bm2 = 0.0; c < ncomp; c++) {
+                    one = mne_dot_vectors_3(fwd->uu[c],B,nch);
+                    Bm2 = Bm2 + one*one;
+                }
+                this_good = 1.0 - (B2 - Bm2)/B2;
+                if (this_good > good) {
+                    best = k;
+                    good = this_good;
+                }
             }
         }
     }
@@ -4675,10 +4830,49 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
                     int           verbose,
                     ECD&          res               /* The fitted dipole */
                     )
+{
+    int   best;
+    float good;
+
+    if (!whiten_one(fit,B))
+        return false;
+    /*
+   * Get the initial guess
+   */
+    if (find_best_guess(B,fit->nmeg+fit->neeg,guess,FIT_GUESS_LIMIT,&best,&good) < 0)
+        return false;
+
+    return fit_one_guess(fit,guess,time,B,best,verbose,res);
+}
+
+//=============================================================================================================
+
+bool DipoleFitData::whiten_one(DipoleFitData* fit, float *B)
+{
+    int nchan = fit->nmeg+fit->neeg;
+
+    if (MneProjOp::mne_proj_op_proj_vector(fit->proj,B,nchan,TRUE) == FAIL)
+        return false;
+
+    if (mne_whiten_one_data(B,B,nchan,fit->noise) == FAIL)
+        return false;
+    return true;
+}
+
+//=============================================================================================================
+
+bool DipoleFitData::fit_one_guess(DipoleFitData* fit,	    /* Precomputed fitting data */
+                                  GuessData*     guess,	    /* The initial guesses */
+                                  float         time,       /* Which time is it? */
+                                  float         *B,	    /* The whitened field to fit */
+                                  int           best,       /* Which guess to start from */
+                                  int           verbose,
+                                  ECD&          res         /* The fitted dipole */
+                                  )
 {
     float  **simplex       = NULL;	       /* The simplex */
     float  vals[4];			       /* Values at the vertices */
-    float  limit           = 0.2;	               /* (pseudo) radial component omission limit */
+    float  limit           = FIT_GUESS_LIMIT;	       /* (pseudo) radial component omission limit */
     float  size            = 1e-2;	       /* Size of the initial simplex */
     float  ftol[]          = { 1e-2, 1e-2 };     /* Tolerances on the the two passes */
     float  atol[]          = { 0.2e-3, 0.2e-3 }; /* If dipole movement between two iterations is less than this,
@@ -4687,8 +4881,7 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
     int    max_eval        = 1000;	       /* Limit for fit function evaluations */
     int    report_interval = verbose ? 1 : -1;   /* How often to report the intermediate result */
 
-    int        best;
-    float      good,rd_guess[3],rd_final[3],Q[3],final_val;
+    float      rd_guess[3],rd_final[3],Q[3],final_val;
     fitDipUserRec user;
     int        k,p,neval,neval_tot,nchan,ncomp;
     int        fit_fail;
@@ -4696,17 +4889,6 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
     nchan = fit->nmeg+fit->neeg;
     user.fwd = NULL;
 
-    if (MneProjOp::mne_proj_op_proj_vector(fit->proj,B,nchan,TRUE) == FAIL)
-        goto bad;
-
-    if (mne_whiten_one_data(B,B,nchan,fit->noise) == FAIL)
-        goto bad;
-    /*
-   * Get the initial guess
-   */
-    if (find_best_guess(B,nchan,guess,limit,&best,&good) < 0)
-        goto bad;
-
     user.limit = limit;
     user.B     = B;
     user.B2    = mne_dot_vectors_3(B,B,nchan);
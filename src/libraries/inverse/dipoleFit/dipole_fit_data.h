@@ -67,6 +67,8 @@
 #define COLUMN_NORM_COMP 1	    /* Componentwise normalization */
 #define COLUMN_NORM_LOC  2	    /* Dipole locationwise normalization */
 
+#define FIT_GUESS_LIMIT  0.2f      /* (Pseudo) radial component omission limit used in the fits */
+
 //=============================================================================================================
 // DEFINE NAMESPACE INVERSELIB
 //=============================================================================================================
@@ -125,6 +127,25 @@ public:
      */
     virtual ~DipoleFitData();
 
+    //=========================================================================================================
+    /**
+     * Creates a copy of the fitting data which can be used in fit_one concurrently with the original.
+     * The read-only parts are shared, the forward computation workspaces are private to the copy.
+     *
+     * @param[in] fit    The fitting data to copy.
+     *
+     * @return The copy. Release it with free_thread_duplicate.
+     */
+    static DipoleFitData* create_thread_duplicate(DipoleFitData* fit);
+
+    //=========================================================================================================
+    /**
+     * Frees a copy created with create_thread_duplicate without touching the shared parts.
+     *
+     * @param[in] dup    The copy to free.
+     */
+    static void free_thread_duplicate(DipoleFitData* dup);
+
     //============================= dipole_fit_setup.c =============================
 
     static int setup_forward_model(DipoleFitData* d, MNELIB::MneCTFCompDataSet* comp_data, FWDLIB::FwdCoilSet* comp_coils);
@@ -164,7 +185,8 @@ public:
                                             int   diagnoise,                /**< Use only the diagonal elements of the noise-covariance matrix. */
                                             const QList<QString>& projnames,/**< SSP file names. */
                                             int   include_meg,              /**< Include MEG in the fitting?. */
-                                            int   include_eeg);
+                                            int   include_eeg,
+                                            const QString& bemcachedir = QString());  /**< Directory of the BEM solution cache. */
 
     //=========================================================================================================
     /**
@@ -180,6 +202,50 @@ public:
      */
     static bool fit_one(DipoleFitData* fit, GuessData* guess, float time, float *B, int verbose, ECD& res);
 
+    //=========================================================================================================
+    /**
+     * Applies the projection and the noise whitening to the data in place.
+     * This is the first step of fit_one.
+     *
+     * @param[in] fit        Precomputed fitting data.
+     * @param[in, out] B     The field to fit.
+     *
+     * @return true when successful.
+     */
+    static bool whiten_one(DipoleFitData* fit, float *B);
+
+    //=========================================================================================================
+    /**
+     * Fit a single dipole to whitened data starting from a known initial guess.
+     * Together with whiten_one and GuessData::find_best_guesses this allows the guesses of many time points
+     * to be selected in one batch.
+     *
+     * @param[in] fit        Precomputed fitting data.
+     * @param[in] guess      The initial guesses.
+     * @param[in] time       Which time is it?.
+     * @param[in] B          The whitened field to fit.
+     * @param[in] best       Index of the initial guess.
+     * @param[in] verbose.
+     * @param[in] res        The fitted dipole.
+     */
+    static bool fit_one_guess(DipoleFitData* fit, GuessData* guess, float time, float *B, int best, int verbose, ECD& res);
+
+    //=========================================================================================================
+    /**
+     * Select the initial guess which explains most of the whitened data of one time point.
+     * Uses the guess basis if it matches the data, otherwise the guess fields are scanned one by one.
+     *
+     * @param[in] B          The whitened field.
+     * @param[in] nch        Number of channels.
+     * @param[in] guess      The initial guesses.
+     * @param[in] limit      Pseudoradial component omission limit.
+     * @param[out] bestp     Index of the best guess.
+     * @param[out] goodp     Goodness of fit of the best guess.
+     *
+     * @return OK if a guess was found, FAIL otherwise.
+     */
+    static int find_best_guess(float *B, int nch, GuessData* guess, float limit, int *bestp, float *goodp);
+
 //============================= dipole_forward.c
 
     static int compute_dipole_field(DipoleFitData* d, float *rd, int whiten, float **fwd);
@@ -203,6 +269,7 @@ public:
       FWDLIB::FwdCoilSet*        eeg_els;           /**< EEG electrode definitions. */
       float             r0[3];              /**< Sphere model origin. */
       QString           bemname;           /**< Using a BEM?. */
+      QString           bemcachedir;       /**< Directory of the BEM solution cache. */
 
       FWDLIB::FwdEegSphereModel *eeg_model;         /**< EEG sphere model definition. */
       FWDLIB::FwdBemModel       *bem_model;         /**< BEM model definition. */
@@ -102,6 +102,7 @@ void DipoleFitSettings::initMembers()
     do_baseline  = false;         
     setno        = 1;             
     verbose      = false;
+    nthread      = 0;
     omit_data_proj = false;
 
          
@@ -144,8 +145,11 @@ void DipoleFitSettings::checkIntegrity()
         projnames.prepend(measname);
     printf("\n");
 
-    if (!bemname.isEmpty())
+    if (!bemname.isEmpty()) {
         printf("BEM              : %s\n",bemname.toUtf8().data());
+        if (!bemcachedir.isEmpty())
+            printf("BEM cache        : %s\n",bemcachedir.toUtf8().data());
+    }
     else {
         printf("Sphere model     : origin at (% 7.2f % 7.2f % 7.2f) mm\n",
                1000*r0[X],1000*r0[Y],1000*r0[Z]);
@@ -246,6 +250,7 @@ void DipoleFitSettings::usage(char *name)
     printf("\nForward model:\n\n");
     printf("\t--mri name        take head/MRI coordinate transform from here (Neuromag MRI description file)\n");
     printf("\t--bem  name       BEM model name\n");
+    printf("\t--bemcache dir    keep computed BEM solutions in this directory and reuse them\n");
     printf("\t--origin x:y:z/mm use a sphere model with this origin (head coordinates/mm)\n");
     printf("\t--eegscalp        scale the electrode locations to the surface of the scalp when using a sphere model\n");
     printf("\t--eegmodels name  read EEG sphere model specifications from here.\n");
@@ -266,6 +271,7 @@ void DipoleFitSettings::usage(char *name)
     printf("\t--dip     name    xfit dip format output file name\n");
     printf("\t--bdip    name    xfit bdip format output file name\n");
     printf("\nGeneral:\n\n");
+    printf("\t--threads n       number of threads used in fitting (default: all processors)\n");
     printf("\t--gui             Enables the gui.\n");
     printf("\t--help            print this info.\n");
     printf("\t--version         print version info.\n\n");
@@ -410,6 +416,14 @@ bool DipoleFitSettings::check_args (int *argc,char **argv)
             }
             bemname = QString(argv[k+1]);
         }
+        else if (strcmp(argv[k],"--bemcache") == 0) {
+            found = 2;
+            if (k == *argc - 1) {
+                qCritical ("--bemcache: argument required.");
+                return false;
+            }
+            bemcachedir = QString(argv[k+1]);
+        }
         else if (strcmp(argv[k],"--accurate") == 0) {
             found = 1;
             accurate = true;
@@ -826,6 +840,22 @@ bool DipoleFitSettings::check_args (int *argc,char **argv)
             found = 1;
             verbose = true;
         }
+        else if (strcmp(argv[k],"--threads") == 0) {
+            found = 2;
+            if (k == *argc - 1) {
+                qCritical ("--threads: argument required.");
+                return false;
+            }
+            if (sscanf(argv[k+1],"%d",&ival) != 1) {
+                qCritical ("Could not interpret the number of threads.");
+                return false;
+            }
+            if (ival < 0) {
+                qCritical ("The number of threads should be non-negative");
+                return false;
+            }
+            nthread = ival;
+        }
         if (found) {
             for (int p = k; p < *argc-found; p++)
                 argv[p] = argv[p+found];
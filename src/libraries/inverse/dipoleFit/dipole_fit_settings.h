@@ -113,6 +113,7 @@ public:
 
 public:
     QString bemname;                    /**< Boundary-element model. */
+    QString bemcachedir;                /**< Directory of the BEM solution cache. */
     Eigen::Vector3f r0;                 /**< Sphere model origin . */
     bool   accurate;         		/**< Use accurate coil definitions?. */
     QString mriname;                    /**< Gives the MRI <-> head transform. */
@@ -144,6 +145,7 @@ float guess_rad;       			/**< Radius of spherical guess surface. */
     bool  do_baseline;         		/**< Are both baseline limits set?. */
     int   setno;             		/**< Which data set. */
     bool  verbose;
+    int   nthread;          		/**< Number of threads used in fitting (0 = all processors). */
     MNELIB::mneFilterDefRec filter;
     QStringList projnames;              /**< Projection file names. */
     bool omit_data_proj;
@@ -129,6 +129,8 @@ float **mne_cmatrix_16(int nr,int nc)
 #define FREE_16(x) if ((char *)(x) != NULL) free((char *)(x))
 #define FREE_CMATRIX_16(m) mne_free_cmatrix_16((m))
 
+#define GUESS_TIME_BLOCK 64     /* How many time points are scored against the guesses at a time */
+
 void mne_free_cmatrix_16 (float **m)
 {
     if (m) {
@@ -264,6 +266,7 @@ GuessData::GuessData(const QString &guessname, const QString &guess_surfname, fl
 #endif
     }
     f->funcs = orig;
+    this->make_guess_basis();
 
     printf("[done %d sources]\n",p);
 
@@ -422,7 +425,79 @@ bool GuessData::compute_guess_fields(DipoleFitData* f)
 #endif
     }
     f->funcs = orig;
+    this->make_guess_basis();
     printf("[done %d sources]\n",this->nguess);
 
     return true;
 }
+
+//=============================================================================================================
+
+bool GuessData::make_guess_basis()
+{
+    int nch;
+
+    basis.resize(0,0);
+    sing_ratio.resize(0);
+    if (nguess <= 0 || !guess_fwd || !guess_fwd[0])
+        return false;
+    nch = guess_fwd[0]->nch;
+    for (int k = 0; k < nguess; k++)
+        if (!guess_fwd[k] || guess_fwd[k]->nch != nch)
+            return false;
+    /*
+     * Three columns per guess so that one matrix product scores the data against all of them
+     */
+    basis.resize(nch,3*nguess);
+    sing_ratio.resize(nguess);
+    for (int k = 0; k < nguess; k++) {
+        for (int c = 0; c < 3; c++)
+            basis.col(3*k+c) = Map<const VectorXf>(guess_fwd[k]->uu[c],nch);
+        sing_ratio[k] = guess_fwd[k]->sing[2]/guess_fwd[k]->sing[0];
+    }
+    return true;
+}
+
+//=============================================================================================================
+
+int GuessData::find_best_guesses(const Ref<const MatrixXf>& B,
+                                 float limit,
+                                 VectorXi& best,
+                                 VectorXf& good) const
+{
+    int      ntime = B.cols();
+    int      nt,ncomp;
+    float    B2,Bm2,this_good;
+    MatrixXf proj;
+    const float *one;
+
+    if (nguess <= 0 || basis.cols() != 3*nguess || basis.rows() != B.rows())
+        return FAIL;
+
+    best = VectorXi::Constant(ntime,-1);
+    good = VectorXf::Zero(ntime);
+    /*
+     * Project a block of time points onto all guess bases at once
+     * and add up the squared projections of each guess
+     */
+    for (int t0 = 0; t0 < ntime; t0 += GUESS_TIME_BLOCK) {
+        nt = ntime - t0 < GUESS_TIME_BLOCK ? ntime - t0 : GUESS_TIME_BLOCK;
+        proj.noalias() = basis.transpose()*B.middleCols(t0,nt);
+        for (int t = 0; t < nt; t++) {
+            B2 = B.col(t0+t).squaredNorm();
+            one = proj.data() + (Eigen::Index)t*proj.rows();
+            for (int k = 0; k < nguess; k++, one += 3) {
+                ncomp = sing_ratio[k] > limit ? 3 : 2;
+                Bm2 = one[0]*one[0] + one[1]*one[1];
+                if (ncomp == 3)
+                    Bm2 += one[2]*one[2];
+                this_good = 1.0 - (B2 - Bm2)/B2;
+                if (this_good > good[t0+t]) {
+                    best[t0+t] = k;
+                    good[t0+t] = this_good;
+                }
+            }
+        }
+    }
+    return OK;
+}
@@ -134,10 +134,38 @@ public:
      */
     bool compute_guess_fields(DipoleFitData* f);
 
+    //=========================================================================================================
+    /**
+     * Collects the field SVD bases of all guesses into one contiguous matrix for batched scoring.
+     * Called once the guess fields have been computed.
+     *
+     * @return true when successful.
+     */
+    bool make_guess_basis();
+
+    //=========================================================================================================
+    /**
+     * Finds the best initial guess for each of several time points at once.
+     * The data are scored against all guesses with matrix products instead of one guess at a time.
+     *
+     * @param[in] B          The whitened data, one time point per column.
+     * @param[in] limit      Pseudoradial component omission limit.
+     * @param[out] best      Which guess is the best for each time point (-1 if none).
+     * @param[out] good      Best goodness of fit for each time point.
+     *
+     * @return OK if the guess basis matches the data, FAIL otherwise.
+     */
+    int find_best_guesses(const Eigen::Ref<const Eigen::MatrixXf>& B,
+                          float limit,
+                          Eigen::VectorXi& best,
+                          Eigen::VectorXf& good) const;
+
 public:
     float          **rr;            /**< These are the guess dipole locations. */
     DipoleForward** guess_fwd;      /**< Forward solutions for the guesses. */
     int            nguess;          /**< How many sources. */
+    Eigen::MatrixXf basis;          /**< The left singular vectors of all guess fields, three columns per guess (nchan x 3*nguess). */
+    Eigen::VectorXf sing_ratio;     /**< Ratio of the smallest and largest singular value of each guess field. */
 
 // ### OLD STRUCT ###
 //    typedef struct {
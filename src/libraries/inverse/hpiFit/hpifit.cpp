@@ -143,10 +143,14 @@ void HPIFit::fit(const MatrixXd& matProjectedData,
     const MatrixXd matAmplitudes = computeAmplitudes(matProjectedData,
                                                      hpiModelParameters);
 
-    const MatrixXd matCoilsSeed = computeSeedPoints(matAmplitudes,
-                                                    hpiFitResult.devHeadTrans,
-                                                    hpiFitResult.errorDistances,
-                                                    matCoilsHead);
+    MatrixXd matCoilsSeed;
+    if(m_fitMethod != HpiFitMethod::levenbergMarquardt ||
+       !computeWarmStartSeedPoints(hpiFitResult, hpiModelParameters, matCoilsSeed)) {
+        matCoilsSeed = computeSeedPoints(matAmplitudes,
+                                         hpiFitResult.devHeadTrans,
+                                         hpiFitResult.errorDistances,
+                                         matCoilsHead);
+    }
 
     CoilParam fittedCoilParams = dipfit(matCoilsSeed,
                                         m_sensors,
@@ -250,6 +254,41 @@ Eigen::MatrixXd HPIFit::computeSeedPoints(const Eigen::MatrixXd& matAmplitudes,
 
 //=============================================================================================================
 
+bool HPIFit::computeWarmStartSeedPoints(const HpiFitResult& hpiFitResult,
+                                        const HpiModelParameters& hpiModelParameters,
+                                        Eigen::MatrixXd& matCoilsSeed)
+{
+    const int iNumCoils = hpiModelParameters.iNHpiCoils();
+    const QVector<int> vecFreqs = hpiModelParameters.vecHpiFreqs();
+
+    if(hpiFitResult.fittedCoils.size() != iNumCoils || hpiFitResult.errorDistances.size() != iNumCoils) {
+        return false;
+    }
+
+    // only start from a good last fit
+    const double dError = std::accumulate(hpiFitResult.errorDistances.begin(), hpiFitResult.errorDistances.end(), .0) / iNumCoils;
+    if(dError >= 0.010) {
+        return false;
+    }
+
+    // the fitted coils are stored in the order of hpiFreqs if the frequencies have been ordered
+    const bool bMapFreqs = hpiFitResult.hpiFreqs.size() == iNumCoils;
+    matCoilsSeed.resize(iNumCoils,3);
+
+    for(int j = 0; j < iNumCoils; ++j) {
+        const int iIdx = bMapFreqs ? hpiFitResult.hpiFreqs.indexOf(vecFreqs[j]) : j;
+        if(iIdx < 0) {
+            return false;
+        }
+        matCoilsSeed(j,0) = hpiFitResult.fittedCoils[iIdx].r[0];
+        matCoilsSeed(j,1) = hpiFitResult.fittedCoils[iIdx].r[1];
+        matCoilsSeed(j,2) = hpiFitResult.fittedCoils[iIdx].r[2];
+    }
+    return true;
+}
+
+//=============================================================================================================
+
 CoilParam HPIFit::dipfit(const MatrixXd matCoilsSeed,
                          const SensorSet& sensors,
                          const MatrixXd& matData,
@@ -270,6 +309,7 @@ CoilParam HPIFit::dipfit(const MatrixXd matCoilsSeed,
         coilData.m_matProjector = matProjectors;
         coilData.m_iMaxIterations = iMaxIterations;
         coilData.m_fAbortError = fAbortError;
+        coilData.m_fitMethod = m_fitMethod;
 
         lCoilData.append(coilData);
     }
@@ -549,3 +589,17 @@ void HPIFit::storeHeadPosition(float fTime,
     matPosition(matPosition.rows()-1,9) = 0;
 }
 
+
+//=============================================================================================================
+
+void HPIFit::setFitMethod(HpiFitMethod fitMethod)
+{
+    m_fitMethod = fitMethod;
+}
+
+//=============================================================================================================
+
+HpiFitMethod HPIFit::fitMethod() const
+{
+    return m_fitMethod;
+}
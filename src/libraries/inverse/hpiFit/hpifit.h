@@ -89,6 +89,11 @@ namespace INVERSELIB
 // Declare all structures to be used
 //=============================================================================================================
 
+/**
+ * The optimizer used to fit the coil positions.
+ */
+enum class HpiFitMethod : int{simplex = 0, levenbergMarquardt = 1};
+
 /**
  * The strucut specifing the coil parameters.
  */
@@ -205,6 +210,24 @@ public:
                                   const Eigen::VectorXd& vecGoF,
                                   const QVector<double>& vecError);
 
+    //=========================================================================================================
+    /**
+     * Sets the optimizer used to fit the coil positions. The default is the simplex search.
+     * The Levenberg-Marquardt fitter uses analytic Jacobians of the magnetic dipole field and warm starts
+     * from the coil positions stored in the HpiFitResult of the previous fit.
+     *
+     * @param[in] fitMethod     The optimizer to use.
+     */
+    void setFitMethod(HpiFitMethod fitMethod);
+
+    //=========================================================================================================
+    /**
+     * Returns the optimizer used to fit the coil positions.
+     *
+     * @return The optimizer in use.
+     */
+    HpiFitMethod fitMethod() const;
+
 private:
 
     //=========================================================================================================
@@ -234,6 +257,19 @@ private:
                                       const QVector<double>& vecError,
                                       const Eigen::MatrixXd& matCoilsHead);
 
+    //=========================================================================================================
+    /**
+     * Use the coil positions of the previous fit as initial positions.
+     *
+     * @param[in]   hpiFitResult        The result of the previous fit.
+     * @param[in]   hpiModelParameters  The model parameters of the current fit.
+     * @param[out]  matCoilsSeed        The seed points, one row per coil in the order of the model frequencies.
+     * @return Returns true if the previous fit was good enough to start from.
+     */
+    bool computeWarmStartSeedPoints(const HpiFitResult& hpiFitResult,
+                                    const HpiModelParameters& hpiModelParameters,
+                                    Eigen::MatrixXd& matCoilsSeed);
+
     //=========================================================================================================
     /**
      * Fits dipoles for the given coils and a given data set.
@@ -357,6 +393,7 @@ private:
 
     SensorSet m_sensors;            /**< The sensor struct that contains information about all sensors. */
     SignalModel m_signalModel;      /**< The signal model for the Hpi signals used to compute extract the coil amplitudes */
+    HpiFitMethod m_fitMethod{HpiFitMethod::simplex};   /**< The optimizer used to fit the coil positions. */
 
 };
 
@@ -51,6 +51,8 @@
 // EIGEN INCLUDES
 //=============================================================================================================
 
+#include <Eigen/Dense>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -73,6 +75,7 @@ using namespace INVERSELIB;
 
 HPIFitData::HPIFitData()
     : m_sensors(SensorSet())
+    , m_fitMethod(HpiFitMethod::simplex)
 {
 }
 
@@ -89,6 +92,16 @@ void HPIFitData::doDipfitConcurrent()
     int iMaxiter = m_iMaxIterations;
     int iSimplexNumitr = 0;
 
+    if(m_fitMethod == HpiFitMethod::levenbergMarquardt) {
+        this->m_coilPos = levenbergMarquardt(vecCurrentCoil,
+                                             iMaxiter,
+                                             vecCurrentData,
+                                             this->m_matProjector,
+                                             currentSensors,
+                                             this->m_errorInfo);
+        return;
+    }
+
     this->m_coilPos = fminsearch(vecCurrentCoil,
                                 iMaxiter,
                                 2 * iMaxiter * vecCurrentCoil.cols(),
@@ -212,6 +225,140 @@ DipFitError HPIFitData::dipfitError(const Eigen::MatrixXd& matPos,
 
 //=============================================================================================================
 
+void HPIFitData::magneticDipoleJacobian(const Eigen::Vector3d& vecPos,
+                                        const Eigen::Vector3d& vecMoment,
+                                        const Eigen::MatrixXd& matRmag,
+                                        const Eigen::MatrixXd& matCosmag,
+                                        const Eigen::RowVectorXd& vecW,
+                                        int iNp,
+                                        Eigen::MatrixXd& matLf,
+                                        Eigen::MatrixXd& matDLf)
+{
+    // same scaling as in magnetic_dipole
+    const double dScale = 1e-7 / (4 * M_PI);
+    const int iNchan = matRmag.rows() / iNp;
+
+    matLf.resize(iNchan,3);
+    matDLf.resize(iNchan,3);
+
+    for(int i = 0; i < iNchan; i++) {
+        Eigen::Vector3d vecLf = Eigen::Vector3d::Zero();
+        Eigen::Vector3d vecDLf = Eigen::Vector3d::Zero();
+
+        for(int p = 0; p < iNp; p++) {
+            const int k = i * iNp + p;
+            const Eigen::Vector3d vecR = matRmag.row(k).transpose() - vecPos;
+            const Eigen::Vector3d vecN = matCosmag.row(k).transpose();
+            const double dR2 = vecR.squaredNorm();
+            const double dInvR3 = 1.0 / (dR2 * std::sqrt(dR2));
+            const double dInvR5 = dInvR3 / dR2;
+            const double dNR = vecN.dot(vecR);
+            const double dMR = vecMoment.dot(vecR);
+            const double dNM = vecN.dot(vecMoment);
+            const double dW = dScale * vecW(k);
+
+            // field of unit dipoles along x, y and z
+            vecLf += dW * (3.0 * dNR * dInvR5 * vecR - dInvR3 * vecN);
+
+            // gradient of the field with respect to r - pos, the dipole position enters with the opposite sign
+            vecDLf -= dW * (3.0 * dInvR5 * (dMR * vecN + dNR * vecMoment + dNM * vecR)
+                            - 15.0 * dNR * dMR * dInvR5 / dR2 * vecR);
+        }
+        matLf.row(i) = vecLf;
+        matDLf.row(i) = vecDLf;
+    }
+}
+
+//=============================================================================================================
+
+Eigen::MatrixXd HPIFitData::levenbergMarquardt(const Eigen::MatrixXd& matPos,
+                                               int iMaxiter,
+                                               const Eigen::MatrixXd& matData,
+                                               const Eigen::MatrixXd& matProjectors,
+                                               const SensorSet& sensors,
+                                               DipFitError& errorInfo)
+{
+    typedef Eigen::Matrix<double,6,6> Matrix6d;
+    typedef Eigen::Matrix<double,6,1> Vector6d;
+
+    const Eigen::MatrixXd matRmag = sensors.rmag();
+    const Eigen::MatrixXd matCosmag = sensors.cosmag();
+    const Eigen::RowVectorXd vecW = sensors.w();
+    const int iNp = sensors.np();
+    const Eigen::VectorXd vecData = Eigen::Map<const Eigen::VectorXd>(matData.data(), matData.size());
+
+    Eigen::Vector3d vecPos(matPos(0), matPos(1), matPos(2));
+    Eigen::Vector3d vecMom = Eigen::Vector3d::Zero();
+    Eigen::MatrixXd matLf, matDLf, matLfNew, matDLfNew, matA;
+    Eigen::MatrixXd matJ(vecData.size(), 6);
+    Eigen::VectorXd vecRes;
+
+    // start from the best moment at the initial position
+    magneticDipoleJacobian(vecPos, vecMom, matRmag, matCosmag, vecW, iNp, matLf, matDLf);
+    matA = matProjectors * matLf;
+    vecMom = (matA.transpose() * matA).ldlt().solve(matA.transpose() * vecData);
+    magneticDipoleJacobian(vecPos, vecMom, matRmag, matCosmag, vecW, iNp, matLf, matDLf);
+    vecRes = vecData - matA * vecMom;
+
+    double dCost = vecRes.squaredNorm();
+    double dLambda = 1e-3;
+    int iItr = 0;
+
+    while(iItr < iMaxiter) {
+        // model is P * L(pos) * mom, parameters are the position and the moment
+        matJ.leftCols(3) = matProjectors * matDLf;
+        matJ.rightCols(3) = matProjectors * matLf;
+
+        const Matrix6d matJtJ = matJ.transpose() * matJ;
+        const Vector6d vecJtr = matJ.transpose() * vecRes;
+        const double dCostOld = dCost;
+        Vector6d vecStep = Vector6d::Zero();
+        bool bAccepted = false;
+
+        while(!bAccepted && dLambda < 1e10) {
+            Matrix6d matH = matJtJ;
+            matH.diagonal() *= 1.0 + dLambda;
+            vecStep = matH.ldlt().solve(vecJtr);
+
+            const Eigen::Vector3d vecPosNew = vecPos + vecStep.head<3>();
+            const Eigen::Vector3d vecMomNew = vecMom + vecStep.tail<3>();
+            magneticDipoleJacobian(vecPosNew, vecMomNew, matRmag, matCosmag, vecW, iNp, matLfNew, matDLfNew);
+            const Eigen::VectorXd vecResNew = vecData - matProjectors * (matLfNew * vecMomNew);
+            const double dCostNew = vecResNew.squaredNorm();
+
+            if(dCostNew < dCost) {
+                vecPos = vecPosNew;
+                vecMom = vecMomNew;
+                vecRes = vecResNew;
+                dCost = dCostNew;
+                matLf.swap(matLfNew);
+                matDLf.swap(matDLfNew);
+                dLambda = std::max(dLambda / 10.0, 1e-12);
+                bAccepted = true;
+            } else {
+                dLambda *= 10.0;
+            }
+        }
+        if(!bAccepted) {
+            break;
+        }
+        iItr++;
+
+        // converged if neither the error nor the position change noticeably
+        if(dCostOld - dCost <= m_fAbortError * dCostOld || vecStep.head<3>().norm() < 1e-8) {
+            break;
+        }
+    }
+
+    errorInfo.error = dCost / vecData.squaredNorm();
+    errorInfo.moment = vecMom;
+    errorInfo.numIterations = iItr;
+
+    return vecPos.transpose();
+}
+
+//=============================================================================================================
+
 bool HPIFitData::compare(HPISortStruct a, HPISortStruct b)
 {
     return (a.base_arr < b.base_arr);
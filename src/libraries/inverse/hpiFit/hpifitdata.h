@@ -132,6 +132,7 @@ public:
 
     int                     m_iMaxIterations;
     float                   m_fAbortError;
+    HpiFitMethod            m_fitMethod;
 
 protected:
     //=========================================================================================================
@@ -167,6 +168,50 @@ protected:
                             const SensorSet& sensors,
                             const Eigen::MatrixXd& matProjectors);
 
+    //=========================================================================================================
+    /**
+     * Computes the lead field of a magnetic dipole at vecPos and the derivatives of the field of the dipole
+     * with moment vecMoment with respect to its position. The derivatives are analytic.
+     *
+     * @param[in]   vecPos          The dipole position.
+     * @param[in]   vecMoment       The dipole moment.
+     * @param[in]   matRmag         The integration points of all sensors (SensorSet::rmag).
+     * @param[in]   matCosmag       The integration point orientations of all sensors (SensorSet::cosmag).
+     * @param[in]   vecW            The integration weights of all sensors (SensorSet::w).
+     * @param[in]   iNp             The number of integration points per sensor.
+     * @param[out]  matLf           The lead field (n_channels x 3).
+     * @param[out]  matDLf          The derivatives of the field with respect to the dipole position (n_channels x 3).
+     */
+    void magneticDipoleJacobian(const Eigen::Vector3d& vecPos,
+                                const Eigen::Vector3d& vecMoment,
+                                const Eigen::MatrixXd& matRmag,
+                                const Eigen::MatrixXd& matCosmag,
+                                const Eigen::RowVectorXd& vecW,
+                                int iNp,
+                                Eigen::MatrixXd& matLf,
+                                Eigen::MatrixXd& matDLf);
+
+    //=========================================================================================================
+    /**
+     * Levenberg-Marquardt fit of the dipole position and moment to the data.
+     * The Jacobian is computed analytically, so only a handful of iterations are needed from a good start.
+     *
+     * @param[in]   matPos          The initial dipole position (1 x 3).
+     * @param[in]   iMaxiter        The maximum number of iterations.
+     * @param[in]   matData         The data to fit.
+     * @param[in]   matProjectors   The projectors to apply.
+     * @param[in]   sensors         The sensor information.
+     * @param[out]  errorInfo       The error and moment at the fitted position.
+     *
+     * @return The fitted position (1 x 3).
+     */
+    Eigen::MatrixXd levenbergMarquardt(const Eigen::MatrixXd& matPos,
+                                       int iMaxiter,
+                                       const Eigen::MatrixXd& matData,
+                                       const Eigen::MatrixXd& matProjectors,
+                                       const SensorSet& sensors,
+                                       DipFitError& errorInfo);
+
     //=========================================================================================================
     /**
      * Compare function for sorting
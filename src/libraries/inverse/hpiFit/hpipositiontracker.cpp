@@ -0,0 +1,272 @@
+//=============================================================================================================
+/**
+ * @file     hpipositiontracker.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    HpiPositionTracker class definition.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "hpipositiontracker.h"
+#include "hpifit.h"
+#include "hpidataupdater.h"
+#include "hpimodelparameters.h"
+
+#include <fiff/fiff_raw_data.h>
+#include <fiff/fiff_info.h>
+
+#include <iostream>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QTextStream>
+#include <QFuture>
+#include <QList>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace INVERSELIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+HpiPositionTracker::HpiPositionTracker(const QVector<int>& vecHpiFreqs,
+                                       float fWindow,
+                                       float fStep,
+                                       bool bBasic)
+    : m_vecHpiFreqs(vecHpiFreqs)
+    , m_fWindow(fWindow)
+    , m_fStep(fStep)
+    , m_bBasic(bBasic)
+    , m_iNumThreads(0)
+    , m_iWindowsPerChunk(50)
+{
+}
+
+//=============================================================================================================
+
+void HpiPositionTracker::setNumThreads(int iNumThreads)
+{
+    m_iNumThreads = iNumThreads;
+}
+
+//=============================================================================================================
+
+void HpiPositionTracker::setWindowsPerChunk(int iWindowsPerChunk)
+{
+    m_iWindowsPerChunk = iWindowsPerChunk > 0 ? iWindowsPerChunk : 1;
+}
+
+//=============================================================================================================
+
+bool HpiPositionTracker::computeHeadPositions(const FiffRawData& raw,
+                                              const MatrixXd& matProjectors,
+                                              MatrixXd& matPosition) const
+{
+    QSharedPointer<FiffInfo> pFiffInfo = QSharedPointer<FiffInfo>(new FiffInfo(raw.info));
+    const double dSFreq = pFiffInfo->sfreq;
+    const int iWindow = static_cast<int>(floor(m_fWindow * dSFreq));
+    const int iStep = std::max(1, static_cast<int>(floor(m_fStep * dSFreq)));
+    const int iFirst = raw.first_samp;
+    const int iNumSamples = raw.last_samp - raw.first_samp + 1;
+
+    if(iWindow <= 0 || iNumSamples < iWindow) {
+        std::cout << "HpiPositionTracker::computeHeadPositions - Recording shorter than one window. Returning." << std::endl;
+        return false;
+    }
+    const int iNumWindows = (iNumSamples - iWindow) / iStep + 1;
+
+    HpiDataUpdater hpiDataUpdater = HpiDataUpdater(pFiffInfo);
+    HPIFit hpiFit = HPIFit(hpiDataUpdater.getSensors());
+    hpiFit.setFitMethod(HpiFitMethod::levenbergMarquardt);
+
+    MatrixXd matData, matTimes;
+
+    // Use the first window to find the coil order
+    if(!raw.read_raw_segment(matData, matTimes, iFirst, iFirst + iWindow - 1)) {
+        std::cout << "HpiPositionTracker::computeHeadPositions - Could not read the first window. Returning." << std::endl;
+        return false;
+    }
+    hpiDataUpdater.prepareDataAndProjectors(matData, matProjectors);
+    const MatrixXd matPreparedProjectors = hpiDataUpdater.getProjectors();
+    const MatrixXd matCoilsHead = hpiDataUpdater.getHpiDigitizer();
+
+    HpiModelParameters hpiModelParameters(m_vecHpiFreqs,
+                                          dSFreq,
+                                          pFiffInfo->linefreq,
+                                          m_bBasic);
+    HpiFitResult hpiFitResultFirst;
+    hpiFit.fit(hpiDataUpdater.getProjectedData(),
+               matPreparedProjectors,
+               hpiModelParameters,
+               matCoilsHead,
+               true,
+               hpiFitResultFirst);
+
+    if(hpiFitResultFirst.errorDistances.isEmpty()) {
+        std::cout << "HpiPositionTracker::computeHeadPositions - Initial fit failed. Returning." << std::endl;
+        return false;
+    }
+
+    // Refit with the ordered frequencies, this also computes the signal model inverse which is copied to all chunks
+    hpiModelParameters = HpiModelParameters(hpiFitResultFirst.hpiFreqs,
+                                            dSFreq,
+                                            pFiffInfo->linefreq,
+                                            m_bBasic);
+    hpiFit.fit(hpiDataUpdater.getProjectedData(),
+               matPreparedProjectors,
+               hpiModelParameters,
+               matCoilsHead,
+               hpiFitResultFirst);
+
+    QThreadPool threadPool;
+    if(m_iNumThreads > 0) {
+        threadPool.setMaxThreadCount(m_iNumThreads);
+    }
+    const int iMaxPending = 2 * threadPool.maxThreadCount();
+
+    matPosition = MatrixXd::Zero(iNumWindows, 10);
+
+    QList<QPair<int,QFuture<MatrixXd> > > lPending;
+    MatrixXd matBlock;              // projected data of the current chunk
+    int iBlockStart = 0;            // sample offset of the first column of matBlock
+    int iBlockEnd = 0;              // sample offset after the last column of matBlock
+
+    for(int iWin = 0; iWin < iNumWindows || !lPending.isEmpty(); iWin += m_iWindowsPerChunk) {
+        // Collect finished chunks in order, and wait if too many are pending
+        while(!lPending.isEmpty() && (lPending.size() >= iMaxPending || iWin >= iNumWindows || lPending.first().second.isFinished())) {
+            const MatrixXd matChunkPosition = lPending.first().second.result();
+            matPosition.middleRows(lPending.first().first, matChunkPosition.rows()) = matChunkPosition;
+            lPending.removeFirst();
+        }
+        if(iWin >= iNumWindows) {
+            continue;
+        }
+
+        // Read only the samples not yet covered by the previous chunk
+        const int iNumChunkWindows = std::min(m_iWindowsPerChunk, iNumWindows - iWin);
+        const int iChunkStart = iWin * iStep;
+        const int iChunkEnd = (iWin + iNumChunkWindows - 1) * iStep + iWindow;
+        const int iReadStart = std::max(iChunkStart, iBlockEnd);
+
+        if(!raw.read_raw_segment(matData, matTimes, iFirst + iReadStart, iFirst + iChunkEnd - 1)) {
+            std::cout << "HpiPositionTracker::computeHeadPositions - Could not read samples " << iFirst + iReadStart << " to " << iFirst + iChunkEnd - 1 << ". Returning." << std::endl;
+            for(int i = 0; i < lPending.size(); ++i) {
+                lPending[i].second.waitForFinished();
+            }
+            return false;
+        }
+        hpiDataUpdater.prepareDataAndProjectors(matData, matProjectors);
+
+        MatrixXd matChunk(hpiDataUpdater.getProjectedData().rows(), iChunkEnd - iChunkStart);
+        const int iNumKept = iReadStart - iChunkStart;
+        if(iNumKept > 0) {
+            matChunk.leftCols(iNumKept) = matBlock.middleCols(iChunkStart - iBlockStart, iNumKept);
+        }
+        matChunk.rightCols(iChunkEnd - iReadStart) = hpiDataUpdater.getProjectedData();
+        matBlock = matChunk;
+        iBlockStart = iChunkStart;
+        iBlockEnd = iChunkEnd;
+
+        // Fit the windows of this chunk in a row, each warm starting from the previous one
+        lPending.append(qMakePair(iWin, QtConcurrent::run(&threadPool, [=]() {
+            HPIFit hpiFitChunk = hpiFit;
+            HpiFitResult hpiFitResult = hpiFitResultFirst;
+            MatrixXd matChunkPosition;
+
+            for(int i = 0; i < iNumChunkWindows; ++i) {
+                hpiFitChunk.fit(matChunk.middleCols(i * iStep, iWindow),
+                                matPreparedProjectors,
+                                hpiModelParameters,
+                                matCoilsHead,
+                                hpiFitResult);
+                HPIFit::storeHeadPosition((iFirst + (iWin + i) * iStep) / dSFreq,
+                                          hpiFitResult.devHeadTrans.trans,
+                                          matChunkPosition,
+                                          hpiFitResult.GoF,
+                                          hpiFitResult.errorDistances);
+            }
+            return matChunkPosition;
+        })));
+    }
+
+    // Velocity from the translation between consecutive windows
+    for(int i = 1; i < matPosition.rows(); ++i) {
+        const double dTime = matPosition(i,0) - matPosition(i-1,0);
+        if(dTime > 0.0) {
+            matPosition(i,9) = (matPosition.block(i,4,1,3) - matPosition.block(i-1,4,1,3)).norm() / dTime;
+        }
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool HpiPositionTracker::writeHeadPositions(const QString& sFileName,
+                                            const MatrixXd& matPosition)
+{
+    QFile file(sFileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        std::cout << "HpiPositionTracker::writeHeadPositions - Could not open " << sFileName.toStdString() << ". Returning." << std::endl;
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << " Time       q1       q2       q3       q4       q5       q6       g-value  error    velocity\n";
+    for(int i = 0; i < matPosition.rows(); ++i) {
+        out << QString::asprintf("%9.3f %8.5f %8.5f %8.5f %8.5f %8.5f %8.5f %8.5f %8.5f %8.5f\n",
+                                 matPosition(i,0), matPosition(i,1), matPosition(i,2), matPosition(i,3), matPosition(i,4),
+                                 matPosition(i,5), matPosition(i,6), matPosition(i,7), matPosition(i,8), matPosition(i,9));
+    }
+    return true;
+}
@@ -0,0 +1,165 @@
+//=============================================================================================================
+/**
+ * @file     hpipositiontracker.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    HpiPositionTracker class declaration.
+ *
+ */
+
+#ifndef HPIPOSITIONTRACKER_H
+#define HPIPOSITIONTRACKER_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../inverse_global.h"
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+namespace FIFFLIB{
+    class FiffRawData;
+}
+
+//=============================================================================================================
+// DEFINE NAMESPACE INVERSELIB
+//=============================================================================================================
+
+namespace INVERSELIB
+{
+
+//=============================================================================================================
+// INVERSELIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+ * Estimates the continuous head position for every window of a whole recording.
+ * The raw file is read once from start to end. Consecutive windows are grouped into chunks which are fitted in
+ * parallel, each chunk warm starting the Levenberg-Marquardt coil fits from window to window. The results are
+ * collected in file order.
+ *
+ * @brief Offline continuous HPI head position estimation.
+ */
+class INVERSESHARED_EXPORT HpiPositionTracker
+{
+
+public:
+    typedef QSharedPointer<HpiPositionTracker> SPtr;            /**< Shared pointer type for HpiPositionTracker. */
+    typedef QSharedPointer<const HpiPositionTracker> ConstSPtr; /**< Const shared pointer type for HpiPositionTracker. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a HpiPositionTracker object.
+     *
+     * @param[in] vecHpiFreqs   The HPI coil frequencies. The order is determined from the data.
+     * @param[in] fWindow       The window length in seconds.
+     * @param[in] fStep         The time between two consecutive windows in seconds.
+     * @param[in] bBasic        Use the basic signal model without line frequency and drift terms.
+     */
+    explicit HpiPositionTracker(const QVector<int>& vecHpiFreqs,
+                                float fWindow = 0.2f,
+                                float fStep = 0.01f,
+                                bool bBasic = false);
+
+    //=========================================================================================================
+    /**
+     * Sets the number of threads used for fitting. 0 uses all processors.
+     *
+     * @param[in] iNumThreads   The number of threads.
+     */
+    void setNumThreads(int iNumThreads);
+
+    //=========================================================================================================
+    /**
+     * Sets the number of consecutive windows fitted by one thread in a row.
+     *
+     * @param[in] iWindowsPerChunk  The number of windows per chunk.
+     */
+    void setWindowsPerChunk(int iWindowsPerChunk);
+
+    //=========================================================================================================
+    /**
+     * Estimates the head position for all windows of a raw data file.
+     * Each row of matPosition holds the window start time, the rotation quaternion q1...q3, the translation,
+     * the mean goodness of fit, the mean coil estimation error and the velocity, as in storeHeadPosition.
+     *
+     * @param[in]   raw             The raw data.
+     * @param[in]   matProjectors   The projectors to apply (all channels).
+     * @param[out]  matPosition     The head positions, one row per window.
+     *
+     * @return true when successful.
+     */
+    bool computeHeadPositions(const FIFFLIB::FiffRawData& raw,
+                              const Eigen::MatrixXd& matProjectors,
+                              Eigen::MatrixXd& matPosition) const;
+
+    //=========================================================================================================
+    /**
+     * Writes head positions to a text file in the MaxFilter head position (.pos) format.
+     *
+     * @param[in] sFileName     The file to write.
+     * @param[in] matPosition   The head positions as computed by computeHeadPositions.
+     *
+     * @return true when successful.
+     */
+    static bool writeHeadPositions(const QString& sFileName,
+                                   const Eigen::MatrixXd& matPosition);
+
+private:
+    QVector<int>    m_vecHpiFreqs;          /**< The HPI coil frequencies. */
+    float           m_fWindow;              /**< The window length in seconds. */
+    float           m_fStep;                /**< The time between windows in seconds. */
+    bool            m_bBasic;               /**< Use the basic signal model. */
+    int             m_iNumThreads;          /**< The number of threads, 0 = all processors. */
+    int             m_iWindowsPerChunk;     /**< The number of consecutive windows fitted in a row. */
+};
+
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+} // namespace INVERSELIB
+
+#endif // HPIPOSITIONTRACKER_H
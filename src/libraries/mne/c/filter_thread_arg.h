@@ -67,6 +67,8 @@
 namespace MNELIB
 {
 
+class MNESurfaceBvh;
+
 //=============================================================================================================
 /**
  * Implements a Filter Thread Argument (Replaces *filterThreadArg,filterThreadArgRec; struct of MNE-C filter_source_space.c).
@@ -97,6 +99,7 @@ public:
     MneSourceSpaceOld* s;           /* The source space to process */
     FIFFLIB::FiffCoordTransOld* mri_head_t;  /* Coordinate transformation */
     MneSurfaceOld*   surf;          /* The inner skull surface */
+    const MNESurfaceBvh* bvh;       /* Triangle hierarchy of the inner skull surface (optional) */
     float          limit;           /* Distance limit */
     FILE           *filtered;       /* Log omitted point locations here */
     int            stat;            /* How was it? */
@@ -41,6 +41,7 @@
 #include "mne_surface_old.h"
 #include "mne_morph_map.h"
 #include "mne_source_space_old.h"
+#include "../mne_surface_bvh.h"
 
 #define FREE_44(x) if ((char *)(x) != NULL) free((char *)(x))
 
@@ -79,6 +80,7 @@ MneMshDisplaySurface::MneMshDisplaySurface()
     filename = Q_NULLPTR;
     time_loaded = 0;
     s = Q_NULLPTR;
+    bvh = Q_NULLPTR;
     sketch = FALSE;
     color_scale    = Q_NULLPTR;
     vertex_colors  = Q_NULLPTR;
@@ -131,6 +133,7 @@ MneMshDisplaySurface::~MneMshDisplaySurface()
 {
     FREE_44(filename);
     delete s;
+    delete bvh;
     FREE_44(marker_values);
     FREE_44(overlay_values);
     FREE_44(alt_overlay_values);
@@ -69,6 +69,7 @@ class MneMorphMap;
 class MneMshPicked;
 class MneMshColorScaleDef;
 class MneSurfaceOld;
+class MNESurfaceBvh;
 
 //=============================================================================================================
 /**
@@ -100,6 +101,7 @@ public:
     char           *subj;		/* The name of the subject in SUBJECTS_DIR */
     char           *surf_name;	/* The name of the surface */
     MNELIB::MneSurfaceOld*     s;		/* This is the surface */
+    MNELIB::MNESurfaceBvh*     bvh;		/* Triangle hierarchy of the surface for closest point searches (built on demand) */
     float          eye[3];	/* Eye position for viewing */
     float          up[3];		/* Up vector for viewing */
     float          rot[3];        /* Rotation angles of the MRI (in radians) */
@@ -51,6 +51,7 @@
 #include "mne_vol_geom.h"
 #include "mne_mgh_tag_group.h"
 #include "mne_mgh_tag.h"
+#include "../mne_surface_bvh.h"
 
 #include <fiff/fiff_stream.h>
 #include <fiff/c/fiff_digitizer_data.h>
@@ -440,18 +441,118 @@ double MneSurfaceOrVolume::sum_solids(float *from, MneSurfaceOld* surf)
 
 //=============================================================================================================
 
+double MneSurfaceOrVolume::sum_solids(float *from, MneSurfaceOld* surf, const MNESurfaceBvh* bvh)
+/*
+     * For a closed surface the winding number of a ray cast equals the solid angle sum divided by 4 pi.
+     * Points too close to the surface or rays too close to a triangle edge fall back to the exact sum.
+     */
+{
+    int  winding;
+    bool reliable = false;
+
+    if (bvh) {
+        winding = bvh->windingNumber(Eigen::Vector3f(from[X_17],from[Y_17],from[Z_17]),reliable);
+        if (reliable)
+            return 4*M_PI*winding;
+    }
+    return sum_solids(from,surf);
+}
+
+//=============================================================================================================
+
+MNESurfaceBvh* MneSurfaceOrVolume::mne_make_surface_bvh(MneSurfaceOld* s)
+/*
+     * Build a bounding volume hierarchy over the triangles for nearest triangle and inside queries
+     */
+{
+    Eigen::MatrixX3f r1(s->ntri,3);
+    Eigen::MatrixX3f r2(s->ntri,3);
+    Eigen::MatrixX3f r3(s->ntri,3);
+    int k,c;
+
+    for (k = 0; k < s->ntri; k++) {
+        for (c = 0; c < 3; c++) {
+            r1(k,c) = s->tris[k].r1[c];
+            r2(k,c) = s->tris[k].r2[c];
+            r3(k,c) = s->tris[k].r3[c];
+        }
+    }
+    return new MNESurfaceBvh(r1,r2,r3);
+}
+
+//=============================================================================================================
+
+int MneSurfaceOrVolume::mne_closest_vertex(MneSurfaceOld* s, const MNESurfaceBvh* bvh, float *r, float *distp)
+/*
+     * Find the closest vertex. With the triangle hierarchy only vertices which belong to a triangle are considered.
+     */
+{
+    float diff[3],dist,mindist;
+    int   k,minvert,tri;
+    MneTriangle* this_tri;
+
+    mindist = 0.0;
+    minvert = -1;
+    if (bvh) {
+        Eigen::Vector3f rr(r[X_17],r[Y_17],r[Z_17]);
+        tri = bvh->findNearest(rr,
+                               [s,&rr](int t, float& d) {
+                                   MneTriangle* t_tri = s->tris+t;
+                                   d = std::min(std::min((rr - Eigen::Map<Eigen::Vector3f>(t_tri->r1)).norm(),
+                                                         (rr - Eigen::Map<Eigen::Vector3f>(t_tri->r2)).norm()),
+                                                (rr - Eigen::Map<Eigen::Vector3f>(t_tri->r3)).norm());
+                                   return true;
+                               },
+                               1.0f,
+                               mindist);
+        if (tri >= 0) {
+            this_tri = s->tris+tri;
+            VEC_DIFF_17(r,this_tri->r1,diff);
+            mindist = VEC_LEN_17(diff);
+            minvert = this_tri->vert[0];
+            VEC_DIFF_17(r,this_tri->r2,diff);
+            dist = VEC_LEN_17(diff);
+            if (dist < mindist) {
+                mindist = dist;
+                minvert = this_tri->vert[1];
+            }
+            VEC_DIFF_17(r,this_tri->r3,diff);
+            dist = VEC_LEN_17(diff);
+            if (dist < mindist) {
+                mindist = dist;
+                minvert = this_tri->vert[2];
+            }
+        }
+    }
+    else {
+        for (k = 0; k < s->np; k++) {
+            VEC_DIFF_17(r,s->rr[k],diff);
+            dist = VEC_LEN_17(diff);
+            if (minvert < 0 || dist < mindist) {
+                mindist = dist;
+                minvert = k;
+            }
+        }
+    }
+    if (distp)
+        *distp = mindist;
+    return minvert;
+}
+
+//=============================================================================================================
+
 int MneSurfaceOrVolume::mne_filter_source_spaces(MneSurfaceOld* surf, float limit, FiffCoordTransOld* mri_head_t, MneSourceSpaceOld* *spaces, int nspace, FILE *filtered)   /* Provide a list of filtered points here */
 /*
      * Remove all source space points closer to the surface than a given limit
      */
 {
     MneSourceSpaceOld* s;
-    int k,p1,p2;
+    int k,p1;
     float r1[3];
-    float mindist,dist,diff[3];
-    int   minnode;
+    float mindist;
     int   omit,omit_outside;
     double tot_angle;
+    MNESurfaceBvh* bvh = NULL;
 
     if (surf == NULL)
         return OK;
@@ -473,6 +574,7 @@ int MneSurfaceOrVolume::mne_filter_source_spaces(MneSurfaceOld* surf, float limi
     if (limit > 0.0)
         printf("and at least %6.1f mm away",1000*limit);
     printf(" (will take a few...)\n");
+    bvh          = mne_make_surface_bvh(surf);
     omit         = 0;
     omit_outside = 0;
     for (k = 0; k < nspace; k++) {
@@ -485,7 +587,7 @@ int MneSurfaceOrVolume::mne_filter_source_spaces(MneSurfaceOld* surf, float limi
                 /*
                 * Check that the source is inside the inner skull surface
                 */
-                tot_angle = sum_solids(r1,surf)/(4*M_PI);
+                tot_angle = sum_solids(r1,surf,bvh)/(4*M_PI);
                 if (std::fabs(tot_angle-1.0) > 1e-5) {
                     omit_outside++;
                     s->inuse[p1] = FALSE;
@@ -498,16 +600,7 @@ int MneSurfaceOrVolume::mne_filter_source_spaces(MneSurfaceOld* surf, float limi
                     /*
                         * Check the distance limit
                         */
-                    mindist = 1.0;
-                    minnode = 0;
-                    for (p2 = 0; p2 < surf->np; p2++) {
-                        VEC_DIFF_17(r1,surf->rr[p2],diff);
-                        dist = VEC_LEN_17(diff);
-                        if (dist < mindist) {
-                            mindist = dist;
-                            minnode = p2;
-                        }
-                    }
+                    mne_closest_vertex(surf,bvh,r1,&mindist);
                     if (mindist < limit) {
                         omit++;
                         s->inuse[p1] = FALSE;
@@ -519,7 +612,7 @@ int MneSurfaceOrVolume::mne_filter_source_spaces(MneSurfaceOld* surf, float limi
                 }
             }
     }
-    (void)minnode; // squash compiler warning, this is unused
+    delete bvh;
     if (omit_outside > 0)
         printf("%d source space points omitted because they are outside the inner skull surface.\n",
                omit_outside);
@@ -652,12 +745,11 @@ void MneSurfaceOrVolume::rearrange_source_space(MneSourceSpaceOld* s)
 void *MneSurfaceOrVolume::filter_source_space(void *arg)
 {
     FilterThreadArg* a = (FilterThreadArg*)arg;
-    int    p1,p2;
+    int    p1;
     double tot_angle;
     int    omit,omit_outside;
     float  r1[3];
-    float  mindist,dist,diff[3];
-    int    minnode;
+    float  mindist;
 
     omit         = 0;
     omit_outside = 0;
@@ -670,7 +762,7 @@ void *MneSurfaceOrVolume::filter_source_space(void *arg)
             /*
            * Check that the source is inside the inner skull surface
            */
-            tot_angle = sum_solids(r1,a->surf)/(4*M_PI);
+            tot_angle = sum_solids(r1,a->surf,a->bvh)/(4*M_PI);
             if (std::fabs(tot_angle-1.0) > 1e-5) {
                 omit_outside++;
                 a->s->inuse[p1] = FALSE;
@@ -683,16 +775,7 @@ void *MneSurfaceOrVolume::filter_source_space(void *arg)
                 /*
          * Check the distance limit
          */
-                mindist = 1.0;
-                minnode = 0;
-                for (p2 = 0; p2 < a->surf->np; p2++) {
-                    VEC_DIFF_17(r1,a->surf->rr[p2],diff);
-                    dist = VEC_LEN_17(diff);
-                    if (dist < mindist) {
-                        mindist = dist;
-                        minnode = p2;
-                    }
-                }
+                mne_closest_vertex(a->surf,a->bvh,r1,&mindist);
                 if (mindist < a->limit) {
                     omit++;
                     a->s->inuse[p1] = FALSE;
@@ -704,7 +787,6 @@ void *MneSurfaceOrVolume::filter_source_space(void *arg)
             }
         }
     }
-    (void)minnode; // squash compiler warning, set but unused
     if (omit_outside > 0)
         printf("%d source space points omitted because they are outside the inner skull surface.\n",
                 omit_outside);
@@ -723,6 +805,7 @@ int MneSurfaceOrVolume::filter_source_spaces(float limit, char *bemfile, FiffCoo
           */
 {
     MneSurfaceOld*    surf = NULL;
+    MNESurfaceBvh*  bvh = NULL;
     int             k;
     int             nproc = QThread::idealThreadCount();
     FilterThreadArg* a;
@@ -748,6 +831,10 @@ int MneSurfaceOrVolume::filter_source_spaces(float limit, char *bemfile, FiffCoo
     if (limit > 0.0)
         printf("and at least %6.1f mm away",1000*limit);
     printf(" (will take a few...)\n");
+    /*
+     * The triangle hierarchy is shared by all source spaces (and threads)
+     */
+    bvh = mne_make_surface_bvh(surf);
     if (nproc < 2 || nspace == 1 || !use_threads) {
         /*
         * This is the conventional calculation
@@ -757,6 +844,7 @@ int MneSurfaceOrVolume::filter_source_spaces(float limit, char *bemfile, FiffCoo
             a->s = spaces[k];
             a->mri_head_t = mri_head_t;
             a->surf = surf;
+            a->bvh = bvh;
             a->limit = limit;
             a->filtered = filtered;
             filter_source_space(a);
@@ -776,6 +864,7 @@ int MneSurfaceOrVolume::filter_source_spaces(float limit, char *bemfile, FiffCoo
             a->s = spaces[k];
             a->mri_head_t = mri_head_t;
             a->surf = surf;
+            a->bvh = bvh;
             a->limit = limit;
             a->filtered = filtered;
             args.append(a);
@@ -791,6 +880,7 @@ int MneSurfaceOrVolume::filter_source_spaces(float limit, char *bemfile, FiffCoo
                 delete args[k];
         }
     }
+    delete bvh;
     if(surf)
         delete surf;
     printf("Thank you for waiting.\n\n");
@@ -1480,6 +1570,16 @@ int MneSurfaceOrVolume::mne_project_to_surface(MneSurfaceOld* s, void *proj_data
 /*
           * Project the point onto the closest point on the surface
           */
+{
+    return mne_project_to_surface(s,proj_data,r,project_it,distp,NULL);
+}
+
+//=============================================================================================================
+
+int MneSurfaceOrVolume::mne_project_to_surface(MneSurfaceOld* s, void *proj_data, float *r, int project_it, float *distp, const MNESurfaceBvh* bvh)
+/*
+          * Project the point onto the closest point on the surface, using the triangle hierarchy if available
+          */
 {
     float dist;			/* Distance to the triangle */
     float p,q;			/* Coordinates on the triangle */
@@ -1489,6 +1589,26 @@ int MneSurfaceOrVolume::mne_project_to_surface(MneSurfaceOld* s, void *proj_data
 
     p0 = q0 = 0.0;
     dist0 = 0.0;
+    if (bvh) {
+        /*
+         * The distances given by nearest_triangle_point are never below 1/sqrt(2) times the
+         * Euclidean ones. With this bound the hierarchy finds the same triangle as the full search.
+         */
+        best = bvh->findNearest(Eigen::Vector3f(r[X_17],r[Y_17],r[Z_17]),
+                                [s,proj_data,r](int tri, float& tri_dist) {
+                                    float tri_p,tri_q;
+                                    return nearest_triangle_point(r,s,proj_data,tri,&tri_p,&tri_q,&tri_dist) != FALSE;
+                                },
+                                (float)M_SQRT1_2,
+                                dist0);
+        if (best >= 0)
+            nearest_triangle_point(r,s,proj_data,best,&p0,&q0,&dist0);
+        if (best >= 0 && project_it)
+            project_to_triangle(s,best,p0,q0,r);
+        if (distp)
+            *distp = dist0;
+        return best;
+    }
     for (best = -1, k = 0; k < s->ntri; k++) {
         if (nearest_triangle_point(r,s,proj_data,k,&p,&q,&dist)) {
             if (best < 0 || std::fabs(dist) < std::fabs(dist0)) {
@@ -1527,6 +1647,22 @@ void MneSurfaceOrVolume::mne_project_to_triangle(MneSurfaceOld* s,
 //=============================================================================================================
 
 void MneSurfaceOrVolume::mne_find_closest_on_surface_approx(MneSurfaceOld* s, float **r, int np, int *nearest, float *dist, int nstep)
+/*
+      * Build the triangle hierarchy for a single search. Callers which search the same surface repeatedly
+      * should keep the hierarchy and use the version below.
+      */
+{
+    MNESurfaceBvh* bvh = mne_make_surface_bvh(s);
+
+    mne_find_closest_on_surface_approx(s,r,np,nearest,dist,nstep,bvh);
+    delete bvh;
+    return;
+}
+
+//=============================================================================================================
+
+void MneSurfaceOrVolume::mne_find_closest_on_surface_approx(MneSurfaceOld* s, float **r, int np, int *nearest, float *dist, int nstep,
+                                                            const MNESurfaceBvh* bvh)
 /*
       * Find the closest triangle on the surface for each point and the distance to it
       * This uses the values in nearest as approximations of the closest triangle
@@ -1540,11 +1676,11 @@ void MneSurfaceOrVolume::mne_find_closest_on_surface_approx(MneSurfaceOld* s, fl
 
     for (k = 0; k < np; k++) {
         was = nearest[k];
-        decide_search_restriction(s,p,nearest[k],nstep,r[k]);
-        nearest[k] =  mne_project_to_surface(s,p,r[k],0,dist ? dist+k : &mydist);
+        decide_search_restriction(s,p,nearest[k],nstep,r[k],bvh);
+        nearest[k] =  mne_project_to_surface(s,p,r[k],0,dist ? dist+k : &mydist,bvh);
         if (nearest[k] < 0) {
-            decide_search_restriction(s,p,-1,nstep,r[k]);
-            nearest[k] =  mne_project_to_surface(s,p,r[k],0,dist ? dist+k : &mydist);
+            decide_search_restriction(s,p,-1,nstep,r[k],bvh);
+            nearest[k] =  mne_project_to_surface(s,p,r[k],0,dist ? dist+k : &mydist,bvh);
         }
     }
     (void)was; // squash compiler warning, set but unused
@@ -1565,6 +1701,22 @@ void MneSurfaceOrVolume::decide_search_restriction(MneSurfaceOld* s,
 /*
       * Restrict the search only to feasible triangles
       */
+{
+    decide_search_restriction(s,p,approx_best,nstep,r,NULL);
+}
+
+//=============================================================================================================
+
+void MneSurfaceOrVolume::decide_search_restriction(MneSurfaceOld* s,
+                                                   MneProjData*   p,
+                                                   int        approx_best, /* We know the best triangle approximately
+                                                                                      * already */
+                                                   int        nstep,
+                                                   float      *r,
+                                                   const MNESurfaceBvh* bvh)  /* Triangle hierarchy for the closest vertex search (optional) */
+/*
+      * Restrict the search only to feasible triangles
+      */
 {
     int k;
     float diff[3],dist,mindist;
@@ -1573,7 +1725,15 @@ void MneSurfaceOrVolume::decide_search_restriction(MneSurfaceOld* s,
     for (k = 0; k < s->ntri; k++)
         p->act[k] = FALSE;
 
-    if (approx_best < 0) {
+    if (approx_best < 0 && bvh) {
+        /*
+        * Search for the closest vertex which belongs to a triangle
+        */
+        minvert = mne_closest_vertex(s,bvh,r,&mindist);
+        if (minvert < 0)
+            minvert = 0;
+    }
+    else if (approx_best < 0) {
         /*
         * Search for the closest vertex
         */
@@ -3095,7 +3255,12 @@ void MneSurfaceOrVolume::calculate_digitizer_distances(FIFFLIB::FiffDigitizerDat
         }
     }
 
-    mne_find_closest_on_surface_approx(head->s,rr,nactive,closest,dist,nstep);
+    /*
+     * The alignment iterations search the same surface many times, keep its triangle hierarchy
+     */
+    if (!head->bvh)
+        head->bvh = mne_make_surface_bvh(head->s);
+    mne_find_closest_on_surface_approx(head->s,rr,nactive,closest,dist,nstep,head->bvh);
     /*
      * Project the points on the triangles
      */
@@ -3257,6 +3422,11 @@ void MneSurfaceOrVolume::scale_display_surface(MneMshDisplaySurface* surf,
     for (j = 0; j < surf->s->np; j++)
         for (k = 0; k < 3; k++)
             surf->s->rr[j][k] = surf->s->rr[j][k]*scales[k];
+    /*
+     * The triangle hierarchy does not match the scaled surface any more
+     */
+    delete surf->bvh;
+    surf->bvh = NULL;
     return;
 }
 
@@ -103,6 +103,7 @@ class MneSurfaceOld;
 class MneMshDisplaySurface;
 class MneProjData;
 class MneMghTagGroup;
+class MNESurfaceBvh;
 
 //=============================================================================================================
 /**
@@ -144,6 +145,15 @@ public:
 
     static double sum_solids(float *from, MneSurfaceOld* surf);
 
+    static double sum_solids(float *from, MneSurfaceOld* surf, const MNESurfaceBvh* bvh);  /* Use the winding number from the hierarchy if reliable */
+
+    static MNESurfaceBvh* mne_make_surface_bvh(MneSurfaceOld* s);
+
+    static int mne_closest_vertex(MneSurfaceOld* s,
+                                  const MNESurfaceBvh* bvh,  /* Triangle hierarchy of the surface (optional) */
+                                  float *r,
+                                  float *distp);
+
     static int mne_filter_source_spaces(MneSurfaceOld* surf,  /* The bounding surface must be provided */
                                         float limit,                                   /* Minimum allowed distance from the surface */
                                         FIFFLIB::FiffCoordTransOld* mri_head_t,     /* Coordinate transformation (may not be needed) */
@@ -232,6 +242,9 @@ public:
 
     static int mne_project_to_surface(MneSurfaceOld* s, void *proj_data, float *r, int project_it, float *distp);
 
+    static int mne_project_to_surface(MneSurfaceOld* s, void *proj_data, float *r, int project_it, float *distp,
+                                      const MNESurfaceBvh* bvh);  /* Triangle hierarchy of the surface (optional) */
+
     static void mne_project_to_triangle(MneSurfaceOld* s,
                                             int        best,
                                             float      *r,
@@ -239,6 +252,9 @@ public:
 
     static void mne_find_closest_on_surface_approx(MneSurfaceOld* s, float **r, int np, int *nearest, float *dist, int nstep);
 
+    static void mne_find_closest_on_surface_approx(MneSurfaceOld* s, float **r, int np, int *nearest, float *dist, int nstep,
+                                                   const MNESurfaceBvh* bvh);  /* Triangle hierarchy of the surface */
+
     static void decide_search_restriction(MneSurfaceOld* s,
                           MneProjData*   p,
                           int        approx_best, /* We know the best triangle approximately
@@ -246,6 +262,14 @@ public:
                           int        nstep,
                           float      *r);
 
+    static void decide_search_restriction(MneSurfaceOld* s,
+                          MneProjData*   p,
+                          int        approx_best, /* We know the best triangle approximately
+                                       * already */
+                          int        nstep,
+                          float      *r,
+                          const MNESurfaceBvh* bvh);  /* Triangle hierarchy of the surface (optional) */
+
     static void activate_neighbors(MneSurfaceOld* s, int start, int *act, int nstep);
 
     //============================= mne_source_space.c =============================
@@ -43,12 +43,16 @@
 
 #include <utils/mnemath.h>
 
+#include <algorithm>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QPointer>
 #include <QtConcurrent>
+#include <QThreadPool>
+#include <QVector>
 #include <QDebug>
 
 //=============================================================================================================
@@ -89,6 +93,31 @@ MNEEpochDataList MNEEpochDataList::readEpochs(const FiffRawData& raw,
                                               const QMap<QString,double>& mapReject,
                                               const QStringList& lExcludeChs,
                                               const RowVectorXi& picks)
+{
+    return readEpochs(raw,
+                      events,
+                      tmin,
+                      tmax,
+                      event,
+                      mapReject,
+                      false,
+                      QPair<float,float>(),
+                      lExcludeChs,
+                      picks);
+}
+
+//=============================================================================================================
+
+MNEEpochDataList MNEEpochDataList::readEpochs(const FiffRawData& raw,
+                                              const MatrixXi& events,
+                                              float tmin,
+                                              float tmax,
+                                              qint32 event,
+                                              const QMap<QString,double>& mapReject,
+                                              bool bApplyBaseline,
+                                              const QPair<float,float>& baseline,
+                                              const QStringList& lExcludeChs,
+                                              const RowVectorXi& picks)
 {
     MNEEpochDataList data;
 
@@ -121,51 +150,107 @@ MNEEpochDataList MNEEpochDataList::readEpochs(const FiffRawData& raw,
         }
     }
 
-    fiff_int_t event_samp, from, to;
-    fiff_int_t dropCount = 0;
-    MatrixXd timesDummy;
-    MatrixXd times;
-
-    std::unique_ptr<MNEEpochData> epoch(Q_NULLPTR);
+    // Compute the epoch ranges, limited to the samples present in the file
+    fiff_int_t event_samp;
+    QVector<fiff_int_t> vecFrom(count);
+    QVector<fiff_int_t> vecTo(count);
+    QVector<int> vecOrder(count);
 
     for (p = 0; p < count; ++p) {
-        // Read a data segment
         event_samp = events(selected(p),0);
-        from = event_samp + tmin*raw.info.sfreq;
-        to   = event_samp + floor(tmax*raw.info.sfreq + 0.5);
+        vecFrom[p] = std::max(fiff_int_t(event_samp + tmin*raw.info.sfreq), raw.first_samp);
+        vecTo[p]   = std::min(fiff_int_t(event_samp + floor(tmax*raw.info.sfreq + 0.5)), raw.last_samp);
+        vecOrder[p] = p;
+    }
 
-        epoch.reset(new MNEEpochData());
+    // Sort the epochs by sample so the file is read sequentially once
+    std::stable_sort(vecOrder.begin(), vecOrder.end(), [&vecFrom](int a, int b) {
+        return vecFrom[a] < vecFrom[b];
+    });
 
-        if(raw.read_raw_segment(epoch->epoch, timesDummy, from, to, picksNew)) {
-            if (p == 0) {
-                times.resize(1, to-from+1);
-                for (qint32 i = 0; i < times.cols(); ++i)
-                    times(0, i) = ((float)(from-event_samp+i)) / raw.info.sfreq;
-            }
+    // Group neighboring epochs into blocks which are read with a single call. Gaps longer than one epoch are skipped.
+    fiff_int_t iEpochSamples = floor((tmax - tmin)*raw.info.sfreq + 0.5) + 1;
+    fiff_int_t iMaxBlockSamples = std::max(fiff_int_t(10.0*raw.info.sfreq), 2*iEpochSamples);
 
-            epoch->event = event;
-            epoch->tmin = tmin;
-            epoch->tmax = tmax;
+    QVector<MNEEpochData::SPtr> vecEpochs(count);
+    QList<QFuture<void> > lFutures;
+    QThreadPool threadPool;
+    MatrixXd matBlock;
+    MatrixXd timesDummy;
 
-            epoch->bReject = checkForArtifact(epoch->epoch,
-                                              raw.info,
-                                              mapReject,
-                                              lExcludeChs);
+    int iBlockStart = 0;
+    while (iBlockStart < count) {
+        fiff_int_t blockFrom = vecFrom[vecOrder[iBlockStart]];
+        fiff_int_t blockTo = vecTo[vecOrder[iBlockStart]];
+        int iBlockEnd = iBlockStart + 1;
+
+        while (iBlockEnd < count
+               && vecFrom[vecOrder[iBlockEnd]] <= blockTo + iEpochSamples
+               && vecTo[vecOrder[iBlockEnd]] - blockFrom < iMaxBlockSamples) {
+            blockTo = std::max(blockTo, vecTo[vecOrder[iBlockEnd]]);
+            ++iBlockEnd;
+        }
+
+        if(blockFrom > blockTo || !raw.read_raw_segment(matBlock, timesDummy, blockFrom, blockTo, picksNew)) {
+            qWarning("[MNEEpochDataList::readEpochs] Can't read the event data segments.");
+            iBlockStart = iBlockEnd;
+            continue;
+        }
+
+        // Cut all epochs of this block and check them while the next block is read
+        for (int i = iBlockStart; i < iBlockEnd; ++i) {
+            p = vecOrder[i];
 
-            if (epoch->bReject) {
-                dropCount++;
+            if(vecFrom[p] > vecTo[p]) {
+                qWarning("[MNEEpochDataList::readEpochs] Can't read the event data segments.");
+                continue;
             }
 
-            //Check if data block has the same size as the previous one
-            if(!data.isEmpty()) {
-                if(epoch->epoch.size() == data.last()->epoch.size()) {
-                    data.append(MNEEpochData::SPtr(epoch.release()));//List takes ownwership of the pointer - no delete need
+            MNEEpochData::SPtr pEpoch = MNEEpochData::SPtr(new MNEEpochData());
+            pEpoch->epoch = matBlock.block(0, vecFrom[p] - blockFrom, matBlock.rows(), vecTo[p] - vecFrom[p] + 1);
+            pEpoch->event = event;
+            pEpoch->tmin = tmin;
+            pEpoch->tmax = tmax;
+            vecEpochs[p] = pEpoch;
+
+            lFutures.append(QtConcurrent::run(&threadPool, [pEpoch, &raw, &mapReject, &lExcludeChs, bApplyBaseline, baseline]() {
+                pEpoch->bReject = checkForArtifact(pEpoch->epoch,
+                                                   raw.info,
+                                                   mapReject,
+                                                   lExcludeChs);
+
+                if(bApplyBaseline) {
+                    pEpoch->applyBaselineCorrection(baseline);
                 }
-            } else {
-                data.append(MNEEpochData::SPtr(epoch.release()));//List takes ownwership of the pointer - no delete need
+            }));
+        }
+
+        iBlockStart = iBlockEnd;
+    }
+
+    for (int i = 0; i < lFutures.size(); ++i) {
+        lFutures[i].waitForFinished();
+    }
+
+    // Assemble the epochs in the order of the events
+    fiff_int_t dropCount = 0;
+
+    for (p = 0; p < count; ++p) {
+        if(!vecEpochs[p]) {
+            continue;
+        }
+
+        if (vecEpochs[p]->bReject) {
+            dropCount++;
+        }
+
+        //Check if data block has the same size as the previous one
+        if(!data.isEmpty()) {
+            if(vecEpochs[p]->epoch.size() == data.last()->epoch.size()) {
+                data.append(vecEpochs[p]);
             }
         } else {
-            qWarning("[MNEEpochDataList::readEpochs] Can't read the event data segments.");
+            data.append(vecEpochs[p]);
         }
     }
 
@@ -96,13 +96,16 @@ public:
 
     //=========================================================================================================
     /**
-     * Read the epochs from a raw file based on provided events.
+     * Read the epochs from a raw file based on provided events. The events are sorted by sample and the file is
+     * read sequentially in blocks, so raw buffers shared by neighboring epochs are only read once. The epochs are
+     * returned in the order of the events.
      *
      * @param[in] raw            The raw data.
      * @param[in] events         The events provided in samples and event kind.
      * @param[in] tmin           The start time relative to the event in seconds.
      * @param[in] tmax           The end time relative to the event in seconds.
      * @param[in] event          The event kind.
+     * @param[in] mapReject      The artifact rejection thresholds.
      * @param[in] lExcludeChs    List of channel names to exclude.
      * @param[in] picks          Which channels to pick.
      */
@@ -115,6 +118,33 @@ public:
                                        const QStringList &lExcludeChs = QStringList(),
                                        const Eigen::RowVectorXi& picks = Eigen::RowVectorXi());
 
+    //=========================================================================================================
+    /**
+     * Read the epochs from a raw file based on provided events. Artifact rejection and the optional baseline
+     * correction run in parallel while the next blocks of the file are read.
+     *
+     * @param[in] raw            The raw data.
+     * @param[in] events         The events provided in samples and event kind.
+     * @param[in] tmin           The start time relative to the event in seconds.
+     * @param[in] tmax           The end time relative to the event in seconds.
+     * @param[in] event          The event kind.
+     * @param[in] mapReject      The artifact rejection thresholds.
+     * @param[in] bApplyBaseline Whether to apply the baseline correction. It is applied after the artifact rejection.
+     * @param[in] baseline       The baseline in seconds relative to the event [from to].
+     * @param[in] lExcludeChs    List of channel names to exclude.
+     * @param[in] picks          Which channels to pick.
+     */
+    static MNEEpochDataList readEpochs(const FIFFLIB::FiffRawData& raw,
+                                       const Eigen::MatrixXi& events,
+                                       float tmin,
+                                       float tmax,
+                                       qint32 event,
+                                       const QMap<QString,double>& mapReject,
+                                       bool bApplyBaseline,
+                                       const QPair<float,float>& baseline,
+                                       const QStringList &lExcludeChs = QStringList(),
+                                       const Eigen::RowVectorXi& picks = Eigen::RowVectorXi());
+
     //=========================================================================================================
     /**
      * Averages epoch list. Note that no baseline correction performed.
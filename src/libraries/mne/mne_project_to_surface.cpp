@@ -80,6 +80,7 @@ MNEProjectToSurface::MNEProjectToSurface()
 , b(VectorXf::Zero(1))
 , c(VectorXf::Zero(1))
 , det(VectorXf::Zero(1))
+, bvhBoundScale(1.0f)
 {
 }
 
@@ -94,6 +95,7 @@ MNEProjectToSurface::MNEProjectToSurface(const MNEBemSurface &p_MNEBemSurf)
 , b(VectorXf::Zero(p_MNEBemSurf.ntri))
 , c(VectorXf::Zero(p_MNEBemSurf.ntri))
 , det(VectorXf::Zero(p_MNEBemSurf.ntri))
+, bvhBoundScale(1.0f)
 {
     for (int i = 0; i < p_MNEBemSurf.ntri; ++i)
     {
@@ -117,6 +119,7 @@ MNEProjectToSurface::MNEProjectToSurface(const MNEBemSurface &p_MNEBemSurf)
         }
     }
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+    buildBvh();
 }
 
 //=============================================================================================================
@@ -130,6 +133,7 @@ MNEProjectToSurface::MNEProjectToSurface(const MNESurface &p_MNESurf)
 , b(VectorXf::Zero(p_MNESurf.ntri))
 , c(VectorXf::Zero(p_MNESurf.ntri))
 , det(VectorXf::Zero(p_MNESurf.ntri))
+, bvhBoundScale(1.0f)
 {
     for (int i = 0; i < p_MNESurf.ntri; ++i)
     {
@@ -143,6 +147,7 @@ MNEProjectToSurface::MNEProjectToSurface(const MNESurface &p_MNESurf)
     }
 
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+    buildBvh();
 }
 
 //=============================================================================================================
@@ -188,20 +193,48 @@ bool MNEProjectToSurface::mne_project_to_surface(const Vector3f &r, Vector3f &rT
     float p = 0, q = 0, p0 = 0, q0 = 0, dist0 = 0;
     bestDist = 0.0f;
     bestTri = -1;
-    for (int tri = 0; tri < a .size(); ++tri)
+    if (bvh.ntri() == a.size())
     {
-        if (!this->nearest_triangle_point(r, tri, p0, q0, dist0))
+        // nearest_triangle_point never underestimates the Euclidean distance by more than bvhBoundScale,
+        // so the hierarchy skips only triangles that could not win the full search either
+        bool bOk = true;
+        bestTri = bvh.findNearest(r,
+                                  [this, &r, &bOk](int tri, float& dist) {
+                                      float pTri, qTri;
+                                      if (!this->nearest_triangle_point(r, tri, pTri, qTri, dist)) {
+                                          bOk = false;
+                                      }
+                                      return bOk;
+                                  },
+                                  bvhBoundScale,
+                                  bestDist);
+        if (!bOk)
         {
-            qDebug() << "The projection on triangle " << tri << " didn't work./n";
+            qDebug() << "The projection on a triangle didn't work./n";
             return false;
         }
-
-        if ((bestTri < 0) || (std::fabs(dist0) < std::fabs(bestDist)))
+        if (bestTri >= 0)
         {
-            bestDist = dist0;
-            p = p0;
-            q = q0;
-            bestTri = tri;
+            this->nearest_triangle_point(r, bestTri, p, q, bestDist);
+        }
+    }
+    else
+    {
+        for (int tri = 0; tri < a .size(); ++tri)
+        {
+            if (!this->nearest_triangle_point(r, tri, p0, q0, dist0))
+            {
+                qDebug() << "The projection on triangle " << tri << " didn't work./n";
+                return false;
+            }
+
+            if ((bestTri < 0) || (std::fabs(dist0) < std::fabs(bestDist)))
+            {
+                bestDist = dist0;
+                p = p0;
+                q = q0;
+                bestTri = tri;
+            }
         }
     }
 
@@ -221,6 +254,20 @@ bool MNEProjectToSurface::mne_project_to_surface(const Vector3f &r, Vector3f &rT
 
 //=============================================================================================================
 
+void MNEProjectToSurface::buildBvh()
+{
+    bvh = MNESurfaceBvh(r1, r1 + r12, r1 + r13);
+
+    // Inside the triangle the distance is nn*(r-r1), i.e. scaled by the length of the normal
+    bvhBoundScale = 1.0f;
+    if (nn.rows() > 0)
+    {
+        bvhBoundScale = std::min(1.0f, nn.rowwise().norm().minCoeff());
+    }
+}
+
+//=============================================================================================================
+
 bool MNEProjectToSurface::nearest_triangle_point(const Vector3f &r, const int tri, float &p, float &q, float &dist)
 {
     //Calculate some helpers
@@ -41,6 +41,7 @@
 //=============================================================================================================
 
 #include "mne_global.h"
+#include "mne_surface_bvh.h"
 
 //=============================================================================================================
 // QT INCLUDES
@@ -175,6 +176,12 @@ private:
      */
     bool project_to_triangle(Eigen::Vector3f &rTri, const float p, const float q, const int tri);
 
+    //=========================================================================================================
+    /**
+     * Builds the triangle hierarchy from the triangle data and the pruning bound for nearest_triangle_point.
+     */
+    void buildBvh();
+
     Eigen::MatrixX3f r1;         /**< Cartesian Vector to the first triangel corner. */
     Eigen::MatrixX3f r12;        /**< Cartesian Vector from the first to the second triangel corner. */
     Eigen::MatrixX3f r13;        /**< Cartesian Vector from the first to the third triangel corner. */
@@ -183,6 +190,8 @@ private:
     Eigen::VectorXf b;           /**< r13*r13. */
     Eigen::VectorXf c;           /**< r12*r13. */
     Eigen::VectorXf det;         /**< Determinant of the Matrix [a c, c b]. */
+    MNESurfaceBvh bvh;           /**< Bounding volume hierarchy over the triangles. */
+    float bvhBoundScale;         /**< Lower bound of nearest_triangle_point distances relative to Euclidean ones. */
 };
 
 //=============================================================================================================
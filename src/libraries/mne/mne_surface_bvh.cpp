@@ -0,0 +1,407 @@
+//=============================================================================================================
+/**
+ * @file     mne_surface_bvh.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    MNESurfaceBvh class definition.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_surface_bvh.h"
+#include "mne_bem_surface.h"
+
+#include <limits>
+#include <numeric>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Geometry>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+#define BVH_LEAF_SIZE   4       /* Maximum number of triangles in a leaf */
+#define BVH_RAY_EPS     1e-6    /* Tolerance of the ray cast in meters and in barycentric coordinates */
+
+namespace {
+
+//=============================================================================================================
+/**
+ * Closest point on a triangle, see Ericson, Real-Time Collision Detection, 5.1.5.
+ */
+Vector3f closestPointOnTriangle(const Vector3f& p,
+                                const Vector3f& a,
+                                const Vector3f& b,
+                                const Vector3f& c)
+{
+    Vector3f ab = b - a;
+    Vector3f ac = c - a;
+    Vector3f ap = p - a;
+    float d1 = ab.dot(ap);
+    float d2 = ac.dot(ap);
+    if(d1 <= 0.0f && d2 <= 0.0f) {
+        return a;
+    }
+
+    Vector3f bp = p - b;
+    float d3 = ab.dot(bp);
+    float d4 = ac.dot(bp);
+    if(d3 >= 0.0f && d4 <= d3) {
+        return b;
+    }
+
+    float vc = d1*d4 - d3*d2;
+    if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return a + d1 / (d1 - d3) * ab;
+    }
+
+    Vector3f cp = p - c;
+    float d5 = ab.dot(cp);
+    float d6 = ac.dot(cp);
+    if(d6 >= 0.0f && d5 <= d6) {
+        return c;
+    }
+
+    float vb = d5*d2 - d1*d6;
+    if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return a + d2 / (d2 - d6) * ac;
+    }
+
+    float va = d3*d6 - d5*d4;
+    if(va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+    }
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+//=============================================================================================================
+/**
+ * Slab test of a ray against a box, slightly enlarged by BVH_RAY_EPS.
+ */
+bool rayHitsBox(const Vector3d& origin,
+                const Vector3d& invDir,
+                const AlignedBox3f& box)
+{
+    double tMin = -BVH_RAY_EPS;
+    double tMax = std::numeric_limits<double>::max();
+
+    for(int c = 0; c < 3; ++c) {
+        double t1 = (box.min()(c) - BVH_RAY_EPS - origin(c)) * invDir(c);
+        double t2 = (box.max()(c) + BVH_RAY_EPS - origin(c)) * invDir(c);
+        if(t1 > t2) {
+            std::swap(t1, t2);
+        }
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if(tMin > tMax) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MNESurfaceBvh::MNESurfaceBvh()
+{
+}
+
+//=============================================================================================================
+
+MNESurfaceBvh::MNESurfaceBvh(const MatrixX3f& matR1,
+                             const MatrixX3f& matR2,
+                             const MatrixX3f& matR3)
+: m_matR1(matR1)
+, m_matR2(matR2)
+, m_matR3(matR3)
+{
+    build();
+}
+
+//=============================================================================================================
+
+MNESurfaceBvh::MNESurfaceBvh(const MNEBemSurface& p_MNEBemSurf)
+: m_matR1(p_MNEBemSurf.ntri, 3)
+, m_matR2(p_MNEBemSurf.ntri, 3)
+, m_matR3(p_MNEBemSurf.ntri, 3)
+{
+    for(int i = 0; i < p_MNEBemSurf.ntri; ++i) {
+        m_matR1.row(i) = p_MNEBemSurf.rr.row(p_MNEBemSurf.tris(i,0));
+        m_matR2.row(i) = p_MNEBemSurf.rr.row(p_MNEBemSurf.tris(i,1));
+        m_matR3.row(i) = p_MNEBemSurf.rr.row(p_MNEBemSurf.tris(i,2));
+    }
+
+    build();
+}
+
+//=============================================================================================================
+
+int MNESurfaceBvh::findNearestPoint(const Vector3f& r,
+                                    Vector3f& rNearest,
+                                    float& fDist) const
+{
+    int iTri = findNearest(r,
+                           [this, &r](int tri, float& dist) {
+                               dist = (closestPointOnTriangle(r,
+                                                              m_matR1.row(tri).transpose(),
+                                                              m_matR2.row(tri).transpose(),
+                                                              m_matR3.row(tri).transpose()) - r).norm();
+                               return true;
+                           },
+                           1.0f,
+                           fDist);
+
+    if(iTri >= 0) {
+        rNearest = closestPointOnTriangle(r,
+                                          m_matR1.row(iTri).transpose(),
+                                          m_matR2.row(iTri).transpose(),
+                                          m_matR3.row(iTri).transpose());
+    }
+
+    return iTri;
+}
+
+//=============================================================================================================
+
+int MNESurfaceBvh::rayCast(const Vector3f& origin,
+                           const Vector3f& dir,
+                           float& fT) const
+{
+    QVector<RayHit> lHits;
+    intersectRay(origin.cast<double>(), dir.cast<double>(), lHits);
+
+    int iBestTri = -1;
+    double dBestT = 0.0;
+
+    for(int i = 0; i < lHits.size(); ++i) {
+        if(lHits[i].dT >= 0.0 && lHits[i].dMinBary >= 0.0 && (iBestTri < 0 || lHits[i].dT < dBestT)) {
+            iBestTri = lHits[i].iTri;
+            dBestT = lHits[i].dT;
+        }
+    }
+
+    fT = dBestT;
+    return iBestTri;
+}
+
+//=============================================================================================================
+
+int MNESurfaceBvh::windingNumber(const Vector3f& r,
+                                 bool& bReliable) const
+{
+    // A direction which is unlikely to be aligned with the triangulation
+    Vector3d dir(0.2852, 0.5611, 0.7771);
+    dir.normalize();
+
+    QVector<RayHit> lHits;
+    intersectRay(r.cast<double>(), dir, lHits);
+
+    int iWinding = 0;
+    bReliable = !m_vecNodes.isEmpty();
+
+    for(int i = 0; i < lHits.size(); ++i) {
+        if(std::fabs(lHits[i].dT) <= BVH_RAY_EPS
+           || lHits[i].dMinBary < BVH_RAY_EPS
+           || std::fabs(lHits[i].dCosine) < BVH_RAY_EPS) {
+            bReliable = false;
+        } else if(lHits[i].dT > 0.0) {
+            iWinding += lHits[i].dCosine > 0.0 ? 1 : -1;
+        }
+    }
+
+    return iWinding;
+}
+
+//=============================================================================================================
+
+void MNESurfaceBvh::build()
+{
+    struct BuildItem {
+        int iNode;
+        int iStart;
+        int iEnd;
+    };
+
+    int ntri = m_matR1.rows();
+
+    m_vecNodes.clear();
+    m_vecTriIdx.resize(ntri);
+    std::iota(m_vecTriIdx.begin(), m_vecTriIdx.end(), 0);
+
+    if(ntri == 0) {
+        return;
+    }
+
+    MatrixX3f matCent = (m_matR1 + m_matR2 + m_matR3) / 3.0f;
+
+    m_vecNodes.reserve(2 * (ntri / BVH_LEAF_SIZE + 1));
+    m_vecNodes.append(Node());
+
+    QVector<BuildItem> lWork;
+    lWork.append({0, 0, ntri});
+
+    while(!lWork.isEmpty()) {
+        BuildItem item = lWork.takeLast();
+
+        AlignedBox3f box;
+        AlignedBox3f centBox;
+        for(int k = item.iStart; k < item.iEnd; ++k) {
+            int iTri = m_vecTriIdx[k];
+            box.extend(m_matR1.row(iTri).transpose());
+            box.extend(m_matR2.row(iTri).transpose());
+            box.extend(m_matR3.row(iTri).transpose());
+            centBox.extend(matCent.row(iTri).transpose());
+        }
+
+        int iCount = item.iEnd - item.iStart;
+        Vector3f vecExtent = centBox.sizes();
+        int iAxis;
+        vecExtent.maxCoeff(&iAxis);
+
+        m_vecNodes[item.iNode].box = box;
+
+        if(iCount <= BVH_LEAF_SIZE || vecExtent(iAxis) <= 0.0f) {
+            m_vecNodes[item.iNode].iFirst = item.iStart;
+            m_vecNodes[item.iNode].iCount = iCount;
+            continue;
+        }
+
+        // Split at the median centroid along the longest axis
+        int iMid = item.iStart + iCount / 2;
+        std::nth_element(m_vecTriIdx.begin() + item.iStart,
+                         m_vecTriIdx.begin() + iMid,
+                         m_vecTriIdx.begin() + item.iEnd,
+                         [&matCent, iAxis](int a, int b) {
+                             return matCent(a, iAxis) < matCent(b, iAxis);
+                         });
+
+        int iChild = m_vecNodes.size();
+        m_vecNodes.append(Node());
+        m_vecNodes.append(Node());
+        m_vecNodes[item.iNode].iFirst = iChild;
+        m_vecNodes[item.iNode].iCount = 0;
+
+        lWork.append({iChild, item.iStart, iMid});
+        lWork.append({iChild + 1, iMid, item.iEnd});
+    }
+}
+
+//=============================================================================================================
+
+void MNESurfaceBvh::intersectRay(const Vector3d& origin,
+                                 const Vector3d& dir,
+                                 QVector<RayHit>& lHits) const
+{
+    lHits.clear();
+
+    if(m_vecNodes.isEmpty()) {
+        return;
+    }
+
+    Vector3d invDir = dir.cwiseInverse();
+    double dDirNorm = dir.norm();
+
+    int vecStack[64];
+    int iStack = 0;
+    vecStack[iStack++] = 0;
+
+    while(iStack > 0) {
+        const Node& node = m_vecNodes[vecStack[--iStack]];
+
+        if(!rayHitsBox(origin, invDir, node.box)) {
+            continue;
+        }
+
+        if(node.iCount == 0) {
+            vecStack[iStack++] = node.iFirst;
+            vecStack[iStack++] = node.iFirst + 1;
+            continue;
+        }
+
+        // Moeller-Trumbore, keeping near misses so that the caller can detect degenerate rays
+        for(int k = node.iFirst; k < node.iFirst + node.iCount; ++k) {
+            int iTri = m_vecTriIdx[k];
+            Vector3d v0 = m_matR1.row(iTri).transpose().cast<double>();
+            Vector3d e1 = m_matR2.row(iTri).transpose().cast<double>() - v0;
+            Vector3d e2 = m_matR3.row(iTri).transpose().cast<double>() - v0;
+
+            Vector3d pvec = dir.cross(e2);
+            double det = e1.dot(pvec);
+            if(det == 0.0) {
+                continue;
+            }
+
+            double invDet = 1.0 / det;
+            Vector3d tvec = origin - v0;
+            double u = tvec.dot(pvec) * invDet;
+            if(u < -BVH_RAY_EPS || u > 1.0 + BVH_RAY_EPS) {
+                continue;
+            }
+
+            Vector3d qvec = tvec.cross(e1);
+            double v = dir.dot(qvec) * invDet;
+            if(v < -BVH_RAY_EPS || u + v > 1.0 + BVH_RAY_EPS) {
+                continue;
+            }
+
+            double t = e2.dot(qvec) * invDet;
+            if(t * dDirNorm < -BVH_RAY_EPS) {
+                continue;
+            }
+
+            Vector3d normal = e1.cross(e2);
+            RayHit hit;
+            hit.iTri = iTri;
+            hit.dT = t * dDirNorm;
+            hit.dMinBary = std::min(std::min(u, v), 1.0 - u - v);
+            hit.dCosine = normal.dot(dir) / (normal.norm() * dDirNorm);
+            lHits.append(hit);
+        }
+    }
+}
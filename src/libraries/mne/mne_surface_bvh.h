@@ -0,0 +1,299 @@
+//=============================================================================================================
+/**
+ * @file     mne_surface_bvh.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    MNESurfaceBvh class declaration.
+ *
+ */
+
+#ifndef MNELIB_MNESURFACEBVH_H
+#define MNELIB_MNESURFACEBVH_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_global.h"
+
+#include <algorithm>
+#include <cmath>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+//=============================================================================================================
+// DEFINE NAMESPACE MNELIB
+//=============================================================================================================
+
+namespace MNELIB {
+
+//=============================================================================================================
+// MNELIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+class MNEBemSurface;
+
+//=============================================================================================================
+/**
+ * Bounding volume hierarchy over the triangles of a surface. It answers nearest triangle, ray cast and
+ * inside/outside (winding number) queries in logarithmic instead of linear time.
+ *
+ * @brief Bounding volume hierarchy over surface triangles.
+ */
+class MNESHARED_EXPORT MNESurfaceBvh
+{
+
+public:
+    typedef QSharedPointer<MNESurfaceBvh> SPtr;            /**< Shared pointer type for MNESurfaceBvh. */
+    typedef QSharedPointer<const MNESurfaceBvh> ConstSPtr; /**< Const shared pointer type for MNESurfaceBvh. */
+
+    //=========================================================================================================
+    /**
+     * Constructs an empty hierarchy.
+     */
+    MNESurfaceBvh();
+
+    //=========================================================================================================
+    /**
+     * Constructs the hierarchy from the triangle corners.
+     *
+     * @param[in] matR1   The first corner of each triangle (ntri x 3).
+     * @param[in] matR2   The second corner of each triangle (ntri x 3).
+     * @param[in] matR3   The third corner of each triangle (ntri x 3).
+     */
+    MNESurfaceBvh(const Eigen::MatrixX3f& matR1,
+                  const Eigen::MatrixX3f& matR2,
+                  const Eigen::MatrixX3f& matR3);
+
+    //=========================================================================================================
+    /**
+     * Constructs the hierarchy from a BEM surface.
+     *
+     * @param[in] p_MNEBemSurf   The BEM surface.
+     */
+    explicit MNESurfaceBvh(const MNELIB::MNEBemSurface& p_MNEBemSurf);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of triangles.
+     *
+     * @return The number of triangles.
+     */
+    inline int ntri() const;
+
+    //=========================================================================================================
+    /**
+     * Finds the triangle which minimizes a user supplied distance. The user distance must not be smaller than
+     * fBoundScale times the Euclidean distance between the point and the triangle, otherwise triangles might be
+     * skipped. Ties are resolved in favour of the lower triangle index, which gives the same result as a linear
+     * search over all triangles.
+     *
+     * @param[in] r             The point.
+     * @param[in] distFunc      Callable bool(int tri, float& dist) which computes the distance to a triangle. Return false to ignore the triangle.
+     * @param[in] fBoundScale   Factor by which the user distance is at least as large as the Euclidean distance.
+     * @param[out] fBestDist    The user distance to the best triangle.
+     *
+     * @return The index of the best triangle, -1 if none was found.
+     */
+    template<typename DistFunc>
+    int findNearest(const Eigen::Vector3f& r,
+                    DistFunc distFunc,
+                    float fBoundScale,
+                    float& fBestDist) const;
+
+    //=========================================================================================================
+    /**
+     * Finds the closest point on the surface.
+     *
+     * @param[in] r             The point.
+     * @param[out] rNearest     The closest point on the surface.
+     * @param[out] fDist        The distance to the closest point.
+     *
+     * @return The index of the closest triangle, -1 if the surface is empty.
+     */
+    int findNearestPoint(const Eigen::Vector3f& r,
+                         Eigen::Vector3f& rNearest,
+                         float& fDist) const;
+
+    //=========================================================================================================
+    /**
+     * Finds the first triangle hit by a ray.
+     *
+     * @param[in] origin    The origin of the ray.
+     * @param[in] dir       The direction of the ray.
+     * @param[out] fT       The distance from the origin to the hit.
+     *
+     * @return The index of the hit triangle, -1 if the ray misses the surface.
+     */
+    int rayCast(const Eigen::Vector3f& origin,
+                const Eigen::Vector3f& dir,
+                float& fT) const;
+
+    //=========================================================================================================
+    /**
+     * Computes the winding number of a closed surface around a point by counting the oriented crossings of a
+     * ray. For an outward oriented surface it is 1 inside and 0 outside, which corresponds to the sum of the
+     * solid angles divided by 4 pi. If the ray passes too close to a triangle edge or the point lies on the
+     * surface, the result is not reliable and an exact solid angle sum should be used instead.
+     *
+     * @param[in] r             The point.
+     * @param[out] bReliable    Whether the result is reliable.
+     *
+     * @return The winding number.
+     */
+    int windingNumber(const Eigen::Vector3f& r,
+                      bool& bReliable) const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Node of the hierarchy. Leaves have iCount > 0 and hold the triangles m_vecTriIdx[iFirst ... iFirst+iCount-1].
+     * Inner nodes have their children at iFirst and iFirst+1.
+     */
+    struct Node {
+        Eigen::AlignedBox3f box;
+        int iFirst;
+        int iCount;
+    };
+
+    //=========================================================================================================
+    /**
+     * A ray/triangle intersection.
+     */
+    struct RayHit {
+        int iTri;
+        double dT;
+        double dMinBary;
+        double dCosine;
+    };
+
+    //=========================================================================================================
+    /**
+     * Builds the hierarchy from m_matR1, m_matR2 and m_matR3.
+     */
+    void build();
+
+    //=========================================================================================================
+    /**
+     * Collects all intersections of a ray with the triangles, including the ones slightly behind the origin.
+     *
+     * @param[in] origin    The origin of the ray.
+     * @param[in] dir       The direction of the ray.
+     * @param[out] lHits    The intersections.
+     */
+    void intersectRay(const Eigen::Vector3d& origin,
+                      const Eigen::Vector3d& dir,
+                      QVector<RayHit>& lHits) const;
+
+    Eigen::MatrixX3f    m_matR1;        /**< The first corner of each triangle. */
+    Eigen::MatrixX3f    m_matR2;        /**< The second corner of each triangle. */
+    Eigen::MatrixX3f    m_matR3;        /**< The third corner of each triangle. */
+    QVector<Node>       m_vecNodes;     /**< The nodes, the root is the first one. */
+    QVector<int>        m_vecTriIdx;    /**< The triangle indices ordered by leaf. */
+};
+
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int MNESurfaceBvh::ntri() const
+{
+    return m_matR1.rows();
+}
+
+//=============================================================================================================
+
+template<typename DistFunc>
+int MNESurfaceBvh::findNearest(const Eigen::Vector3f& r,
+                               DistFunc distFunc,
+                               float fBoundScale,
+                               float& fBestDist) const
+{
+    int iBestTri = -1;
+    float fBestAbs = 0.0f;
+    float fDist;
+    fBestDist = 0.0f;
+
+    if(m_vecNodes.isEmpty()) {
+        return iBestTri;
+    }
+
+    int vecStack[64];
+    int iStack = 0;
+    vecStack[iStack++] = 0;
+
+    while(iStack > 0) {
+        const Node& node = m_vecNodes[vecStack[--iStack]];
+
+        if(iBestTri >= 0 && fBoundScale * std::sqrt(node.box.squaredExteriorDistance(r)) > fBestAbs) {
+            continue;
+        }
+
+        if(node.iCount > 0) {
+            for(int k = node.iFirst; k < node.iFirst + node.iCount; ++k) {
+                int iTri = m_vecTriIdx[k];
+                if(!distFunc(iTri, fDist)) {
+                    continue;
+                }
+                if(iBestTri < 0
+                   || std::fabs(fDist) < fBestAbs
+                   || (std::fabs(fDist) == fBestAbs && iTri < iBestTri)) {
+                    iBestTri = iTri;
+                    fBestDist = fDist;
+                    fBestAbs = std::fabs(fDist);
+                }
+            }
+        } else {
+            // Visit the closer child first
+            int iNear = node.iFirst;
+            int iFar = node.iFirst + 1;
+            if(m_vecNodes[iFar].box.squaredExteriorDistance(r) < m_vecNodes[iNear].box.squaredExteriorDistance(r)) {
+                std::swap(iNear, iFar);
+            }
+            vecStack[iStack++] = iFar;
+            vecStack[iStack++] = iNear;
+        }
+    }
+
+    return iBestTri;
+}
+} // namespace MNELIB
+
+#endif // MNELIB_MNESURFACEBVH_H
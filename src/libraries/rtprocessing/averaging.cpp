@@ -82,14 +82,11 @@ FiffEvoked RTPROCESSINGLIB::computeAverage(const FiffRawData& raw,
                                                                      fTMaxS,
                                                                      eventType,
                                                                      mapReject,
+                                                                     bApplyBaseline,
+                                                                     QPair<float, float>(fTBaselineFromS, fTBaselineToS),
                                                                      lExcludeChs,
                                                                      picks);
 
-    if(bApplyBaseline){
-        QPair<float, float> baselinePair(fTBaselineFromS, fTBaselineToS);
-        lstEpochDataList.applyBaselineCorrection(baselinePair);
-    }
-
     if(!mapReject.isEmpty()){
         lstEpochDataList.dropRejected();
     }
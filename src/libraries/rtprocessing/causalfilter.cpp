@@ -0,0 +1,473 @@
+//=============================================================================================================
+/**
+ * @file     causalfilter.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    CausalFilter definitions.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "causalfilter.h"
+
+#include "helpers/filterfftengine.h"
+
+#include <algorithm>
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC METHODS
+//=============================================================================================================
+
+/**
+ * Creates second order (or first order for odd orders) Butterworth sections via the bilinear transform.
+ */
+static void appendButterworthSections(QVector<BiquadSection>& vecSections,
+                                      bool bHighpass,
+                                      int iOrder,
+                                      double dCutoff,
+                                      double dSFreq)
+{
+    const double dOmega = 2.0 * M_PI * dCutoff / dSFreq;
+    const double dCos = std::cos(dOmega);
+    const double dSin = std::sin(dOmega);
+
+    // Pole pairs of the analog prototype
+    for(int k = 0; k < iOrder/2; ++k) {
+        const double dTheta = (iOrder % 2 == 0) ? M_PI * (2.0 * k + 1.0) / (2.0 * iOrder)
+                                                : M_PI * (k + 1.0) / iOrder;
+        const double dQ = 1.0 / (2.0 * std::cos(dTheta));
+        const double dAlpha = dSin / (2.0 * dQ);
+        const double a0 = 1.0 + dAlpha;
+
+        BiquadSection section;
+        if(bHighpass) {
+            section.b0 = (1.0 + dCos) / 2.0 / a0;
+            section.b1 = -(1.0 + dCos) / a0;
+            section.b2 = (1.0 + dCos) / 2.0 / a0;
+        } else {
+            section.b0 = (1.0 - dCos) / 2.0 / a0;
+            section.b1 = (1.0 - dCos) / a0;
+            section.b2 = (1.0 - dCos) / 2.0 / a0;
+        }
+        section.a1 = -2.0 * dCos / a0;
+        section.a2 = (1.0 - dAlpha) / a0;
+        vecSections.append(section);
+    }
+
+    // Real pole for odd orders
+    if(iOrder % 2 == 1) {
+        const double dK = std::tan(dOmega / 2.0);
+
+        BiquadSection section;
+        if(bHighpass) {
+            section.b0 = 1.0 / (1.0 + dK);
+            section.b1 = -1.0 / (1.0 + dK);
+        } else {
+            section.b0 = dK / (1.0 + dK);
+            section.b1 = dK / (1.0 + dK);
+        }
+        section.b2 = 0.0;
+        section.a1 = (dK - 1.0) / (dK + 1.0);
+        section.a2 = 0.0;
+        vecSections.append(section);
+    }
+}
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+CausalFilter::CausalFilter()
+: m_mode(IirBiquad)
+, m_dSFreq(1000.0)
+, m_iPartitionSize(0)
+, m_iNumPartitions(0)
+, m_iBufferLatency(-1)
+, m_iNumChannels(0)
+{
+}
+
+//=============================================================================================================
+
+void CausalFilter::designButterworth(int iFilterType,
+                                     int iOrder,
+                                     double dCenterfreq,
+                                     double dBandwidth,
+                                     double dSFreq)
+{
+    QVector<BiquadSection> vecSections;
+    const double dNyquist = dSFreq / 2.0;
+
+    if(iOrder < 1) {
+        qWarning() << "[CausalFilter::designButterworth] Order must be at least 1. Setting order to 1.";
+        iOrder = 1;
+    }
+
+    switch(iFilterType) {
+        case 0:
+        case 1:
+            if(dCenterfreq <= 0.0 || dCenterfreq >= dNyquist) {
+                qWarning() << "[CausalFilter::designButterworth] Cut off frequency must be between 0 and nyquist. Returning.";
+                return;
+            }
+            appendButterworthSections(vecSections, iFilterType == 1, iOrder, dCenterfreq, dSFreq);
+            break;
+
+        case 2: {
+            const double dLow = dCenterfreq - dBandwidth / 2.0;
+            const double dHigh = dCenterfreq + dBandwidth / 2.0;
+            if(dLow > 0.0) {
+                appendButterworthSections(vecSections, true, iOrder, dLow, dSFreq);
+            }
+            if(dHigh < dNyquist) {
+                appendButterworthSections(vecSections, false, iOrder, dHigh, dSFreq);
+            }
+            break;
+        }
+
+        case 3: {
+            if(dCenterfreq <= 0.0 || dCenterfreq >= dNyquist || dBandwidth <= 0.0) {
+                qWarning() << "[CausalFilter::designButterworth] Invalid notch parameters. Returning.";
+                return;
+            }
+            const double dOmega = 2.0 * M_PI * dCenterfreq / dSFreq;
+            const double dAlpha = std::sin(dOmega) / (2.0 * dCenterfreq / dBandwidth);
+            const double a0 = 1.0 + dAlpha;
+
+            BiquadSection section;
+            section.b0 = 1.0 / a0;
+            section.b1 = -2.0 * std::cos(dOmega) / a0;
+            section.b2 = 1.0 / a0;
+            section.a1 = -2.0 * std::cos(dOmega) / a0;
+            section.a2 = (1.0 - dAlpha) / a0;
+
+            for(int i = 0; i < (iOrder + 1) / 2; ++i) {
+                vecSections.append(section);
+            }
+            break;
+        }
+
+        default:
+            qWarning() << "[CausalFilter::designButterworth] Unknown filter type" << iFilterType << ". Returning.";
+            return;
+    }
+
+    m_dSFreq = dSFreq;
+    setSections(vecSections);
+}
+
+//=============================================================================================================
+
+void CausalFilter::setSections(const QVector<BiquadSection>& vecSections)
+{
+    m_mode = IirBiquad;
+    m_vecSections = vecSections;
+    reset();
+}
+
+//=============================================================================================================
+
+void CausalFilter::setFirKernel(const FilterKernel& filterKernel,
+                                int iPartitionSize)
+{
+    m_mode = PartitionedFir;
+    m_dSFreq = filterKernel.getSamplingFrequency();
+    m_vecFirCoeff = filterKernel.getCoefficients();
+    m_iPartitionSize = std::max(1, iPartitionSize);
+    m_iNumPartitions = (m_vecFirCoeff.cols() + m_iPartitionSize - 1) / m_iPartitionSize;
+
+    // Transform each kernel partition zero padded to twice the partition size
+    const int iFftLength = 2 * m_iPartitionSize;
+    FilterFftWorkspace& workspace = FilterFftEngine::threadWorkspace();
+
+    m_matKernelSpectra.resize(m_iPartitionSize + 1, m_iNumPartitions);
+    for(int p = 0; p < m_iNumPartitions; ++p) {
+        const int iTaps = std::min(m_iPartitionSize, int(m_vecFirCoeff.cols()) - p * m_iPartitionSize);
+        workspace.vecTime.setZero(iFftLength);
+        workspace.vecTime.head(iTaps) = m_vecFirCoeff.segment(p * m_iPartitionSize, iTaps).transpose();
+        workspace.fft.fwd(m_matKernelSpectra.col(p).data(), workspace.vecTime.data(), iFftLength);
+    }
+
+    reset();
+}
+
+//=============================================================================================================
+
+void CausalFilter::reset()
+{
+    m_iNumChannels = 0;
+    m_iBufferLatency = -1;
+    m_matIirState.resize(0,0);
+    m_vecDelayLines.clear();
+    m_matLastInput.resize(0,0);
+    m_vecDelayLinePos.resize(0);
+    m_matPendingInput.resize(0,0);
+    m_matPendingOutput.resize(0,0);
+}
+
+//=============================================================================================================
+
+CausalFilter::FilterMode CausalFilter::getMode() const
+{
+    return m_mode;
+}
+
+//=============================================================================================================
+
+int CausalFilter::getBufferLatency() const
+{
+    if(m_mode == IirBiquad) {
+        return 0;
+    }
+
+    // Worst case until the first block fixed the latency
+    return m_iBufferLatency < 0 ? std::max(0, m_iPartitionSize - 1) : m_iBufferLatency;
+}
+
+//=============================================================================================================
+
+double CausalFilter::getGroupDelay(double dFreq) const
+{
+    const double dOmega = 2.0 * M_PI * dFreq / m_dSFreq;
+    const double dDelta = 1e-4;
+
+    // Numerical derivative of the phase. The ratio avoids phase wrapping.
+    std::complex<double> ratio = frequencyResponse(dOmega + dDelta) / frequencyResponse(dOmega - dDelta);
+
+    return -std::arg(ratio) / (2.0 * dDelta);
+}
+
+//=============================================================================================================
+
+double CausalFilter::getLatency(double dFreq) const
+{
+    return (getBufferLatency() + getGroupDelay(dFreq)) / m_dSFreq;
+}
+
+//=============================================================================================================
+
+std::complex<double> CausalFilter::frequencyResponse(double dOmega) const
+{
+    const std::complex<double> z1 = std::polar(1.0, -dOmega);
+    const std::complex<double> z2 = z1 * z1;
+
+    std::complex<double> response(1.0, 0.0);
+
+    if(m_mode == IirBiquad) {
+        for(int s = 0; s < m_vecSections.size(); ++s) {
+            const BiquadSection& section = m_vecSections.at(s);
+            response *= (section.b0 + section.b1 * z1 + section.b2 * z2) / (1.0 + section.a1 * z1 + section.a2 * z2);
+        }
+    } else {
+        response = std::complex<double>(0.0, 0.0);
+        for(int n = 0; n < m_vecFirCoeff.cols(); ++n) {
+            response += m_vecFirCoeff[n] * std::polar(1.0, -dOmega * n);
+        }
+    }
+
+    return response;
+}
+
+//=============================================================================================================
+
+void CausalFilter::initState(int iNumChannels)
+{
+    reset();
+
+    m_iNumChannels = iNumChannels;
+
+    if(m_mode == IirBiquad) {
+        m_matIirState = MatrixXd::Zero(iNumChannels, 2 * m_vecSections.size());
+    } else {
+        // The delay lines are allocated on first use, so that channels which are not picked do not cost memory
+        m_vecDelayLines.resize(iNumChannels);
+        m_matLastInput = MatrixXd::Zero(iNumChannels, m_iPartitionSize);
+        m_vecDelayLinePos = VectorXi::Zero(iNumChannels);
+        m_matPendingInput.resize(iNumChannels, 0);
+        m_vecAccumulator.resize(m_iPartitionSize + 1);
+    }
+}
+
+//=============================================================================================================
+
+void CausalFilter::filterIir(int iRow,
+                             RowVectorXd& vecData)
+{
+    double* pState = m_matIirState.row(iRow).data();
+    const int iStride = m_matIirState.rows();
+
+    for(int s = 0; s < m_vecSections.size(); ++s) {
+        const BiquadSection& section = m_vecSections.at(s);
+        double z1 = pState[(2 * s) * iStride];
+        double z2 = pState[(2 * s + 1) * iStride];
+
+        for(int i = 0; i < vecData.cols(); ++i) {
+            const double x = vecData[i];
+            const double y = section.b0 * x + z1;
+            z1 = section.b1 * x - section.a1 * y + z2;
+            z2 = section.b2 * x - section.a2 * y;
+            vecData[i] = y;
+        }
+
+        pState[(2 * s) * iStride] = z1;
+        pState[(2 * s + 1) * iStride] = z2;
+    }
+}
+
+//=============================================================================================================
+
+void CausalFilter::filterPartition(int iRow,
+                                   const double* pInput,
+                                   double* pOutput)
+{
+    const int B = m_iPartitionSize;
+    const int P = m_iNumPartitions;
+    FilterFftWorkspace& workspace = FilterFftEngine::threadWorkspace();
+
+    MatrixXcd& matDelayLine = m_vecDelayLines[iRow];
+    if(matDelayLine.cols() != P) {
+        matDelayLine = MatrixXcd::Zero(B + 1, P);
+    }
+
+    // Overlap-save input: previous partition followed by the new one
+    workspace.vecTime.resize(2 * B);
+    workspace.vecTime.head(B) = m_matLastInput.row(iRow).transpose();
+    workspace.vecTime.tail(B) = Map<const VectorXd>(pInput, B);
+    m_matLastInput.row(iRow) = Map<const RowVectorXd>(pInput, B);
+
+    int iPos = m_vecDelayLinePos[iRow];
+    workspace.fft.fwd(matDelayLine.col(iPos).data(), workspace.vecTime.data(), 2 * B);
+
+    // Multiply the frequency delay line with the kernel partitions
+    m_vecAccumulator.setZero();
+    for(int p = 0; p < P; ++p) {
+        m_vecAccumulator.array() += m_matKernelSpectra.col(p).array() * matDelayLine.col((iPos - p + P) % P).array();
+    }
+
+    workspace.fft.inv(workspace.vecTime.data(), m_vecAccumulator.data(), 2 * B);
+    Map<VectorXd>(pOutput, B) = workspace.vecTime.tail(B);
+
+    m_vecDelayLinePos[iRow] = (iPos + 1) % P;
+}
+
+//=============================================================================================================
+
+MatrixXd CausalFilter::calculate(const MatrixXd& matData,
+                                 const RowVectorXi& vecPicks)
+{
+    if(m_iNumChannels != matData.rows()) {
+        initState(matData.rows());
+    }
+
+    RowVectorXi vecRows = vecPicks;
+    if(vecRows.cols() == 0) {
+        vecRows = RowVectorXi::LinSpaced(matData.rows(), 0, matData.rows() - 1);
+    }
+
+    if(m_mode == IirBiquad) {
+        MatrixXd matDataOut = matData;
+        RowVectorXd vecRow;
+
+        for(int i = 0; i < vecRows.cols(); ++i) {
+            vecRow = matDataOut.row(vecRows[i]);
+            filterIir(vecRows[i], vecRow);
+            matDataOut.row(vecRows[i]) = vecRow;
+        }
+
+        return matDataOut;
+    }
+
+    if(m_iNumPartitions == 0) {
+        return matData;
+    }
+
+    const int B = m_iPartitionSize;
+
+    // The latency is fixed with the first block
+    if(m_iBufferLatency < 0) {
+        m_iBufferLatency = (matData.cols() % B == 0) ? 0 : B - 1;
+        m_matPendingOutput = MatrixXd::Zero(matData.rows(), m_iBufferLatency);
+    }
+
+    MatrixXd matInput(matData.rows(), m_matPendingInput.cols() + matData.cols());
+    matInput << m_matPendingInput, matData;
+
+    const int iNumSamples = (matInput.cols() / B) * B;
+
+    // Channels which are not picked pass through with the same latency
+    MatrixXd matOutput = MatrixXd::Zero(matData.rows(), m_matPendingOutput.cols() + iNumSamples);
+    matOutput.leftCols(m_matPendingOutput.cols()) = m_matPendingOutput;
+    matOutput.rightCols(iNumSamples) = matInput.leftCols(iNumSamples);
+
+    RowVectorXd vecIn, vecOut(iNumSamples);
+    for(int i = 0; i < vecRows.cols(); ++i) {
+        const int iRow = vecRows[i];
+        vecIn = matInput.row(iRow).head(iNumSamples);
+
+        for(int k = 0; k < iNumSamples; k += B) {
+            filterPartition(iRow, vecIn.data() + k, vecOut.data() + k);
+        }
+
+        matOutput.row(iRow).tail(iNumSamples) = vecOut;
+    }
+
+    m_matPendingInput = matInput.rightCols(matInput.cols() - iNumSamples);
+
+    // Blocks which are no multiple of the partition size after a latency of 0 was fixed
+    if(matOutput.cols() < matData.cols()) {
+        const int iMissing = matData.cols() - matOutput.cols();
+        qWarning() << "[CausalFilter::calculate] Block size changed. Increasing buffer latency by" << iMissing << "samples.";
+        MatrixXd matPadded = MatrixXd::Zero(matData.rows(), matData.cols());
+        matPadded.rightCols(matOutput.cols()) = matOutput;
+        matOutput = matPadded;
+        m_iBufferLatency += iMissing;
+    }
+
+    m_matPendingOutput = matOutput.rightCols(matOutput.cols() - matData.cols());
+
+    return matOutput.leftCols(matData.cols());
+}
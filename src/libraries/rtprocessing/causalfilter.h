@@ -0,0 +1,254 @@
+//=============================================================================================================
+/**
+ * @file     causalfilter.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    CausalFilter declarations.
+ *
+ */
+
+#ifndef CAUSALFILTER_RTPROCESSING_H
+#define CAUSALFILTER_RTPROCESSING_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtprocessing_global.h"
+
+#include "helpers/filterkernel.h"
+
+#include <complex>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+//=============================================================================================================
+/**
+ * Second order IIR section in direct form II transposed. The coefficients are normalized to a0 = 1.
+ */
+struct RTPROCESINGSHARED_EXPORT BiquadSection {
+    double b0;  /**< Feed forward coefficient 0. */
+    double b1;  /**< Feed forward coefficient 1. */
+    double b2;  /**< Feed forward coefficient 2. */
+    double a1;  /**< Feedback coefficient 1. */
+    double a2;  /**< Feedback coefficient 2. */
+};
+
+//=============================================================================================================
+/**
+ * Causal filtering of continous data streams. In contrast to FilterOverlapAdd, which filters with a linear phase
+ * kernel and delays the data by half the filter order, this class only uses past samples. Two modes are supported:
+ *
+ * - IirBiquad: A cascade of second order IIR sections (e.g. a Butterworth design). No buffering latency.
+ * - PartitionedFir: Uniformly partitioned overlap-save FFT convolution with an FIR kernel. The kernel is split
+ *   into partitions of the given size, so that the block latency only depends on the partition size and not on the
+ *   kernel length.
+ *
+ * The filter state of every channel is kept between calls to calculate.
+ *
+ * @brief Causal low-latency IIR/partitioned convolution filtering for continous data streams.
+ */
+class RTPROCESINGSHARED_EXPORT CausalFilter
+{
+public:
+    typedef QSharedPointer<CausalFilter> SPtr;             /**< Shared pointer type for CausalFilter. */
+    typedef QSharedPointer<const CausalFilter> ConstSPtr;  /**< Const shared pointer type for CausalFilter. */
+
+    enum FilterMode {
+        IirBiquad,
+        PartitionedFir
+    };
+
+    //=========================================================================================================
+    /**
+     * Constructs a CausalFilter without any sections, which passes the data unchanged.
+     */
+    CausalFilter();
+
+    //=========================================================================================================
+    /**
+     * Designs a Butterworth IIR filter as cascade of second order sections via the bilinear transform and
+     * switches to IirBiquad mode.
+     *
+     * @param[in] iFilterType      The type of the filter: LPF, HPF, BPF, NOTCH (index into FilterKernel::m_filterTypes).
+     * @param[in] iOrder           The filter order. For BPF the order is used for the high and the low pass each.
+     * @param[in] dCenterfreq      The cut off frequency for LPF/HPF, the center frequency for BPF/NOTCH in Hz.
+     * @param[in] dBandwidth       The bandwidth for BPF/NOTCH in Hz. Ignored for LPF/HPF.
+     * @param[in] dSFreq           The sampling frequency in Hz.
+     */
+    void designButterworth(int iFilterType,
+                           int iOrder,
+                           double dCenterfreq,
+                           double dBandwidth,
+                           double dSFreq);
+
+    //=========================================================================================================
+    /**
+     * Sets the IIR sections and switches to IirBiquad mode.
+     *
+     * @param[in] vecSections      The second order sections, applied in the given order.
+     */
+    void setSections(const QVector<BiquadSection>& vecSections);
+
+    //=========================================================================================================
+    /**
+     * Sets an FIR kernel and switches to PartitionedFir mode. The kernel is split into partitions of
+     * iPartitionSize samples. Choose the partition size equal to the incoming block size to avoid buffering
+     * latency.
+     *
+     * @param[in] filterKernel     The FIR kernel.
+     * @param[in] iPartitionSize   The partition size in samples.
+     */
+    void setFirKernel(const FilterKernel& filterKernel,
+                      int iPartitionSize);
+
+    //=========================================================================================================
+    /**
+     * Filters a block of data. Channels which are not picked are delayed by the buffering latency only.
+     *
+     * @param[in] matData          The data which is to be filtered.
+     * @param[in] vecPicks         Channel indexes to filter. Default is filter all channels.
+     *
+     * @return The filtered data, same size as matData.
+     */
+    Eigen::MatrixXd calculate(const Eigen::MatrixXd& matData,
+                              const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi());
+
+    //=========================================================================================================
+    /**
+     * Resets the filter state of all channels.
+     */
+    void reset();
+
+    //=========================================================================================================
+    /**
+     * Returns the current mode.
+     *
+     * @return The filter mode.
+     */
+    FilterMode getMode() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the latency introduced by buffering in samples. This is 0 for IirBiquad and for PartitionedFir if
+     * all blocks are multiples of the partition size. It is fixed once the first block was processed.
+     *
+     * @return The buffering latency in samples.
+     */
+    int getBufferLatency() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the group delay of the filter at the given frequency in samples. For linear phase FIR kernels this
+     * is (N-1)/2 at all frequencies.
+     *
+     * @param[in] dFreq            The frequency in Hz.
+     *
+     * @return The group delay in samples.
+     */
+    double getGroupDelay(double dFreq) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the total latency at the given frequency in seconds, i.e. buffering latency plus group delay.
+     *
+     * @param[in] dFreq            The frequency in Hz.
+     *
+     * @return The latency in seconds.
+     */
+    double getLatency(double dFreq) const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Returns the complex frequency response at the normalized angular frequency dOmega.
+     */
+    std::complex<double> frequencyResponse(double dOmega) const;
+
+    //=========================================================================================================
+    /**
+     * Filters one channel row with the IIR sections.
+     */
+    void filterIir(int iRow,
+                   Eigen::RowVectorXd& vecData);
+
+    //=========================================================================================================
+    /**
+     * Processes one complete partition of one channel with uniformly partitioned overlap-save convolution.
+     */
+    void filterPartition(int iRow,
+                         const double* pInput,
+                         double* pOutput);
+
+    //=========================================================================================================
+    /**
+     * Initializes the state for the given number of channels.
+     */
+    void initState(int iNumChannels);
+
+    FilterMode                  m_mode;                 /**< The filter mode. */
+    double                      m_dSFreq;               /**< The sampling frequency. */
+
+    QVector<BiquadSection>      m_vecSections;          /**< The IIR sections. */
+    Eigen::MatrixXd             m_matIirState;          /**< IIR state, channels x 2*sections. */
+
+    Eigen::RowVectorXd          m_vecFirCoeff;          /**< The FIR kernel. */
+    int                         m_iPartitionSize;       /**< Partition size B. */
+    int                         m_iNumPartitions;       /**< Number of kernel partitions P. */
+    Eigen::MatrixXcd            m_matKernelSpectra;     /**< Half spectra of the kernel partitions, (B+1) x P. */
+    QVector<Eigen::MatrixXcd>   m_vecDelayLines;        /**< Frequency domain delay line per channel, (B+1) x P. */
+    Eigen::MatrixXd             m_matLastInput;         /**< Previous input partition per channel, channels x B. */
+    Eigen::VectorXi             m_vecDelayLinePos;      /**< Current delay line position per channel. */
+    Eigen::MatrixXd             m_matPendingInput;      /**< Input samples which do not fill a partition yet. */
+    Eigen::MatrixXd             m_matPendingOutput;     /**< Filtered samples which were not returned yet. */
+    Eigen::VectorXcd            m_vecAccumulator;       /**< Frequency domain accumulator scratch buffer. */
+    int                         m_iBufferLatency;       /**< Buffering latency in samples, -1 if not fixed yet. */
+
+    int                         m_iNumChannels;         /**< Number of channels the state was initialized for. */
+};
+} // NAMESPACE
+
+#endif // CAUSALFILTER_RTPROCESSING_H
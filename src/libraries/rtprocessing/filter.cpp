@@ -48,6 +48,10 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QWaitCondition>
+#include <QQueue>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -69,6 +73,20 @@ using namespace UTILSLIB;
 // DEFINE GLOBAL RTPROCESSINGLIB METHODS
 //=============================================================================================================
 
+namespace {
+
+/**
+ * A chunk of the raw file on its way through the filterFile pipeline.
+ */
+struct FilterFileChunk {
+    fiff_int_t          first = 0;      /**< The first sample of the chunk. */
+    fiff_int_t          last = 0;       /**< The last sample of the chunk. */
+    bool                bOk = true;     /**< Whether the chunk could be read. */
+    QFuture<MatrixXd>   future;         /**< The filtered chunk. */
+};
+
+} // namespace
+
 bool RTPROCESSINGLIB::filterFile(QIODevice &pIODevice,
                                  QSharedPointer<FiffRawData> pFiffRawData,
                                  int type,
@@ -114,8 +132,6 @@ bool RTPROCESSINGLIB::filterFile(QIODevice &pIODevice,
     int iOrder = filterKernel.getFilterOrder();
 
     RowVectorXd cals;
-    SparseMatrix<double> mult;
-    RowVectorXi sel;
     FiffStream::SPtr outfid = FiffStream::start_writing_raw(pIODevice, pFiffRawData->info, cals);
 
     //Setup reading parameters
@@ -133,57 +149,145 @@ bool RTPROCESSINGLIB::filterFile(QIODevice &pIODevice,
 
         if((iSize < iOrder)) {
             qInfo() << "[Filter::filterData] Sliced data block size is too small. Filtering whole block at once.";
-            iSize = to - from;
+            iSize = to - from + 1;
             break;
         }
     }
 
-    float quantum_sec = iSize/pFiffRawData->info.sfreq;
-    fiff_int_t quantum = ceil(quantum_sec*pFiffRawData->info.sfreq);
+    fiff_int_t quantum = iSize;
+
+    // The kernel spectrum and FFT plans are reused for all chunks
+    FilterFftEngine filterEngine(filterKernel);
+
+    // Read, filter and write the data in a pipeline: The reader thread reads the chunks in order and hands them
+    // to the filter workers. The calling thread writes the filtered chunks in order and carries the overlap from
+    // one chunk to the next. At most iMaxChunks chunks are in flight, so the memory does not grow with the file.
+    QThreadPool filterPool;
+    filterPool.setMaxThreadCount(bUseThreads ? qMax(1, QThread::idealThreadCount()) : 1);
+    const int iMaxChunks = 2 * filterPool.maxThreadCount();
+
+    QThreadPool readerPool;
+    readerPool.setMaxThreadCount(1);
+
+    QSemaphore freeSlots(iMaxChunks);
+    QAtomicInt bAbort(0);
+    QMutex queueMutex;
+    QWaitCondition queueCondition;
+    QQueue<FilterFileChunk> queueChunks;
+    bool bReaderDone = false;
+
+    auto readerLambda = [&]() {
+        MatrixXd matData;
+        MatrixXd times;
+        SparseMatrix<double> mult;
+        RowVectorXi sel;
+
+        for(fiff_int_t first = from; first <= to; first += quantum) {
+            freeSlots.acquire();
+
+            if(bAbort.loadAcquire()) {
+                break;
+            }
+
+            FilterFileChunk chunk;
+            chunk.first = first;
+            chunk.last = first + quantum - 1;
+            if (chunk.last > to) {
+                chunk.last = to;
+            }
+
+            chunk.bOk = pFiffRawData->read_raw_segment(matData, times, mult, chunk.first, chunk.last, sel);
+
+            if(chunk.bOk) {
+                // The chunks are filtered in parallel, the channels of one chunk sequentially
+                chunk.future = QtConcurrent::run(&filterPool, [&filterEngine, &vecPicks, matChunk = std::move(matData)]() {
+                    return filterEngine.filterBlock(matChunk,
+                                                    vecPicks,
+                                                    false);
+                });
+            }
+
+            QMutexLocker locker(&queueMutex);
+            queueChunks.enqueue(chunk);
+            queueCondition.wakeAll();
+
+            if(!chunk.bOk) {
+                break;
+            }
+        }
 
-    // Read, filter and write the data
-    bool first_buffer = true;
+        QMutexLocker locker(&queueMutex);
+        bReaderDone = true;
+        queueCondition.wakeAll();
+    };
 
-    fiff_int_t first, last;
+    QFuture<void> readerFuture = QtConcurrent::run(&readerPool, readerLambda);
+
+    bool bFirstBuffer = true;
+    bool bOk = true;
     MatrixXd matData, matDataOverlap;
-    MatrixXd times;
 
-    for(first = from; first < to; first+=quantum) {
-        last = first+quantum-1;
-        if (last > to) {
-            last = to;
+    forever {
+        FilterFileChunk chunk;
+
+        {
+            QMutexLocker locker(&queueMutex);
+            while(queueChunks.isEmpty() && !bReaderDone) {
+                queueCondition.wait(&queueMutex);
+            }
+
+            if(queueChunks.isEmpty()) {
+                break;
+            }
+
+            chunk = queueChunks.dequeue();
         }
 
-        if (!pFiffRawData->read_raw_segment(matData, times, mult, first, last, sel)) {
+        if(!chunk.bOk) {
             qWarning("[Filter::filterData] Error during read_raw_segment\n");
-            return false;
+            bOk = false;
+            break;
         }
 
-        qInfo() << "Filtering and writing block" << first << "to" << last;
+        matData = chunk.future.result();
 
-        if (first_buffer) {
-           if (first > 0) {
-               outfid->write_int(FIFF_FIRST_SAMPLE,&first);
-           }
-           first_buffer = false;
-        }
+        qInfo() << "Filtering and writing block" << chunk.first << "to" << chunk.last;
 
-        matData = filterDataBlock(matData,
-                                  vecPicks,
-                                  filterKernel,
-                                  bUseThreads);
+        // The filtered chunk starts iOrder/2 samples before the chunk. Skip this delay for the first chunk and write
+        // the filter tail of the last chunk, so that the output is aligned with the input like in filterData.
+        int iChunkSize = matData.cols() - iOrder;
+        int iWriteFrom = 0;
+        int iWriteTo = chunk.last >= to ? iChunkSize + iOrder/2 : iChunkSize;
 
-        if(first == from) {
-            outfid->write_raw_buffer(matData.block(0,iOrder/2,matData.rows(),matData.cols()-iOrder), cals);
-        } else if(first + quantum >= to) {
-            matData.block(0,0,matData.rows(),iOrder) += matDataOverlap;
-            outfid->write_raw_buffer(matData.block(0,0,matData.rows(),matData.cols()-iOrder), cals);
+        if (bFirstBuffer) {
+           if (chunk.first > 0) {
+               outfid->write_int(FIFF_FIRST_SAMPLE,&chunk.first);
+           }
+           bFirstBuffer = false;
+
+           iWriteFrom = iOrder/2;
         } else {
             matData.block(0,0,matData.rows(),iOrder) += matDataOverlap;
-            outfid->write_raw_buffer(matData.block(0,0,matData.rows(),matData.cols()-iOrder), cals);
         }
 
-        matDataOverlap = matData.block(0,matData.cols()-iOrder,matData.rows(),iOrder);
+        outfid->write_raw_buffer(matData.block(0,iWriteFrom,matData.rows(),iWriteTo-iWriteFrom), cals);
+
+        matDataOverlap = matData.block(0,iChunkSize,matData.rows(),iOrder);
+
+        freeSlots.release();
+    }
+
+    if(!bOk) {
+        // Wake up the reader so that it can stop
+        bAbort.storeRelease(1);
+        freeSlots.release(iMaxChunks);
+    }
+
+    readerFuture.waitForFinished();
+    filterPool.waitForDone();
+
+    if(!bOk) {
+        return false;
     }
 
     outfid->finish_writing_raw();
@@ -254,6 +358,9 @@ MatrixXd RTPROCESSINGLIB::filterData(const MatrixXd& mataData,
     matDataOut.setZero();
     MatrixXd sliceFiltered;
 
+    // The kernel spectrum and FFT plans are reused for all slices
+    FilterFftEngine filterEngine(filterKernel);
+
     // slice input data into data junks with proper length so that the slices are always >= the filter order
     float fFactor = 2.0f;
     int iSize = fFactor * iOrder;
@@ -280,10 +387,9 @@ MatrixXd RTPROCESSINGLIB::filterData(const MatrixXd& mataData,
             }
 
             // Filter the data block. This will return data with a fitler delay of iOrder/2 in front and back
-            sliceFiltered = filterDataBlock(mataData.block(0,from,mataData.rows(),iSize),
-                                            vecPicks,
-                                            filterKernel,
-                                            bUseThreads);
+            sliceFiltered = filterEngine.filterBlock(mataData.block(0,from,mataData.rows(),iSize),
+                                                     vecPicks,
+                                                     bUseThreads);
 
             // Perform overlap add
             if(i == 0) {
@@ -295,10 +401,9 @@ MatrixXd RTPROCESSINGLIB::filterData(const MatrixXd& mataData,
             from += iSize;
         }
     } else {
-        matDataOut = filterDataBlock(mataData,
-                                     vecPicks,
-                                     filterKernel,
-                                     bUseThreads);
+        matDataOut = filterEngine.filterBlock(mataData,
+                                              vecPicks,
+                                              bUseThreads);
     }
 
     if(bKeepOverhead) {
@@ -315,60 +420,12 @@ MatrixXd RTPROCESSINGLIB::filterDataBlock(const MatrixXd& mataData,
                                           const FilterKernel& filterKernel,
                                           bool bUseThreads)
 {
-    int iOrder = filterKernel.getFilterOrder();
-
-    // Check for size of data
-    if(mataData.cols() < iOrder){
-        qWarning() << QString("[Filter::filterDataBlock] Filter length/order is bigger than data length. Returning.");
-        return mataData;
-    }
-
-    // Setup filters to the correct length, so we do not have to do this everytime we call the FFT filter function
-    FilterKernel filterKernelSetup = filterKernel;
-    filterKernelSetup.prepareFilter(mataData.cols());
-
-    // Do the concurrent filtering
-    RowVectorXi vecPicksNew = vecPicks;
-    if(vecPicksNew.cols() == 0) {
-        vecPicksNew = RowVectorXi::LinSpaced(mataData.rows(), 0, mataData.rows());
-    }
+    // The kernel is transformed once for all channels instead of being copied into one FilterObject per channel
+    FilterFftEngine filterEngine(filterKernel);
 
-    // Generate QList structure which can be handled by the QConcurrent framework
-    QList<FilterObject> timeData;
-
-    // Only select channels specified in vecPicksNew
-    FilterObject data;
-    for(qint32 i = 0; i < vecPicksNew.cols(); ++i) {
-        data.filterKernel = filterKernelSetup;
-        data.iRow = vecPicksNew[i];
-        data.vecData = mataData.row(vecPicksNew[i]);
-        timeData.append(data);
-    }
-
-    // Copy in data from last data block. This is necessary in order to also delay channels which are not filtered
-    MatrixXd matDataOut(mataData.rows(), mataData.cols()+iOrder);
-    matDataOut.setZero();
-    matDataOut.block(0, iOrder/2, mataData.rows(), mataData.cols()) = mataData;
-
-    if(bUseThreads) {
-        QFuture<void> future = QtConcurrent::map(timeData,
-                                                 filterChannel);
-        future.waitForFinished();
-    } else {
-        for(int i = 0; i < timeData.size(); ++i) {
-            filterChannel(timeData[i]);
-        }
-    }
-
-    // Do the overlap add method and store in matDataOut
-    RowVectorXd tempData;
-
-    for(int r = 0; r < timeData.size(); r++) {
-        // Write the newly calculated filtered data to the filter data matrix. This data has a delay of iOrder/2 in front and back
-        matDataOut.row(timeData.at(r).iRow) = timeData.at(r).vecData;
-    }
-
-    return matDataOut;
+    return filterEngine.filterBlock(mataData,
+                                    vecPicks,
+                                    bUseThreads);
 }
 
 //=============================================================================================================
@@ -453,6 +510,13 @@ MatrixXd FilterOverlapAdd::calculate(const MatrixXd& mataData,
         m_matOverlapFront.setZero();
     }
 
+    // The engine keeps the kernel spectrum and FFT plans between consecutive blocks
+    if(!m_pFilterEngine) {
+        m_pFilterEngine = FilterFftEngine::SPtr(new FilterFftEngine(filterKernel));
+    } else {
+        m_pFilterEngine->setFilterKernel(filterKernel);
+    }
+
     // Create output matrix with size of input matrix
     MatrixXd matDataOut(mataData.rows(), mataData.cols()+iOrder);
     matDataOut.setZero();
@@ -484,10 +548,9 @@ MatrixXd FilterOverlapAdd::calculate(const MatrixXd& mataData,
             }
 
             // Filter the data block. This will return data with a fitler delay of iOrder/2 in front and back
-            sliceFiltered = filterDataBlock(mataData.block(0,from,mataData.rows(),iSize),
-                                            vecPicks,
-                                            filterKernel,
-                                            bUseThreads);
+            sliceFiltered = m_pFilterEngine->filterBlock(mataData.block(0,from,mataData.rows(),iSize),
+                                                         vecPicks,
+                                                         bUseThreads);
 
             if(i == 0) {
                 matDataOut.block(0,0,mataData.rows(),sliceFiltered.cols()) += sliceFiltered;
@@ -504,10 +567,9 @@ MatrixXd FilterOverlapAdd::calculate(const MatrixXd& mataData,
             from += iSize;
         }
     } else {
-        matDataOut = filterDataBlock(mataData,
-                                     vecPicks,
-                                     filterKernel,
-                                     bUseThreads);
+        matDataOut = m_pFilterEngine->filterBlock(mataData,
+                                                  vecPicks,
+                                                  bUseThreads);
 
         if(bFilterEnd) {
             matDataOut.block(0,0,matDataOut.rows(),iOrder) += m_matOverlapBack;
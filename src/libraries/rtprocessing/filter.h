@@ -43,6 +43,7 @@
 #include "rtprocessing_global.h"
 
 #include "helpers/filterkernel.h"
+#include "helpers/filterfftengine.h"
 
 #include <fiff/fiff_info.h>
 
@@ -114,13 +115,15 @@ RTPROCESINGSHARED_EXPORT bool filterFile(QIODevice& pIODevice,
 //=========================================================================================================
 /**
  * Filters data from an input file based on an exisiting filter kernel and writes the filtered data to a
- * pIODevice.
+ * pIODevice. The file is processed chunk by chunk in a pipeline: a reader thread reads the chunks, the filter
+ * workers filter them in parallel and the calling thread writes them in order while carrying the overlap between
+ * consecutive chunks. Only a bounded number of chunks is held in memory, independent of the file length.
  *
  * @param[in] pIODevice            The IO device to write to.
  * @param[in] pFiffRawData         The fiff raw data object to read from.
  * @param[in] filterKernel         The list of filter kernels to use.
  * @param[in] vecPicks             Channel indexes to filter. Default is filter all channels.
- * @param[in] bUseThreads          hether to use multiple threads. Default is set to true.
+ * @param[in] bUseThreads          Whether to filter multiple chunks in parallel. Default is set to false.
  *
  * @return Returns true if successfull, false otherwise.
  */
@@ -279,6 +282,7 @@ public:
 private:
     Eigen::MatrixXd                 m_matOverlapBack;                   /**< Overlap block for the end of the data block. */
     Eigen::MatrixXd                 m_matOverlapFront;                  /**< Overlap block for the beginning of the data block. */
+    FilterFftEngine::SPtr           m_pFilterEngine;                    /**< Batched FFT filter engine, kept between blocks. */
 };
 
 //=============================================================================================================
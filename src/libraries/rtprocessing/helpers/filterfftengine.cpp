@@ -0,0 +1,245 @@
+//=============================================================================================================
+/**
+ * @file     filterfftengine.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    FilterFftEngine class definition.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "filterfftengine.h"
+
+#include <utils/mnemath.h>
+
+#include <algorithm>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QList>
+#include <QPair>
+#include <QThreadStorage>
+#include <QtConcurrent>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+using namespace UTILSLIB;
+
+//=============================================================================================================
+// INIT STATIC MEMBERS
+//=============================================================================================================
+
+static QThreadStorage<FilterFftWorkspace*> s_threadWorkspaces;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FilterFftEngine::FilterFftEngine(const FilterKernel& filterKernel,
+                                 int iBlockSize)
+: m_iBlockSize(std::max(1, iBlockSize))
+{
+    setFilterKernel(filterKernel);
+}
+
+//=============================================================================================================
+
+void FilterFftEngine::setFilterKernel(const FilterKernel& filterKernel)
+{
+    RowVectorXd vecCoeff = filterKernel.getCoefficients();
+
+    QMutexLocker locker(&m_mutex);
+
+    if(vecCoeff.cols() != m_vecCoeff.cols() || vecCoeff != m_vecCoeff) {
+        m_vecCoeff = vecCoeff;
+        m_mapSpectra.clear();
+    }
+}
+
+//=============================================================================================================
+
+int FilterFftEngine::getFilterOrder() const
+{
+    return m_vecCoeff.cols();
+}
+
+//=============================================================================================================
+
+int FilterFftEngine::fftLength(int iDataSize) const
+{
+    int iFftLength = iDataSize + m_vecCoeff.cols();
+    int exp = ceil(MNEMath::log2(iFftLength));
+
+    return pow(2, exp);
+}
+
+//=============================================================================================================
+
+FilterFftWorkspace& FilterFftEngine::threadWorkspace()
+{
+    if(!s_threadWorkspaces.hasLocalData()) {
+        #ifdef EIGEN_FFTW_DEFAULT
+        fftw_make_planner_thread_safe();
+        #endif
+
+        FilterFftWorkspace* pWorkspace = new FilterFftWorkspace();
+        pWorkspace->fft.SetFlag(pWorkspace->fft.HalfSpectrum);
+        s_threadWorkspaces.setLocalData(pWorkspace);
+    }
+
+    return *s_threadWorkspaces.localData();
+}
+
+//=============================================================================================================
+
+VectorXcd FilterFftEngine::kernelSpectrum(int iFftLength)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QMap<int,VectorXcd>::const_iterator it = m_mapSpectra.constFind(iFftLength);
+    if(it != m_mapSpectra.constEnd()) {
+        return it.value();
+    }
+
+    FilterFftWorkspace& workspace = threadWorkspace();
+
+    workspace.vecTime.setZero(iFftLength);
+    workspace.vecTime.head(m_vecCoeff.cols()) = m_vecCoeff.transpose();
+
+    VectorXcd vecSpectrum(iFftLength/2+1);
+    workspace.fft.fwd(vecSpectrum.data(), workspace.vecTime.data(), iFftLength);
+
+    m_mapSpectra.insert(iFftLength, vecSpectrum);
+
+    return vecSpectrum;
+}
+
+//=============================================================================================================
+
+MatrixXd FilterFftEngine::filterBlock(const MatrixXd& matData,
+                                      const RowVectorXi& vecPicks,
+                                      bool bUseThreads)
+{
+    const int iOrder = m_vecCoeff.cols();
+
+    // Check for size of data
+    if(matData.cols() < iOrder) {
+        qWarning() << "[FilterFftEngine::filterBlock] Filter length/order is bigger than data length. Returning.";
+        return matData;
+    }
+
+    // Non picked channels are only delayed
+    MatrixXd matDataOut = MatrixXd::Zero(matData.rows(), matData.cols() + iOrder);
+    matDataOut.block(0, iOrder/2, matData.rows(), matData.cols()) = matData;
+
+    RowVectorXi vecRows = vecPicks;
+    if(vecRows.cols() == 0) {
+        vecRows = RowVectorXi::LinSpaced(matData.rows(), 0, matData.rows() - 1);
+    }
+
+    // The kernel spectrum is computed once per FFT length and shared by all channel blocks
+    const VectorXcd vecSpectrum = kernelSpectrum(fftLength(matData.cols()));
+
+    QList<QPair<int,int> > lBlocks;
+    for(int i = 0; i < vecRows.cols(); i += m_iBlockSize) {
+        lBlocks.append(qMakePair(i, std::min(m_iBlockSize, int(vecRows.cols()) - i)));
+    }
+
+    std::function<void(QPair<int,int>&)> computeLambda = [&](QPair<int,int>& block) {
+        filterChannelBlock(matData,
+                           vecRows,
+                           block.first,
+                           block.second,
+                           vecSpectrum,
+                           matDataOut);
+    };
+
+    if(bUseThreads && lBlocks.size() > 1) {
+        QFuture<void> future = QtConcurrent::map(lBlocks,
+                                                 computeLambda);
+        future.waitForFinished();
+    } else {
+        for(int i = 0; i < lBlocks.size(); ++i) {
+            computeLambda(lBlocks[i]);
+        }
+    }
+
+    return matDataOut;
+}
+
+//=============================================================================================================
+
+void FilterFftEngine::filterChannelBlock(const MatrixXd& matData,
+                                         const RowVectorXi& vecRows,
+                                         int iFirst,
+                                         int iCount,
+                                         const VectorXcd& vecSpectrum,
+                                         MatrixXd& matDataOut) const
+{
+    FilterFftWorkspace& workspace = threadWorkspace();
+
+    const int iFftLength = 2 * (vecSpectrum.size() - 1);
+    const int iCols = matData.cols();
+    const int iOutCols = matDataOut.cols();
+
+    // Only grows, the buffers are reused by all following blocks of this thread
+    if(workspace.matBlock.rows() != iFftLength || workspace.matBlock.cols() < iCount) {
+        workspace.matBlock.resize(iFftLength, std::max(iCount, m_iBlockSize));
+    }
+    if(workspace.vecFreq.size() != vecSpectrum.size()) {
+        workspace.vecFreq.resize(vecSpectrum.size());
+    }
+
+    // Transpose the channel rows into contiguous, zero padded columns
+    for(int j = 0; j < iCount; ++j) {
+        workspace.matBlock.col(j).head(iCols) = matData.row(vecRows[iFirst + j]).transpose();
+        workspace.matBlock.col(j).tail(iFftLength - iCols).setZero();
+    }
+
+    for(int j = 0; j < iCount; ++j) {
+        double* pColumn = workspace.matBlock.col(j).data();
+
+        workspace.fft.fwd(workspace.vecFreq.data(), pColumn, iFftLength);
+        workspace.vecFreq.array() *= vecSpectrum.array();
+        workspace.fft.inv(pColumn, workspace.vecFreq.data(), iFftLength);
+    }
+
+    for(int j = 0; j < iCount; ++j) {
+        matDataOut.row(vecRows[iFirst + j]) = workspace.matBlock.col(j).head(iOutCols).transpose();
+    }
+}
@@ -0,0 +1,194 @@
+//=============================================================================================================
+/**
+ * @file     filterfftengine.h
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    FilterFftEngine class declaration.
+ *
+ */
+
+#ifndef FILTERFFTENGINE_H
+#define FILTERFFTENGINE_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../rtprocessing_global.h"
+
+#include "filterkernel.h"
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <unsupported/Eigen/FFT>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QMap>
+#include <QMutex>
+
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+//=============================================================================================================
+/**
+ * Per-thread FFT workspace. Eigen's FFT keeps its plans per transform length, so reusing the same object in a
+ * thread reuses the plans. The scratch buffers grow to the largest block seen and are not freed in between calls.
+ *
+ * @brief Per-thread FFT plans and scratch buffers.
+ */
+struct FilterFftWorkspace {
+    Eigen::FFT<double>  fft;                /**< The FFT object holding the plans. */
+    Eigen::VectorXd     vecTime;            /**< Time domain scratch buffer. */
+    Eigen::VectorXcd    vecFreq;            /**< Frequency domain scratch buffer. */
+    Eigen::MatrixXd     matBlock;           /**< Zero padded channel block, one channel per column. */
+};
+
+//=============================================================================================================
+/**
+ * Batched FFT filtering of multi-channel data. In contrast to filterDataBlock with FilterObjects, the filter
+ * kernel is not copied per channel. Its spectrum is computed once per FFT length and shared by all channels.
+ * The channels are processed in blocks. Each block is transposed into a contiguous, zero padded scratch matrix
+ * of the calling thread's workspace, filtered column by column and written back.
+ *
+ * @brief Batched multi-channel FFT filtering with kernel spectrum and FFT plan reuse.
+ */
+class RTPROCESINGSHARED_EXPORT FilterFftEngine
+{
+public:
+    typedef QSharedPointer<FilterFftEngine> SPtr;             /**< Shared pointer type for FilterFftEngine. */
+    typedef QSharedPointer<const FilterFftEngine> ConstSPtr;  /**< Const shared pointer type for FilterFftEngine. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a FilterFftEngine.
+     *
+     * @param[in] filterKernel     The filter kernel to use.
+     * @param[in] iBlockSize       The number of channels which are processed together. Default is 16.
+     */
+    explicit FilterFftEngine(const FilterKernel& filterKernel = FilterKernel(),
+                             int iBlockSize = 16);
+
+    //=========================================================================================================
+    /**
+     * Sets a new filter kernel. The cached kernel spectra are only dropped if the coefficients changed.
+     *
+     * @param[in] filterKernel     The filter kernel to use.
+     */
+    void setFilterKernel(const FilterKernel& filterKernel);
+
+    //=========================================================================================================
+    /**
+     * Returns the filter order, i.e. the number of filter taps.
+     *
+     * @return The filter order.
+     */
+    int getFilterOrder() const;
+
+    //=========================================================================================================
+    /**
+     * Filters a data block. Behaves like filterDataBlock: The output has iOrder/2 samples delay in front and
+     * back. Channels which are not picked are copied with the same delay.
+     *
+     * @param[in] matData          The data which is to be filtered.
+     * @param[in] vecPicks         Channel indexes to filter. Default is filter all channels.
+     * @param[in] bUseThreads      Whether to use multiple threads. Default is set to true.
+     *
+     * @return The filtered data (rows x cols+iOrder).
+     */
+    Eigen::MatrixXd filterBlock(const Eigen::MatrixXd& matData,
+                                const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi(),
+                                bool bUseThreads = true);
+
+    //=========================================================================================================
+    /**
+     * Returns the FFT length used for a data block of the given length.
+     *
+     * @param[in] iDataSize        The number of samples of the data block.
+     *
+     * @return The FFT length.
+     */
+    int fftLength(int iDataSize) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the workspace of the calling thread. The workspace is created on first use and lives until the
+     * thread finishes.
+     *
+     * @return The workspace of the calling thread.
+     */
+    static FilterFftWorkspace& threadWorkspace();
+
+private:
+    //=========================================================================================================
+    /**
+     * Returns the half spectrum of the kernel for the given FFT length. The spectrum is computed once per
+     * FFT length.
+     *
+     * @param[in] iFftLength       The FFT length.
+     *
+     * @return The kernel spectrum (iFftLength/2+1).
+     */
+    Eigen::VectorXcd kernelSpectrum(int iFftLength);
+
+    //=========================================================================================================
+    /**
+     * Filters a block of channels.
+     *
+     * @param[in] matData          The input data.
+     * @param[in] vecRows          The rows to filter.
+     * @param[in] iFirst           First index into vecRows.
+     * @param[in] iCount           Number of rows to process.
+     * @param[in] vecSpectrum      The kernel spectrum.
+     * @param[out] matDataOut      The output data.
+     */
+    void filterChannelBlock(const Eigen::MatrixXd& matData,
+                            const Eigen::RowVectorXi& vecRows,
+                            int iFirst,
+                            int iCount,
+                            const Eigen::VectorXcd& vecSpectrum,
+                            Eigen::MatrixXd& matDataOut) const;
+
+    Eigen::RowVectorXd          m_vecCoeff;         /**< The filter coefficients. */
+    int                         m_iBlockSize;       /**< Number of channels per block. */
+    QMap<int,Eigen::VectorXcd>  m_mapSpectra;       /**< Kernel spectra keyed by FFT length. */
+    QMutex                      m_mutex;            /**< Guards the spectra cache. */
+};
+} // NAMESPACE
+
+#endif // FILTERFFTENGINE_H
@@ -118,6 +118,15 @@ void RtAveragingWorker::doWork(const MatrixXd& rawSegment)
 
 //=============================================================================================================
 
+void RtAveragingWorker::doWorkOnBlock(const QSharedPointer<const MatrixXd>& pMatData)
+{
+    if(pMatData) {
+        doWork(*pMatData);
+    }
+}
+
+//=============================================================================================================
+
 void RtAveragingWorker::setAverageNumber(qint32 numAve)
 {
     if(numAve <= 0) {
@@ -139,6 +148,8 @@ void RtAveragingWorker::setAverageNumber(qint32 numAve)
                 for(int i = 0; i < iDiff; ++i) {
                     idx.value().pop_front();
                 }
+
+                recomputeStimSums(idx.key());
             }
         }
     }
@@ -352,6 +363,7 @@ void RtAveragingWorker::emitEvoked(double dTriggerType, QStringList& lResponsibl
 
     if(m_stimEvokedSet.evoked.size() > 0) {
         emit resultReady(m_stimEvokedSet, lResponsibleTriggerTypes);
+        emit stdErrReady(m_stimEvokedSetStdErr, lResponsibleTriggerTypes);
     }
 
 //    qDebug()<<"RtAveragingWorker::emitEvoked() - dTriggerType:" << dTriggerType;
@@ -381,36 +393,51 @@ void RtAveragingWorker::fillFrontBuffer(const MatrixXd &data, double dTriggerTyp
     if(!m_mapDataPre.contains(dTriggerType)) {
         if(dTriggerType != -1.0) {
             m_mapDataPre[dTriggerType] = m_mapDataPre[-1.0];
+            m_mapDataPreIdx[dTriggerType] = m_mapDataPreIdx.value(-1.0, 0);
         } else {
             m_mapDataPre[-1.0].resize(m_pFiffInfo->chs.size(), m_iPreStimSamples);
             m_mapDataPre[-1.0].setZero();
+            m_mapDataPreIdx[-1.0] = 0;
         }
     }
 
-    if(m_mapDataPre[dTriggerType].cols() <= data.cols()) {
-        if(m_iPreStimSamples > 0 && data.cols() >= m_iPreStimSamples) {
-            m_mapDataPre[dTriggerType] = data.block(0,
-                                                    data.cols() - m_iPreStimSamples,
-                                                    data.rows(),
-                                                    m_iPreStimSamples);
-        }
-    } else {
-        int residual = m_mapDataPre[dTriggerType].cols() - data.cols();
+    MatrixXd& matDataPre = m_mapDataPre[dTriggerType];
+    qint32& iDataPreIdx = m_mapDataPreIdx[dTriggerType];
+    int iNumPre = matDataPre.cols();
+
+    if(iNumPre == 0 || data.cols() == 0) {
+        return;
+    }
 
-        //Copy shift data
-        m_mapDataPre[dTriggerType].block(0,
-                                         0,
-                                         m_mapDataPre[dTriggerType].rows(),
-                                         residual) = m_mapDataPre[dTriggerType].block(0,
-                                                                                      m_mapDataPre[dTriggerType].cols() - residual,
-                                                                                      m_mapDataPre[dTriggerType].rows(),
-                                                                                      residual);
+    if(iNumPre <= data.cols()) {
+        matDataPre = data.block(0,
+                                data.cols() - iNumPre,
+                                data.rows(),
+                                iNumPre);
+        iDataPreIdx = 0;
+    } else {
+        //Copy new data in at the write index and wrap around at the end of the buffer
+        int iNumTail = std::min(int(data.cols()), iNumPre - iDataPreIdx);
+
+        matDataPre.block(0,
+                         iDataPreIdx,
+                         matDataPre.rows(),
+                         iNumTail) = data.block(0,
+                                                0,
+                                                data.rows(),
+                                                iNumTail);
+
+        if(iNumTail < data.cols()) {
+            matDataPre.block(0,
+                             0,
+                             matDataPre.rows(),
+                             data.cols() - iNumTail) = data.block(0,
+                                                                  iNumTail,
+                                                                  data.rows(),
+                                                                  data.cols() - iNumTail);
+        }
 
-        //Copy new data in
-        m_mapDataPre[dTriggerType].block(0,
-                                         residual,
-                                         m_mapDataPre[dTriggerType].rows(),
-                                         data.cols()) = data;
+        iDataPreIdx = (iDataPreIdx + data.cols()) % iNumPre;
     }
 }
 
@@ -423,9 +450,17 @@ void RtAveragingWorker::mergeData(double dTriggerType)
         return;
     }
 
-    MatrixXd mergedData(m_mapDataPre[dTriggerType].rows(), m_mapDataPre[dTriggerType].cols() + m_mapDataPost[dTriggerType].cols());
+    const MatrixXd& matDataPre = m_mapDataPre[dTriggerType];
+    const MatrixXd& matDataPost = m_mapDataPost[dTriggerType];
+    int iNumPre = matDataPre.cols();
+    int iDataPreIdx = m_mapDataPreIdx.value(dTriggerType, 0);
+
+    //Unroll the circular pre stim buffer, which starts with the oldest sample at the write index
+    MatrixXd mergedData(matDataPre.rows(), iNumPre + matDataPost.cols());
 
-    mergedData << m_mapDataPre[dTriggerType], m_mapDataPost[dTriggerType];
+    mergedData.block(0, 0, mergedData.rows(), iNumPre - iDataPreIdx) = matDataPre.block(0, iDataPreIdx, matDataPre.rows(), iNumPre - iDataPreIdx);
+    mergedData.block(0, iNumPre - iDataPreIdx, mergedData.rows(), iDataPreIdx) = matDataPre.block(0, 0, matDataPre.rows(), iDataPreIdx);
+    mergedData.block(0, iNumPre, mergedData.rows(), matDataPost.cols()) = matDataPost;
 
     //Perform artifact threshold
     bool bArtifactDetected = false;
@@ -439,21 +474,67 @@ void RtAveragingWorker::mergeData(double dTriggerType)
     }
 
     if(!bArtifactDetected) {
-        //Add cut data to average buffer
-        m_mapStimAve[dTriggerType].append(mergedData);
+        //Add cut data to average buffer and running sums
+        QList<MatrixXd>& lStimAve = m_mapStimAve[dTriggerType];
+        lStimAve.append(mergedData);
+
+        if(!m_mapStimSum.contains(dTriggerType)) {
+            m_mapStimSum[dTriggerType] = MatrixXd::Zero(mergedData.rows(), mergedData.cols());
+            m_mapStimSumSq[dTriggerType] = MatrixXd::Zero(mergedData.rows(), mergedData.cols());
+            m_mapNumSumUpdates[dTriggerType] = 0;
+        }
+
+        MatrixXd& matSum = m_mapStimSum[dTriggerType];
+        MatrixXd& matSumSq = m_mapStimSumSq[dTriggerType];
+        matSum += mergedData;
+        matSumSq += mergedData.array().square().matrix();
 
-        //Pop data from buffer
-        int iDiff =  m_mapStimAve[dTriggerType].size() - m_iNumAverages;
+        //Pop data from buffer and subtract it from the running sums
+        int iDiff =  lStimAve.size() - m_iNumAverages;
         if(iDiff > 0) {
             for(int i = 0; i < iDiff; ++i) {
-                m_mapStimAve[dTriggerType].pop_front();
+                matSum -= lStimAve.first();
+                matSumSq -= lStimAve.first().array().square().matrix();
+                lStimAve.pop_front();
             }
+
+            m_mapNumSumUpdates[dTriggerType] += iDiff;
+        }
+
+        //Recompute the sums once per full buffer cycle, so the cost per epoch stays independent of the number of averages
+        if(m_mapNumSumUpdates[dTriggerType] >= m_iNumAverages) {
+            recomputeStimSums(dTriggerType);
         }
     }
 }
 
 //=============================================================================================================
 
+void RtAveragingWorker::recomputeStimSums(double dTriggerType)
+{
+    const QList<MatrixXd>& lStimAve = m_mapStimAve[dTriggerType];
+    m_mapNumSumUpdates[dTriggerType] = 0;
+
+    if(lStimAve.isEmpty()) {
+        m_mapStimSum.remove(dTriggerType);
+        m_mapStimSumSq.remove(dTriggerType);
+        return;
+    }
+
+    MatrixXd matSum = MatrixXd::Zero(lStimAve.first().rows(), lStimAve.first().cols());
+    MatrixXd matSumSq = MatrixXd::Zero(lStimAve.first().rows(), lStimAve.first().cols());
+
+    for(int i = 0; i < lStimAve.size(); ++i) {
+        matSum += lStimAve.at(i);
+        matSumSq += lStimAve.at(i).array().square().matrix();
+    }
+
+    m_mapStimSum[dTriggerType] = matSum;
+    m_mapStimSumSq[dTriggerType] = matSumSq;
+}
+
+//=============================================================================================================
+
 void RtAveragingWorker::generateEvoked(double dTriggerType)
 {
     if(m_mapStimAve[dTriggerType].isEmpty()) {
@@ -488,15 +569,15 @@ void RtAveragingWorker::generateEvoked(double dTriggerType)
         evoked.comment = QString::number(dTriggerType);
     }
 
-    // Generate final evoked
-    MatrixXd finalAverage = MatrixXd::Zero(m_mapStimAve[dTriggerType].first().rows(), m_iPreStimSamples+m_iPostStimSamples);
+    // Generate final evoked and its standard error from the running sums, var = (sum(x^2) - sum(x)^2/n) / (n-1)
+    int iNumAve = m_mapStimAve[dTriggerType].size();
+    const MatrixXd& matSum = m_mapStimSum[dTriggerType];
+    MatrixXd finalAverage = matSum / iNumAve;
+    MatrixXd finalStdErr = MatrixXd::Zero(matSum.rows(), matSum.cols());
 
-    for(int i = 0; i < m_mapStimAve[dTriggerType].size(); ++i) {
-        finalAverage += m_mapStimAve[dTriggerType].at(i);
-    }
-
-    if(!m_mapStimAve[dTriggerType].isEmpty()) {
-        finalAverage = finalAverage/m_mapStimAve[dTriggerType].size();
+    if(iNumAve > 1) {
+        finalStdErr = ((m_mapStimSumSq[dTriggerType].array() - matSum.array().square() / iNumAve).max(0.0)
+                       / (double(iNumAve - 1) * iNumAve)).sqrt().matrix();
     }
 
     if(m_bDoBaselineCorrection) {
@@ -505,7 +586,7 @@ void RtAveragingWorker::generateEvoked(double dTriggerType)
 
     evoked.data = finalAverage;
 
-    evoked.nave = m_mapStimAve[dTriggerType].size();
+    evoked.nave = iNumAve;
 
     //Add new data to evoked data set
     if(iEvokedIdx != -1) {
@@ -515,6 +596,26 @@ void RtAveragingWorker::generateEvoked(double dTriggerType)
         //Evoked data is not present yet
         m_stimEvokedSet.evoked.append(evoked);
     }
+
+    //Add the standard error to the standard error data set
+    FiffEvoked evokedStdErr = evoked;
+    evokedStdErr.aspect_kind = FIFFV_ASPECT_STD_ERR;
+    evokedStdErr.data = finalStdErr;
+    m_stimEvokedSetStdErr.info = m_stimEvokedSet.info;
+
+    int iStdErrIdx = -1;
+    for(int i = 0; i < m_stimEvokedSetStdErr.evoked.size(); ++i) {
+        if(m_stimEvokedSetStdErr.evoked.at(i).comment == evokedStdErr.comment) {
+            iStdErrIdx = i;
+            break;
+        }
+    }
+
+    if(iStdErrIdx != -1) {
+        m_stimEvokedSetStdErr.evoked[iStdErrIdx] = evokedStdErr;
+    } else {
+        m_stimEvokedSetStdErr.evoked.append(evokedStdErr);
+    }
 }
 
 //=============================================================================================================
@@ -528,11 +629,17 @@ void RtAveragingWorker::reset()
 
     //Clear all evoked data information
     m_stimEvokedSet.evoked.clear();
+    m_stimEvokedSetStdErr.evoked.clear();
 
     //Clear all maps
     m_mapStimAve.clear();
+    m_mapStimSum.clear();
+    m_mapStimSumSq.clear();
+    m_mapNumSumUpdates.clear();
     m_mapDataPre.clear();
     m_mapDataPre[-1.0] = MatrixXd::Zero(m_pFiffInfo->chs.size(), m_iPreStimSamples);
+    m_mapDataPreIdx.clear();
+    m_mapDataPreIdx[-1.0] = 0;
     m_mapDataPost.clear();
     m_mapMatDataPostIdx.clear();
     m_mapFillingBackBuffer.clear();
@@ -553,6 +660,7 @@ RtAveraging::RtAveraging(quint32 numAverages,
 : QObject(parent)
 {
     qRegisterMetaType<Eigen::MatrixXd>("Eigen::MatrixXd");
+    qRegisterMetaType<QSharedPointer<const Eigen::MatrixXd> >("QSharedPointer<const Eigen::MatrixXd>");
 
     RtAveragingWorker *worker = new RtAveragingWorker(numAverages,
                                                       iPreStimSamples,
@@ -568,9 +676,13 @@ RtAveraging::RtAveraging(quint32 numAverages,
 
     connect(this, &RtAveraging::operate,
             worker, &RtAveragingWorker::doWork);
+    connect(this, &RtAveraging::operateOnBlock,
+            worker, &RtAveragingWorker::doWorkOnBlock);
 
     connect(worker, &RtAveragingWorker::resultReady,
             this, &RtAveraging::handleResults, Qt::DirectConnection);
+    connect(worker, &RtAveragingWorker::stdErrReady,
+            this, &RtAveraging::handleStdErrResults, Qt::DirectConnection);
 
     connect(this, &RtAveraging::averageNumberChanged,
             worker, &RtAveragingWorker::setAverageNumber);
@@ -610,6 +722,13 @@ void RtAveraging::append(const MatrixXd &data)
 
 //=============================================================================================================
 
+void RtAveraging::append(const QSharedPointer<const MatrixXd> &pData)
+{
+    emit operateOnBlock(pData);
+}
+
+//=============================================================================================================
+
 void RtAveraging::handleResults(const FiffEvokedSet& evokedStimSet,
                           const QStringList &lResponsibleTriggerTypes)
 {
@@ -619,6 +738,15 @@ void RtAveraging::handleResults(const FiffEvokedSet& evokedStimSet,
 
 //=============================================================================================================
 
+void RtAveraging::handleStdErrResults(const FiffEvokedSet& evokedStimSetStdErr,
+                                      const QStringList &lResponsibleTriggerTypes)
+{
+    emit evokedStimStdErr(evokedStimSetStdErr,
+                          lResponsibleTriggerTypes);
+}
+
+//=============================================================================================================
+
 void RtAveraging::restart(quint32 numAverages,
                           quint32 iPreStimSamples,
                           quint32 iPostStimSamples,
@@ -643,9 +771,13 @@ void RtAveraging::restart(quint32 numAverages,
 
     connect(this, &RtAveraging::operate,
             worker, &RtAveragingWorker::doWork);
+    connect(this, &RtAveraging::operateOnBlock,
+            worker, &RtAveragingWorker::doWorkOnBlock);
 
     connect(worker, &RtAveragingWorker::resultReady,
             this, &RtAveraging::handleResults, Qt::DirectConnection);
+    connect(worker, &RtAveragingWorker::stdErrReady,
+            this, &RtAveraging::handleStdErrResults, Qt::DirectConnection);
 
     connect(this, &RtAveraging::averageNumberChanged,
             worker, &RtAveragingWorker::setAverageNumber);
@@ -113,6 +113,14 @@ public:
      */
     void doWork(const Eigen::MatrixXd& matData);
 
+    //=========================================================================================================
+    /**
+     * Averages a shared data block. The block is read in place and not copied.
+     *
+     * @param[in] pMatData        Shared data block to calculate the average from.
+     */
+    void doWorkOnBlock(const QSharedPointer<const Eigen::MatrixXd>& pMatData);
+
     //=========================================================================================================
     /**
      * Sets the number of averages
@@ -200,7 +208,7 @@ protected:
 
     //=========================================================================================================
     /**
-     * Prepends incoming data to front/pre stim buffer.
+     * Writes incoming data to the circular front/pre stim buffer.
      */
     void fillFrontBuffer(const Eigen::MatrixXd& data,
                          double dTriggerType);
@@ -223,7 +231,16 @@ protected:
 
     //=========================================================================================================
     /**
-     * Generates the final evoke variable.
+     * Recomputes the running sums of a trigger type from the stored epochs. This removes the rounding errors
+     * which accumulate when old epochs are subtracted from the sums.
+     *
+     * @param[in] dTriggerType    The trigger type.
+     */
+    void recomputeStimSums(double dTriggerType);
+
+    //=========================================================================================================
+    /**
+     * Generates the final evoke variable and its standard error from the running sums.
      */
     void generateEvoked(double dTriggerType);
 
@@ -255,10 +272,15 @@ protected:
 
     FIFFLIB::FiffInfo::SPtr                         m_pFiffInfo;                /**< Holds the fiff measurement information. */
     FIFFLIB::FiffEvokedSet                          m_stimEvokedSet;            /**< Holds the evoked information. */
+    FIFFLIB::FiffEvokedSet                          m_stimEvokedSetStdErr;      /**< Holds the standard error of the evoked information. */
 
     QMap<QString,double>                            m_mapThresholds;            /**< Holds the current thresholds for artifact rejection. */
     QMap<double,QList<Eigen::MatrixXd> >            m_mapStimAve;               /**< the current stimulus average buffer. Holds m_iNumAverages vectors. */
-    QMap<double,Eigen::MatrixXd>                    m_mapDataPre;               /**< The matrix holding pre stim data. */
+    QMap<double,Eigen::MatrixXd>                    m_mapStimSum;               /**< The running sum of the epochs in m_mapStimAve. */
+    QMap<double,Eigen::MatrixXd>                    m_mapStimSumSq;             /**< The running sum of the squared epochs in m_mapStimAve. */
+    QMap<double,qint32>                             m_mapNumSumUpdates;         /**< Number of epochs subtracted from the running sums since they were last recomputed. */
+    QMap<double,Eigen::MatrixXd>                    m_mapDataPre;               /**< The circular buffer holding pre stim data. */
+    QMap<double,qint32>                             m_mapDataPreIdx;            /**< Current write index inside of the circular buffer m_mapDataPre, which is also the oldest sample. */
     QMap<double,Eigen::MatrixXd>                    m_mapDataPost;              /**< The matrix holding post stim data. */
     QMap<double,qint32>                             m_mapMatDataPostIdx;        /**< Current index inside of the matrix m_matDataPost. */
     QMap<double,bool>                               m_mapFillingBackBuffer;     /**< Whether the back buffer is currently getting filled. */
@@ -273,6 +295,16 @@ signals:
      */
     void resultReady(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                      const QStringList& lResponsibleTriggerTypes);
+
+    //=========================================================================================================
+    /**
+     * Signal which is emitted together with resultReady and holds the standard error of the evoked stimulus data.
+     *
+     * @param[in] evokedStimSetStdErr        The standard error of the evoked stimulus data set.
+     * @param[in] lResponsibleTriggerTypes   List of all trigger types which lead to the recent emit of a new evoked set.
+     */
+    void stdErrReady(const FIFFLIB::FiffEvokedSet& evokedStimSetStdErr,
+                     const QStringList& lResponsibleTriggerTypes);
 };
 
 //=============================================================================================================
@@ -325,6 +357,15 @@ public:
      */
     void append(const Eigen::MatrixXd &data);
 
+    //=========================================================================================================
+    /**
+     * Slot to receive incoming shared data blocks. Only the reference is handed to the worker thread, the data
+     * is not copied.
+     *
+     * @param[in] pData  Shared data block to calculate the average from.
+     */
+    void append(const QSharedPointer<const Eigen::MatrixXd> &pData);
+
     //=========================================================================================================
     /**
      * Restarts the thread by interrupting its computation queue, quitting, waiting and then starting it again.
@@ -437,12 +478,22 @@ protected:
     void handleResults(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                        const QStringList& lResponsibleTriggerTypes);
 
+    //=========================================================================================================
+    /**
+     * Handles the standard error results.
+     */
+    void handleStdErrResults(const FIFFLIB::FiffEvokedSet& evokedStimSetStdErr,
+                             const QStringList& lResponsibleTriggerTypes);
+
     QThread             m_workerThread;         /**< The worker thread. */
 
 signals:
     void evokedStim(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                     const QStringList& lResponsibleTriggerTypes);
+    void evokedStimStdErr(const FIFFLIB::FiffEvokedSet& evokedStimSetStdErr,
+                          const QStringList& lResponsibleTriggerTypes);
     void operate(const Eigen::MatrixXd& matData);
+    void operateOnBlock(const QSharedPointer<const Eigen::MatrixXd>& pMatData);
     void averageNumberChanged(qint32 numAve);
     void averagePreStimChanged(qint32 samples,
                                qint32 secs);
@@ -476,4 +527,11 @@ inline bool RtAveragingWorker::controlValuesChanged()
 }
 } // NAMESPACE
 
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#ifndef metatype_sharedconstmatrix
+#define metatype_sharedconstmatrix
+Q_DECLARE_METATYPE(QSharedPointer<const Eigen::MatrixXd>); /**< Provides QT META type declaration of the QSharedPointer<const Eigen::MatrixXd> type. For signal/slot usage.*/
+#endif
+#endif
+
 #endif // RTAVERAGING_RTPROCESSING_H
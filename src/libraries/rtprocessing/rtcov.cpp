@@ -62,6 +62,10 @@ using namespace Eigen;
 RtCov::RtCov(QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo)
 : m_fiffInfo(*pFiffInfo)
 , m_iSamples(0)
+, m_bIncremental(false)
+, m_dForgettingFactor(1.0)
+, m_dWeight(0.0)
+, m_dWeightSquared(0.0)
 {
 }
 
@@ -75,6 +79,10 @@ FiffCov RtCov::estimateCovariance(const Eigen::MatrixXd& matData,
         return FiffCov();
     }
 
+    if(m_bIncremental) {
+        return estimateCovarianceIncremental(matData, iNewMaxSamples);
+    }
+
     m_lData.append(matData);
     m_iSamples += matData.cols();
 
@@ -90,57 +98,181 @@ FiffCov RtCov::estimateCovariance(const Eigen::MatrixXd& matData,
 
     RtCovComputeResult finalResult = result.result();
 
-    //Final computation
-    FiffCov computedCov;
-    computedCov.data = finalResult.matData;
+    FiffCov computedCov = finalizeCovariance(finalResult.mu,
+                                             finalResult.matData,
+                                             m_iSamples,
+                                             m_iSamples);
 
-    QStringList exclude;
-    for(int i = 0; i<m_fiffInfo.chs.size(); i++) {
-        if(m_fiffInfo.chs.at(i).kind != FIFFV_MEG_CH &&
-           m_fiffInfo.chs.at(i).kind != FIFFV_EEG_CH) {
-            exclude << m_fiffInfo.chs.at(i).ch_name;
-        }
+    m_lData.clear();
+    m_iSamples = 0;
+
+    return computedCov;
+}
+
+//=============================================================================================================
+
+void RtCov::setIncrementalMode(bool bIncremental,
+                               double dForgettingFactor)
+{
+    if(dForgettingFactor <= 0.0 || dForgettingFactor > 1.0) {
+        qWarning() << "[RtCov::setIncrementalMode] Forgetting factor" << dForgettingFactor << "is not in (0,1]. Using 1.0.";
+        dForgettingFactor = 1.0;
     }
-    bool doProj = true;
 
-    if(m_iSamples > 0) {
-        finalResult.mu /= (float)m_iSamples;
-        computedCov.data.array() -= m_iSamples * (finalResult.mu * finalResult.mu.transpose()).array();
-        computedCov.data.array() /= (m_iSamples - 1);
+    m_bIncremental = bIncremental;
+    m_dForgettingFactor = dForgettingFactor;
 
-        computedCov.kind = FIFFV_MNE_NOISE_COV;
-        computedCov.diag = false;
-        computedCov.dim = computedCov.data.rows();
+    reset();
+}
 
-        //ToDo do picks
-        computedCov.names = m_fiffInfo.ch_names;
-        computedCov.projs = m_fiffInfo.projs;
-        computedCov.bads = m_fiffInfo.bads;
-        computedCov.nfree = m_iSamples;
+//=============================================================================================================
 
-        // regularize noise covariance
-        computedCov = computedCov.regularize(m_fiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
+bool RtCov::isIncrementalMode() const
+{
+    return m_bIncremental;
+}
 
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
+//=============================================================================================================
 
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
+double RtCov::getForgettingFactor() const
+{
+    return m_dForgettingFactor;
+}
 
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
+//=============================================================================================================
+
+void RtCov::reset()
+{
+    m_lData.clear();
+    m_iSamples = 0;
 
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
+    m_vecSum.resize(0);
+    m_matOuterSum.resize(0,0);
+    m_dWeight = 0.0;
+    m_dWeightSquared = 0.0;
+}
 
-        m_lData.clear();
+//=============================================================================================================
+
+FiffCov RtCov::estimateCovarianceIncremental(const MatrixXd& matData,
+                                             int iNewMaxSamples)
+{
+    const int iNumCols = matData.cols();
+
+    if(iNumCols == 0) {
+        return FiffCov();
+    }
+
+    if(m_matOuterSum.rows() != matData.rows()) {
+        if(m_matOuterSum.size() != 0) {
+            qWarning() << "[RtCov::estimateCovarianceIncremental] Number of channels changed. Resetting accumulators.";
+        }
         m_iSamples = 0;
+        m_vecSum = VectorXd::Zero(matData.rows());
+        m_matOuterSum = MatrixXd::Zero(matData.rows(), matData.rows());
+        m_dWeight = 0.0;
+        m_dWeightSquared = 0.0;
+    }
 
-        return computedCov;
+    if(m_dForgettingFactor >= 1.0) {
+        // Only the lower triangle is updated, the upper one is filled in when publishing
+        m_vecSum += matData.rowwise().sum();
+        m_matOuterSum.selfadjointView<Lower>().rankUpdate(matData);
+        m_dWeight += iNumCols;
+        m_dWeightSquared += iNumCols;
     } else {
-        qWarning() << "[RtCov::estimateCovariance] Number of samples equals zero. Regularization not possible. Returning empty covariance estimation.";
+        // The newest sample gets weight 1, each older sample is down weighted by the forgetting factor
+        VectorXd vecWeights(iNumCols);
+        double dWeight = 1.0;
+        for(int j = iNumCols - 1; j >= 0; --j) {
+            vecWeights(j) = dWeight;
+            dWeight *= m_dForgettingFactor;
+        }
+        // dWeight now equals forgettingFactor^iNumCols, which is the decay of the already accumulated samples
+        m_vecSum *= dWeight;
+        m_matOuterSum.triangularView<Lower>() *= dWeight;
+        m_dWeight *= dWeight;
+        m_dWeightSquared *= dWeight * dWeight;
+
+        m_vecSum.noalias() += matData * vecWeights;
+        m_matOuterSum.selfadjointView<Lower>().rankUpdate(matData * vecWeights.cwiseSqrt().asDiagonal());
+        m_dWeight += vecWeights.sum();
+        m_dWeightSquared += vecWeights.squaredNorm();
+    }
+
+    m_iSamples += iNumCols;
+
+    if(m_iSamples < iNewMaxSamples) {
         return FiffCov();
     }
 
+    FiffCov computedCov = finalizeCovariance(m_vecSum,
+                                             m_matOuterSum,
+                                             m_dWeight,
+                                             m_dWeightSquared,
+                                             true);
+
+    m_iSamples = 0;
+
+    if(m_dForgettingFactor >= 1.0) {
+        m_vecSum.setZero();
+        m_matOuterSum.setZero();
+        m_dWeight = 0.0;
+        m_dWeightSquared = 0.0;
+    }
+
+    return computedCov;
+}
+
+//=============================================================================================================
+
+FiffCov RtCov::finalizeCovariance(const VectorXd& vecSum,
+                                  const MatrixXd& matOuterSum,
+                                  double dWeight,
+                                  double dWeightSquared,
+                                  bool bLowerOnly)
+{
+    // Unbiased estimate for (reliability) weighted samples. Reduces to n-1 for unit weights.
+    double dNorm = dWeight > 0.0 ? dWeight - dWeightSquared / dWeight : 0.0;
+
+    if(dNorm <= 0.0) {
+        qWarning() << "[RtCov::finalizeCovariance] Number of samples too small. Regularization not possible. Returning empty covariance estimation.";
+        return FiffCov();
+    }
+
+    FiffCov computedCov;
+    if(bLowerOnly) {
+        computedCov.data = matOuterSum.selfadjointView<Lower>();
+    } else {
+        computedCov.data = matOuterSum;
+    }
+
+    VectorXd mu = vecSum / dWeight;
+    computedCov.data.noalias() -= dWeight * (mu * mu.transpose());
+    computedCov.data /= dNorm;
+
+    QStringList exclude;
+    for(int i = 0; i<m_fiffInfo.chs.size(); i++) {
+        if(m_fiffInfo.chs.at(i).kind != FIFFV_MEG_CH &&
+           m_fiffInfo.chs.at(i).kind != FIFFV_EEG_CH) {
+            exclude << m_fiffInfo.chs.at(i).ch_name;
+        }
+    }
+    bool doProj = true;
+
+    computedCov.kind = FIFFV_MNE_NOISE_COV;
+    computedCov.diag = false;
+    computedCov.dim = computedCov.data.rows();
+
+    //ToDo do picks
+    computedCov.names = m_fiffInfo.ch_names;
+    computedCov.projs = m_fiffInfo.projs;
+    computedCov.bads = m_fiffInfo.bads;
+    // Effective number of samples (Kish), equals the number of samples for unit weights
+    computedCov.nfree = qRound(dWeight * dWeight / dWeightSquared);
+
+    // regularize noise covariance
+    return computedCov.regularize(m_fiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
 }
 
 //=============================================================================================================
@@ -104,7 +104,78 @@ public:
     FIFFLIB::FiffCov estimateCovariance(const Eigen::MatrixXd& matData,
                                         int iNewMaxSamples);
 
+    //=========================================================================================================
+    /**
+     * Switches between the batch mode (default), which stores all blocks until iNewMaxSamples is reached, and
+     * the incremental mode, which folds every incoming block into running sum and outer-product accumulators.
+     * In incremental mode the memory stays O(nchan^2) and the work is spread evenly across the blocks.
+     * A forgetting factor smaller than 1 exponentially down weights older samples (per sample). In that case the
+     * accumulators are kept after a covariance was published, so that every published estimate reflects the
+     * exponentially weighted history. With a forgetting factor of 1 the accumulators are cleared after each
+     * publication, which reproduces the batch mode result.
+     * Changing the mode resets all accumulated data.
+     *
+     * @param[in] bIncremental          Whether to use the incremental mode.
+     * @param[in] dForgettingFactor     The per sample forgetting factor in (0,1]. Default is 1.0 (no forgetting).
+     */
+    void setIncrementalMode(bool bIncremental,
+                            double dForgettingFactor = 1.0);
+
+    //=========================================================================================================
+    /**
+     * Returns whether the incremental mode is active.
+     *
+     * @return   True if the incremental mode is active.
+     */
+    bool isIncrementalMode() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the per sample forgetting factor used in incremental mode.
+     *
+     * @return   The forgetting factor.
+     */
+    double getForgettingFactor() const;
+
+    //=========================================================================================================
+    /**
+     * Discards all stored blocks and accumulated sums.
+     */
+    void reset();
+
 protected:
+    //=========================================================================================================
+    /**
+     * Folds a data block into the running accumulators and publishes a covariance estimate once
+     * iNewMaxSamples new samples were accumulated since the last publication.
+     *
+     * @param[in] matData            Data block to add.
+     * @param[in] iNewMaxSamples     Publication cadence in samples.
+     *
+     * @return   The regularized covariance or an empty covariance if no estimate is due.
+     */
+    FIFFLIB::FiffCov estimateCovarianceIncremental(const Eigen::MatrixXd& matData,
+                                                   int iNewMaxSamples);
+
+    //=========================================================================================================
+    /**
+     * Creates the regularized noise covariance from the (weighted) sums.
+     *
+     * @param[in] vecSum             The (weighted) sum over all samples.
+     * @param[in] matOuterSum        The (weighted) sum of the outer products. Only the lower triangle needs to be valid
+     *                               if bLowerOnly is true.
+     * @param[in] dWeight            The sum of the sample weights.
+     * @param[in] dWeightSquared     The sum of the squared sample weights.
+     * @param[in] bLowerOnly         Whether only the lower triangle of matOuterSum is valid.
+     *
+     * @return   The regularized covariance.
+     */
+    FIFFLIB::FiffCov finalizeCovariance(const Eigen::VectorXd& vecSum,
+                                        const Eigen::MatrixXd& matOuterSum,
+                                        double dWeight,
+                                        double dWeightSquared,
+                                        bool bLowerOnly = false);
+
     //=========================================================================================================
     /**
      * Computer multiplication with transposed.
@@ -129,6 +200,13 @@ protected:
     QList<Eigen::MatrixXd>  m_lData;                    /**< The stored data blocks. */
 
     FIFFLIB::FiffInfo       m_fiffInfo;                 /**< Holds the fiff measurement information. */
+
+    bool                    m_bIncremental;             /**< Whether the incremental mode is active. */
+    double                  m_dForgettingFactor;        /**< The per sample forgetting factor of the incremental mode. */
+    double                  m_dWeight;                  /**< The sum of the sample weights of the incremental accumulators. */
+    double                  m_dWeightSquared;           /**< The sum of the squared sample weights of the incremental accumulators. */
+    Eigen::VectorXd         m_vecSum;                   /**< The running (weighted) sum of the samples. */
+    Eigen::MatrixXd         m_matOuterSum;              /**< The running (weighted) sum of the outer products, lower triangle only. */
 };
 
 //=============================================================================================================
@@ -49,6 +49,17 @@
 #include <QPair>
 #include <QSemaphore>
 #include <QSharedPointer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QThread>
+
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <atomic>
+#include <utility>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -284,6 +295,487 @@ inline int CircularBuffer<_Tp>::getFreeElementsWrite()
     return m_pFreeElements->available();
 }
 
+//=============================================================================================================
+/**
+ * TEMPLATE SINGLE PRODUCER SINGLE CONSUMER CIRCULAR BUFFER
+ *
+ * Lock-free counterpart of CircularBuffer for exactly one producer thread and one consumer thread. The read and
+ * write positions are atomics, so try_push and try_pop never enter the kernel. Elements can be moved in and out.
+ * For Eigen matrices, moving out swaps the storage of the popped slot with the caller's matrix, and copying a
+ * matrix of the same size into a slot reuses the slot's storage. Hence, a steady stream of equally sized blocks
+ * does not allocate. The blocking push and pop first spin and only park the thread if the buffer stays
+ * full/empty. The other side wakes a parked thread only if it is actually parked.
+ *
+ * @brief Lock-free single producer single consumer circular buffer.
+ */
+template<typename _Tp>
+class SpscCircularBuffer
+{
+public:
+    typedef QSharedPointer<SpscCircularBuffer> SPtr;              /**< Shared pointer type for SpscCircularBuffer. */
+    typedef QSharedPointer<const SpscCircularBuffer> ConstSPtr;   /**< Const shared pointer type for SpscCircularBuffer. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a SpscCircularBuffer.
+     *
+     * @param[in] uiMaxNumElements length of buffer.
+     */
+    explicit SpscCircularBuffer(unsigned int uiMaxNumElements);
+
+    //=========================================================================================================
+    /**
+     * Destroys the SpscCircularBuffer.
+     */
+    ~SpscCircularBuffer();
+
+    //=========================================================================================================
+    /**
+     * Adds an element at the end of the buffer if there is space. Never blocks. Producer thread only.
+     *
+     * @param[in] newElement the element to copy into the buffer.
+     *
+     * @return true if the element was added, false if the buffer is full.
+     */
+    inline bool try_push(const _Tp& newElement);
+
+    //=========================================================================================================
+    /**
+     * Moves an element to the end of the buffer if there is space. Never blocks. Producer thread only.
+     *
+     * @param[in] newElement the element to move into the buffer. Only moved from if true is returned.
+     *
+     * @return true if the element was added, false if the buffer is full.
+     */
+    inline bool try_push(_Tp&& newElement);
+
+    //=========================================================================================================
+    /**
+     * Moves the first element (first in first out) out of the buffer if there is one. Never blocks. Consumer
+     * thread only.
+     *
+     * @param[out] element the popped element.
+     *
+     * @return true if an element was popped, false if the buffer is empty.
+     */
+    inline bool try_pop(_Tp& element);
+
+    //=========================================================================================================
+    /**
+     * Adds a whole array at the end buffer. Waits for free space (spin, then park) until the timeout. Either all
+     * or none of the elements are added.
+     *
+     * @param[in] pArray pointer to an Array which should be apend to the end.
+     * @param[in] size number of elements containing the array.
+     *
+     * @return false if the timeout was reached or the array is larger than the buffer. No element was added.
+     */
+    inline bool push(const _Tp* pArray, unsigned int size);
+
+    //=========================================================================================================
+    /**
+     * Adds an element at the end of the buffer. Waits for free space (spin, then park) until the timeout.
+     *
+     * @param[in] newElement the element to copy into the buffer.
+     *
+     * @return false if the timeout was reached.
+     */
+    inline bool push(const _Tp& newElement);
+
+    //=========================================================================================================
+    /**
+     * Moves an element to the end of the buffer. Waits for free space (spin, then park) until the timeout.
+     *
+     * @param[in] newElement the element to move into the buffer. Only moved from if true is returned.
+     *
+     * @return false if the timeout was reached.
+     */
+    inline bool push(_Tp&& newElement);
+
+    //=========================================================================================================
+    /**
+     * Moves the first element (first in first out) out of the buffer. Waits for an element (spin, then park)
+     * until the timeout.
+     *
+     * @param[out] element the popped element.
+     *
+     * @return false if the timeout was reached.
+     */
+    inline bool pop(_Tp& element);
+
+    //=========================================================================================================
+    /**
+     * Clears the buffer. Must not be called while the producer or consumer is active.
+     */
+    void clear();
+
+    //=========================================================================================================
+    /**
+     * Pauses the buffer. Skips any incoming elements and pop does not return any. try_push and try_pop are
+     * not affected.
+     */
+    inline void pause(bool);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of elements which can be read.
+     */
+    inline int getFreeElementsRead();
+
+    //=========================================================================================================
+    /**
+     * Returns the number of elements which can be written.
+     */
+    inline int getFreeElementsWrite();
+
+private:
+    //=========================================================================================================
+    /**
+     * Spins for a short while and then parks the calling thread until bReady returns true or the timeout is
+     * reached.
+     *
+     * @param[in] bReady             Returns true once the thread can continue.
+     * @param[in, out] iWaiting      The flag telling the other side that this side is parked.
+     *
+     * @return false if the timeout was reached.
+     */
+    template<typename Func>
+    inline bool wait(Func bReady,
+                     std::atomic<int>& iWaiting);
+
+    //=========================================================================================================
+    /**
+     * Wakes the other side if it is parked. Called after the read or write position moved.
+     *
+     * @param[in] iWaiting      The flag of the other side.
+     */
+    inline void wake(std::atomic<int>& iWaiting);
+
+    //=========================================================================================================
+    /**
+     * Adds an element at the end of the buffer if there is space, without waking the consumer.
+     *
+     * @param[in] newElement the element to copy or move into the buffer. Only moved from if true is returned.
+     *
+     * @return true if the element was added, false if the buffer is full.
+     */
+    template<typename _Up>
+    inline bool pushNoWake(_Up&& newElement);
+
+    //=========================================================================================================
+    /**
+     * Moves the first element out of the buffer if there is one, without waking the producer.
+     *
+     * @param[out] element the popped element.
+     *
+     * @return true if an element was popped, false if the buffer is empty.
+     */
+    inline bool popNoWake(_Tp& element);
+
+    unsigned int                m_uiMaxNumElements;     /**< Holds the maximal number of buffer elements.*/
+    _Tp*                        m_pBuffer;              /**< Holds the circular buffer.*/
+
+    alignas(64) std::atomic<quint64>    m_iReadIndex;   /**< Number of popped elements. Only written by the consumer.*/
+    alignas(64) std::atomic<quint64>    m_iWriteIndex;  /**< Number of pushed elements. Only written by the producer.*/
+
+    alignas(64) std::atomic<int>        m_iConsumerWaiting;     /**< Whether the consumer is parked.*/
+    std::atomic<int>                    m_iProducerWaiting;     /**< Whether the producer is parked.*/
+    QMutex                      m_mutex;                /**< Guards parking, never taken on the fast path.*/
+    QWaitCondition              m_waitCondition;        /**< Parked threads wait here.*/
+
+    int                         m_iTimeout;             /**< Holds the timeout value after which push and pop return false.*/
+    int                         m_iSpinCount;           /**< Number of retries before the thread is parked.*/
+    std::atomic<bool>           m_bPause;
+};
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+template<typename _Tp>
+SpscCircularBuffer<_Tp>::SpscCircularBuffer(unsigned int uiMaxNumElements)
+: m_uiMaxNumElements(uiMaxNumElements)
+, m_pBuffer(new _Tp[m_uiMaxNumElements])
+, m_iReadIndex(0)
+, m_iWriteIndex(0)
+, m_iConsumerWaiting(0)
+, m_iProducerWaiting(0)
+, m_iTimeout(1000)
+, m_iSpinCount(1000)
+, m_bPause(false)
+{
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+SpscCircularBuffer<_Tp>::~SpscCircularBuffer()
+{
+    delete [] m_pBuffer;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool SpscCircularBuffer<_Tp>::try_push(const _Tp& newElement)
+{
+    if(!pushNoWake(newElement)) {
+        return false;
+    }
+
+    wake(m_iConsumerWaiting);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool SpscCircularBuffer<_Tp>::try_push(_Tp&& newElement)
+{
+    if(!pushNoWake(std::move(newElement))) {
+        return false;
+    }
+
+    wake(m_iConsumerWaiting);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool SpscCircularBuffer<_Tp>::try_pop(_Tp& element)
+{
+    if(!popNoWake(element)) {
+        return false;
+    }
+
+    wake(m_iProducerWaiting);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool SpscCircularBuffer<_Tp>::push(const _Tp* pArray, unsigned int size)
+{
+    if(m_bPause.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    if(size > m_uiMaxNumElements) {
+        return false;
+    }
+
+    // Only the producer adds elements, so the free space can only grow while waiting for it
+    auto bSpace = [&]() {
+        return m_uiMaxNumElements - (m_iWriteIndex.load(std::memory_order_relaxed) - m_iReadIndex.load(std::memory_order_acquire)) >= size;
+    };
+
+    if(!bSpace() && !wait(bSpace, m_iProducerWaiting)) {
+        return false;
+    }
+
+    const quint64 iWrite = m_iWriteIndex.load(std::memory_order_relaxed);
+
+    for(unsigned int i = 0; i < size; ++i) {
+        m_pBuffer[(iWrite + i) % m_uiMaxNumElements] = pArray[i];
+    }
+
+    m_iWriteIndex.store(iWrite + size, std::memory_order_seq_cst);
+
+    wake(m_iConsumerWaiting);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool SpscCircularBuffer<_Tp>::push(const _Tp& newElement)
+{
+    if(m_bPause.load(std::memory_order_relaxed) || try_push(newElement)) {
+        return true;
+    }
+
+    if(!wait([&]() { return pushNoWake(newElement); }, m_iProducerWaiting)) {
+        return false;
+    }
+
+    wake(m_iConsumerWaiting);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool SpscCircularBuffer<_Tp>::push(_Tp&& newElement)
+{
+    if(m_bPause.load(std::memory_order_relaxed) || try_push(std::move(newElement))) {
+        return true;
+    }
+
+    if(!wait([&]() { return pushNoWake(std::move(newElement)); }, m_iProducerWaiting)) {
+        return false;
+    }
+
+    wake(m_iConsumerWaiting);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool SpscCircularBuffer<_Tp>::pop(_Tp& element)
+{
+    if(m_bPause.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    if(try_pop(element)) {
+        return true;
+    }
+
+    if(!wait([&]() { return popNoWake(element); }, m_iConsumerWaiting)) {
+        return false;
+    }
+
+    wake(m_iProducerWaiting);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+template<typename Func>
+inline bool SpscCircularBuffer<_Tp>::wait(Func bReady,
+                                          std::atomic<int>& iWaiting)
+{
+    // Spin first, the other side is usually only a few microseconds away
+    for(int i = 0; i < m_iSpinCount; ++i) {
+        if(bReady()) {
+            return true;
+        }
+
+        if(i % 100 == 99) {
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    // Park until woken up by the other side or the timeout is reached. bReady must not wake the other side,
+    // since wake takes m_mutex. The caller wakes the other side after the mutex was released.
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(&m_mutex);
+
+    while(true) {
+        iWaiting.store(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Check again after announcing the wait, so a wake up in between is not lost
+        if(bReady()) {
+            iWaiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        qint64 iRemaining = m_iTimeout - timer.elapsed();
+        if(iRemaining <= 0) {
+            iWaiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_waitCondition.wait(&m_mutex, static_cast<unsigned long>(iRemaining));
+    }
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline void SpscCircularBuffer<_Tp>::wake(std::atomic<int>& iWaiting)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if(iWaiting.load(std::memory_order_seq_cst)) {
+        QMutexLocker locker(&m_mutex);
+        iWaiting.store(0, std::memory_order_relaxed);
+        m_waitCondition.wakeAll();
+    }
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+template<typename _Up>
+inline bool SpscCircularBuffer<_Tp>::pushNoWake(_Up&& newElement)
+{
+    const quint64 iWrite = m_iWriteIndex.load(std::memory_order_relaxed);
+
+    if(iWrite - m_iReadIndex.load(std::memory_order_acquire) >= m_uiMaxNumElements) {
+        return false;
+    }
+
+    m_pBuffer[iWrite % m_uiMaxNumElements] = std::forward<_Up>(newElement);
+    m_iWriteIndex.store(iWrite + 1, std::memory_order_seq_cst);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline bool SpscCircularBuffer<_Tp>::popNoWake(_Tp& element)
+{
+    const quint64 iRead = m_iReadIndex.load(std::memory_order_relaxed);
+
+    if(iRead == m_iWriteIndex.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    element = std::move(m_pBuffer[iRead % m_uiMaxNumElements]);
+    m_iReadIndex.store(iRead + 1, std::memory_order_seq_cst);
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline void SpscCircularBuffer<_Tp>::clear()
+{
+    m_iReadIndex.store(0);
+    m_iWriteIndex.store(0);
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline void SpscCircularBuffer<_Tp>::pause(bool bPause)
+{
+    m_bPause.store(bPause);
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline int SpscCircularBuffer<_Tp>::getFreeElementsRead()
+{
+    return int(m_iWriteIndex.load(std::memory_order_acquire) - m_iReadIndex.load(std::memory_order_acquire));
+}
+
+//=============================================================================================================
+
+template<typename _Tp>
+inline int SpscCircularBuffer<_Tp>::getFreeElementsWrite()
+{
+    return int(m_uiMaxNumElements - getFreeElementsRead());
+}
+
 //=============================================================================================================
 // TYPEDEF
 //=============================================================================================================
@@ -297,6 +789,9 @@ typedef CircularBuffer< QPair<double, double> >  CircularBuffer_pair_double_doub
 typedef CircularBuffer< Eigen::MatrixXd >        CircularBuffer_Matrix_double;       /**< Defines CircularBuffer of Eigen::MatrixXd type.*/
 typedef CircularBuffer< Eigen::MatrixXf >        CircularBuffer_Matrix_float;        /**< Defines CircularBuffer of Eigen::MatrixXf type.*/
 
+typedef SpscCircularBuffer< Eigen::MatrixXd >    SpscCircularBuffer_Matrix_double;   /**< Defines SpscCircularBuffer of Eigen::MatrixXd type.*/
+typedef SpscCircularBuffer< Eigen::MatrixXf >    SpscCircularBuffer_Matrix_float;    /**< Defines SpscCircularBuffer of Eigen::MatrixXf type.*/
+
 } // NAMESPACE
 
 #endif // CIRCULARBUFFER_H
@@ -57,6 +57,9 @@
 #include <QtMath>
 #include <QtConcurrent>
 #include <QVector>
+#include <QCache>
+#include <QMutex>
+#include <QThreadStorage>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -65,6 +68,65 @@
 using namespace UTILSLIB;
 using namespace Eigen;
 
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+/**
+ * Per-thread FFT plans and scratch buffer. Eigen's FFT keeps its plans per transform length, so reusing the same
+ * object in a thread reuses the plans.
+ */
+struct SpectralWorkspace {
+    FFT<double>     fft;            /**< The FFT object holding the plans. */
+    QList<int>      lFftLengths;    /**< The FFT lengths the plans were created for. */
+    RowVectorXd     vecInputFFT;    /**< Zero padded, tapered input. */
+    RowVectorXcd    vecTmpFreq;     /**< Half spectrum output. */
+};
+
+const int s_iMaxFftLengths = 8;     /**< Number of FFT lengths a thread keeps plans for. */
+const int s_iMaxCachedTapers = 16;  /**< Number of taper sets kept in the cache. */
+
+QThreadStorage<SpectralWorkspace*> s_threadWorkspaces;
+
+QMutex s_taperMutex;
+QCache<QPair<int,QString>, QSharedPointer<const QPair<MatrixXd, VectorXd> > > s_taperCache(s_iMaxCachedTapers);
+
+//=============================================================================================================
+
+SpectralWorkspace& threadWorkspace()
+{
+    if(!s_threadWorkspaces.hasLocalData()) {
+        SpectralWorkspace* pWorkspace = new SpectralWorkspace();
+        pWorkspace->fft.SetFlag(pWorkspace->fft.HalfSpectrum);
+        s_threadWorkspaces.setLocalData(pWorkspace);
+    }
+
+    return *s_threadWorkspaces.localData();
+}
+
+//=============================================================================================================
+
+void prepareFft(SpectralWorkspace& workspace,
+                int iNfft)
+{
+    if(workspace.lFftLengths.contains(iNfft)) {
+        return;
+    }
+
+    // The FFT keeps its plans for every length it has seen. Start over instead of growing without bound.
+    if(workspace.lFftLengths.size() >= s_iMaxFftLengths) {
+        workspace.fft = FFT<double>();
+        workspace.fft.SetFlag(workspace.fft.HalfSpectrum);
+        workspace.lFftLengths.clear();
+    }
+
+    workspace.lFftLengths.append(iNfft);
+}
+
+} // namespace
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -74,25 +136,58 @@ MatrixXcd Spectral::computeTaperedSpectraRow(const RowVectorXd &vecData,
                                              int iNfft)
 {
     //qDebug() << "Spectral::computeTaperedSpectra Matrixwise";
-    FFT<double> fft;
-    fft.SetFlag(fft.HalfSpectrum);
+    MatrixXcd matTapSpectrum;
+
+    if(!computeTaperedSpectraRow(vecData,
+                                 matTaper,
+                                 iNfft,
+                                 matTapSpectrum)) {
+        return MatrixXcd();
+    }
 
+    return matTapSpectrum;
+}
+
+//=============================================================================================================
+
+bool Spectral::computeTaperedSpectraRow(const Ref<const RowVectorXd, 0, InnerStride<> > &vecData,
+                                        const MatrixXd &matTaper,
+                                        int iNfft,
+                                        MatrixXcd &matTapSpectrum)
+{
     //Check inputs
     if (vecData.cols() != matTaper.cols() || iNfft < vecData.cols()) {
-        return MatrixXcd();
+        return false;
+    }
+
+    SpectralWorkspace& workspace = threadWorkspace();
+    prepareFft(workspace, iNfft);
+
+    // Zero pad once, only the first vecData.cols() samples are overwritten per taper
+    if(workspace.vecInputFFT.cols() != iNfft) {
+        workspace.vecInputFFT.setZero(iNfft);
+    } else {
+        workspace.vecInputFFT.tail(iNfft - vecData.cols()).setZero();
+    }
+
+    int iNFreqs = int(floor(iNfft / 2.0)) + 1;
+    if(matTapSpectrum.rows() != matTaper.rows() || matTapSpectrum.cols() != iNFreqs) {
+        matTapSpectrum.resize(matTaper.rows(), iNFreqs);
     }
 
     //FFT for freq domain returning the half spectrum
-    RowVectorXd vecInputFFT;
-    RowVectorXcd vecTmpFreq;
-    MatrixXcd matTapSpectrum(matTaper.rows(), int(floor(iNfft / 2.0)) + 1);
-    for (int i=0; i < matTaper.rows(); i++) {
-        vecInputFFT = vecData.cwiseProduct(matTaper.row(i));
-        fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
+    RowVectorXcd& vecTmpFreq = workspace.vecTmpFreq;
+    if(vecTmpFreq.cols() != iNFreqs) {
+        vecTmpFreq.resize(iNFreqs);
+    }
+
+    for (int i = 0; i < matTaper.rows(); i++) {
+        workspace.vecInputFFT.head(vecData.cols()) = vecData.cwiseProduct(matTaper.row(i));
+        workspace.fft.fwd(vecTmpFreq.data(), workspace.vecInputFFT.data(), iNfft);
         matTapSpectrum.row(i) = vecTmpFreq;
     }
 
-    return matTapSpectrum;
+    return true;
 }
 
 //=============================================================================================================
@@ -106,61 +201,36 @@ QVector<MatrixXcd> Spectral::computeTaperedSpectraMatrix(const MatrixXd &matData
         fftw_make_planner_thread_safe();
     #endif
 
-    QVector<MatrixXcd> finalResult;
+    QVector<MatrixXcd> finalResult(matData.rows());
+
+    // Each row is written into its own preallocated result. The FFT plans and scratch buffers are kept per thread.
+    MatrixXcd* pResult = finalResult.data();
 
     if(!bUseThreads) {
         // Sequential
-//        QElapsedTimer timer;
-//        int iTime = 0;
-//        int iTimeAll = 0;
-//        timer.start();
-
-        FFT<double> fft;
-        fft.SetFlag(fft.HalfSpectrum);
-
-        RowVectorXd vecInputFFT, rowData;
-        RowVectorXcd vecTmpFreq;
-
-        MatrixXcd matTapSpectrum(matTaper.rows(), int(floor(iNfft / 2.0)) + 1);
-        int j;
         for (int i = 0; i < matData.rows(); ++i) {
-            rowData = matData.row(i);
-
-            //FFT for freq domain returning the half spectrum
-            for (j = 0; j < matTaper.rows(); j++) {
-                vecInputFFT = rowData.cwiseProduct(matTaper.row(j));
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq;
-            }
-
-            finalResult.append(matTapSpectrum);
-
-//            iTime = timer.elapsed();
-//            qDebug() << QThread::currentThreadId() << "Spectral::computeTaperedSpectraMatrix - Row-wise computation:" << iTime;
-//            iTimeAll += iTime;
-//            timer.restart();
+            computeTaperedSpectraRow(matData.row(i),
+                                     matTaper,
+                                     iNfft,
+                                     pResult[i]);
         }
-
-//        qDebug() << QThread::currentThreadId() << "Spectral::computeTaperedSpectraMatrix - Complete computation:" << iTimeAll;
     } else {
         // Parallel
-        QList<TaperedSpectraInputData> lData;
-        TaperedSpectraInputData dataTemp;
-        dataTemp.matTaper = matTaper;
-        dataTemp.iNfft = iNfft;
-
+        QVector<int> vecRows(matData.rows());
         for (int i = 0; i < matData.rows(); ++i) {
-            dataTemp.vecData = matData.row(i);
-
-            lData.append(dataTemp);
+            vecRows[i] = i;
         }
 
-        QFuture<QVector<MatrixXcd> > result = QtConcurrent::mappedReduced(lData,
-                                                                          compute,
-                                                                          reduce,
-                                                                          QtConcurrent::OrderedReduce);
+        std::function<void(int&)> computeLambda = [&](int& iRow) {
+            computeTaperedSpectraRow(matData.row(iRow),
+                                     matTaper,
+                                     iNfft,
+                                     pResult[iRow]);
+        };
+
+        QFuture<void> result = QtConcurrent::map(vecRows,
+                                                 computeLambda);
         result.waitForFinished();
-        finalResult = result.result();
     }
 
     return finalResult;
@@ -200,23 +270,52 @@ Eigen::RowVectorXd Spectral::psdFromTaperedSpectra(const Eigen::MatrixXcd &matTa
                                                    int iNfft,
                                                    double dSampFreq)
 {
-    //Check inputs
-    if (matTapSpectrum.rows() != vecTapWeights.rows()) {
+    Eigen::RowVectorXd vecPsd;
+
+    if(!psdFromTaperedSpectra(matTapSpectrum,
+                              vecTapWeights,
+                              iNfft,
+                              dSampFreq,
+                              vecPsd)) {
         return Eigen::RowVectorXd();
     }
 
+    return vecPsd;
+}
+
+//=============================================================================================================
+
+bool Spectral::psdFromTaperedSpectra(const Eigen::MatrixXcd &matTapSpectrum,
+                                     const Eigen::VectorXd &vecTapWeights,
+                                     int iNfft,
+                                     double dSampFreq,
+                                     Eigen::RowVectorXd &vecPsd)
+{
+    //Check inputs
+    if (matTapSpectrum.rows() != vecTapWeights.rows() || matTapSpectrum.cols() == 0) {
+        return false;
+    }
+
     //Compute PSD (average over tapers if necessary)
     //Normalization via sFreq
     //multiply by 2 due to half spectrum
     double denom = vecTapWeights.cwiseAbs2().sum() * dSampFreq;
-    Eigen::RowVectorXd vecPsd = 2.0 * (vecTapWeights.asDiagonal() * matTapSpectrum).cwiseAbs2().colwise().sum() / denom;
+
+    if(vecPsd.cols() != matTapSpectrum.cols()) {
+        vecPsd.resize(matTapSpectrum.cols());
+    }
+    vecPsd.setZero();
+
+    for (int i = 0; i < matTapSpectrum.rows(); ++i) {
+        vecPsd += (2.0 * vecTapWeights(i) * vecTapWeights(i) / denom) * matTapSpectrum.row(i).cwiseAbs2();
+    }
 
     vecPsd(0) /= 2.0;
     if (iNfft % 2 == 0){
         vecPsd.tail(1) /= 2.0;
     }
 
-    return vecPsd;
+    return true;
 }
 
 //=============================================================================================================
@@ -228,49 +327,66 @@ Eigen::RowVectorXcd Spectral::csdFromTaperedSpectra(const Eigen::MatrixXcd &vecT
                                                     int iNfft,
                                                     double dSampFreq)
 {
-//    QElapsedTimer timer;
-//    int iTime = 0;
-//    timer.start();
+    Eigen::RowVectorXcd vecCsd;
+
+    if(!csdFromTaperedSpectra(vecTapSpectrumSeed,
+                              vecTapSpectrumTarget,
+                              vecTapWeightsSeed,
+                              vecTapWeightsTarget,
+                              iNfft,
+                              dSampFreq,
+                              vecCsd)) {
+        return Eigen::MatrixXcd();
+    }
+
+    return vecCsd;
+}
+
+//=============================================================================================================
 
+bool Spectral::csdFromTaperedSpectra(const Eigen::MatrixXcd &vecTapSpectrumSeed,
+                                     const Eigen::MatrixXcd &vecTapSpectrumTarget,
+                                     const Eigen::VectorXd &vecTapWeightsSeed,
+                                     const Eigen::VectorXd &vecTapWeightsTarget,
+                                     int iNfft,
+                                     double dSampFreq,
+                                     Eigen::RowVectorXcd &vecCsd)
+{
     //Check inputs
     if (vecTapSpectrumSeed.rows() != vecTapSpectrumTarget.rows()) {
-        return Eigen::MatrixXcd();
+        return false;
     }
-    if (vecTapSpectrumSeed.cols() != vecTapSpectrumTarget.cols()) {
-        return Eigen::MatrixXcd();
+    if (vecTapSpectrumSeed.cols() != vecTapSpectrumTarget.cols() || vecTapSpectrumSeed.cols() == 0) {
+        return false;
     }
     if (vecTapSpectrumSeed.rows() != vecTapWeightsSeed.rows()) {
-        return Eigen::MatrixXcd();
+        return false;
     }
     if (vecTapSpectrumTarget.rows() != vecTapWeightsTarget.rows()) {
-        return Eigen::MatrixXcd();
+        return false;
     }
 
-//    iTime = timer.elapsed();
-//    qDebug() << QThread::currentThreadId() << "Spectral::csdFromTaperedSpectra timer - Prepare:" << iTime;
-//    timer.restart();
-
-    // Compute PSD (average over tapers if necessary)
+    // Compute CSD (average over tapers if necessary)
     // Multiply by 2 due to half spectrum
     // Normalize via sFreq
     double denom = sqrt(vecTapWeightsSeed.cwiseAbs2().sum()) * sqrt(vecTapWeightsTarget.cwiseAbs2().sum()) * dSampFreq;
-    Eigen::RowVectorXcd vecCsd = 2.0 * (vecTapWeightsSeed.asDiagonal() * vecTapSpectrumSeed).cwiseProduct((vecTapWeightsTarget.asDiagonal() * vecTapSpectrumTarget).conjugate()).colwise().sum() / denom;
 
-//    iTime = timer.elapsed();
-//    qDebug() << QThread::currentThreadId() << "Spectral::csdFromTaperedSpectra timer - compute PSD:" << iTime;
-//    timer.restart();
+    if(vecCsd.cols() != vecTapSpectrumSeed.cols()) {
+        vecCsd.resize(vecTapSpectrumSeed.cols());
+    }
+    vecCsd.setZero();
+
+    for (int i = 0; i < vecTapSpectrumSeed.rows(); ++i) {
+        vecCsd += (2.0 * vecTapWeightsSeed(i) * vecTapWeightsTarget(i) / denom) * vecTapSpectrumSeed.row(i).cwiseProduct(vecTapSpectrumTarget.row(i).conjugate());
+    }
 
-    //multiply first and last element by 2 due to half spectrum
+    //divide first and last element by 2 due to half spectrum
     vecCsd(0) /= 2.0;
     if (iNfft % 2 == 0){
         vecCsd.tail(1) /= 2.0;
     }
 
-//    iTime = timer.elapsed();
-//    qDebug() << QThread::currentThreadId() << "Spectral::csdFromTaperedSpectra timer - half spectrum:" << iTime;
-//    timer.restart();
-
-    return vecCsd;
+    return true;
 }
 
 //=============================================================================================================
@@ -291,25 +407,51 @@ VectorXd Spectral::calculateFFTFreqs(int iNfft, double dSampFreq)
 
 QPair<MatrixXd, VectorXd> Spectral::generateTapers(int iSignalLength, const QString &sWindowType)
 {
-    QPair<MatrixXd, VectorXd> pairOut;
-    if (sWindowType == "hanning") {
-        pairOut.first = hanningWindow(iSignalLength);
-        pairOut.second = VectorXd::Ones(1);
-    } else if (sWindowType == "ones") {
-        pairOut.first = MatrixXd::Ones(1, iSignalLength) / double(iSignalLength);
-        pairOut.second = VectorXd::Ones(1);
-    } else {
-        pairOut.first = hanningWindow(iSignalLength);
-        pairOut.second = VectorXd::Ones(1);
-    }
-    return pairOut;
+    return *getTapers(iSignalLength, sWindowType);
 }
 
 //=============================================================================================================
 
 std::pair<MatrixXd, VectorXd> Spectral::generateTapers(int iSignalLength, const std::string &sWindowType)
 {
-    std::pair<MatrixXd, VectorXd> pairOut;
+    QSharedPointer<const QPair<MatrixXd, VectorXd> > pTapers = getTapers(iSignalLength, QString::fromStdString(sWindowType));
+
+    return std::make_pair(pTapers->first, pTapers->second);
+}
+
+//=============================================================================================================
+
+QSharedPointer<const QPair<MatrixXd, VectorXd> > Spectral::getTapers(int iSignalLength, const QString &sWindowType)
+{
+    QPair<int,QString> key(iSignalLength, sWindowType);
+
+    QMutexLocker locker(&s_taperMutex);
+
+    // The cache drops the least recently used tapers. Callers still holding them keep their copy alive.
+    if(QSharedPointer<const QPair<MatrixXd, VectorXd> >* pCached = s_taperCache.object(key)) {
+        return *pCached;
+    }
+
+    QSharedPointer<const QPair<MatrixXd, VectorXd> > pTapers(new QPair<MatrixXd, VectorXd>(computeTapers(iSignalLength, sWindowType)));
+    s_taperCache.insert(key, new QSharedPointer<const QPair<MatrixXd, VectorXd> >(pTapers));
+
+    return pTapers;
+}
+
+//=============================================================================================================
+
+void Spectral::clearTaperCache()
+{
+    QMutexLocker locker(&s_taperMutex);
+
+    s_taperCache.clear();
+}
+
+//=============================================================================================================
+
+QPair<MatrixXd, VectorXd> Spectral::computeTapers(int iSignalLength, const QString &sWindowType)
+{
+    QPair<MatrixXd, VectorXd> pairOut;
     if (sWindowType == "hanning") {
         pairOut.first = hanningWindow(iSignalLength);
         pairOut.second = VectorXd::Ones(1);
@@ -106,6 +106,23 @@ public:
                                                      const Eigen::MatrixXd &matTaper,
                                                      int iNfft);
 
+    //=========================================================================================================
+    /**
+     * Calculates the full tapered spectra of a given input row data into an existing matrix. The FFT plans and
+     * scratch buffers of the calling thread are reused, so repeated calls with the same sizes do not allocate.
+     *
+     * @param[in] vecData           input row data (time domain), for which the spectrum is computed.
+     * @param[in] matTaper          tapers used to compute the spectra.
+     * @param[in] iNfft             FFT length.
+     * @param[out] matTapSpectrum   tapered spectra of the input data. Only resized if the dimensions change.
+     *
+     * @return Returns false if the input dimensions do not match.
+     */
+    static bool computeTaperedSpectraRow(const Eigen::Ref<const Eigen::RowVectorXd, 0, Eigen::InnerStride<> > &vecData,
+                                         const Eigen::MatrixXd &matTaper,
+                                         int iNfft,
+                                         Eigen::MatrixXcd &matTapSpectrum);
+
     //=========================================================================================================
     /**
      * Calculates the full tapered spectra of a given input matrix data. This function calculates each row in parallel.
@@ -184,6 +201,25 @@ public:
                                                     int iNfft,
                                                     double dSampFreq=1.0);
 
+    //=========================================================================================================
+    /**
+     * Calculates the power spectral density of given tapered spectrum into an existing vector without
+     * allocating temporaries.
+     *
+     * @param[in] matTapSpectrum    tapered spectrum, for which the PSD is calculated.
+     * @param[in] vecTapWeights     taper weights.
+     * @param[in] iNfft             FFT length.
+     * @param[in] dSampFreq         sampling frequency of the input data.
+     * @param[out] vecPsd           power spectral density. Only resized if the dimensions change.
+     *
+     * @return Returns false if the input dimensions do not match.
+     */
+    static bool psdFromTaperedSpectra(const Eigen::MatrixXcd &matTapSpectrum,
+                                      const Eigen::VectorXd &vecTapWeights,
+                                      int iNfft,
+                                      double dSampFreq,
+                                      Eigen::RowVectorXd &vecPsd);
+
     //=========================================================================================================
     /**
      * Calculates the cross-spectral density of the tapered spectra of seed and target
@@ -204,6 +240,29 @@ public:
                                                      int iNfft,
                                                      double dSampFreq = 1.0);
 
+    //=========================================================================================================
+    /**
+     * Calculates the cross-spectral density of the tapered spectra of seed and target into an existing vector
+     * without allocating temporaries.
+     *
+     * @param[in] vecTapSpectrumSeed      tapered spectrum of the seed.
+     * @param[in] vecTapSpectrumTarget    tapered spectrum of the target.
+     * @param[in] vecTapWeightsSeed       taper weights of the seed.
+     * @param[in] vecTapWeightsTarget     taper weights of the target.
+     * @param[in] iNfft                   FFT length.
+     * @param[in] dSampFreq               sampling frequency of the input data.
+     * @param[out] vecCsd                 cross-spectral density. Only resized if the dimensions change.
+     *
+     * @return Returns false if the input dimensions do not match.
+     */
+    static bool csdFromTaperedSpectra(const Eigen::MatrixXcd &vecTapSpectrumSeed,
+                                      const Eigen::MatrixXcd &vecTapSpectrumTarget,
+                                      const Eigen::VectorXd &vecTapWeightsSeed,
+                                      const Eigen::VectorXd &vecTapWeightsTarget,
+                                      int iNfft,
+                                      double dSampFreq,
+                                      Eigen::RowVectorXcd &vecCsd);
+
     //=========================================================================================================
     /**
      * Calculates the FFT frequencies
@@ -239,6 +298,26 @@ public:
     static std::pair<Eigen::MatrixXd, Eigen::VectorXd> generateTapers(int iSignalLength,
                                                                   const std::string &sWindowType = "hanning");
 
+    //=========================================================================================================
+    /**
+     * Returns the tapers of given length and window type. The tapers are computed once per length and window
+     * type and shared afterwards. In contrast to generateTapers no copy is made. Only the most recently used
+     * tapers are kept, older ones are computed again when requested.
+     *
+     * @param[in] iSignalLength    length of the tapers.
+     * @param[in] sWindowType      type of the window function used to compute tapered spectra.
+     *
+     * @return The shared pair of tapers and taper weights.
+     */
+    static QSharedPointer<const QPair<Eigen::MatrixXd, Eigen::VectorXd> > getTapers(int iSignalLength,
+                                                                                    const QString &sWindowType = "hanning");
+
+    //=========================================================================================================
+    /**
+     * Drops the cached tapers. The FFT plans and scratch buffers are kept per thread and freed with the thread.
+     */
+    static void clearTaperCache();
+
 private:
     //=========================================================================================================
     /**
@@ -249,6 +328,18 @@ private:
      * @return hanning window.
      */
     static Eigen::MatrixXd hanningWindow(int iSignalLength);
+
+    //=========================================================================================================
+    /**
+     * Computes the tapers of given length and window type without caching.
+     *
+     * @param[in] iSignalLength    length of the tapers.
+     * @param[in] sWindowType      type of the window function used to compute tapered spectra.
+     *
+     * @return Qpair of tapers and taper weights.
+     */
+    static QPair<Eigen::MatrixXd, Eigen::VectorXd> computeTapers(int iSignalLength,
+                                                                 const QString &sWindowType);
 };
 
 //=============================================================================================================
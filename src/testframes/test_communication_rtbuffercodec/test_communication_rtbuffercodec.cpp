@@ -0,0 +1,217 @@
+//=============================================================================================================
+/**
+ * @file     test_communication_rtbuffercodec.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Test for the lossless raw buffer codec of the real-time protocol.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <communication/rtClient/rtbuffercodec.h>
+
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QDebug>
+#include <QTest>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace COMMUNICATIONLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtBufferCodec
+ *
+ * @brief The TestRtBufferCodec class verifies that raw buffers are restored bitwise and compressed
+ *
+ */
+
+class TestRtBufferCodec : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testLosslessRoundTrip();
+    void testCompressionRatio();
+    void testFloatChannels();
+    void testCalibrationMismatch();
+    void testCorruptBuffer();
+
+private:
+    bool isBitwiseEqual(const MatrixXf& matA, const MatrixXf& matB);
+
+    VectorXd    m_vecCals;
+    MatrixXf    m_matData;
+};
+
+//=============================================================================================================
+
+void TestRtBufferCodec::initTestCase()
+{
+    const int iChannels = 306;
+    const int iSamples = 500;
+
+    // Calibrations as the raw data reader computes them: range * cal in single precision
+    m_vecCals.resize(iChannels);
+    for(int i = 0; i < iChannels; ++i) {
+        float fRange = 1.0f;
+        float fCal = (i % 3 == 0) ? 3.1e-12f : 1.7e-13f;
+        m_vecCals[i] = fRange*fCal;
+    }
+
+    // Calibrated integers: a slow oscillation plus a few DAU noise
+    quint32 iSeed = 42;
+    m_matData.resize(iChannels, iSamples);
+    for(int i = 0; i < iChannels; ++i) {
+        for(int j = 0; j < iSamples; ++j) {
+            iSeed = iSeed * 1664525u + 1013904223u;
+            int iDau = static_cast<int>(1500.0 * std::sin(0.02 * j * (1 + i % 5))) + static_cast<int>((iSeed >> 16) % 21) - 10;
+            m_matData(i,j) = static_cast<float>(static_cast<double>(iDau) * m_vecCals[i]);
+        }
+    }
+
+    // A processed channel which is no calibrated integer, and special values
+    for(int j = 0; j < iSamples; ++j) {
+        m_matData(5,j) = static_cast<float>(std::sin(0.1 * j)) * 1.234567e-12f;
+    }
+    m_matData(7,3) = -0.0f;
+    m_matData(8,4) = std::numeric_limits<float>::quiet_NaN();
+    m_matData(9,5) = std::numeric_limits<float>::infinity();
+}
+
+//=============================================================================================================
+
+void TestRtBufferCodec::testLosslessRoundTrip()
+{
+    RtBufferCodec encoder(m_vecCals);
+    RtBufferCodec decoder(m_vecCals);
+
+    QByteArray baEncoded = encoder.encode(m_matData);
+
+    MatrixXf matDecoded;
+    QVERIFY(decoder.decode(baEncoded, matDecoded));
+    QVERIFY(isBitwiseEqual(m_matData, matDecoded));
+}
+
+//=============================================================================================================
+
+void TestRtBufferCodec::testCompressionRatio()
+{
+    RtBufferCodec codec(m_vecCals);
+
+    QByteArray baEncoded = codec.encode(m_matData);
+    double dRatio = double(m_matData.size() * sizeof(float)) / baEncoded.size();
+
+    qDebug() << "Compression ratio" << dRatio;
+    QVERIFY(dRatio > 2.5);
+}
+
+//=============================================================================================================
+
+void TestRtBufferCodec::testFloatChannels()
+{
+    // Without calibrations every channel is coded as float bit patterns and must still be lossless
+    RtBufferCodec codec;
+
+    QByteArray baEncoded = codec.encode(m_matData);
+
+    MatrixXf matDecoded;
+    QVERIFY(codec.decode(baEncoded, matDecoded));
+    QVERIFY(isBitwiseEqual(m_matData, matDecoded));
+}
+
+//=============================================================================================================
+
+void TestRtBufferCodec::testCalibrationMismatch()
+{
+    RtBufferCodec encoder(m_vecCals);
+
+    VectorXd vecOtherCals = m_vecCals;
+    vecOtherCals[0] *= 2.0;
+    RtBufferCodec decoder(vecOtherCals);
+
+    QVERIFY(encoder.getCalibrationId() != decoder.getCalibrationId());
+
+    MatrixXf matDecoded;
+    QVERIFY(!decoder.decode(encoder.encode(m_matData), matDecoded));
+}
+
+//=============================================================================================================
+
+void TestRtBufferCodec::testCorruptBuffer()
+{
+    RtBufferCodec codec(m_vecCals);
+
+    QByteArray baEncoded = codec.encode(m_matData);
+
+    MatrixXf matDecoded;
+    QVERIFY(!codec.decode(baEncoded.left(baEncoded.size() / 2), matDecoded));
+    QVERIFY(!codec.decode(QByteArray(), matDecoded));
+
+    // Empty buffers are valid
+    QVERIFY(codec.decode(codec.encode(MatrixXf(0,0)), matDecoded));
+    QCOMPARE(matDecoded.size(), Index(0));
+}
+
+//=============================================================================================================
+
+bool TestRtBufferCodec::isBitwiseEqual(const MatrixXf& matA, const MatrixXf& matB)
+{
+    return matA.rows() == matB.rows()
+           && matA.cols() == matB.cols()
+           && memcmp(matA.data(), matB.data(), matA.size() * sizeof(float)) == 0;
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtBufferCodec);
+#include "test_communication_rtbuffercodec.moc"
@@ -0,0 +1,292 @@
+//=============================================================================================================
+/**
+ * @file     test_communication_rtsharedmemoryring.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    test for the shared memory ring of the same-host raw buffer transport.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <communication/rtClient/rtsharedmemoryring.h>
+
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_file.h>
+
+#include <atomic>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QTest>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace COMMUNICATIONLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtSharedMemoryRing
+ *
+ * @brief The TestRtSharedMemoryRing class verifies the handshake flags and the records of the shared memory ring
+ *
+ */
+
+class TestRtSharedMemoryRing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testAttachFlags();
+    void testRoundTrip();
+    void testWrapAndFull();
+    void testReadTimeout();
+    void testProducerConsumer();
+
+private:
+    QString key(const QString& sName) const;
+};
+
+//=============================================================================================================
+
+QString TestRtSharedMemoryRing::key(const QString& sName) const
+{
+    return QString("test_rtsharedmemoryring_%1_%2").arg(QCoreApplication::applicationPid()).arg(sName);
+}
+
+//=============================================================================================================
+
+void TestRtSharedMemoryRing::testAttachFlags()
+{
+    RtSharedMemoryRing reader;
+    QVERIFY(!reader.attach(key("missing")));
+    QVERIFY(!reader.isAttached());
+
+    RtSharedMemoryRing writer;
+    QVERIFY(writer.create(key("flags"), 1024));
+    QVERIFY(writer.isAttached());
+    QVERIFY(writer.isWriterAttached());
+
+    // The writer must not switch a client to the ring before its reader attached
+    QVERIFY(!writer.isReaderAttached());
+    QVERIFY(!writer.isReaderDetached());
+
+    QVERIFY(reader.attach(key("flags")));
+    QVERIFY(reader.isWriterAttached());
+    QVERIFY(writer.isReaderAttached());
+    QVERIFY(!writer.isReaderDetached());
+
+    // Only the writer writes and only the reader reads
+    const float fSample = 1.0f;
+    MatrixXf matData;
+    fiff_int_t kind;
+    QVERIFY(!reader.write(FIFF_DATA_BUFFER, &fSample, 1));
+    QVERIFY(!writer.read(1, matData, kind, 0));
+
+    reader.detach();
+    QVERIFY(!writer.isReaderAttached());
+    QVERIFY(writer.isReaderDetached());
+
+    QVERIFY(reader.attach(key("flags")));
+    writer.detach();
+    QVERIFY(!reader.isWriterAttached());
+}
+
+//=============================================================================================================
+
+void TestRtSharedMemoryRing::testRoundTrip()
+{
+    RtSharedMemoryRing writer;
+    RtSharedMemoryRing reader;
+    QVERIFY(writer.create(key("roundtrip"), 64*1024));
+    QVERIFY(reader.attach(key("roundtrip")));
+
+    const int iNumChannels = 7;
+    QList<MatrixXf> lBuffers;
+    for(int i = 1; i <= 4; ++i) {
+        lBuffers.append(MatrixXf::Random(iNumChannels, 10 * i));
+        QVERIFY(writer.write(FIFF_DATA_BUFFER, lBuffers.last().data(), lBuffers.last().size()));
+    }
+
+    const float fOther = 0.0f;
+    QVERIFY(writer.write(FIFF_MNE_RT_CLIENT_ID, &fOther, 1));
+
+    MatrixXf matData;
+    fiff_int_t kind = -1;
+    for(const MatrixXf& matExpected : lBuffers) {
+        QVERIFY(reader.read(iNumChannels, matData, kind, 0));
+        QCOMPARE(kind, FIFF_DATA_BUFFER);
+        QCOMPARE(matData.rows(), matExpected.rows());
+        QCOMPARE(matData.cols(), matExpected.cols());
+        QVERIFY(matData == matExpected);
+    }
+
+    // Records of other kinds are passed through without touching the data
+    matData.resize(0, 0);
+    QVERIFY(reader.read(iNumChannels, matData, kind, 0));
+    QCOMPARE(kind, FIFF_MNE_RT_CLIENT_ID);
+    QCOMPARE(matData.size(), Index(0));
+
+    QVERIFY(!reader.read(iNumChannels, matData, kind, 0));
+}
+
+//=============================================================================================================
+
+void TestRtSharedMemoryRing::testWrapAndFull()
+{
+    // 16 byte record header plus 2 x 5 samples, i.e. 56 bytes per record and a padding of 32 bytes before a wrap
+    RtSharedMemoryRing writer;
+    RtSharedMemoryRing reader;
+    QVERIFY(writer.create(key("wrap"), 256));
+    QVERIFY(reader.attach(key("wrap")));
+
+    MatrixXf matLarge = MatrixXf::Zero(2, 200);
+    QVERIFY(!writer.write(FIFF_DATA_BUFFER, matLarge.data(), matLarge.size()));
+
+    QList<MatrixXf> lPending;
+    for(int i = 0; i < 4; ++i) {
+        lPending.append(MatrixXf::Random(2, 5));
+        QVERIFY(writer.write(FIFF_DATA_BUFFER, lPending.last().data(), lPending.last().size()));
+    }
+
+    // The fifth record only fits after the wrap, which is occupied by the first record
+    MatrixXf matNext = MatrixXf::Random(2, 5);
+    QVERIFY(!writer.write(FIFF_DATA_BUFFER, matNext.data(), matNext.size()));
+
+    MatrixXf matData;
+    fiff_int_t kind;
+    for(int i = 0; i < 20; ++i) {
+        QVERIFY(reader.read(2, matData, kind, 0));
+        QCOMPARE(kind, FIFF_DATA_BUFFER);
+        QVERIFY(matData == lPending.takeFirst());
+
+        lPending.append(MatrixXf::Random(2, 5));
+        QVERIFY(writer.write(FIFF_DATA_BUFFER, lPending.last().data(), lPending.last().size()));
+    }
+
+    while(!lPending.isEmpty()) {
+        QVERIFY(reader.read(2, matData, kind, 0));
+        QVERIFY(matData == lPending.takeFirst());
+    }
+
+    QVERIFY(!reader.read(2, matData, kind, 0));
+}
+
+//=============================================================================================================
+
+void TestRtSharedMemoryRing::testReadTimeout()
+{
+    RtSharedMemoryRing writer;
+    RtSharedMemoryRing reader;
+    QVERIFY(writer.create(key("timeout"), 1024));
+    QVERIFY(reader.attach(key("timeout")));
+
+    MatrixXf matData;
+    fiff_int_t kind;
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!reader.read(1, matData, kind, 50));
+    QVERIFY(timer.elapsed() >= 50);
+
+    // Records which were written before the writer left are still delivered, then the reader gives up at once
+    const float fSample = 3.0f;
+    QVERIFY(writer.write(FIFF_DATA_BUFFER, &fSample, 1));
+    writer.detach();
+
+    QVERIFY(reader.read(1, matData, kind, 1000));
+    QCOMPARE(matData(0,0), 3.0f);
+
+    timer.restart();
+    QVERIFY(!reader.read(1, matData, kind, 10000));
+    QVERIFY(timer.elapsed() < 5000);
+}
+
+//=============================================================================================================
+
+void TestRtSharedMemoryRing::testProducerConsumer()
+{
+    const int iNumChannels = 4;
+    const int iNumBuffers = 2000;
+
+    RtSharedMemoryRing writer;
+    RtSharedMemoryRing reader;
+    QVERIFY(writer.create(key("threads"), 4096));
+    QVERIFY(reader.attach(key("threads")));
+
+    // Each buffer carries its index, the number of samples varies to exercise the padding at the end of the ring
+    QThread* pProducer = QThread::create([&writer]() {
+        for(int i = 0; i < iNumBuffers; ++i) {
+            MatrixXf matData = MatrixXf::Constant(iNumChannels, 1 + i % 13, float(i));
+            while(!writer.write(FIFF_DATA_BUFFER, matData.data(), matData.size())) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    });
+    pProducer->start();
+
+    MatrixXf matData;
+    fiff_int_t kind;
+    int iNext = 0;
+    while(iNext < iNumBuffers && reader.read(iNumChannels, matData, kind, 5000)) {
+        if(matData.cols() != 1 + iNext % 13 || (matData.array() != float(iNext)).any()) {
+            break;
+        }
+        ++iNext;
+    }
+
+    pProducer->wait();
+    delete pProducer;
+
+    QCOMPARE(iNext, iNumBuffers);
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtSharedMemoryRing)
+#include "test_communication_rtsharedmemoryring.moc"
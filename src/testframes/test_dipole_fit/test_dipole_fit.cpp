@@ -39,6 +39,13 @@
 
 #include <inverse/dipoleFit/dipole_fit_settings.h>
 #include <inverse/dipoleFit/dipole_fit.h>
+#include <inverse/dipoleFit/dipole_fit_data.h>
+#include <inverse/dipoleFit/guess_data.h>
+#include <inverse/c/mne_meas_data.h>
+
+#include <fwd/fwd_eeg_sphere_model.h>
+
+#include <cmath>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -51,6 +58,7 @@
 //=============================================================================================================
 
 using namespace INVERSELIB;
+using namespace FWDLIB;
 
 //=============================================================================================================
 /**
@@ -70,6 +78,8 @@ private slots:
     void initTestCase();
     void dipoleFitSimple();
     void dipoleFitAdvanced();
+    void dipoleFitThreadCount();
+    void dipoleFitBatchGuesses();
     void cleanupTestCase();
 
 private:
@@ -261,6 +271,145 @@ void TestDipoleFit::dipoleFitAdvanced()
 
 //=============================================================================================================
 
+void TestDipoleFit::dipoleFitThreadCount()
+{
+    printf(">>>>>>>>>>>>>>>>>>>>>>>>> Dipole Fit Thread Count >>>>>>>>>>>>>>>>>>>>>>>>>\n");
+
+    //Same MEG and EEG sphere model fit as dipoleFitSimple, once sequentially and once with several threads which
+    //share the sphere model
+    DipoleFitSettings settings;
+    QFile testFile(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif"); QVERIFY( testFile.exists() );
+    settings.measname = testFile.fileName();
+    settings.is_raw = false;
+    settings.setno = 1;
+    settings.include_meg = true;
+    settings.include_eeg = true;
+    settings.tmin = 32.0f/1000.0f;
+    settings.tmax = 148.0f/1000.0f;
+    settings.bmin = -100.0f/1000.0f;
+    settings.bmax = 0.0f/1000.0f;
+    settings.dipname = QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/Result/dip_fit.dat";
+
+    settings.checkIntegrity();
+
+    settings.nthread = 1;
+    ECDSet setSequential = DipoleFit(&settings).calculateFit();
+
+    settings.nthread = 4;
+    ECDSet setParallel = DipoleFit(&settings).calculateFit();
+
+    QVERIFY( setSequential.size() > 0 );
+    QCOMPARE( setParallel.size(), setSequential.size() );
+
+    for (int i = 0; i < setSequential.size(); ++i)
+    {
+        QCOMPARE( setParallel[i].valid, setSequential[i].valid );
+        QCOMPARE( setParallel[i].time, setSequential[i].time );
+        QVERIFY( setParallel[i].rd == setSequential[i].rd );
+        QVERIFY( setParallel[i].Q == setSequential[i].Q );
+        QCOMPARE( setParallel[i].good, setSequential[i].good );
+        QCOMPARE( setParallel[i].khi2, setSequential[i].khi2 );
+        QCOMPARE( setParallel[i].nfree, setSequential[i].nfree );
+        QCOMPARE( setParallel[i].neval, setSequential[i].neval );
+    }
+
+    printf("<<<<<<<<<<<<<<<<<<<<<<<<< Dipole Fit Thread Count Finished <<<<<<<<<<<<<<<<<<<<<<<<<\n");
+}
+
+//=============================================================================================================
+
+void TestDipoleFit::dipoleFitBatchGuesses()
+{
+    printf(">>>>>>>>>>>>>>>>>>>>>>>>> Dipole Fit Batch Guesses >>>>>>>>>>>>>>>>>>>>>>>>>\n");
+
+    DipoleFitSettings settings;
+    QFile testFile(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif"); QVERIFY( testFile.exists() );
+    settings.measname = testFile.fileName();
+    settings.is_raw = false;
+    settings.setno = 1;
+    settings.include_meg = true;
+    settings.include_eeg = true;
+    settings.tmin = 32.0f/1000.0f;
+    settings.tmax = 148.0f/1000.0f;
+    settings.bmin = -100.0f/1000.0f;
+    settings.bmax = 0.0f/1000.0f;
+    settings.dipname = QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/Result/dip_fit.dat";
+
+    settings.checkIntegrity();
+
+    FwdEegSphereModel* eeg_model = FwdEegSphereModel::setup_eeg_sphere_model(settings.eeg_model_file,settings.eeg_model_name,settings.eeg_sphere_rad);
+    QVERIFY( eeg_model );
+
+    DipoleFitData* fit_data = DipoleFitData::setup_dipole_fit_data(settings.mriname,
+                                                                   settings.measname,
+                                                                   NULL,
+                                                                   &settings.r0,
+                                                                   eeg_model,
+                                                                   settings.accurate,
+                                                                   settings.badname,
+                                                                   settings.noisename,
+                                                                   settings.grad_std,
+                                                                   settings.mag_std,
+                                                                   settings.eeg_std,
+                                                                   settings.mag_reg,
+                                                                   settings.grad_reg,
+                                                                   settings.eeg_reg,
+                                                                   settings.diagnoise,
+                                                                   settings.projnames,
+                                                                   settings.include_meg,
+                                                                   settings.include_eeg,
+                                                                   settings.bemcachedir);
+    QVERIFY( fit_data );
+
+    MneMeasData* data = MneMeasData::mne_read_meas_data(settings.measname,settings.setno,NULL,NULL,fit_data->ch_names,fit_data->nmeg+fit_data->neeg);
+    QVERIFY( data );
+    data->adjust_baselines(settings.bmin,settings.bmax);
+
+    GuessData* guess = new GuessData(settings.guessname,settings.guess_surfname,settings.guess_mindist,settings.guess_exclude,settings.guess_grid,fit_data);
+    QVERIFY( guess->basis.rows() == fit_data->nmeg+fit_data->neeg );
+
+    //The guesses of all time points are selected with one matrix product
+    ECDSet setBatch;
+    QVERIFY( DipoleFit::fit_dipoles(settings.measname,data,fit_data,guess,settings.tmin,settings.tmax,data->current->tstep,0.0f,0,setBatch,2) == 0 );
+
+    //A guess basis which does not match the guesses makes the batch selection fail after the data were whitened
+    Eigen::MatrixXf basis = guess->basis;
+    guess->basis.conservativeResize(Eigen::NoChange,basis.cols()-3);
+    ECDSet setFallback;
+    QVERIFY( DipoleFit::fit_dipoles(settings.measname,data,fit_data,guess,settings.tmin,settings.tmax,data->current->tstep,0.0f,0,setFallback,2) == 0 );
+
+    //Without a guess basis every time point is fitted on its own by DipoleFitData::fit_one
+    guess->basis.resize(0,0);
+    ECDSet setSingle;
+    QVERIFY( DipoleFit::fit_dipoles(settings.measname,data,fit_data,guess,settings.tmin,settings.tmax,data->current->tstep,0.0f,0,setSingle,2) == 0 );
+    guess->basis = basis;
+
+    QVERIFY( setSingle.size() > 0 );
+    QCOMPARE( setBatch.size(), setSingle.size() );
+    QCOMPARE( setFallback.size(), setSingle.size() );
+
+    for (int i = 0; i < setSingle.size(); ++i)
+    {
+        QCOMPARE( setBatch[i].time, setSingle[i].time );
+        QVERIFY( (setBatch[i].rd - setSingle[i].rd).norm() < 1e-4f );
+        QVERIFY( (setBatch[i].Q - setSingle[i].Q).norm() <= 1e-3f*setSingle[i].Q.norm() );
+        QVERIFY( std::fabs(setBatch[i].good - setSingle[i].good) < 1e-4f );
+
+        QCOMPARE( setFallback[i].time, setSingle[i].time );
+        QVERIFY( (setFallback[i].rd - setSingle[i].rd).norm() < 1e-4f );
+        QVERIFY( (setFallback[i].Q - setSingle[i].Q).norm() <= 1e-3f*setSingle[i].Q.norm() );
+        QVERIFY( std::fabs(setFallback[i].good - setSingle[i].good) < 1e-4f );
+    }
+
+    delete guess;
+    delete data;
+    delete fit_data;
+
+    printf("<<<<<<<<<<<<<<<<<<<<<<<<< Dipole Fit Batch Guesses Finished <<<<<<<<<<<<<<<<<<<<<<<<<\n");
+}
+
+//=============================================================================================================
+
 void TestDipoleFit::compareFit()
 {
     //*********************************************************************************************************
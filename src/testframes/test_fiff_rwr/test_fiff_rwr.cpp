@@ -76,6 +76,7 @@ private slots:
     void compareData();
     void compareTimes();
     void compareInfo();
+    void compareRawReader();
     void cleanupTestCase();
 
 private:
@@ -308,6 +309,51 @@ void TestFiffRWR::compareInfo()
 
 //=============================================================================================================
 
+void TestFiffRWR::compareRawReader()
+{
+    FiffRawReader reader(rawFirstInRaw);
+
+    QVERIFY( reader.findBuffer(rawFirstInRaw.first_samp - 1) == -1 );
+    QVERIFY( reader.findBuffer(rawFirstInRaw.first_samp) == 0 );
+    QVERIFY( reader.findBuffer(rawFirstInRaw.last_samp) == rawFirstInRaw.rawdir.size() - 1 );
+
+    RowVectorXi vecSel(3);
+    vecSel << 0, 5, 10;
+
+    MatrixXd matDataRef, matTimesRef, matData, matTimes;
+
+    // Windows inside a buffer, across buffer boundaries and repeated reads served from the caches
+    QList<QPair<fiff_int_t,fiff_int_t> > lWindows;
+    lWindows << qMakePair(rawFirstInRaw.first_samp + 10, rawFirstInRaw.first_samp + 60)
+             << qMakePair(rawFirstInRaw.first_samp + 100, rawFirstInRaw.first_samp + 2100)
+             << qMakePair(rawFirstInRaw.first_samp + 10, rawFirstInRaw.first_samp + 60);
+
+    for(int i = 0; i < lWindows.size(); ++i) {
+        QVERIFY( rawFirstInRaw.read_raw_segment(matDataRef, matTimesRef, lWindows[i].first, lWindows[i].second) );
+        QVERIFY( reader.read_raw_segment(matData, matTimes, lWindows[i].first, lWindows[i].second) );
+        QVERIFY( matData.rows() == matDataRef.rows() && matData.cols() == matDataRef.cols() );
+        QVERIFY( (matData - matDataRef).cwiseAbs().maxCoeff() < dEpsilon );
+        QVERIFY( (matTimes - matTimesRef).cwiseAbs().maxCoeff() < dEpsilon );
+
+        QVERIFY( rawFirstInRaw.read_raw_segment(matDataRef, matTimesRef, lWindows[i].first, lWindows[i].second, vecSel) );
+        QVERIFY( reader.read_raw_segment(matData, matTimes, lWindows[i].first, lWindows[i].second, vecSel) );
+        QVERIFY( matData.rows() == vecSel.size() );
+        QVERIFY( (matData - matDataRef).cwiseAbs().maxCoeff() < dEpsilon );
+    }
+
+    // Zero-copy reads from the memory mapped file must match the tag based reads
+    FiffRawReader readerMapped(rawFirstInRaw);
+    QVERIFY( readerMapped.setUseMemoryMapping(true) );
+
+    for(int i = 0; i < lWindows.size(); ++i) {
+        QVERIFY( reader.read_raw_segment(matDataRef, matTimesRef, lWindows[i].first, lWindows[i].second, vecSel) );
+        QVERIFY( readerMapped.read_raw_segment(matData, matTimes, lWindows[i].first, lWindows[i].second, vecSel) );
+        QVERIFY( (matData - matDataRef).cwiseAbs().maxCoeff() < dEpsilon );
+    }
+}
+
+//=============================================================================================================
+
 void TestFiffRWR::cleanupTestCase()
 {
 }
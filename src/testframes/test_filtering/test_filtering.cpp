@@ -45,6 +45,8 @@
 #include <fiff/fiff.h>
 #include <rtprocessing/helpers/filterkernel.h>
 #include <rtprocessing/filter.h>
+#include <rtprocessing/helpers/filterfftengine.h>
+#include <rtprocessing/causalfilter.h>
 
 #include <Eigen/Dense>
 
@@ -84,6 +86,10 @@ private slots:
     void initTestCase();
     void compareData();
     void compareTimes();
+    void compareFftEngine();
+    void compareCausalFilter();
+    void compareFilterFile_data();
+    void compareFilterFile();
     void cleanupTestCase();
 
 private:
@@ -231,6 +237,159 @@ void TestFiltering::compareTimes()
     QVERIFY( mTimesDiff.sum() < dEpsilon );
 }
 
+//=============================================================================================================
+
+void TestFiltering::compareFftEngine()
+{
+    // The batched engine must produce the same result as filtering each channel with its own kernel copy
+    FilterKernel filterKernel("test_kernel",
+                              FilterKernel::m_filterTypes.indexOf(FilterParameter("LPF")),
+                              128,
+                              0.2,
+                              0.0,
+                              0.05,
+                              1000.0,
+                              FilterKernel::m_designMethods.indexOf(FilterParameter("Cosine")));
+
+    MatrixXd matData = MatrixXd::Random(37, 700);
+    RowVectorXi vecPicks(3);
+    vecPicks << 1, 20, 36;
+
+    FilterFftEngine engine(filterKernel, 8);
+    MatrixXd matEngine = engine.filterBlock(matData, RowVectorXi(), true);
+    MatrixXd matEnginePicks = engine.filterBlock(matData, vecPicks, false);
+
+    QVERIFY( matEngine.cols() == matData.cols() + engine.getFilterOrder() );
+
+    for(int i = 0; i < matData.rows(); ++i) {
+        FilterKernel kernelCopy = filterKernel;
+        RowVectorXd vecRow = matData.row(i);
+        kernelCopy.applyFftFilter(vecRow, true);
+        QVERIFY( (matEngine.row(i) - vecRow).cwiseAbs().maxCoeff() < dEpsilon );
+    }
+
+    // Non picked channels are only delayed
+    QVERIFY( (matEnginePicks.row(0).segment(engine.getFilterOrder()/2, matData.cols()) - matData.row(0)).cwiseAbs().maxCoeff() < dEpsilon );
+    QVERIFY( (matEnginePicks.row(20) - matEngine.row(20)).cwiseAbs().maxCoeff() < dEpsilon );
+}
+
+//=============================================================================================================
+
+void TestFiltering::compareCausalFilter()
+{
+    FilterKernel filterKernel("test_kernel",
+                              FilterKernel::m_filterTypes.indexOf(FilterParameter("LPF")),
+                              100,
+                              0.2,
+                              0.0,
+                              0.05,
+                              1000.0,
+                              FilterKernel::m_designMethods.indexOf(FilterParameter("Cosine")));
+    RowVectorXd vecCoeff = filterKernel.getCoefficients();
+
+    MatrixXd matData = MatrixXd::Random(2, 600);
+
+    // Reference: direct causal convolution
+    MatrixXd matRef = MatrixXd::Zero(2, 600);
+    for(int r = 0; r < matData.rows(); ++r) {
+        for(int i = 0; i < matData.cols(); ++i) {
+            for(int j = 0; j < vecCoeff.cols() && j <= i; ++j) {
+                matRef(r,i) += vecCoeff[j] * matData(r,i-j);
+            }
+        }
+    }
+
+    // Partition size equal to the block size adds no buffering latency
+    CausalFilter causalFilter;
+    causalFilter.setFirKernel(filterKernel, 50);
+
+    MatrixXd matOut(2, 600);
+    for(int i = 0; i < matData.cols(); i += 50) {
+        matOut.middleCols(i, 50) = causalFilter.calculate(matData.middleCols(i, 50));
+    }
+
+    QVERIFY( causalFilter.getBufferLatency() == 0 );
+    QVERIFY( (matOut - matRef).cwiseAbs().maxCoeff() < dEpsilon );
+
+    // Butterworth low pass passes DC with unit gain and does not add buffering latency
+    CausalFilter iirFilter;
+    iirFilter.designButterworth(FilterKernel::m_filterTypes.indexOf(FilterParameter("LPF")), 4, 40.0, 0.0, 1000.0);
+    MatrixXd matStep = iirFilter.calculate(MatrixXd::Ones(1, 2000));
+
+    QVERIFY( iirFilter.getBufferLatency() == 0 );
+    QVERIFY( std::abs(matStep(0, 1999) - 1.0) < dEpsilon );
+}
+
+//=============================================================================================================
+
+void TestFiltering::compareFilterFile_data()
+{
+    QTest::addColumn<int>("iFilterOrder");
+    QTest::addColumn<bool>("bUseThreads");
+
+    QTest::newRow("order 512, single thread") << 512 << false;
+    QTest::newRow("order 512, threads") << 512 << true;
+    QTest::newRow("order 128, threads") << 128 << true;
+}
+
+//=============================================================================================================
+
+void TestFiltering::compareFilterFile()
+{
+    QFETCH(int, iFilterOrder);
+    QFETCH(bool, bUseThreads);
+
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    QFile t_fileOut(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/MEG/sample/rtfilter_filterfile_out_raw.fif");
+
+    FiffRawData::SPtr pRawIn = FiffRawData::SPtr::create(t_fileIn);
+    RowVectorXi vPicks = pRawIn->info.pick_types(true, true, false);
+    fiff_int_t from = pRawIn->first_samp;
+    fiff_int_t to = pRawIn->last_samp;
+
+    FilterKernel filterKernel("test_kernel",
+                              FilterKernel::m_filterTypes.indexOf(FilterParameter("BPF")),
+                              iFilterOrder,
+                              10.0/(pRawIn->info.sfreq/2.0),
+                              10.0/(pRawIn->info.sfreq/2.0),
+                              1.0/(pRawIn->info.sfreq/2.0),
+                              pRawIn->info.sfreq,
+                              FilterKernel::m_designMethods.indexOf(FilterParameter("Cosine")));
+
+    // Make sure the file is filtered in several chunks, so that the chunk boundaries are part of the comparison
+    QVERIFY( to - from + 1 > 4 * iFilterOrder );
+
+    // Reference: filter the whole segment at once
+    MatrixXd matData, matTimes;
+    QVERIFY( pRawIn->read_raw_segment(matData, matTimes, from, to) );
+    MatrixXd matRef = RTPROCESSINGLIB::filterData(matData, filterKernel, vPicks, bUseThreads);
+
+    // Filter the file chunk by chunk and read the written result back
+    QVERIFY( t_fileOut.open(QIODevice::WriteOnly) );
+    QVERIFY( RTPROCESSINGLIB::filterFile(t_fileOut, pRawIn, filterKernel, vPicks, bUseThreads) );
+    t_fileOut.close();
+
+    FiffRawData rawOut(t_fileOut);
+    QCOMPARE( rawOut.first_samp, from );
+    QCOMPARE( rawOut.last_samp, to );
+
+    MatrixXd matFiltered, matFilteredTimes;
+    QVERIFY( rawOut.read_raw_segment(matFiltered, matFilteredTimes, from, to) );
+    QCOMPARE( matFiltered.rows(), matRef.rows() );
+    QCOMPARE( matFiltered.cols(), matRef.cols() );
+
+    // The file stores single precision values
+    for(int i = 0; i < matRef.rows(); ++i) {
+        double dTolerance = 1e-6 * matRef.row(i).cwiseAbs().maxCoeff();
+        QVERIFY2( (matFiltered.row(i) - matRef.row(i)).cwiseAbs().maxCoeff() <= dTolerance,
+                  qPrintable(QString("Channel %1 differs").arg(i)) );
+    }
+
+    t_fileOut.remove();
+}
+
+//=============================================================================================================
+
 void TestFiltering::cleanupTestCase()
 {
     QFile t_fileOut(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/MEG/sample/rtfilter_filterdata_out_raw.fif");
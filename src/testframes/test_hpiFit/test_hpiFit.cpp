@@ -49,6 +49,7 @@
 #include <inverse/hpiFit/hpifit.h>
 #include <inverse/hpiFit/hpidataupdater.h>
 #include <inverse/hpiFit/sensorset.h>
+#include <inverse/hpiFit/hpipositiontracker.h>
 
 #include <utils/ioutils.h>
 #include <utils/mnemath.h>
@@ -66,6 +67,7 @@
 #include <QCommandLineParser>
 #include <QDebug>
 #include <QtTest>
+#include <QElapsedTimer>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -103,6 +105,10 @@ private slots:
     void testFit_advanced_error();  // compare error to specified value
     void testCheckForUpdate();
     void testFindOrder();  // test with all possible frequency oders
+    void testFit_lm_error();  // compare error of the Levenberg-Marquardt fit to specified value
+    void testFit_lm_warmStart();  // warm start from the previous result
+    void testFit_lm_compareSimplex();  // compare positions and timing to the simplex fit
+    void testPositionTracker();  // continuous head positions over the whole recording
     void cleanupTestCase();  // clean-up at the end
 
 private:
@@ -656,6 +662,191 @@ void TestHpiFit::testFindOrder()
 
 //=============================================================================================================
 
+void TestHpiFit::testFit_lm_error()
+{
+    /// prepare
+    int iSampleFreq = m_pFiffInfo->sfreq;
+    int iLineFreq = m_pFiffInfo->linefreq;
+    QVector<int> vecHpiFreqs = {166, 154, 161, 158};
+    bool bBasic = false;
+    HpiModelParameters hpiModelParameters(vecHpiFreqs,
+                                          iSampleFreq,
+                                          iLineFreq,
+                                          bBasic);
+
+    HpiDataUpdater hpiDataUpdater = HpiDataUpdater(m_pFiffInfo);
+    HPIFit HPI = HPIFit(hpiDataUpdater.getSensors());
+    HPI.setFitMethod(HpiFitMethod::levenbergMarquardt);
+    hpiDataUpdater.prepareDataAndProjectors(m_matData,m_matProjectors);
+    const auto& matProjectedData = hpiDataUpdater.getProjectedData();
+    const auto& matPreparedProjectors = hpiDataUpdater.getProjectors();
+    const auto& matCoilsHead = hpiDataUpdater.getHpiDigitizer();
+
+    HpiFitResult hpiFitResult;
+
+    HPI.fit(matProjectedData,
+            matPreparedProjectors,
+            hpiModelParameters,
+            matCoilsHead,
+            hpiFitResult);
+
+    QVector<double> vecError = hpiFitResult.errorDistances;
+
+    /// assert
+    double dLocalizationErrorMean = 1000.0 * std::accumulate(vecError.begin(), vecError.end(), .0) / vecError.size();
+    QVERIFY(dLocalizationErrorMean < dLocalizationErrorTol);
+    QVERIFY(hpiFitResult.GoF.mean() > dGofTol);
+}
+
+//=============================================================================================================
+
+void TestHpiFit::testFit_lm_warmStart()
+{
+    /// prepare
+    int iSampleFreq = m_pFiffInfo->sfreq;
+    int iLineFreq = m_pFiffInfo->linefreq;
+    QVector<int> vecHpiFreqs = {166, 154, 161, 158};
+    bool bBasic = false;
+    HpiModelParameters hpiModelParameters(vecHpiFreqs,
+                                          iSampleFreq,
+                                          iLineFreq,
+                                          bBasic);
+
+    HpiDataUpdater hpiDataUpdater = HpiDataUpdater(m_pFiffInfo);
+    HPIFit HPI = HPIFit(hpiDataUpdater.getSensors());
+    HPI.setFitMethod(HpiFitMethod::levenbergMarquardt);
+    hpiDataUpdater.prepareDataAndProjectors(m_matData,m_matProjectors);
+    const auto& matProjectedData = hpiDataUpdater.getProjectedData();
+    const auto& matPreparedProjectors = hpiDataUpdater.getProjectors();
+    const auto& matCoilsHead = hpiDataUpdater.getHpiDigitizer();
+
+    HpiFitResult hpiFitResult;
+
+    /// act
+    HPI.fit(matProjectedData,matPreparedProjectors,hpiModelParameters,matCoilsHead,hpiFitResult);
+    FiffDigPointSet fittedCoilsCold = hpiFitResult.fittedCoils;
+
+    // the second fit starts from the first result
+    HPI.fit(matProjectedData,matPreparedProjectors,hpiModelParameters,matCoilsHead,hpiFitResult);
+    FiffDigPointSet fittedCoilsWarm = hpiFitResult.fittedCoils;
+
+    /// assert
+    QVERIFY(fittedCoilsCold.size() == fittedCoilsWarm.size());
+    for(int i = 0; i < fittedCoilsCold.size(); ++i) {
+        Vector3f vecDiff(fittedCoilsCold[i].r[0] - fittedCoilsWarm[i].r[0],
+                         fittedCoilsCold[i].r[1] - fittedCoilsWarm[i].r[1],
+                         fittedCoilsCold[i].r[2] - fittedCoilsWarm[i].r[2]);
+        QVERIFY(1000.0 * vecDiff.norm() < 0.1);
+    }
+    QVERIFY(hpiFitResult.GoF.mean() > dGofTol);
+}
+
+//=============================================================================================================
+
+void TestHpiFit::testFit_lm_compareSimplex()
+{
+    /// prepare
+    int iSampleFreq = m_pFiffInfo->sfreq;
+    int iLineFreq = m_pFiffInfo->linefreq;
+    QVector<int> vecHpiFreqs = {166, 154, 161, 158};
+    bool bBasic = false;
+    int iNumFits = 10;
+    HpiModelParameters hpiModelParameters(vecHpiFreqs,
+                                          iSampleFreq,
+                                          iLineFreq,
+                                          bBasic);
+
+    HpiDataUpdater hpiDataUpdater = HpiDataUpdater(m_pFiffInfo);
+    HPIFit HPI = HPIFit(hpiDataUpdater.getSensors());
+    hpiDataUpdater.prepareDataAndProjectors(m_matData,m_matProjectors);
+    const auto& matProjectedData = hpiDataUpdater.getProjectedData();
+    const auto& matPreparedProjectors = hpiDataUpdater.getProjectors();
+    const auto& matCoilsHead = hpiDataUpdater.getHpiDigitizer();
+
+    HpiFitResult hpiFitResultSimplex;
+    HpiFitResult hpiFitResultLM;
+    QElapsedTimer timer;
+
+    /// act
+    timer.start();
+    for(int i = 0; i < iNumFits; ++i) {
+        hpiFitResultSimplex = HpiFitResult();
+        HPI.fit(matProjectedData,matPreparedProjectors,hpiModelParameters,matCoilsHead,hpiFitResultSimplex);
+    }
+    qint64 iTimeSimplex = timer.elapsed();
+
+    HPI.setFitMethod(HpiFitMethod::levenbergMarquardt);
+    timer.restart();
+    for(int i = 0; i < iNumFits; ++i) {
+        HPI.fit(matProjectedData,matPreparedProjectors,hpiModelParameters,matCoilsHead,hpiFitResultLM);
+    }
+    qint64 iTimeLM = timer.elapsed();
+
+    qInfo() << "TestHpiFit::testFit_lm_compareSimplex - Simplex:" << iTimeSimplex / (double)iNumFits << "ms per fit,"
+            << "Levenberg-Marquardt (warm start):" << iTimeLM / (double)iNumFits << "ms per fit";
+
+    /// assert
+    QVERIFY(hpiFitResultSimplex.fittedCoils.size() == hpiFitResultLM.fittedCoils.size());
+    for(int i = 0; i < hpiFitResultLM.fittedCoils.size(); ++i) {
+        Vector3f vecDiff(hpiFitResultSimplex.fittedCoils[i].r[0] - hpiFitResultLM.fittedCoils[i].r[0],
+                         hpiFitResultSimplex.fittedCoils[i].r[1] - hpiFitResultLM.fittedCoils[i].r[1],
+                         hpiFitResultSimplex.fittedCoils[i].r[2] - hpiFitResultLM.fittedCoils[i].r[2]);
+        QVERIFY(1000.0 * vecDiff.norm() < dLocalizationErrorTol);
+    }
+}
+
+//=============================================================================================================
+
+void TestHpiFit::testPositionTracker()
+{
+    /// prepare
+    QVector<int> vecHpiFreqs = {166, 154, 161, 158};
+    float fWindow = 0.2f;
+    float fStep = 0.1f;
+    HpiPositionTracker tracker(vecHpiFreqs, fWindow, fStep);
+    tracker.setWindowsPerChunk(5);
+    QString sFileName = QDir::tempPath() + "/test_hpiFit_positions.pos";
+
+    MatrixXd matPositionSingle;
+    MatrixXd matPositionMulti;
+
+    /// act
+    tracker.setNumThreads(1);
+    bool bSingle = tracker.computeHeadPositions(m_raw, m_matProjectors, matPositionSingle);
+    tracker.setNumThreads(4);
+    bool bMulti = tracker.computeHeadPositions(m_raw, m_matProjectors, matPositionMulti);
+    bool bWritten = HpiPositionTracker::writeHeadPositions(sFileName, matPositionMulti);
+
+    /// assert
+    int iWindow = floor(fWindow * m_raw.info.sfreq);
+    int iStep = floor(fStep * m_raw.info.sfreq);
+    int iNumWindows = (m_raw.last_samp - m_raw.first_samp + 1 - iWindow) / iStep + 1;
+
+    QVERIFY(bSingle && bMulti);
+    QVERIFY(matPositionMulti.rows() == iNumWindows);
+    QVERIFY(matPositionMulti.cols() == 10);
+    QVERIFY(matPositionSingle == matPositionMulti);
+    for(int i = 1; i < matPositionMulti.rows(); ++i) {
+        QVERIFY(matPositionMulti(i,0) > matPositionMulti(i-1,0));
+    }
+    QVERIFY(matPositionMulti.col(7).mean() > dGofTol);
+    QVERIFY(1000.0 * matPositionMulti.col(8).mean() < dLocalizationErrorTol);
+
+    QVERIFY(bWritten);
+    QFile file(sFileName);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    int iNumLines = 0;
+    while(!file.atEnd()) {
+        file.readLine();
+        iNumLines++;
+    }
+    file.close();
+    QVERIFY(iNumLines == iNumWindows + 1);
+    file.remove();
+}
+
+//=============================================================================================================
+
 void TestHpiFit::cleanupTestCase()
 {
 }
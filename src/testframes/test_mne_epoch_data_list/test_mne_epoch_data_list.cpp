@@ -0,0 +1,231 @@
+//=============================================================================================================
+/**
+ * @file     test_mne_epoch_data_list.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Tests the block-wise epoch reading of MNEEpochDataList against reading each epoch on its own.
+ *
+ */
+
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <mne/mne_epoch_data_list.h>
+#include <mne/mne_epoch_data.h>
+
+#include <fiff/fiff_raw_data.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestMneEpochDataList
+ *
+ * @brief The TestMneEpochDataList class compares the block-wise epoch reading with reading each epoch on its own.
+ *
+ */
+class TestMneEpochDataList: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMneEpochDataList();
+
+private slots:
+    void initTestCase();
+    void testReadEpochs();
+    void testReadEpochsBaseline();
+    void cleanupTestCase();
+
+private:
+    void compareWithSegments(bool bApplyBaseline);
+
+    double                  dEpsilon;
+    float                   fTMin;
+    float                   fTMax;
+    qint32                  iEvent;
+    QPair<float,float>      pairBaseline;
+    QMap<QString,double>    mapReject;
+    QFile                   fileIn;
+    FiffRawData             raw;
+    MatrixXi                matEvents;
+};
+
+//=============================================================================================================
+
+TestMneEpochDataList::TestMneEpochDataList()
+: dEpsilon(1e-10)
+, fTMin(-0.1f)
+, fTMax(0.3f)
+, iEvent(1)
+, pairBaseline(qMakePair(-0.1f, 0.0f))
+{
+}
+
+//=============================================================================================================
+
+void TestMneEpochDataList::initTestCase()
+{
+    // The raw data keep reading from the file, so the file is kept as a member
+    fileIn.setFileName(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    raw = FiffRawData(fileIn);
+    QVERIFY(raw.last_samp - raw.first_samp > 1000);
+
+    // Thresholds in the range of the data, so that the rejection flags are compared as well
+    mapReject.insert("grad", 1000e-13);
+    mapReject.insert("mag", 2e-12);
+
+    // Unsorted events of the selected kind, partly overlapping and partly separated by gaps longer than one epoch.
+    // The events of another kind and the one with a non zero previous value must not be read.
+    fiff_int_t iNumSamples = raw.last_samp - raw.first_samp;
+    fiff_int_t iBase = raw.first_samp + iNumSamples / 10;
+    QList<QVector<int> > lEvents;
+    lEvents << QVector<int>({iBase + iNumSamples / 2, 0, iEvent})
+            << QVector<int>({iBase + 100, 0, iEvent})
+            << QVector<int>({iBase, 0, iEvent})
+            << QVector<int>({iBase + iNumSamples / 4, 0, 2})
+            << QVector<int>({iBase + 60, 0, iEvent})
+            << QVector<int>({iBase + iNumSamples / 2 + 50, 0, iEvent})
+            << QVector<int>({iBase + iNumSamples / 3, 5, iEvent})
+            << QVector<int>({iBase + iNumSamples / 2 - 30, 0, iEvent});
+
+    matEvents.resize(lEvents.size(), 3);
+    for(int i = 0; i < lEvents.size(); ++i) {
+        for(int j = 0; j < 3; ++j) {
+            matEvents(i,j) = lEvents.at(i).at(j);
+        }
+    }
+}
+
+//=============================================================================================================
+
+void TestMneEpochDataList::testReadEpochs()
+{
+    compareWithSegments(false);
+}
+
+//=============================================================================================================
+
+void TestMneEpochDataList::testReadEpochsBaseline()
+{
+    compareWithSegments(true);
+}
+
+//=============================================================================================================
+
+void TestMneEpochDataList::cleanupTestCase()
+{
+}
+
+//=============================================================================================================
+
+void TestMneEpochDataList::compareWithSegments(bool bApplyBaseline)
+{
+    MNEEpochDataList lEpochs = MNEEpochDataList::readEpochs(raw,
+                                                            matEvents,
+                                                            fTMin,
+                                                            fTMax,
+                                                            iEvent,
+                                                            mapReject,
+                                                            bApplyBaseline,
+                                                            pairBaseline);
+
+    // Read every selected event on its own, in the order of the events
+    RowVectorXi vecPicks(raw.info.chs.size());
+    for(int i = 0; i < raw.info.chs.size(); ++i) {
+        vecPicks(i) = i;
+    }
+
+    int iNumRefEpochs = 0;
+    MatrixXd matTimes;
+
+    for(int p = 0; p < matEvents.rows(); ++p) {
+        if(matEvents(p,1) != 0 || matEvents(p,2) != iEvent) {
+            continue;
+        }
+
+        fiff_int_t from = matEvents(p,0) + fTMin*raw.info.sfreq;
+        fiff_int_t to = matEvents(p,0) + floor(fTMax*raw.info.sfreq + 0.5);
+
+        MNEEpochData refEpoch;
+        QVERIFY(raw.read_raw_segment(refEpoch.epoch, matTimes, from, to, vecPicks));
+        refEpoch.tmin = fTMin;
+        refEpoch.tmax = fTMax;
+
+        bool bReject = MNEEpochDataList::checkForArtifact(refEpoch.epoch, raw.info, mapReject);
+
+        if(bApplyBaseline) {
+            refEpoch.applyBaselineCorrection(pairBaseline);
+        }
+
+        QVERIFY(iNumRefEpochs < lEpochs.size());
+        const MNEEpochData::SPtr& pEpoch = lEpochs.at(iNumRefEpochs);
+
+        QCOMPARE(pEpoch->event, iEvent);
+        QCOMPARE(pEpoch->bReject, bReject);
+        QCOMPARE(pEpoch->epoch.rows(), refEpoch.epoch.rows());
+        QCOMPARE(pEpoch->epoch.cols(), refEpoch.epoch.cols());
+
+        // Relative to each channel, since the channel types differ by orders of magnitude
+        for(int i = 0; i < refEpoch.epoch.rows(); ++i) {
+            QVERIFY((pEpoch->epoch.row(i) - refEpoch.epoch.row(i)).cwiseAbs().maxCoeff() <= dEpsilon * refEpoch.epoch.row(i).cwiseAbs().maxCoeff());
+        }
+
+        ++iNumRefEpochs;
+    }
+
+    QCOMPARE(iNumRefEpochs, 6);
+    QCOMPARE(lEpochs.size(), iNumRefEpochs);
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestMneEpochDataList)
+#include "test_mne_epoch_data_list.moc"
@@ -40,6 +40,7 @@
 #include <mne/mne_project_to_surface.h>
 #include <mne/mne_bem.h>
 #include <mne/mne_bem_surface.h>
+#include <mne/mne_surface_bvh.h>
 #include <utils/ioutils.h>
 
 //=============================================================================================================
@@ -48,6 +49,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtTest>
+#include <QtMath>
 
 //=============================================================================================================
 // Eigen
@@ -79,13 +81,18 @@ public:
 private slots:
     void initTestCase();
     void compareValue();
+    void compareBvh();
     void cleanupTestCase();
 
 private:
+    double solidAngleSum(const Vector3f& vecFrom) const;
+
     // declare thresholds, and variables
     double dEpsilon;
     MatrixXf matResult;
+    MatrixXf matPointsShifted;
     MatrixXd matRef;
+    MNEBemSurface::SPtr bemSurface;
 
 };
 
@@ -104,13 +111,13 @@ void TestMNEProjectToSurface::initTestCase()
     QString sRef(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/Result/mne_project_to_surface.txt");
 
     MNEBem bemHead(t_fileBem);
-    MNEBemSurface::SPtr bemSurface = MNEBemSurface::SPtr::create(bemHead[0]);
+    bemSurface = MNEBemSurface::SPtr::create(bemHead[0]);
     MNEProjectToSurface::SPtr mneSurfacePoints = MNEProjectToSurface::SPtr::create(*bemSurface);
 
     VectorXi vecNearest;    // Triangle of the new point
     VectorXf vecDist;       // The Distance between matX and matP
 
-    MatrixXf matPointsShifted = bemSurface->rr.cast<float>() * 1.1;     // Move all points with same amout from surface
+    matPointsShifted = bemSurface->rr.cast<float>() * 1.1;     // Move all points with same amout from surface
     int iNP = matPointsShifted.rows();
 
     mneSurfacePoints->mne_find_closest_on_surface(matPointsShifted, iNP, matResult, vecNearest, vecDist);
@@ -131,6 +138,68 @@ void TestMNEProjectToSurface::compareValue()
 
 //=============================================================================================================
 
+void TestMNEProjectToSurface::compareBvh()
+{
+    MNESurfaceBvh bvh(*bemSurface);
+    QVERIFY(bvh.ntri() == bemSurface->ntri);
+
+    // the nearest points of the hierarchy have to match the projections
+    Vector3f vecNearest;
+    float fDist;
+    float fMaxDiff = 0.0f;
+    for(int i = 0; i < matPointsShifted.rows(); ++i) {
+        QVERIFY(bvh.findNearestPoint(matPointsShifted.row(i).transpose(), vecNearest, fDist) >= 0);
+        fMaxDiff = std::max(fMaxDiff, (vecNearest - matResult.row(i).transpose()).norm());
+    }
+    QVERIFY(fMaxDiff < 1e-4f);
+
+    // points shrunk towards the center are inside, points moved away are outside
+    Vector3f vecCenter = bemSurface->rr.cast<float>().colwise().mean().transpose();
+    // ray casts grazing an edge are flagged unreliable and are left to the solid angle sum by the callers
+    bool bReliable;
+    int iNumQueries = 0;
+    int iNumReliable = 0;
+    for(int i = 0; i < bemSurface->rr.rows(); ++i) {
+        Vector3f vecVert = bemSurface->rr.row(i).cast<float>().transpose();
+        for(float fScale : {0.5f, 1.5f}) {
+            Vector3f vecPoint = vecCenter + fScale * (vecVert - vecCenter);
+            int iWinding = bvh.windingNumber(vecPoint, bReliable);
+            ++iNumQueries;
+            if(bReliable) {
+                ++iNumReliable;
+                QCOMPARE(iWinding, fScale < 1.0f ? 1 : 0);
+                QCOMPARE(iWinding, qRound(solidAngleSum(vecPoint) / (4.0 * M_PI)));
+            }
+        }
+    }
+    // the fallback is meant for rare grazing rays only
+    QVERIFY(iNumReliable >= 0.9 * iNumQueries);
+}
+
+//=============================================================================================================
+
+double TestMNEProjectToSurface::solidAngleSum(const Vector3f& vecFrom) const
+{
+    // van Oosterom's formula summed over all triangles, as in MneSurfaceOrVolume::sum_solids
+    double dTotAngle = 0.0;
+    for(int i = 0; i < bemSurface->tris.rows(); ++i) {
+        Vector3d v1 = (bemSurface->rr.row(bemSurface->tris(i,0)).transpose() - vecFrom).cast<double>();
+        Vector3d v2 = (bemSurface->rr.row(bemSurface->tris(i,1)).transpose() - vecFrom).cast<double>();
+        Vector3d v3 = (bemSurface->rr.row(bemSurface->tris(i,2)).transpose() - vecFrom).cast<double>();
+
+        double dTriple = v1.cross(v2).dot(v3);
+        double l1 = v1.norm();
+        double l2 = v2.norm();
+        double l3 = v3.norm();
+        double dS = l1*l2*l3 + v1.dot(v2)*l3 + v1.dot(v3)*l2 + v2.dot(v3)*l1;
+
+        dTotAngle += 2.0 * std::atan2(dTriple, dS);
+    }
+    return dTotAngle;
+}
+
+//=============================================================================================================
+
 void TestMNEProjectToSurface::cleanupTestCase()
 {
 }
@@ -0,0 +1,323 @@
+//=============================================================================================================
+/**
+ * @file     test_rtprocessing_rtaveraging.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Tests the running average and standard error of RtAveragingWorker against a naive computation.
+ *
+ */
+
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtprocessing/rtaveraging.h>
+
+#include <fiff/fiff_info.h>
+#include <fiff/fiff_evoked_set.h>
+#include <fiff/fiff_constants.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtAveraging
+ *
+ * @brief The TestRtAveraging class compares the running average and standard error of RtAveragingWorker with a naive computation.
+ *
+ */
+class TestRtAveraging: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtAveraging();
+
+private slots:
+    void initTestCase();
+    void testRunningAverage();
+    void testReducedAverageNumber();
+    void testEarlyTriggers_data();
+    void testEarlyTriggers();
+    void cleanupTestCase();
+
+private:
+    void compareWithNaive(const QList<MatrixXd>& lEpochs, int iNumAverages);
+
+    double                  dEpsilon;
+    int                     iNumChannels;
+    int                     iBlockSize;
+    int                     iTriggerPos;
+    int                     iPreStimSamples;
+    int                     iPostStimSamples;
+    int                     iNumBlocks;
+    FiffInfo::SPtr          pFiffInfo;
+    QList<MatrixXd>         lBlocks;
+    FiffEvokedSet           evokedSet;
+    FiffEvokedSet           evokedSetStdErr;
+};
+
+//=============================================================================================================
+
+TestRtAveraging::TestRtAveraging()
+: dEpsilon(1e-6)
+, iNumChannels(6)
+, iBlockSize(100)
+, iTriggerPos(40)
+, iPreStimSamples(20)
+, iPostStimSamples(30)
+, iNumBlocks(12)
+{
+}
+
+//=============================================================================================================
+
+void TestRtAveraging::initTestCase()
+{
+    // Misc channels followed by one stim channel, which is the last row of each block
+    pFiffInfo = FiffInfo::SPtr::create();
+    for(int i = 0; i <= iNumChannels; ++i) {
+        FiffChInfo chInfo;
+        if(i < iNumChannels) {
+            chInfo.ch_name = QString("MISC %1").arg(i + 1, 3, 10, QChar('0'));
+            chInfo.kind = FIFFV_MISC_CH;
+        } else {
+            chInfo.ch_name = QString("STI 014");
+            chInfo.kind = FIFFV_STIM_CH;
+        }
+        pFiffInfo->chs.append(chInfo);
+        pFiffInfo->ch_names.append(chInfo.ch_name);
+    }
+    pFiffInfo->nchan = iNumChannels + 1;
+    pFiffInfo->sfreq = 1000.0;
+
+    // Every block holds one trigger, so that each block completes exactly one epoch.
+    // The offset makes the sum of squares considerably larger than the variance.
+    std::srand(42);
+    for(int i = 0; i < iNumBlocks; ++i) {
+        MatrixXd matBlock = MatrixXd::Zero(iNumChannels + 1, iBlockSize);
+        matBlock.topRows(iNumChannels) = MatrixXd::Random(iNumChannels, iBlockSize).array() + 10.0;
+        matBlock(iNumChannels, iTriggerPos) = 1.0;
+        lBlocks.append(matBlock);
+    }
+}
+
+//=============================================================================================================
+
+void TestRtAveraging::testRunningAverage()
+{
+    int iNumAverages = 4;
+
+    RtAveragingWorker worker(iNumAverages, iPreStimSamples, iPostStimSamples, 0, 0, iNumChannels, pFiffInfo);
+    connect(&worker, &RtAveragingWorker::resultReady,
+            [this](const FiffEvokedSet& evokedStimSet, const QStringList&) { evokedSet = evokedStimSet; });
+    connect(&worker, &RtAveragingWorker::stdErrReady,
+            [this](const FiffEvokedSet& evokedStimSetStdErr, const QStringList&) { evokedSetStdErr = evokedStimSetStdErr; });
+
+    // More blocks than twice the number of averages, so that the running sums are recomputed at least once
+    QList<MatrixXd> lEpochs;
+    for(int i = 0; i < iNumBlocks; ++i) {
+        worker.doWork(lBlocks.at(i));
+        lEpochs.append(lBlocks.at(i).middleCols(iTriggerPos - iPreStimSamples, iPreStimSamples + iPostStimSamples));
+
+        compareWithNaive(lEpochs, iNumAverages);
+    }
+}
+
+//=============================================================================================================
+
+void TestRtAveraging::testReducedAverageNumber()
+{
+    int iNumAverages = 5;
+
+    RtAveragingWorker worker(iNumAverages, iPreStimSamples, iPostStimSamples, 0, 0, iNumChannels, pFiffInfo);
+    connect(&worker, &RtAveragingWorker::resultReady,
+            [this](const FiffEvokedSet& evokedStimSet, const QStringList&) { evokedSet = evokedStimSet; });
+    connect(&worker, &RtAveragingWorker::stdErrReady,
+            [this](const FiffEvokedSet& evokedStimSetStdErr, const QStringList&) { evokedSetStdErr = evokedStimSetStdErr; });
+
+    QList<MatrixXd> lEpochs;
+    int i = 0;
+    for(; i < iNumBlocks / 2; ++i) {
+        worker.doWork(lBlocks.at(i));
+        lEpochs.append(lBlocks.at(i).middleCols(iTriggerPos - iPreStimSamples, iPreStimSamples + iPostStimSamples));
+    }
+    compareWithNaive(lEpochs, iNumAverages);
+
+    // Reducing the number of averages drops the oldest epochs from the running sums
+    iNumAverages = 2;
+    worker.setAverageNumber(iNumAverages);
+
+    for(; i < iNumBlocks; ++i) {
+        worker.doWork(lBlocks.at(i));
+        lEpochs.append(lBlocks.at(i).middleCols(iTriggerPos - iPreStimSamples, iPreStimSamples + iPostStimSamples));
+
+        compareWithNaive(lEpochs, iNumAverages);
+    }
+}
+
+//=============================================================================================================
+
+void TestRtAveraging::testEarlyTriggers_data()
+{
+    QTest::addColumn<int>("iTestBlockSize");
+
+    // Blocks shorter than the pre stim window make the pre stim buffer wrap around
+    QTest::newRow("blocks shorter than pre stim") << 8;
+    QTest::newRow("blocks longer than pre stim") << iBlockSize;
+}
+
+//=============================================================================================================
+
+void TestRtAveraging::testEarlyTriggers()
+{
+    QFETCH(int, iTestBlockSize);
+
+    // Every trigger lies within the first iPreStimSamples of its block, so the pre stim part of each epoch is
+    // collected across several blocks
+    int iNumAverages = 3;
+    int iNumTriggers = 8;
+
+    // The worker does not fill the pre stim buffer while it completes the post stim part of an epoch. Leave enough
+    // samples in between, so that the pre stim part of each epoch is the contiguous signal before its trigger.
+    // A trigger on the first sample of a block is not detected, since the offset is removed before the detection.
+    QList<int> lTriggers;
+    int iTrigger = ((iPreStimSamples + iTestBlockSize - 1) / iTestBlockSize) * iTestBlockSize + 5;
+    for(int i = 0; i < iNumTriggers; ++i) {
+        lTriggers.append(iTrigger);
+
+        int iNextFreeBlock = (iTrigger + iPostStimSamples - 1) / iTestBlockSize + 1;
+        iTrigger = iNextFreeBlock * iTestBlockSize + iPreStimSamples;
+
+        if(iTrigger % iTestBlockSize == 0 || iTrigger % iTestBlockSize >= iPreStimSamples) {
+            iTrigger = (iTrigger / iTestBlockSize + 1) * iTestBlockSize + 1;
+        }
+
+        // Vary the position within the block
+        int iShifted = iTrigger + i % 5;
+        if(iShifted / iTestBlockSize == iTrigger / iTestBlockSize
+           && iShifted % iTestBlockSize < iPreStimSamples) {
+            iTrigger = iShifted;
+        }
+    }
+
+    int iNumTestBlocks = (lTriggers.last() + iPostStimSamples) / iTestBlockSize + 2;
+    MatrixXd matSignal = MatrixXd::Zero(iNumChannels + 1, iNumTestBlocks * iTestBlockSize);
+    matSignal.topRows(iNumChannels) = MatrixXd::Random(iNumChannels, matSignal.cols()).array() + 10.0;
+    for(int i = 0; i < lTriggers.size(); ++i) {
+        matSignal(iNumChannels, lTriggers.at(i)) = 1.0;
+    }
+
+    RtAveragingWorker worker(iNumAverages, iPreStimSamples, iPostStimSamples, 0, 0, iNumChannels, pFiffInfo);
+    connect(&worker, &RtAveragingWorker::resultReady,
+            [this](const FiffEvokedSet& evokedStimSet, const QStringList&) { evokedSet = evokedStimSet; });
+    connect(&worker, &RtAveragingWorker::stdErrReady,
+            [this](const FiffEvokedSet& evokedStimSetStdErr, const QStringList&) { evokedSetStdErr = evokedStimSetStdErr; });
+
+    QList<MatrixXd> lEpochs;
+    for(int i = 0; i < iNumTestBlocks; ++i) {
+        worker.doWork(matSignal.middleCols(i * iTestBlockSize, iTestBlockSize));
+
+        // An epoch is emitted with the block which completes its post stim part
+        bool bNewEpoch = false;
+        while(lEpochs.size() < lTriggers.size() && lTriggers.at(lEpochs.size()) + iPostStimSamples <= (i + 1) * iTestBlockSize) {
+            lEpochs.append(matSignal.middleCols(lTriggers.at(lEpochs.size()) - iPreStimSamples, iPreStimSamples + iPostStimSamples));
+            bNewEpoch = true;
+        }
+
+        if(bNewEpoch) {
+            compareWithNaive(lEpochs, iNumAverages);
+        }
+    }
+
+    QCOMPARE(lEpochs.size(), iNumTriggers);
+}
+
+//=============================================================================================================
+
+void TestRtAveraging::cleanupTestCase()
+{
+}
+
+//=============================================================================================================
+
+void TestRtAveraging::compareWithNaive(const QList<MatrixXd>& lEpochs, int iNumAverages)
+{
+    // Naive mean and standard error of the last iNumAverages epochs
+    int iNumAve = std::min(iNumAverages, int(lEpochs.size()));
+    MatrixXd matMean = MatrixXd::Zero(lEpochs.first().rows(), lEpochs.first().cols());
+    for(int i = lEpochs.size() - iNumAve; i < lEpochs.size(); ++i) {
+        matMean += lEpochs.at(i);
+    }
+    matMean /= iNumAve;
+
+    MatrixXd matStdErr = MatrixXd::Zero(matMean.rows(), matMean.cols());
+    if(iNumAve > 1) {
+        for(int i = lEpochs.size() - iNumAve; i < lEpochs.size(); ++i) {
+            matStdErr += (lEpochs.at(i) - matMean).array().square().matrix();
+        }
+        matStdErr = (matStdErr.array() / (double(iNumAve - 1) * iNumAve)).sqrt().matrix();
+    }
+
+    QCOMPARE(evokedSet.evoked.size(), 1);
+    QCOMPARE(evokedSetStdErr.evoked.size(), 1);
+    QCOMPARE(evokedSet.evoked.first().nave, iNumAve);
+    QCOMPARE(evokedSet.evoked.first().data.rows(), matMean.rows());
+    QCOMPARE(evokedSet.evoked.first().data.cols(), matMean.cols());
+    QCOMPARE(evokedSetStdErr.evoked.first().data.rows(), matStdErr.rows());
+    QCOMPARE(evokedSetStdErr.evoked.first().data.cols(), matStdErr.cols());
+
+    QVERIFY((evokedSet.evoked.first().data - matMean).cwiseAbs().maxCoeff() < dEpsilon);
+    QVERIFY((evokedSetStdErr.evoked.first().data - matStdErr).cwiseAbs().maxCoeff() < dEpsilon);
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtAveraging)
+#include "test_rtprocessing_rtaveraging.moc"
@@ -0,0 +1,247 @@
+//=============================================================================================================
+/**
+ * @file     test_rtprocessing_rtcov.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Tests the batch and the incremental covariance estimation of RtCov.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtprocessing/rtcov.h>
+
+#include <fiff/fiff_info.h>
+#include <fiff/fiff_cov.h>
+#include <fiff/fiff_constants.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtCov
+ *
+ * @brief The TestRtCov class provides tests for the batch and incremental covariance estimation of RtCov.
+ *
+ */
+class TestRtCov: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtCov();
+
+private slots:
+    void initTestCase();
+    void testIncrementalMatchesBatch();
+    void testExponentialWeighting();
+    void cleanupTestCase();
+
+private:
+    MatrixXd weightedCovariance(const MatrixXd& matData, double dForgettingFactor) const;
+
+    double                  dEpsilon;
+    int                     iNumChannels;
+    int                     iBlockSize;
+    int                     iNumBlocks;
+    FiffInfo::SPtr          pFiffInfo;
+    QList<MatrixXd>         lBlocks;
+};
+
+//=============================================================================================================
+
+TestRtCov::TestRtCov()
+: dEpsilon(1e-10)
+, iNumChannels(12)
+, iBlockSize(100)
+, iNumBlocks(10)
+{
+}
+
+//=============================================================================================================
+
+void TestRtCov::initTestCase()
+{
+    // Misc channels are excluded from the regularization, so the estimates can be compared with plain covariances
+    pFiffInfo = FiffInfo::SPtr::create();
+    for(int i = 0; i < iNumChannels; ++i) {
+        FiffChInfo chInfo;
+        chInfo.ch_name = QString("MISC %1").arg(i + 1, 3, 10, QChar('0'));
+        chInfo.kind = FIFFV_MISC_CH;
+        pFiffInfo->chs.append(chInfo);
+        pFiffInfo->ch_names.append(chInfo.ch_name);
+    }
+    pFiffInfo->nchan = iNumChannels;
+
+    // Correlated channels with a non zero mean
+    std::srand(42);
+    MatrixXd matMixing = MatrixXd::Random(iNumChannels, iNumChannels);
+    VectorXd vecOffset = VectorXd::Random(iNumChannels);
+    for(int i = 0; i < iNumBlocks; ++i) {
+        MatrixXd matBlock = matMixing * MatrixXd::Random(iNumChannels, iBlockSize);
+        matBlock.colwise() += vecOffset;
+        lBlocks.append(matBlock);
+    }
+}
+
+//=============================================================================================================
+
+void TestRtCov::testIncrementalMatchesBatch()
+{
+    RtCov rtCovBatch(pFiffInfo);
+    RtCov rtCovIncremental(pFiffInfo);
+    rtCovIncremental.setIncrementalMode(true);
+    QVERIFY(rtCovIncremental.isIncrementalMode());
+
+    int iMaxSamples = iNumBlocks * iBlockSize;
+    FiffCov covBatch, covIncremental;
+    MatrixXd matAll(iNumChannels, iMaxSamples);
+
+    for(int i = 0; i < iNumBlocks; ++i) {
+        matAll.block(0, i * iBlockSize, iNumChannels, iBlockSize) = lBlocks.at(i);
+
+        covBatch = rtCovBatch.estimateCovariance(lBlocks.at(i), iMaxSamples);
+        covIncremental = rtCovIncremental.estimateCovariance(lBlocks.at(i), iMaxSamples);
+
+        // Nothing is published before iMaxSamples are reached
+        if(i < iNumBlocks - 1) {
+            QVERIFY(covBatch.data.size() == 0);
+            QVERIFY(covIncremental.data.size() == 0);
+        }
+    }
+
+    QCOMPARE(covBatch.data.rows(), iNumChannels);
+    QCOMPARE(covIncremental.data.rows(), iNumChannels);
+
+    MatrixXd matCentered = matAll.colwise() - matAll.rowwise().mean();
+    MatrixXd matReference = matCentered * matCentered.transpose() / double(iMaxSamples - 1);
+    double dScale = matReference.cwiseAbs().maxCoeff();
+
+    QVERIFY((covBatch.data - matReference).cwiseAbs().maxCoeff() < dEpsilon * dScale);
+    QVERIFY((covIncremental.data - matReference).cwiseAbs().maxCoeff() < dEpsilon * dScale);
+    QVERIFY((covIncremental.data - covIncremental.data.transpose()).cwiseAbs().maxCoeff() == 0.0);
+    QCOMPARE(covIncremental.nfree, covBatch.nfree);
+    QCOMPARE(covIncremental.nfree, iMaxSamples);
+
+    // Without forgetting the accumulators are cleared after publishing, so the next window starts anew
+    for(int i = 0; i < iNumBlocks; ++i) {
+        covIncremental = rtCovIncremental.estimateCovariance(lBlocks.at(iNumBlocks - 1 - i), iMaxSamples);
+    }
+    QVERIFY((covIncremental.data - matReference).cwiseAbs().maxCoeff() < dEpsilon * dScale);
+}
+
+//=============================================================================================================
+
+void TestRtCov::testExponentialWeighting()
+{
+    double dForgettingFactor = 0.995;
+
+    RtCov rtCov(pFiffInfo);
+    rtCov.setIncrementalMode(true, dForgettingFactor);
+    QCOMPARE(rtCov.getForgettingFactor(), dForgettingFactor);
+
+    // Publish after every block, the accumulators keep the exponentially weighted history
+    MatrixXd matHistory(iNumChannels, 0);
+    FiffCov cov;
+    for(int i = 0; i < iNumBlocks; ++i) {
+        // Change the signal power halfway through, the estimate has to follow the weighted history
+        MatrixXd matBlock = i < iNumBlocks / 2 ? lBlocks.at(i) : MatrixXd(3.0 * lBlocks.at(i));
+
+        matHistory.conservativeResize(NoChange, matHistory.cols() + iBlockSize);
+        matHistory.rightCols(iBlockSize) = matBlock;
+
+        cov = rtCov.estimateCovariance(matBlock, iBlockSize);
+        QCOMPARE(cov.data.rows(), iNumChannels);
+
+        MatrixXd matReference = weightedCovariance(matHistory, dForgettingFactor);
+        double dScale = matReference.cwiseAbs().maxCoeff();
+        QVERIFY((cov.data - matReference).cwiseAbs().maxCoeff() < 1e-8 * dScale);
+    }
+
+    // The estimate is dominated by the recent, stronger half and not the plain covariance of the history
+    MatrixXd matCentered = matHistory.colwise() - matHistory.rowwise().mean();
+    MatrixXd matPlain = matCentered * matCentered.transpose() / double(matHistory.cols() - 1);
+    QVERIFY(cov.data.trace() > 1.2 * matPlain.trace());
+
+    // Reset drops the history
+    rtCov.reset();
+    cov = rtCov.estimateCovariance(lBlocks.at(0), iBlockSize);
+    MatrixXd matReference = weightedCovariance(lBlocks.at(0), dForgettingFactor);
+    QVERIFY((cov.data - matReference).cwiseAbs().maxCoeff() < 1e-8 * matReference.cwiseAbs().maxCoeff());
+}
+
+//=============================================================================================================
+
+void TestRtCov::cleanupTestCase()
+{
+}
+
+//=============================================================================================================
+
+MatrixXd TestRtCov::weightedCovariance(const MatrixXd& matData, double dForgettingFactor) const
+{
+    // The newest sample has weight 1, the one before dForgettingFactor and so on
+    int iNumSamples = matData.cols();
+    VectorXd vecWeights(iNumSamples);
+    for(int j = 0; j < iNumSamples; ++j) {
+        vecWeights(j) = std::pow(dForgettingFactor, iNumSamples - 1 - j);
+    }
+    double dWeight = vecWeights.sum();
+    double dWeightSquared = vecWeights.squaredNorm();
+
+    VectorXd vecMean = matData * vecWeights / dWeight;
+    MatrixXd matCentered = matData.colwise() - vecMean;
+    return matCentered * vecWeights.asDiagonal() * matCentered.transpose() / (dWeight - dWeightSquared / dWeight);
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtCov)
+#include "test_rtprocessing_rtcov.moc"
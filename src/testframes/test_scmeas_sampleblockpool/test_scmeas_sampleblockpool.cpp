@@ -0,0 +1,249 @@
+//=============================================================================================================
+/**
+ * @file     test_scmeas_sampleblockpool.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    test for the recycling and the statistics of SampleBlockPool.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <scMeas/sampleblockpool.h>
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QTest>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCMEASLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestSampleBlockPool
+ *
+ * @brief The TestSampleBlockPool class verifies that released blocks are recycled and counted correctly
+ *
+ */
+class TestSampleBlockPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCopyAcquireRecycles();
+    void testMoveAcquireRecycles();
+    void testSharedBlocks();
+    void testPoolLimits();
+    void testStatistics();
+};
+
+//=============================================================================================================
+
+void TestSampleBlockPool::testCopyAcquireRecycles()
+{
+    SampleBlockPool::SPtr pPool = SampleBlockPool::create("copy", 4);
+
+    MatrixXd matFirst = MatrixXd::Random(3, 10);
+    SampleBlockPool::Block block = pPool->acquire(matFirst);
+    const MatrixXd* pStorage = block.data();
+
+    QCOMPARE(block->rows(), Index(3));
+    QCOMPARE(block->cols(), Index(10));
+    QVERIFY(*block == matFirst);
+    QCOMPARE(pPool->getStatistics().iAllocations, qint64(1));
+    QCOMPARE(pPool->getStatistics().iBlocksInUse, qint64(1));
+
+    // Releasing the block puts its storage back into the pool
+    block.reset();
+    QCOMPARE(pPool->getStatistics().iBlocksInUse, qint64(0));
+    QCOMPARE(pPool->getStatistics().iBlocksPooled, qint64(1));
+
+    // A block with the same number of coefficients reuses the storage, even if the shape differs
+    MatrixXd matSecond = MatrixXd::Random(5, 6);
+    block = pPool->acquire(matSecond);
+
+    QVERIFY(block.data() == pStorage);
+    QVERIFY(*block == matSecond);
+    QCOMPARE(pPool->getStatistics().iAllocations, qint64(1));
+    QCOMPARE(pPool->getStatistics().iRecycled, qint64(1));
+    QCOMPARE(pPool->getStatistics().iBlocksPooled, qint64(0));
+
+    // A different size needs new storage
+    SampleBlockPool::Block blockOther = pPool->acquire(MatrixXd::Random(2, 2));
+    QVERIFY(blockOther.data() != pStorage);
+    QCOMPARE(pPool->getStatistics().iAllocations, qint64(2));
+    QCOMPARE(pPool->getStatistics().iBlocksInUse, qint64(2));
+}
+
+//=============================================================================================================
+
+void TestSampleBlockPool::testMoveAcquireRecycles()
+{
+    SampleBlockPool::SPtr pPool = SampleBlockPool::create("move", 4);
+
+    // The samples are handed over without a copy
+    MatrixXd matFirst = MatrixXd::Random(4, 8);
+    const double* pFirstData = matFirst.data();
+    SampleBlockPool::Block block = pPool->acquire(std::move(matFirst));
+
+    QVERIFY(block->data() == pFirstData);
+    QCOMPARE(block->rows(), Index(4));
+    QCOMPARE(matFirst.size(), Index(0));
+
+    block.reset();
+
+    // The producer gets the released storage back and can refill it without allocating
+    MatrixXd matSecond = MatrixXd::Random(4, 8);
+    const double* pSecondData = matSecond.data();
+    MatrixXd matSecondCopy = matSecond;
+    block = pPool->acquire(std::move(matSecond));
+
+    QVERIFY(block->data() == pSecondData);
+    QVERIFY(*block == matSecondCopy);
+    QCOMPARE(matSecond.size(), Index(32));
+    QVERIFY(matSecond.data() == pFirstData);
+    QCOMPARE(pPool->getStatistics().iRecycled, qint64(1));
+}
+
+//=============================================================================================================
+
+void TestSampleBlockPool::testSharedBlocks()
+{
+    SampleBlockPool::SPtr pPool = SampleBlockPool::create("shared", 4);
+
+    SampleBlockPool::Block block = pPool->acquire(MatrixXd::Ones(2, 5));
+    SampleBlockPool::Block blockConsumer = block;
+
+    // The storage is only returned once the last consumer dropped its reference
+    block.reset();
+    QCOMPARE(pPool->getStatistics().iBlocksInUse, qint64(1));
+    QCOMPARE(pPool->getStatistics().iBlocksPooled, qint64(0));
+    QVERIFY(*blockConsumer == MatrixXd::Ones(2, 5));
+
+    blockConsumer.reset();
+    QCOMPARE(pPool->getStatistics().iBlocksInUse, qint64(0));
+    QCOMPARE(pPool->getStatistics().iBlocksPooled, qint64(1));
+
+    // Blocks stay valid when the pool is destroyed before them
+    block = pPool->acquire(MatrixXd::Constant(3, 3, 2.0));
+    pPool.reset();
+    QVERIFY(*block == MatrixXd::Constant(3, 3, 2.0));
+    block.reset();
+}
+
+//=============================================================================================================
+
+void TestSampleBlockPool::testPoolLimits()
+{
+    SampleBlockPool::SPtr pPool = SampleBlockPool::create("limits", 2);
+
+    QList<SampleBlockPool::Block> lBlocks;
+    for(int i = 0; i < 3; ++i) {
+        lBlocks.append(pPool->acquire(MatrixXd::Random(4, 4)));
+    }
+    lBlocks.clear();
+
+    // Only iMaxPooledBlocks released blocks are kept
+    QCOMPARE(pPool->getStatistics().iBlocksPooled, qint64(2));
+
+    pPool->clear();
+    QCOMPARE(pPool->getStatistics().iBlocksPooled, qint64(0));
+
+    pPool->acquire(MatrixXd::Random(4, 4));
+    QCOMPARE(pPool->getStatistics().iAllocations, qint64(4));
+    QCOMPARE(pPool->getStatistics().iRecycled, qint64(0));
+
+    // A pool without free list never recycles
+    SampleBlockPool::SPtr pNoPool = SampleBlockPool::create("nopool", 0);
+    pNoPool->acquire(MatrixXd::Random(4, 4));
+    pNoPool->acquire(MatrixXd::Random(4, 4));
+    QCOMPARE(pNoPool->getStatistics().iAllocations, qint64(2));
+    QCOMPARE(pNoPool->getStatistics().iBlocksPooled, qint64(0));
+}
+
+//=============================================================================================================
+
+void TestSampleBlockPool::testStatistics()
+{
+    SampleBlockPool::SPtr pPool = SampleBlockPool::create("statistics", 8);
+
+    for(int i = 0; i < 10; ++i) {
+        pPool->acquire(MatrixXd::Random(6, 20));
+    }
+
+    SampleBlockPool::Statistics statistics = pPool->getStatistics();
+    QCOMPARE(statistics.iAllocations, qint64(1));
+    QCOMPARE(statistics.iRecycled, qint64(9));
+    QCOMPARE(statistics.iBytesAllocated, qint64(6 * 20 * sizeof(double)));
+    QVERIFY(statistics.dBlocksPerSecond >= statistics.dAllocationsPerSecond);
+
+    // Resetting clears the counters but keeps the pooled blocks
+    pPool->resetStatistics();
+    statistics = pPool->getStatistics();
+    QCOMPARE(statistics.iAllocations, qint64(0));
+    QCOMPARE(statistics.iRecycled, qint64(0));
+    QCOMPARE(statistics.iBytesAllocated, qint64(0));
+    QCOMPARE(statistics.iBlocksPooled, qint64(1));
+
+    // The pool is reported under its current name while it is alive
+    pPool->setName("renamed");
+
+    auto containsPool = [](const QString& sName) {
+        for(const QPair<QString, SampleBlockPool::Statistics>& pair : SampleBlockPool::getStatisticsOfAllPools()) {
+            if(pair.first == sName) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    QVERIFY(containsPool("renamed"));
+    QVERIFY(!containsPool("statistics"));
+
+    pPool.reset();
+    QVERIFY(!containsPool("renamed"));
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestSampleBlockPool)
+#include "test_scmeas_sampleblockpool.moc"
@@ -50,7 +50,9 @@
 #include <connectivity/metrics/weightedphaselagindex.h>
 #include <connectivity/metrics/debiasedsquaredweightedphaselagindex.h>
 #include <connectivity/metrics/crosscorrelation.h>
+#include <connectivity/metrics/abstractmetric.h>
 #include <connectivity/connectivitysettings.h>
+#include <connectivity/connectivity.h>
 #include <connectivity/network/network.h>
 
 //=============================================================================================================
@@ -97,6 +99,7 @@ private slots:
     void spectralConnectivityCoherence();
     void spectralConnectivityImagCoherence();
     void spectralConnectivityXCOR();
+    void spectralConnectivityMapReduce();
     void cleanupTestCase();
 
 private:
@@ -358,6 +361,99 @@ void TestSpectralConnectivity::spectralConnectivityXCOR()
 
 //=============================================================================================================
 
+void TestSpectralConnectivity::spectralConnectivityMapReduce()
+{
+    //*********************************************************************************************************
+    // Compute Partial Results For Two Chunks Of Trials
+    //*********************************************************************************************************
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QList<MatrixXd> matDataList = readConnectivityData();
+    int iNFirstChunk = matDataList.size() / 2;
+    QStringList lFileNames;
+
+    for(int i = 0; i < 2; ++i) {
+        ConnectivitySettings chunkSettings;
+        chunkSettings.setConnectivityMethods(QStringList() << "PLV");
+        chunkSettings.setFFTSize(matDataList.at(0).cols());
+        chunkSettings.setWindowType("hanning");
+        chunkSettings.append(i == 0 ? matDataList.mid(0, iNFirstChunk) : matDataList.mid(iNFirstChunk));
+
+        lFileNames << tempDir.filePath(QString("chunk_%1.sums").arg(i));
+        QVERIFY(Connectivity::calculateIntermediateSumData(chunkSettings, lFileNames.last()));
+
+        // A finished chunk is not computed again
+        QVERIFY(Connectivity::calculateIntermediateSumData(chunkSettings, lFileNames.last()));
+    }
+
+    // A partial result must only be reused for the same trials, nodes and frequency bins
+    int iSums = ConnectivitySettings::CsdSum | ConnectivitySettings::CsdNormalizedSum;
+    int iBinStart = AbstractMetric::m_iNumberBinStart;
+    int iBinAmount = AbstractMetric::m_iNumberBinAmount;
+
+    ConnectivitySettings otherSettings;
+    otherSettings.setConnectivityMethods(QStringList() << "PLV");
+    otherSettings.setFFTSize(matDataList.at(0).cols());
+    otherSettings.setWindowType("hanning");
+    otherSettings.append(matDataList.mid(0, iNFirstChunk));
+    QVERIFY(otherSettings.isValidIntermediateSumFile(lFileNames.at(0), iSums, iBinStart, iBinAmount));
+    QVERIFY(!otherSettings.isValidIntermediateSumFile(lFileNames.at(0), iSums, iBinStart + 1, iBinAmount - 1));
+
+    ConnectivitySettings fewerTrialsSettings;
+    fewerTrialsSettings.setConnectivityMethods(QStringList() << "PLV");
+    fewerTrialsSettings.setFFTSize(matDataList.at(0).cols());
+    fewerTrialsSettings.setWindowType("hanning");
+    fewerTrialsSettings.append(matDataList.mid(0, iNFirstChunk - 1));
+    QVERIFY(!fewerTrialsSettings.isValidIntermediateSumFile(lFileNames.at(0), iSums, iBinStart, iBinAmount));
+
+    QList<MatrixXd> lMoreNodes;
+    for(int i = 0; i < iNFirstChunk; ++i) {
+        MatrixXd matTrial(matDataList.at(i).rows() + 1, matDataList.at(i).cols());
+        matTrial << matDataList.at(i), matDataList.at(i).row(0);
+        lMoreNodes.append(matTrial);
+    }
+    ConnectivitySettings moreNodesSettings;
+    moreNodesSettings.setConnectivityMethods(QStringList() << "PLV");
+    moreNodesSettings.setFFTSize(matDataList.at(0).cols());
+    moreNodesSettings.setWindowType("hanning");
+    moreNodesSettings.append(lMoreNodes);
+    QVERIFY(!moreNodesSettings.isValidIntermediateSumFile(lFileNames.at(0), iSums, iBinStart, iBinAmount));
+
+    //*********************************************************************************************************
+    // Merge Partial Results And Compute Connectivity
+    //*********************************************************************************************************
+
+    ConnectivitySettings mergedSettings;
+    mergedSettings.setConnectivityMethods(QStringList() << "PLV");
+    mergedSettings.setFFTSize(matDataList.at(0).cols());
+    mergedSettings.setWindowType("hanning");
+
+    QVERIFY(Connectivity::mergeIntermediateSumData(mergedSettings, lFileNames));
+    QCOMPARE(mergedSettings.getNumberTrials(), matDataList.size());
+
+    Network network = PhaseLockingValue::calculate(mergedSettings);
+    m_dConnectivityOutput = network.getFullConnectivityMatrix()(0,1);
+
+    //*********************************************************************************************************
+    // Load MNE-PYTHON Results As Reference
+    //*********************************************************************************************************
+
+    MatrixXd refConnectivity;
+    QString refFileName(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/Result/Connectivity/ref_spectral_connectivity_plv.txt");
+    IOUtils::read_eigen_matrix(refConnectivity, refFileName);
+    m_dRefConnectivityOutput = refConnectivity.col(0).mean();
+
+    //*********************************************************************************************************
+    // Compare Connectivity
+    //*********************************************************************************************************
+
+    compareConnectivity();
+}
+
+//=============================================================================================================
+
 QList<MatrixXd> TestSpectralConnectivity::readConnectivityData()
 {
     MatrixXd inputTrials;
@@ -38,6 +38,8 @@
 
 #include <utils/generics/circularbuffer.h>
 
+#include <atomic>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -45,6 +47,7 @@
 #include <QCoreApplication>
 #include <QObject>
 #include <QDebug>
+#include <QThread>
 #include <QTest>
 
 //=============================================================================================================
@@ -69,6 +72,8 @@ private slots:
     void testBufferCreationDestruction();
     void testBufferPushingPopping();
     void testBufferCapacity();
+    void testSpscArrayPush();
+    void testSpscProducerConsumer();
 };
 
 //=============================================================================================================
@@ -139,6 +144,112 @@ void TestCircularBuffer::testBufferCapacity()
     QVERIFY(!testBuffer.pop(testSink));
 }
 
+//=============================================================================================================
+
+void TestCircularBuffer::testSpscArrayPush()
+{
+    SpscCircularBuffer<int> testBuffer(4);
+    int testArray[5] = {1, 2, 3, 4, 5};
+    int testSink = 0;
+
+    // Arrays are added as a whole or not at all
+    QVERIFY(!testBuffer.push(testArray, 5));
+    QCOMPARE(testBuffer.getFreeElementsRead(), 0);
+
+    QVERIFY(testBuffer.push(testArray, 3));
+    QVERIFY(!testBuffer.push(testArray, 2));
+    QCOMPARE(testBuffer.getFreeElementsRead(), 3);
+
+    QVERIFY(testBuffer.try_pop(testSink));
+    QCOMPARE(testSink, 1);
+    QVERIFY(testBuffer.push(testArray + 3, 2));
+    QVERIFY(!testBuffer.try_push(6));
+
+    for(int i = 2; i <= 5; ++i) {
+        QVERIFY(testBuffer.try_pop(testSink));
+        QCOMPARE(testSink, i);
+    }
+
+    QVERIFY(!testBuffer.try_pop(testSink));
+}
+
+//=============================================================================================================
+
+void TestCircularBuffer::testSpscProducerConsumer()
+{
+    // A small buffer makes both sides run into a full or an empty buffer and park often. The pauses let the
+    // spinning run out, so that parked threads have to be woken up by the other side.
+    const int iNumElements = 200000;
+    SpscCircularBuffer<int> testBuffer(8);
+
+    std::atomic<int> iProducerErrors(0);
+    int testArray[3];
+
+    QThread* pProducer = QThread::create([&]() {
+        for(int i = 0; i < iNumElements;) {
+            bool bOk = true;
+
+            if(i % 5 == 0 && i + 3 <= iNumElements) {
+                testArray[0] = i;
+                testArray[1] = i + 1;
+                testArray[2] = i + 2;
+                bOk = testBuffer.push(testArray, 3);
+                i += 3;
+            } else if(i % 7 == 0) {
+                while(!testBuffer.try_push(i)) {
+                    QThread::yieldCurrentThread();
+                }
+                ++i;
+            } else {
+                bOk = testBuffer.push(i);
+                ++i;
+            }
+
+            if(!bOk) {
+                iProducerErrors.fetch_add(1);
+                return;
+            }
+
+            if(i % 50000 == 0) {
+                QThread::msleep(5);
+            }
+        }
+    });
+
+    pProducer->start();
+
+    int iExpected = 0;
+    bool bInOrder = true;
+    bool bPopOk = true;
+
+    for(int i = 0; i < iNumElements && bPopOk; ++i) {
+        int testSink = -1;
+
+        if(i % 11 == 0) {
+            while(!testBuffer.try_pop(testSink)) {
+                QThread::yieldCurrentThread();
+            }
+        } else {
+            bPopOk = testBuffer.pop(testSink);
+        }
+
+        bInOrder = bInOrder && (testSink == iExpected);
+        ++iExpected;
+
+        if(i % 40000 == 0) {
+            QThread::msleep(5);
+        }
+    }
+
+    QVERIFY(pProducer->wait(10000));
+    delete pProducer;
+
+    QVERIFY(bPopOk);
+    QCOMPARE(iProducerErrors.load(), 0);
+    QVERIFY(bInOrder);
+    QCOMPARE(testBuffer.getFreeElementsRead(), 0);
+}
+
 //=============================================================================================================
 // MAIN
 //=============================================================================================================
@@ -0,0 +1,213 @@
+//=============================================================================================================
+/**
+ * @file     test_utils_spectral.cpp
+ * @author   MNE-CPP Developers
+ * @since    0.1.9
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    test for the taper cache and the per thread FFT workspace of Spectral.
+ *
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/spectral.h>
+
+#include <Eigen/Dense>
+#include <unsupported/Eigen/FFT>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QtMath>
+#include <QTest>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestSpectral
+ *
+ * @brief The TestSpectral class verifies that cached tapers and reused FFT plans give the uncached results
+ *
+ */
+class TestSpectral : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSpectral();
+
+private slots:
+    void initTestCase();
+    void testTaperCache();
+    void testFftWorkspace();
+    void cleanupTestCase();
+
+private:
+    MatrixXd hanningReference(int iSignalLength) const;
+    MatrixXcd spectraReference(const RowVectorXd& vecData,
+                               const MatrixXd& matTaper,
+                               int iNfft) const;
+
+    double m_dEpsilon;
+};
+
+//=============================================================================================================
+
+TestSpectral::TestSpectral()
+: m_dEpsilon(1e-12)
+{
+}
+
+//=============================================================================================================
+
+void TestSpectral::initTestCase()
+{
+    Spectral::clearTaperCache();
+}
+
+//=============================================================================================================
+
+void TestSpectral::testTaperCache()
+{
+    // Hold on to the first tapers while enough other lengths are requested to push them out of the cache
+    QSharedPointer<const QPair<MatrixXd, VectorXd> > pFirst = Spectral::getTapers(100, "hanning");
+    QVERIFY( pFirst == Spectral::getTapers(100, "hanning") );
+
+    for(int iLength = 101; iLength < 200; ++iLength) {
+        QSharedPointer<const QPair<MatrixXd, VectorXd> > pTapers = Spectral::getTapers(iLength, "hanning");
+        QCOMPARE( pTapers->first.cols(), iLength );
+        QVERIFY( (pTapers->first - hanningReference(iLength)).cwiseAbs().maxCoeff() < m_dEpsilon );
+        QVERIFY( (pTapers->second - VectorXd::Ones(1)).cwiseAbs().maxCoeff() < m_dEpsilon );
+    }
+
+    // The tapers handed out before stay valid, the evicted ones are computed again with the same values
+    QSharedPointer<const QPair<MatrixXd, VectorXd> > pAgain = Spectral::getTapers(100, "hanning");
+    QVERIFY( (pFirst->first - hanningReference(100)).cwiseAbs().maxCoeff() < m_dEpsilon );
+    QVERIFY( (pAgain->first - pFirst->first).cwiseAbs().maxCoeff() < m_dEpsilon );
+
+    // Window types of the same length are cached separately
+    QPair<MatrixXd, VectorXd> pairOnes = Spectral::generateTapers(100, QString("ones"));
+    QVERIFY( (pairOnes.first - MatrixXd::Ones(1, 100) / 100.0).cwiseAbs().maxCoeff() < m_dEpsilon );
+    QVERIFY( (Spectral::generateTapers(100, QString("hanning")).first - hanningReference(100)).cwiseAbs().maxCoeff() < m_dEpsilon );
+
+    Spectral::clearTaperCache();
+    QVERIFY( (Spectral::getTapers(100, "hanning")->first - hanningReference(100)).cwiseAbs().maxCoeff() < m_dEpsilon );
+}
+
+//=============================================================================================================
+
+void TestSpectral::testFftWorkspace()
+{
+    srand(7);
+
+    // Cycle through more FFT lengths than the workspace keeps plans for, twice, so that plans are reused as well
+    // as dropped and created again
+    MatrixXcd matSpectra;
+
+    for(int iRound = 0; iRound < 2; ++iRound) {
+        for(int iLength = 50; iLength < 70; ++iLength) {
+            RowVectorXd vecData = RowVectorXd::Random(iLength);
+            MatrixXd matTaper = Spectral::getTapers(iLength, "hanning")->first;
+            int iNfft = 2 * iLength + iRound;
+
+            MatrixXcd matRef = spectraReference(vecData, matTaper, iNfft);
+
+            QVERIFY( Spectral::computeTaperedSpectraRow(vecData, matTaper, iNfft, matSpectra) );
+            QCOMPARE( matSpectra.rows(), matRef.rows() );
+            QCOMPARE( matSpectra.cols(), matRef.cols() );
+            QVERIFY( (matSpectra - matRef).cwiseAbs().maxCoeff() < 1e-10 );
+
+            MatrixXcd matSpectraCopy = Spectral::computeTaperedSpectraRow(vecData, matTaper, iNfft);
+            QVERIFY( (matSpectraCopy - matRef).cwiseAbs().maxCoeff() < 1e-10 );
+        }
+    }
+
+    // Input longer than the FFT length is rejected
+    QVERIFY( !Spectral::computeTaperedSpectraRow(RowVectorXd::Random(64), MatrixXd::Ones(1, 64), 32, matSpectra) );
+}
+
+//=============================================================================================================
+
+void TestSpectral::cleanupTestCase()
+{
+    Spectral::clearTaperCache();
+}
+
+//=============================================================================================================
+
+MatrixXd TestSpectral::hanningReference(int iSignalLength) const
+{
+    MatrixXd matHann(1, iSignalLength);
+
+    for(int n = 0; n < iSignalLength; ++n) {
+        matHann(0, n) = 0.5 - 0.5 * cos(2.0 * M_PI * n / (iSignalLength - 1.0));
+    }
+
+    return matHann / matHann.norm();
+}
+
+//=============================================================================================================
+
+MatrixXcd TestSpectral::spectraReference(const RowVectorXd& vecData,
+                                         const MatrixXd& matTaper,
+                                         int iNfft) const
+{
+    // A new FFT object for every taper, so that no plan is reused
+    int iNFreqs = iNfft / 2 + 1;
+    MatrixXcd matSpectra(matTaper.rows(), iNFreqs);
+
+    for(int i = 0; i < matTaper.rows(); ++i) {
+        VectorXd vecInput = VectorXd::Zero(iNfft);
+        vecInput.head(vecData.cols()) = vecData.cwiseProduct(matTaper.row(i)).transpose();
+
+        FFT<double> fft;
+        VectorXcd vecFreq;
+        fft.fwd(vecFreq, vecInput);
+
+        matSpectra.row(i) = vecFreq.head(iNFreqs).transpose();
+    }
+
+    return matSpectra;
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestSpectral)
+#include "test_utils_spectral.moc"